@@ -0,0 +1,323 @@
+#pragma once
+
+#include <cstddef>
+
+#include "algobase.h"
+#include "allocator.h"
+#include "construct.h"
+#include "functional.h"
+#include "iterator.h"
+#include "uninitialized.h"
+#include "util.h"
+
+namespace hxqstl{
+    // lower_bound
+    // 在[first,last)中查找第一个不小于value的元素，返回指向它的迭代器，若没有则返回last
+    template<class ForwardIter,class T,class Compare>
+    ForwardIter lower_bound(ForwardIter first,ForwardIter last,const T& value,Compare comp){
+        auto len = hxqstl::distance(first,last);
+        while(len > 0){
+            auto half = len >> 1;
+            auto middle = first;
+            hxqstl::advance(middle,half);
+            if(comp(*middle,value)){
+                first = ++middle;
+                len = len - half - 1;
+            }
+            else{
+                len = half;
+            }
+        }
+        return first;
+    }
+
+    template<class ForwardIter,class T>
+    ForwardIter lower_bound(ForwardIter first,ForwardIter last,const T& value){
+        return hxqstl::lower_bound(first,last,value,
+                                   [](const typename iterator_traits<ForwardIter>::value_type& a,const T& b){
+                                       return a < b;
+                                   });
+    }
+
+    // upper_bound
+    // 在[first,last)中查找第一个大于value的元素，返回指向它的迭代器，若没有则返回last
+    template<class ForwardIter,class T,class Compare>
+    ForwardIter upper_bound(ForwardIter first,ForwardIter last,const T& value,Compare comp){
+        auto len = hxqstl::distance(first,last);
+        while(len > 0){
+            auto half = len >> 1;
+            auto middle = first;
+            hxqstl::advance(middle,half);
+            if(comp(value,*middle)){
+                len = half;
+            }
+            else{
+                first = ++middle;
+                len = len - half - 1;
+            }
+        }
+        return first;
+    }
+
+    template<class ForwardIter,class T>
+    ForwardIter upper_bound(ForwardIter first,ForwardIter last,const T& value){
+        return hxqstl::upper_bound(first,last,value,
+                                   [](const T& a,const typename iterator_traits<ForwardIter>::value_type& b){
+                                       return a < b;
+                                   });
+    }
+
+    // unique
+    // 移除[first,last)内相邻的重复元素，只保留每组的第一个，返回新的尾部
+    template<class ForwardIter,class BinaryPred>
+    ForwardIter unique(ForwardIter first,ForwardIter last,BinaryPred pred){
+        if(first == last) return last;
+        ForwardIter result = first;
+        while(++first != last){
+            if(!pred(*result,*first)){
+                // 还没有遇到重复元素时 result 与 first 重合，不做自我移动赋值
+                if(++result != first) *result = hxqstl::move(*first);
+            }
+        }
+        return ++result;
+    }
+
+    // merge
+    // 将两个经过排序的区间合并到以result起始的空间，两区间相等的元素先取第一个区间的
+    template<class InputIter1,class InputIter2,class OutputIter,class Compare>
+    OutputIter merge(InputIter1 first1,InputIter1 last1,InputIter2 first2,InputIter2 last2,
+                     OutputIter result,Compare comp){
+        while(first1 != last1 && first2 != last2){
+            if(comp(*first2,*first1)){
+                *result = *first2;
+                ++first2;
+            }
+            else{
+                *result = *first1;
+                ++first1;
+            }
+            ++result;
+        }
+        return hxqstl::copy(first2,last2,hxqstl::copy(first1,last1,result));
+    }
+
+    // insertion_sort
+    template<class RandomIter,class Compare>
+    void insertion_sort(RandomIter first,RandomIter last,Compare comp){
+        if(first == last) return;
+        for(auto i = first + 1;i != last;++i){
+            auto value = hxqstl::move(*i);
+            auto hole = i;
+            for(auto prev = i;prev != first && comp(value,*--prev);--hole){
+                *hole = hxqstl::move(*prev);
+            }
+            *hole = hxqstl::move(value);
+        }
+    }
+
+    // stable_sort
+    // 归并排序，只需要一半长度的辅助空间，相等元素保持原来的相对次序
+    template<class RandomIter,class Pointer,class Compare>
+    void stable_sort_aux(RandomIter first,RandomIter last,Pointer buffer,Compare comp){
+        const auto len = last - first;
+        if(len <= 16){
+            hxqstl::insertion_sort(first,last,comp);
+            return;
+        }
+        const RandomIter middle = first + len / 2;
+        hxqstl::stable_sort_aux(first,middle,buffer,comp);
+        hxqstl::stable_sort_aux(middle,last,buffer,comp);
+        if(!comp(*middle,*(middle - 1))){
+            return;     // 两段已经有序
+        }
+        // 把前半段移到缓冲区，再从缓冲区和后半段归并回原区间
+        Pointer buf_end = hxqstl::uninitialized_move(first,middle,buffer);
+        Pointer b = buffer;
+        RandomIter r = middle;
+        RandomIter out = first;
+        while(b != buf_end && r != last){
+            if(comp(*r,*b)){
+                *out = hxqstl::move(*r);
+                ++r;
+            }
+            else{
+                *out = hxqstl::move(*b);
+                ++b;
+            }
+            ++out;
+        }
+        for(;b != buf_end;++b,++out){
+            *out = hxqstl::move(*b);
+        }
+        hxqstl::destroy(buffer,buf_end);
+    }
+
+    template<class RandomIter,class Compare>
+    void stable_sort(RandomIter first,RandomIter last,Compare comp){
+        typedef typename iterator_traits<RandomIter>::value_type value_type;
+        const auto len = last - first;
+        if(len <= 16){
+            hxqstl::insertion_sort(first,last,comp);
+            return;
+        }
+        const size_t buf_len = static_cast<size_t>(len - len / 2);
+        value_type* buffer = hxqstl::allocator<value_type>::allocate(buf_len);
+        try{
+            hxqstl::stable_sort_aux(first,last,buffer,comp);
+        }
+        catch(...){
+            hxqstl::allocator<value_type>::deallocate(buffer,buf_len);
+            throw;
+        }
+        hxqstl::allocator<value_type>::deallocate(buffer,buf_len);
+    }
+
+    template<class RandomIter>
+    void stable_sort(RandomIter first,RandomIter last){
+        typedef typename iterator_traits<RandomIter>::value_type value_type;
+        hxqstl::stable_sort(first,last,[](const value_type& a,const value_type& b){
+            return a < b;
+        });
+    }
+
+    /*****************************************************************************************/
+    // 堆算法
+    // d 叉堆：第 i 个节点的孩子是 [i*D+1,i*D+D]，D == 2 就是普通的二叉堆
+    // D 较大时树更矮，下沉时一次比较的孩子在同一条 cache line 上，push 也更快
+    // comp 为 less 时是大顶堆，堆顶是最大的元素
+
+    // 把 value 从 hole 处向上调整，top 是堆顶的位置
+    template<size_t D,class RandomIter,class Distance,class T,class Compare>
+    void dary_sift_up(RandomIter first,Distance hole,Distance top,T value,Compare comp){
+        while(hole > top){
+            const Distance parent = (hole - 1) / D;
+            if(!comp(*(first + parent),value)) break;
+            *(first + hole) = hxqstl::move(*(first + parent));
+            hole = parent;
+        }
+        *(first + hole) = hxqstl::move(value);
+    }
+
+    // 把 value 从 hole 处向下调整，len 是堆的长度
+    template<size_t D,class RandomIter,class Distance,class T,class Compare>
+    void dary_sift_down(RandomIter first,Distance hole,Distance len,T value,Compare comp){
+        for(;;){
+            const Distance child = hole * static_cast<Distance>(D) + 1;
+            if(child >= len) break;
+            const Distance child_end = hxqstl::min(child + static_cast<Distance>(D),len);
+            Distance best = child;
+            for(Distance c = child + 1;c < child_end;++c){
+                if(comp(*(first + best),*(first + c))) best = c;
+            }
+            if(!comp(value,*(first + best))) break;
+            *(first + hole) = hxqstl::move(*(first + best));
+            hole = best;
+        }
+        *(first + hole) = hxqstl::move(value);
+    }
+
+    // [first,last-1) 是堆，把 last-1 处的新元素加入堆
+    template<size_t D,class RandomIter,class Compare>
+    void push_dary_heap(RandomIter first,RandomIter last,Compare comp){
+        typedef typename iterator_traits<RandomIter>::difference_type distance_type;
+        const distance_type len = last - first;
+        if(len < 2) return;
+        auto value = hxqstl::move(*(last - 1));
+        hxqstl::dary_sift_up<D>(first,len - 1,distance_type(0),hxqstl::move(value),comp);
+    }
+
+    // 把堆顶移到 last-1，[first,last-1) 重新成为堆
+    template<size_t D,class RandomIter,class Compare>
+    void pop_dary_heap(RandomIter first,RandomIter last,Compare comp){
+        typedef typename iterator_traits<RandomIter>::difference_type distance_type;
+        const distance_type len = last - first;
+        if(len < 2) return;
+        auto value = hxqstl::move(*(last - 1));
+        *(last - 1) = hxqstl::move(*first);
+        hxqstl::dary_sift_down<D>(first,distance_type(0),len - 1,hxqstl::move(value),comp);
+    }
+
+    // Floyd 建堆：从最后一个非叶子节点开始依次下沉，O(n)
+    template<size_t D,class RandomIter,class Compare>
+    void make_dary_heap(RandomIter first,RandomIter last,Compare comp){
+        typedef typename iterator_traits<RandomIter>::difference_type distance_type;
+        const distance_type len = last - first;
+        if(len < 2) return;
+        for(distance_type hole = (len - 2) / static_cast<distance_type>(D);;--hole){
+            auto value = hxqstl::move(*(first + hole));
+            hxqstl::dary_sift_down<D>(first,hole,len,hxqstl::move(value),comp);
+            if(hole == 0) break;
+        }
+    }
+
+    template<size_t D,class RandomIter,class Compare>
+    RandomIter is_dary_heap_until(RandomIter first,RandomIter last,Compare comp){
+        typedef typename iterator_traits<RandomIter>::difference_type distance_type;
+        const distance_type len = last - first;
+        for(distance_type i = 1;i < len;++i){
+            if(comp(*(first + (i - 1) / static_cast<distance_type>(D)),*(first + i))){
+                return first + i;
+            }
+        }
+        return last;
+    }
+
+    // push_heap
+    template<class RandomIter,class Compare>
+    void push_heap(RandomIter first,RandomIter last,Compare comp){
+        hxqstl::push_dary_heap<2>(first,last,comp);
+    }
+
+    template<class RandomIter>
+    void push_heap(RandomIter first,RandomIter last){
+        hxqstl::push_heap(first,last,hxqstl::less<typename iterator_traits<RandomIter>::value_type>());
+    }
+
+    // pop_heap
+    template<class RandomIter,class Compare>
+    void pop_heap(RandomIter first,RandomIter last,Compare comp){
+        hxqstl::pop_dary_heap<2>(first,last,comp);
+    }
+
+    template<class RandomIter>
+    void pop_heap(RandomIter first,RandomIter last){
+        hxqstl::pop_heap(first,last,hxqstl::less<typename iterator_traits<RandomIter>::value_type>());
+    }
+
+    // make_heap
+    template<class RandomIter,class Compare>
+    void make_heap(RandomIter first,RandomIter last,Compare comp){
+        hxqstl::make_dary_heap<2>(first,last,comp);
+    }
+
+    template<class RandomIter>
+    void make_heap(RandomIter first,RandomIter last){
+        hxqstl::make_heap(first,last,hxqstl::less<typename iterator_traits<RandomIter>::value_type>());
+    }
+
+    // sort_heap
+    // 不断把堆顶移到末尾，得到升序序列
+    template<class RandomIter,class Compare>
+    void sort_heap(RandomIter first,RandomIter last,Compare comp){
+        while(last - first > 1){
+            hxqstl::pop_heap(first,last,comp);
+            --last;
+        }
+    }
+
+    template<class RandomIter>
+    void sort_heap(RandomIter first,RandomIter last){
+        hxqstl::sort_heap(first,last,hxqstl::less<typename iterator_traits<RandomIter>::value_type>());
+    }
+
+    // is_heap
+    template<class RandomIter,class Compare>
+    bool is_heap(RandomIter first,RandomIter last,Compare comp){
+        return hxqstl::is_dary_heap_until<2>(first,last,comp) == last;
+    }
+
+    template<class RandomIter>
+    bool is_heap(RandomIter first,RandomIter last){
+        return hxqstl::is_heap(first,last,hxqstl::less<typename iterator_traits<RandomIter>::value_type>());
+    }
+}
@@ -18,41 +18,101 @@ namespace hxqstl{
     // max
     // 取二者中的较大值，语义相等时返回第一个参数
     template<class T>
-    const T& max(const T& lhs,const T& rhs){
+    constexpr const T& max(const T& lhs,const T& rhs){
         return lhs < rhs ? rhs : lhs;
     }
 
     // 重载版本使用函数对象comp代替比较操作
     template<class T,class Compare>
-    const T& max(const T& lhs,const T& rhs,Compare comp){
+    constexpr const T& max(const T& lhs,const T& rhs,Compare comp){
         return comp(lhs,rhs) ? rhs : lhs;
     }
 
     // min
     // 取二者中的最小值，语义相等时返回第一个参数
     template<class T>
-    const T& min(const T& lhs,const T& rhs){
-        return lhs < rhs ? rhs : lhs;
+    constexpr const T& min(const T& lhs,const T& rhs){
+        return rhs < lhs ? rhs : lhs;
     }
 
     // 重载版本使用函数对象comp代替比较操作
     template<class T,class Compare>
-    const T& min(const T& lhs,const T& rhs,Compare comp){
-        return comp(lhs,rhs) ? rhs : lhs;
+    constexpr const T& min(const T& lhs,const T& rhs,Compare comp){
+        return comp(rhs,lhs) ? rhs : lhs;
     }   
 
     // iter_swap
     // 将两个迭代器所指对象对调
     template<class FIter1,class FIter2>
-    void iter_swap(FIter1 lhs,FIter2 rhs){
+    constexpr void iter_swap(FIter1 lhs,FIter2 rhs){
         hxqstl::swap(*lhs,*rhs);
     }
 
+    template<class InputIter,class OutputIter>
+    constexpr OutputIter copy(InputIter first,InputIter last,OutputIter result);
+    template<class BidirectionalIter1,class BidirectionalIter2>
+    constexpr BidirectionalIter2 copy_backward(BidirectionalIter1 first,BidirectionalIter1 last,
+                                               BidirectionalIter2 result);
+    template<class InputIter,class OutputIter>
+    constexpr OutputIter move(InputIter first,InputIter last,OutputIter result);
+    template<class BidirectionalIter1,class BidirectionalIter2>
+    constexpr BidirectionalIter2 move_backward(BidirectionalIter1 first,BidirectionalIter1 last,
+                                               BidirectionalIter2 result);
+
+    // copy/move 系列在逐元素循环之前先选择快速路径：
+    // 指针对指针的情况由下面针对 Tp* 的重载直接处理，其余情况按迭代器类型分派
+    namespace fastpath{
+        struct generic_path {};         // 逐元素处理
+        struct memmove_path {};         // 两端都是连续迭代器且元素可按字节复制，换成指针处理
+        struct reverse_path {};         // 两端都是连续区间上的 reverse_iterator，对底层区间反方向处理
+        struct segmented_path {};       // 源是分段迭代器，逐段处理
+        struct unwrap_move_path {};     // 源是 move_iterator，改为对底层区间做 move
+
+        template<class Iter>
+        struct is_move_iter : std::false_type {};
+        template<class Iter>
+        struct is_move_iter<move_iterator<Iter>> : std::true_type {};
+
+        // 两端元素类型相同且满足 Trivial 时才能按字节复制
+        template<class In,class Out,template<class> class Trivial,
+                 bool = is_contiguous_iterator<In>::value && is_contiguous_iterator<Out>::value>
+        struct bytewise : std::false_type {};
+
+        template<class In,class Out,template<class> class Trivial>
+        struct bytewise<In,Out,Trivial,true>
+        : std::integral_constant<bool,
+            std::is_same<typename std::remove_cv<typename iterator_traits<In>::value_type>::type,
+                         typename iterator_traits<Out>::value_type>::value &&
+            Trivial<typename iterator_traits<Out>::value_type>::value> {};
+
+        template<class In,class Out,template<class> class Trivial>
+        struct reverse_bytewise : std::false_type {};
+
+        template<class In,class Out,template<class> class Trivial>
+        struct reverse_bytewise<reverse_iterator<In>,reverse_iterator<Out>,Trivial>
+        : bytewise<In,Out,Trivial> {};
+
+        template<class In,class Out,template<class> class Trivial,bool UnwrapMove>
+        struct select_path
+        {
+            typedef typename std::conditional<segmented_iterator_traits<In>::is_segmented::value,
+                segmented_path,
+                typename std::conditional<UnwrapMove && is_move_iter<In>::value,
+                unwrap_move_path,
+                typename std::conditional<bytewise<In,Out,Trivial>::value &&
+                                          !(std::is_pointer<In>::value && std::is_pointer<Out>::value),
+                memmove_path,
+                typename std::conditional<reverse_bytewise<In,Out,Trivial>::value,
+                reverse_path,
+                generic_path>::type>::type>::type>::type type;
+        };
+    }
+
     // copy
     // 把[first,last)区间的元素拷贝到[result,result + (last - first))内
     // input_iterator_tag版本
     template<class InputIter,class OutputIter>
-    OutputIter unchecked_copy_cat(InputIter first,InputIter last,OutputIter result,hxqstl::input_iterator_tag){
+    constexpr OutputIter unchecked_copy_cat(InputIter first,InputIter last,OutputIter result,hxqstl::input_iterator_tag){
         for(;first != last;++first,++result){
             *result = *first;
         }
@@ -60,7 +120,7 @@ namespace hxqstl{
     }
     
     template<class RandomIter,class OutputIter>
-    OutputIter unchecked_copy_cat(RandomIter first,RandomIter last,OutputIter result,hxqstl::random_access_iterator_tag){
+    constexpr OutputIter unchecked_copy_cat(RandomIter first,RandomIter last,OutputIter result,hxqstl::random_access_iterator_tag){
         for(auto n = last - first;n > 0;--n,++first,++result){
             *result = *first;
         }
@@ -68,29 +128,75 @@ namespace hxqstl{
     }
 
     template<class InputIter,class OutputIter>
-    OutputIter unchecked_copy(InputIter first,InputIter last,OutputIter result){
+    constexpr OutputIter unchecked_copy_path(InputIter first,InputIter last,OutputIter result,
+                                             fastpath::generic_path){
         return unchecked_copy_cat(first,last,result,iterator_category(first));
     }
 
+    template<class InputIter,class OutputIter>
+    constexpr OutputIter unchecked_copy_path(InputIter first,InputIter last,OutputIter result,
+                                             fastpath::memmove_path){
+        const auto n = last - first;
+        const auto p = hxqstl::to_address(first);
+        hxqstl::copy(p,p + n,hxqstl::to_address(result));
+        return result + n;
+    }
+
+    // 反向区间复制到反向区间，等价于对底层区间做 copy_backward
+    template<class InputIter,class OutputIter>
+    constexpr OutputIter unchecked_copy_path(InputIter first,InputIter last,OutputIter result,
+                                             fastpath::reverse_path){
+        return OutputIter(hxqstl::copy_backward(last.base(),first.base(),result.base()));
+    }
+
+    template<class InputIter,class OutputIter>
+    constexpr OutputIter unchecked_copy_path(InputIter first,InputIter last,OutputIter result,
+                                             fastpath::segmented_path){
+        typedef segmented_iterator_traits<InputIter> traits;
+        auto sf = traits::segment(first);
+        const auto sl = traits::segment(last);
+        if(sf == sl) return hxqstl::copy(traits::local(first),traits::local(last),result);
+        result = hxqstl::copy(traits::local(first),traits::end(sf),result);
+        for(++sf;sf != sl;++sf){
+            result = hxqstl::copy(traits::begin(sf),traits::end(sf),result);
+        }
+        return hxqstl::copy(traits::begin(sl),traits::local(last),result);
+    }
+
+    template<class InputIter,class OutputIter>
+    constexpr OutputIter unchecked_copy_path(InputIter first,InputIter last,OutputIter result,
+                                             fastpath::unwrap_move_path){
+        return hxqstl::move(first.base(),last.base(),result);
+    }
+
+    template<class InputIter,class OutputIter>
+    constexpr OutputIter unchecked_copy(InputIter first,InputIter last,OutputIter result){
+        return unchecked_copy_path(first,last,result,typename fastpath::select_path<
+            InputIter,OutputIter,std::is_trivially_copy_assignable,true>::type{});
+    }
+
     // 为trivially_copy_assignable类型提供特化版本
     template<class Tp,class Up>
-    typename std::enable_if<std::is_same<typename std::remove_const<Tp>::type,Up>::value &&
+    constexpr typename std::enable_if<std::is_same<typename std::remove_const<Tp>::type,Up>::value &&
             std::is_trivially_copy_assignable<Up>::value,
             Up*>::type unchecked_copy(Tp* first,Tp* last,Up* result){
                 const auto n = static_cast<size_t>(last - first);
-                if(n != 0){
+                if(hxqstl::is_constant_evaluated()){
+                    for(size_t i = 0;i < n;++i) result[i] = first[i];
+                }
+                else if(n != 0){
                     std::memmove(result,first,n * sizeof(Up));
                 }
                 return result + n;
             }
 
     template<class InputIter,class OutputIter>
-    OutputIter copy(InputIter first,InputIter last,OutputIter result){
+    constexpr OutputIter copy(InputIter first,InputIter last,OutputIter result){
         return unchecked_copy(first,last,result);
     }
 
     template<class BidirectionalIter1,class BidirectionalIter2>
-    BidirectionalIter2 unchecked_copy_backward_cat(BidirectionalIter1 first,BidirectionalIter1 last,
+    constexpr BidirectionalIter2 unchecked_copy_backward_cat(BidirectionalIter1 first,BidirectionalIter1 last,
                                     BidirectionalIter2 result,hxqstl::bidirectional_iterator_tag){
                                         while(first != last){
                                             *--result = *--last;
@@ -99,7 +205,7 @@ namespace hxqstl{
                                     }
 
     template <class RandomIter1, class BidirectionalIter2>
-    BidirectionalIter2 
+    constexpr BidirectionalIter2
     unchecked_copy_backward_cat(RandomIter1 first, RandomIter1 last,
                                 BidirectionalIter2 result, hxqstl::random_access_iterator_tag)
     {
@@ -108,25 +214,71 @@ namespace hxqstl{
     return result;
     }
 
+    template<class BidirectionalIter1,class BidirectionalIter2>
+    constexpr BidirectionalIter2 unchecked_copy_backward_path(BidirectionalIter1 first,BidirectionalIter1 last,
+                                                              BidirectionalIter2 result,fastpath::generic_path){
+        return unchecked_copy_backward_cat(first,last,result,iterator_category(first));
+    }
+
+    template<class BidirectionalIter1,class BidirectionalIter2>
+    constexpr BidirectionalIter2 unchecked_copy_backward_path(BidirectionalIter1 first,BidirectionalIter1 last,
+                                                              BidirectionalIter2 result,fastpath::memmove_path){
+        const auto n = last - first;
+        const auto p = hxqstl::to_address(first);
+        hxqstl::copy_backward(p,p + n,hxqstl::to_address(result));
+        return result - n;
+    }
+
+    // 反向区间的 copy_backward 等价于对底层区间做 copy
+    template<class BidirectionalIter1,class BidirectionalIter2>
+    constexpr BidirectionalIter2 unchecked_copy_backward_path(BidirectionalIter1 first,BidirectionalIter1 last,
+                                                              BidirectionalIter2 result,fastpath::reverse_path){
+        return BidirectionalIter2(hxqstl::copy(last.base(),first.base(),result.base()));
+    }
+
+    template<class BidirectionalIter1,class BidirectionalIter2>
+    constexpr BidirectionalIter2 unchecked_copy_backward_path(BidirectionalIter1 first,BidirectionalIter1 last,
+                                                              BidirectionalIter2 result,fastpath::segmented_path){
+        typedef segmented_iterator_traits<BidirectionalIter1> traits;
+        const auto sf = traits::segment(first);
+        auto sl = traits::segment(last);
+        if(sf == sl) return hxqstl::copy_backward(traits::local(first),traits::local(last),result);
+        result = hxqstl::copy_backward(traits::begin(sl),traits::local(last),result);
+        for(--sl;sl != sf;--sl){
+            result = hxqstl::copy_backward(traits::begin(sl),traits::end(sl),result);
+        }
+        return hxqstl::copy_backward(traits::local(first),traits::end(sf),result);
+    }
+
+    template<class BidirectionalIter1,class BidirectionalIter2>
+    constexpr BidirectionalIter2 unchecked_copy_backward_path(BidirectionalIter1 first,BidirectionalIter1 last,
+                                                              BidirectionalIter2 result,fastpath::unwrap_move_path){
+        return hxqstl::move_backward(first.base(),last.base(),result);
+    }
+
     template <class BidirectionalIter1, class BidirectionalIter2>
-    BidirectionalIter2 
+    constexpr BidirectionalIter2
     unchecked_copy_backward(BidirectionalIter1 first, BidirectionalIter1 last,
                             BidirectionalIter2 result)
     {
-    return unchecked_copy_backward_cat(first, last, result,
-                                        iterator_category(first));
+    return unchecked_copy_backward_path(first, last, result, typename fastpath::select_path<
+        BidirectionalIter1, BidirectionalIter2, std::is_trivially_copy_assignable, true>::type{});
     }
 
     // 为 trivially_copy_assignable 类型提供特化版本
     template <class Tp, class Up>
-    typename std::enable_if<
+    constexpr typename std::enable_if<
     std::is_same<typename std::remove_const<Tp>::type, Up>::value &&
     std::is_trivially_copy_assignable<Up>::value,
     Up*>::type
     unchecked_copy_backward(Tp* first, Tp* last, Up* result)
     {
     const auto n = static_cast<size_t>(last - first);
-    if (n != 0)
+    if (hxqstl::is_constant_evaluated())
+    {
+        while (first != last) *--result = *--last;
+    }
+    else if (n != 0)
     {
         result -= n;
         std::memmove(result, first, n * sizeof(Up));
@@ -135,9 +287,303 @@ namespace hxqstl{
     }
 
     template <class BidirectionalIter1, class BidirectionalIter2>
-    BidirectionalIter2 
+    constexpr BidirectionalIter2
     copy_backward(BidirectionalIter1 first, BidirectionalIter1 last, BidirectionalIter2 result)
     {
     return unchecked_copy_backward(first, last, result);
     }
-}
\ No newline at end of file
+
+    // copy_n
+    // 把[first,first + n)区间上的元素拷贝到[result,result + n)上
+    // 返回一个pair分别指向拷贝结束的尾部
+    template<class InputIter,class Size,class OutputIter>
+    hxqstl::pair<InputIter,OutputIter>
+    unchecked_copy_n(InputIter first,Size n,OutputIter result,hxqstl::input_iterator_tag){
+        for(;n > 0;--n,++first,++result){
+            *result = *first;
+        }
+        return hxqstl::pair<InputIter,OutputIter>(first,result);
+    }
+
+    template<class RandomIter,class Size,class OutputIter>
+    hxqstl::pair<RandomIter,OutputIter>
+    unchecked_copy_n(RandomIter first,Size n,OutputIter result,hxqstl::random_access_iterator_tag){
+        auto last = first + n;
+        return hxqstl::pair<RandomIter,OutputIter>(last,hxqstl::copy(first,last,result));
+    }
+
+    template<class InputIter,class Size,class OutputIter>
+    hxqstl::pair<InputIter,OutputIter>
+    copy_n(InputIter first,Size n,OutputIter result){
+        return unchecked_copy_n(first,n,result,iterator_category(first));
+    }
+
+    // move
+    // 把[first,last)区间内的元素移动到[result,result + (last - first))内
+    template<class InputIter,class OutputIter>
+    constexpr OutputIter unchecked_move_cat(InputIter first,InputIter last,OutputIter result,hxqstl::input_iterator_tag){
+        for(;first != last;++first,++result){
+            *result = hxqstl::move(*first);
+        }
+        return result;
+    }
+
+    template<class RandomIter,class OutputIter>
+    constexpr OutputIter unchecked_move_cat(RandomIter first,RandomIter last,OutputIter result,hxqstl::random_access_iterator_tag){
+        for(auto n = last - first;n > 0;--n,++first,++result){
+            *result = hxqstl::move(*first);
+        }
+        return result;
+    }
+
+    template<class InputIter,class OutputIter>
+    constexpr OutputIter unchecked_move_path(InputIter first,InputIter last,OutputIter result,
+                                             fastpath::generic_path){
+        return unchecked_move_cat(first,last,result,iterator_category(first));
+    }
+
+    template<class InputIter,class OutputIter>
+    constexpr OutputIter unchecked_move_path(InputIter first,InputIter last,OutputIter result,
+                                             fastpath::memmove_path){
+        const auto n = last - first;
+        const auto p = hxqstl::to_address(first);
+        hxqstl::move(p,p + n,hxqstl::to_address(result));
+        return result + n;
+    }
+
+    template<class InputIter,class OutputIter>
+    constexpr OutputIter unchecked_move_path(InputIter first,InputIter last,OutputIter result,
+                                             fastpath::reverse_path){
+        return OutputIter(hxqstl::move_backward(last.base(),first.base(),result.base()));
+    }
+
+    template<class InputIter,class OutputIter>
+    constexpr OutputIter unchecked_move_path(InputIter first,InputIter last,OutputIter result,
+                                             fastpath::segmented_path){
+        typedef segmented_iterator_traits<InputIter> traits;
+        auto sf = traits::segment(first);
+        const auto sl = traits::segment(last);
+        if(sf == sl) return hxqstl::move(traits::local(first),traits::local(last),result);
+        result = hxqstl::move(traits::local(first),traits::end(sf),result);
+        for(++sf;sf != sl;++sf){
+            result = hxqstl::move(traits::begin(sf),traits::end(sf),result);
+        }
+        return hxqstl::move(traits::begin(sl),traits::local(last),result);
+    }
+
+    template<class InputIter,class OutputIter>
+    constexpr OutputIter unchecked_move(InputIter first,InputIter last,OutputIter result){
+        return unchecked_move_path(first,last,result,typename fastpath::select_path<
+            InputIter,OutputIter,std::is_trivially_move_assignable,false>::type{});
+    }
+
+    // 为trivially_copy_assignable类型提供特化版本
+    template<class Tp,class Up>
+    constexpr typename std::enable_if<std::is_same<typename std::remove_const<Tp>::type,Up>::value &&
+            std::is_trivially_move_assignable<Up>::value,
+            Up*>::type unchecked_move(Tp* first,Tp* last,Up* result){
+                const size_t n = static_cast<size_t>(last - first);
+                if(hxqstl::is_constant_evaluated()){
+                    for(size_t i = 0;i < n;++i) result[i] = hxqstl::move(first[i]);
+                }
+                else if(n != 0){
+                    std::memmove(result,first,n * sizeof(Up));
+                }
+                return result + n;
+            }
+
+    template<class InputIter,class OutputIter>
+    constexpr OutputIter move(InputIter first,InputIter last,OutputIter result){
+        return unchecked_move(first,last,result);
+    }
+
+    // move_backward
+    // 把[first,last)区间内的元素从后往前移动到以result结尾的区间内
+    template<class BidirectionalIter1,class BidirectionalIter2>
+    constexpr BidirectionalIter2 unchecked_move_backward_path(BidirectionalIter1 first,BidirectionalIter1 last,
+                                                              BidirectionalIter2 result,fastpath::generic_path){
+        while(first != last){
+            *--result = hxqstl::move(*--last);
+        }
+        return result;
+    }
+
+    template<class BidirectionalIter1,class BidirectionalIter2>
+    constexpr BidirectionalIter2 unchecked_move_backward_path(BidirectionalIter1 first,BidirectionalIter1 last,
+                                                              BidirectionalIter2 result,fastpath::memmove_path){
+        const auto n = last - first;
+        const auto p = hxqstl::to_address(first);
+        hxqstl::move_backward(p,p + n,hxqstl::to_address(result));
+        return result - n;
+    }
+
+    template<class BidirectionalIter1,class BidirectionalIter2>
+    constexpr BidirectionalIter2 unchecked_move_backward_path(BidirectionalIter1 first,BidirectionalIter1 last,
+                                                              BidirectionalIter2 result,fastpath::reverse_path){
+        return BidirectionalIter2(hxqstl::move(last.base(),first.base(),result.base()));
+    }
+
+    template<class BidirectionalIter1,class BidirectionalIter2>
+    constexpr BidirectionalIter2 unchecked_move_backward_path(BidirectionalIter1 first,BidirectionalIter1 last,
+                                                              BidirectionalIter2 result,fastpath::segmented_path){
+        typedef segmented_iterator_traits<BidirectionalIter1> traits;
+        const auto sf = traits::segment(first);
+        auto sl = traits::segment(last);
+        if(sf == sl) return hxqstl::move_backward(traits::local(first),traits::local(last),result);
+        result = hxqstl::move_backward(traits::begin(sl),traits::local(last),result);
+        for(--sl;sl != sf;--sl){
+            result = hxqstl::move_backward(traits::begin(sl),traits::end(sl),result);
+        }
+        return hxqstl::move_backward(traits::local(first),traits::end(sf),result);
+    }
+
+    template<class BidirectionalIter1,class BidirectionalIter2>
+    constexpr BidirectionalIter2 unchecked_move_backward(BidirectionalIter1 first,BidirectionalIter1 last,
+                                                         BidirectionalIter2 result){
+        return unchecked_move_backward_path(first,last,result,typename fastpath::select_path<
+            BidirectionalIter1,BidirectionalIter2,std::is_trivially_move_assignable,false>::type{});
+    }
+
+    // 为trivially_move_assignable类型提供特化版本
+    template<class Tp,class Up>
+    constexpr typename std::enable_if<std::is_same<typename std::remove_const<Tp>::type,Up>::value &&
+            std::is_trivially_move_assignable<Up>::value,
+            Up*>::type unchecked_move_backward(Tp* first,Tp* last,Up* result){
+                const size_t n = static_cast<size_t>(last - first);
+                if(hxqstl::is_constant_evaluated()){
+                    while(first != last) *--result = hxqstl::move(*--last);
+                }
+                else if(n != 0){
+                    result -= n;
+                    std::memmove(result,first,n * sizeof(Up));
+                }
+                return result;
+            }
+
+    template<class BidirectionalIter1,class BidirectionalIter2>
+    constexpr BidirectionalIter2 move_backward(BidirectionalIter1 first,BidirectionalIter1 last,
+                                     BidirectionalIter2 result){
+        return unchecked_move_backward(first,last,result);
+    }
+
+    // fill_n
+    // 从first位置开始填充n个值
+    template<class OutputIter,class Size,class T>
+    constexpr OutputIter unchecked_fill_n(OutputIter first,Size n,const T& value){
+        for(;n > 0;--n,++first){
+            *first = value;
+        }
+        return first;
+    }
+
+    // 为one-byte类型提供特化版本
+    template<class Tp,class Size,class Up>
+    constexpr typename std::enable_if<std::is_integral<Tp>::value && sizeof(Tp) == 1 &&
+            !std::is_same<Tp,bool>::value &&
+            std::is_integral<Up>::value && sizeof(Up) == 1,
+            Tp*>::type unchecked_fill_n(Tp* first,Size n,Up value){
+                if(hxqstl::is_constant_evaluated()){
+                    for(Size i = 0;i < n;++i) first[i] = static_cast<Tp>(value);
+                }
+                else if(n > 0){
+                    std::memset(first,(unsigned char)value,(size_t)(n));
+                }
+                return first + n;
+            }
+
+    template<class OutputIter,class Size,class T>
+    constexpr OutputIter fill_n(OutputIter first,Size n,const T& value){
+        return unchecked_fill_n(first,n,value);
+    }
+
+    // fill
+    // 为[first,last)区间内的所有元素填充新值
+    template<class ForwardIter,class T>
+    constexpr void fill_cat(ForwardIter first,ForwardIter last,const T& value,hxqstl::forward_iterator_tag){
+        for(;first != last;++first){
+            *first = value;
+        }
+    }
+
+    template<class RandomIter,class T>
+    constexpr void fill_cat(RandomIter first,RandomIter last,const T& value,hxqstl::random_access_iterator_tag){
+        hxqstl::fill_n(first,last - first,value);
+    }
+
+    // 分段迭代器逐段填充，包装成类的连续迭代器换成指针填充
+    template<class ForwardIter,class T>
+    constexpr void fill_path(ForwardIter first,ForwardIter last,const T& value,fastpath::generic_path){
+        fill_cat(first,last,value,iterator_category(first));
+    }
+
+    template<class ForwardIter,class T>
+    constexpr void fill_path(ForwardIter first,ForwardIter last,const T& value,fastpath::memmove_path){
+        const auto p = hxqstl::to_address(first);
+        fill_cat(p,p + (last - first),value,random_access_iterator_tag());
+    }
+
+    template<class ForwardIter,class T>
+    constexpr void fill_path(ForwardIter first,ForwardIter last,const T& value,fastpath::segmented_path){
+        typedef segmented_iterator_traits<ForwardIter> traits;
+        auto sf = traits::segment(first);
+        const auto sl = traits::segment(last);
+        if(sf == sl){
+            fill_cat(traits::local(first),traits::local(last),value,random_access_iterator_tag());
+            return;
+        }
+        fill_cat(traits::local(first),traits::end(sf),value,random_access_iterator_tag());
+        for(++sf;sf != sl;++sf){
+            fill_cat(traits::begin(sf),traits::end(sf),value,random_access_iterator_tag());
+        }
+        fill_cat(traits::begin(sl),traits::local(last),value,random_access_iterator_tag());
+    }
+
+    template<class ForwardIter,class T>
+    constexpr void fill(ForwardIter first,ForwardIter last,const T& value){
+        fill_path(first,last,value,typename std::conditional<
+            segmented_iterator_traits<ForwardIter>::is_segmented::value,fastpath::segmented_path,
+            typename std::conditional<is_contiguous_iterator<ForwardIter>::value &&
+                                      !std::is_pointer<ForwardIter>::value,
+            fastpath::memmove_path,fastpath::generic_path>::type>::type{});
+    }
+
+    // equal
+    // 比较[first1,last1)与从first2开始的区间是否相等
+    template<class InputIter1,class InputIter2>
+    constexpr bool equal(InputIter1 first1,InputIter1 last1,InputIter2 first2){
+        for(;first1 != last1;++first1,++first2){
+            if(!(*first1 == *first2)) return false;
+        }
+        return true;
+    }
+
+    template<class InputIter1,class InputIter2,class Compare>
+    constexpr bool equal(InputIter1 first1,InputIter1 last1,InputIter2 first2,Compare comp){
+        for(;first1 != last1;++first1,++first2){
+            if(!comp(*first1,*first2)) return false;
+        }
+        return true;
+    }
+
+    // lexicographical_compare
+    // 按字典序比较[first1,last1)与[first2,last2)，前者小于后者时返回true
+    template<class InputIter1,class InputIter2>
+    constexpr bool lexicographical_compare(InputIter1 first1,InputIter1 last1,
+                                           InputIter2 first2,InputIter2 last2){
+        for(;first1 != last1 && first2 != last2;++first1,++first2){
+            if(*first1 < *first2) return true;
+            if(*first2 < *first1) return false;
+        }
+        return first1 == last1 && first2 != last2;
+    }
+
+    template<class InputIter1,class InputIter2,class Compare>
+    constexpr bool lexicographical_compare(InputIter1 first1,InputIter1 last1,
+                                           InputIter2 first2,InputIter2 last2,Compare comp){
+        for(;first1 != last1 && first2 != last2;++first1,++first2){
+            if(comp(*first1,*first2)) return true;
+            if(comp(*first2,*first1)) return false;
+        }
+        return first1 == last1 && first2 != last2;
+    }
+}
@@ -1,8 +1,11 @@
 #pragma once
 #include <new>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 
 namespace hxqstl
 {
@@ -24,7 +27,34 @@ namespace hxqstl
     enum{ESmallObjectBytes = 4096};
     enum{EFreeListsNumber = 56};
 
-    class alloc{
+    enum{EDefaultAlign = alignof(std::max_align_t)};    // ::operator new 和 malloc 保证的对齐
+    enum{EMaxPoolAlign = 64};                           // 内存池能保证的最大对齐
+
+    // 对齐参数，C++14 没有 std::align_val_t
+    enum class align_val_t : size_t {};
+
+    // 超过默认对齐的堆内存：多申请 align 字节，对齐后地址的前一个字保存原始指针
+    inline void* aligned_new(size_t bytes,align_val_t al){
+        const size_t align = static_cast<size_t>(al);
+        if(align <= static_cast<size_t>(EDefaultAlign)) return ::operator new(bytes);
+        void* raw = ::operator new(bytes + align);
+        const uintptr_t addr = (reinterpret_cast<uintptr_t>(raw) + align) & ~static_cast<uintptr_t>(align - 1);
+        reinterpret_cast<void**>(addr)[-1] = raw;
+        return reinterpret_cast<void*>(addr);
+    }
+
+    inline void aligned_delete(void* p,align_val_t al) noexcept{
+        if(p == nullptr) return;
+        if(static_cast<size_t>(al) <= static_cast<size_t>(EDefaultAlign)) ::operator delete(p);
+        else ::operator delete(static_cast<void**>(p)[-1]);
+    }
+
+    // 小块内存池
+    // 每一档的块都按自身大小的自然对齐放置(大小的最低位，最多 64 字节)，
+    // 所以 16/32/64 的倍数大小的块天然按 16/32/64 对齐，带对齐参数的 allocate 只需把大小上调到对齐的倍数
+    // 写成模板是为了让静态成员可以定义在头文件里，供多个翻译单元包含
+    template<int Inst>
+    class basic_alloc{
     private:
         static char* start_free;
         static char* end_free;
@@ -32,24 +62,52 @@ namespace hxqstl
 
         static FreeList* free_list[EFreeListsNumber];
 
+        // 保护上面所有静态成员的自旋锁，临界区只有几条指令
+        static std::atomic_flag lock_;
+        struct lock_guard
+        {
+            lock_guard() noexcept {while(lock_.test_and_set(std::memory_order_acquire)) {}}
+            ~lock_guard() {lock_.clear(std::memory_order_release);}
+        };
+
     public:
         static void* allocate(size_t n);
         static void deallocate(void* p,size_t n);
         static void* reallocate(void* p,size_t old_size,size_t new_size);
+
+        // align 必须是 2 的幂；超过 64 字节或大块内存改用 aligned_new
+        // 释放时必须传入与分配时相同的 n 和 align
+        static void* allocate(size_t n,align_val_t al);
+        static void deallocate(void* p,size_t n,align_val_t al);
+
+        // 一次取出 count 个大小为 n 的块，用 FreeList::next 串成以 nullptr 结尾的链表，只加一次锁
+        // 每一块都可以单独用 deallocate(p,n) 释放，也可以串起来用 deallocate_chain 一次归还
+        static FreeList* allocate_chain(size_t n,size_t count);
+        static void deallocate_chain(FreeList* first,FreeList* last,size_t n);
     private:
         static size_t M_align(size_t bytes);
+        static size_t M_block_align(size_t bytes);
+        static void M_free_range(char* first,char* last);
         static size_t M_round_up(size_t bytes);
         static size_t M_freelist_index(size_t bytes);
         static void* M_refill(size_t n);
         static char* M_chunk_alloc(size_t size,size_t &nobj);
     };
 
+    typedef basic_alloc<0> alloc;
+
     // 静态成员变量初始化
-    char* alloc::start_free = nullptr;
-    char* alloc::end_free = nullptr;
-    size_t alloc::heap_size = 0;
+    template<int Inst>
+    char* basic_alloc<Inst>::start_free = nullptr;
+    template<int Inst>
+    char* basic_alloc<Inst>::end_free = nullptr;
+    template<int Inst>
+    size_t basic_alloc<Inst>::heap_size = 0;
+    template<int Inst>
+    std::atomic_flag basic_alloc<Inst>::lock_ = ATOMIC_FLAG_INIT;
 
-    FreeList* alloc::free_list[EFreeListsNumber] = {
+    template<int Inst>
+    FreeList* basic_alloc<Inst>::free_list[EFreeListsNumber] = {
         nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,
         nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,
         nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,
@@ -59,24 +117,31 @@ namespace hxqstl
         nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr
     };
 
-    inline void* alloc::allocate(size_t n){
-        FreeList* my_free_list;
-        FreeList* result;
-        if(n > static_cast<size_t>(ESmallObjectBytes)) return std::malloc(n);
-        my_free_list = free_list[M_freelist_index(n)];
-        result = my_free_list;
+    template<int Inst>
+    inline void* basic_alloc<Inst>::allocate(size_t n){
+        if(n > static_cast<size_t>(ESmallObjectBytes)){
+            // 与内存池路径一致，分配失败时抛出而不是返回空指针
+            void* p = std::malloc(n);
+            if(p == nullptr) throw std::bad_alloc();
+            return p;
+        }
+        if(n == 0) n = 1;
+        lock_guard guard;
+        // 必须通过二级指针修改 free list 的表头
+        FreeList** my_free_list = free_list + M_freelist_index(n);
+        FreeList* result = *my_free_list;
         if(result == nullptr){
-            void* r = M_refill(M_round_up(n));
-            return r;
+            return M_refill(M_round_up(n));
         }
-        my_free_list = result->next;
+        *my_free_list = result->next;
         return result;
     }
 
-    inline size_t alloc::M_align(size_t bytes){
+    template<int Inst>
+    inline size_t basic_alloc<Inst>::M_align(size_t bytes){
         if(bytes <= 512){
-            return bytes <= 256 ? 
-            bytes <= 128 ? EAlign128 : EAlign256 
+            return bytes <= 256 ?
+            bytes <= 128 ? EAlign128 : EAlign256
             : EAlign512;
         }
         return bytes <= 2048
@@ -85,19 +150,21 @@ namespace hxqstl
     }
 
     // bytes上调 与M_align(bytes)对齐
-    inline size_t alloc::M_round_up(size_t bytes)
+    template<int Inst>
+    inline size_t basic_alloc<Inst>::M_round_up(size_t bytes)
     {
         return ((bytes + M_align(bytes) - 1) & ~(M_align(bytes) - 1));
     }
 
-    // index从1开始算
-    inline size_t alloc::M_freelist_index(size_t bytes){
+    // index从0开始算，每一档的第一个 index 紧接上一档的最后一个
+    template<int Inst>
+    inline size_t basic_alloc<Inst>::M_freelist_index(size_t bytes){
         if(bytes <= 512){
             return bytes <= 256 ?
                 bytes <= 128 ?
                 ((bytes + EAlign128 - 1) / EAlign128 - 1) :
                 (15 + (bytes + EAlign256 - 129) / EAlign256)
-                : (23 + (bytes + EAlign4096 - 2049) / EAlign4096);
+                : (23 + (bytes + EAlign512 - 257) / EAlign512);
         }
         return bytes <= 2048 ?
             bytes <= 1024 ?
@@ -106,63 +173,201 @@ namespace hxqstl
             (47 + (bytes + EAlign4096 - 2049) / EAlign4096);
     }
 
-    inline void alloc::deallocate(void *p,size_t n){
+    template<int Inst>
+    inline void basic_alloc<Inst>::deallocate(void *p,size_t n){
+        if(p == nullptr) return;
         if(n > static_cast<size_t>(ESmallObjectBytes)){
             std::free(p);
             return;
         }
+        if(n == 0) n = 1;
         FreeList* q = reinterpret_cast<FreeList*>(p);
-        FreeList* my_free_list;
-        my_free_list = free_list[M_freelist_index(n)];
-        q->next = my_free_list;
-        my_free_list = q;
+        lock_guard guard;
+        FreeList** my_free_list = free_list + M_freelist_index(n);
+        q->next = *my_free_list;
+        *my_free_list = q;
+    }
+
+    template<int Inst>
+    inline void* basic_alloc<Inst>::allocate(size_t n,align_val_t al){
+        const size_t align = static_cast<size_t>(al);
+        if(align <= static_cast<size_t>(EAlign128)) return allocate(n);
+        if(align > static_cast<size_t>(EMaxPoolAlign) || n > static_cast<size_t>(ESmallObjectBytes)){
+            return aligned_new(n,al);
+        }
+        if(n == 0) n = 1;
+        return allocate((n + align - 1) & ~(align - 1));
     }
 
-    inline void* alloc::reallocate(void* p,size_t old_size,size_t new_size){
-        deallocate(p,old_size);
-        p = allocate(new_size);
-        return p;
+    template<int Inst>
+    inline void basic_alloc<Inst>::deallocate(void* p,size_t n,align_val_t al){
+        const size_t align = static_cast<size_t>(al);
+        if(align <= static_cast<size_t>(EAlign128)) return deallocate(p,n);
+        if(align > static_cast<size_t>(EMaxPoolAlign) || n > static_cast<size_t>(ESmallObjectBytes)){
+            aligned_delete(p,al);
+            return;
+        }
+        if(n == 0) n = 1;
+        deallocate(p,(n + align - 1) & ~(align - 1));
+    }
+
+    template<int Inst>
+    inline void* basic_alloc<Inst>::reallocate(void* p,size_t old_size,size_t new_size){
+        void* result = allocate(new_size);
+        if(p != nullptr){
+            std::memcpy(result,p,old_size < new_size ? old_size : new_size);
+            deallocate(p,old_size);
+        }
+        return result;
+    }
+
+    // 先取 free list 上现成的块，不够时直接从内存池切出连续的块，不再挂到 free list 上
+    template<int Inst>
+    FreeList* basic_alloc<Inst>::allocate_chain(size_t n,size_t count){
+        FreeList* head = nullptr;
+        FreeList** tail = &head;
+        if(n > static_cast<size_t>(ESmallObjectBytes)){
+            for(;count > 0;--count){
+                FreeList* p = static_cast<FreeList*>(std::malloc(n));
+                if(p == nullptr){
+                    *tail = nullptr;
+                    while(head != nullptr){
+                        FreeList* next = head->next;
+                        std::free(head);
+                        head = next;
+                    }
+                    throw std::bad_alloc();
+                }
+                *tail = p;
+                tail = &p->next;
+            }
+            *tail = nullptr;
+            return head;
+        }
+        if(n == 0) n = 1;
+        const size_t size = M_round_up(n);
+        lock_guard guard;
+        FreeList** my_free_list = free_list + M_freelist_index(n);
+        while(count > 0 && *my_free_list != nullptr){
+            FreeList* p = *my_free_list;
+            *my_free_list = p->next;
+            *tail = p;
+            tail = &p->next;
+            --count;
+        }
+        while(count > 0){
+            size_t nblock = count;
+            char* c;
+            try{
+                c = M_chunk_alloc(size,nblock);
+            }
+            catch(...){
+                // 已取到的块还给 free list
+                *tail = *my_free_list;
+                *my_free_list = head;
+                throw;
+            }
+            for(size_t i = 0;i < nblock;++i){
+                FreeList* p = reinterpret_cast<FreeList*>(c + i * size);
+                *tail = p;
+                tail = &p->next;
+            }
+            count -= nblock;
+        }
+        *tail = nullptr;
+        return head;
+    }
+
+    // [first,last] 是用 next 串起来的链表，last->next 会被改写
+    template<int Inst>
+    void basic_alloc<Inst>::deallocate_chain(FreeList* first,FreeList* last,size_t n){
+        if(first == nullptr) return;
+        if(n > static_cast<size_t>(ESmallObjectBytes)){
+            last->next = nullptr;
+            while(first != nullptr){
+                FreeList* next = first->next;
+                std::free(first);
+                first = next;
+            }
+            return;
+        }
+        if(n == 0) n = 1;
+        lock_guard guard;
+        FreeList** my_free_list = free_list + M_freelist_index(n);
+        last->next = *my_free_list;
+        *my_free_list = first;
+    }
+
+    // 块大小的自然对齐：大小的最低位，最多 64 字节
+    template<int Inst>
+    inline size_t basic_alloc<Inst>::M_block_align(size_t bytes){
+        const size_t low = bytes & (~bytes + 1);
+        return low < static_cast<size_t>(EMaxPoolAlign) ? low : static_cast<size_t>(EMaxPoolAlign);
+    }
+
+    // 把 [first,last) 切成若干块挂到 free list 上，每一块都满足自身大小的自然对齐
+    // 地址未按 64 对齐时先切出与地址对齐相同大小的块，地址的对齐会逐步变大
+    // 调用者已持有锁
+    template<int Inst>
+    void basic_alloc<Inst>::M_free_range(char* first,char* last){
+        while(static_cast<size_t>(last - first) >= static_cast<size_t>(EAlign128)){
+            const size_t rest = static_cast<size_t>(last - first);
+            const size_t addr_align = M_block_align(reinterpret_cast<uintptr_t>(first));
+            size_t bytes;
+            if(addr_align == static_cast<size_t>(EMaxPoolAlign)){
+                bytes = rest < static_cast<size_t>(ESmallObjectBytes) ? rest : static_cast<size_t>(ESmallObjectBytes);
+                bytes &= ~(M_align(bytes) - 1);
+            }
+            else{
+                bytes = rest < addr_align ? rest : addr_align;
+            }
+            FreeList** my_free_list = free_list + M_freelist_index(bytes);
+            reinterpret_cast<FreeList*>(first)->next = *my_free_list;
+            *my_free_list = reinterpret_cast<FreeList*>(first);
+            first += bytes;
+        }
     }
 
     // 从内存池中取空间给free list，条件不允许时，调整nblock
-    char* alloc::M_chunk_alloc(size_t size,size_t& nblock){
+    // 区块的起点先上调到 size 的自然对齐，跳过的零头挂回 free list
+    // 调用者已持有锁
+    template<int Inst>
+    char* basic_alloc<Inst>::M_chunk_alloc(size_t size,size_t& nblock){
         char* result;
         size_t need_bytes = size * nblock;
-        size_t pool_bytes = end_free - start_free;
-
-        if(pool_bytes >= need_bytes){
-            result = start_free;
-            start_free += need_bytes;
-            return result;
-        }
+        const size_t align = M_block_align(size);
+        char* aligned = reinterpret_cast<char*>(
+            (reinterpret_cast<uintptr_t>(start_free) + align - 1) & ~static_cast<uintptr_t>(align - 1));
+        size_t pool_bytes = aligned <= end_free ? static_cast<size_t>(end_free - aligned) : 0;
 
         // 如果内存池剩余大小不能完全满足需求，但至少可以分配一个或一个以上的区块，就返回这些区块
-        else if(pool_bytes >= size){
-            nblock = pool_bytes / size;
-            need_bytes = size * nblock;
-            result = start_free;
-            start_free += need_bytes;
+        if(pool_bytes >= size){
+            if(pool_bytes < need_bytes){
+                nblock = pool_bytes / size;
+                need_bytes = size * nblock;
+            }
+            M_free_range(start_free,aligned);
+            result = aligned;
+            start_free = aligned + need_bytes;
             return result;
         }
 
         else{
-            if(pool_bytes > 0){
-                FreeList* my_free_list = free_list[M_freelist_index(pool_bytes)];
-                ((FreeList*)start_free)->next = my_free_list;
-                my_free_list = (FreeList*)start_free;
-            }
-            
+            // 把剩余的零头切成对齐的小块挂到 free list 上
+            M_free_range(start_free,end_free);
+
             // 申请堆空间
             size_t bytes_to_get = (need_bytes << 1) + M_round_up(heap_size >> 4);
             start_free = (char*)std::malloc(bytes_to_get);
             if(!start_free){
-                FreeList* my_free_list,*p;
+                FreeList** my_free_list,*p;
                 for(size_t i = size;i <= ESmallObjectBytes;i += M_align(i))
                 {
-                    my_free_list = free_list[M_freelist_index(i)];
-                    p = my_free_list;
-                    if(p){
-                        my_free_list = p->next;
+                    my_free_list = free_list + M_freelist_index(i);
+                    p = *my_free_list;
+                    // 只取起始地址满足 size 对齐要求的块
+                    if(p && (reinterpret_cast<uintptr_t>(p) & (align - 1)) == 0){
+                        *my_free_list = p->next;
                         start_free = (char*)p;
                         end_free = start_free + i;
                         return M_chunk_alloc(size,nblock);
@@ -177,17 +382,19 @@ namespace hxqstl
         }
     }
 
-    void* alloc::M_refill(size_t n){
+    // 调用者已持有锁
+    template<int Inst>
+    void* basic_alloc<Inst>::M_refill(size_t n){
         size_t nblock = 10;
         char* c = M_chunk_alloc(n,nblock);
-        FreeList* my_free_list;
+        FreeList** my_free_list;
         FreeList* result,* cur,* next;
         if (nblock == 1){
             return c;
         }
-        my_free_list = free_list[M_freelist_index(n)];
+        my_free_list = free_list + M_freelist_index(n);
         result = (FreeList*)c;
-        my_free_list = next = (FreeList*)(c + n);
+        *my_free_list = next = (FreeList*)(c + n);
         for(size_t i = 1;;++i){
             cur = next;
             next = (FreeList*)((char*)next + n);
@@ -199,6 +406,6 @@ namespace hxqstl
                 cur->next = next;
             }
         }
-        return result; 
+        return result;
     }
-}
\ No newline at end of file
+}
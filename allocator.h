@@ -1,7 +1,20 @@
+#pragma once
+
+#include "alloc.h"
 #include "construct.h"
 #include "util.h"
 
+#ifdef MYSTL_HEAP_PROFILE
+#include "heap_profiler.h"
+#define MYSTL_PROFILE_ALLOC(T,p,n) hxqstl::heap_profiler::on_allocate<T>((p),(n))
+#define MYSTL_PROFILE_DEALLOC(T,p,n) hxqstl::heap_profiler::on_deallocate<T>((p),(n))
+#else
+#define MYSTL_PROFILE_ALLOC(T,p,n) ((void)(p),(void)(n))
+#define MYSTL_PROFILE_DEALLOC(T,p,n) ((void)(p),(void)(n))
+#endif
+
 namespace hxqstl{
+    // alignof(T) 超过 ::operator new 的默认对齐时改用 aligned_new
     template<class T>
     class allocator
     {
@@ -21,6 +34,10 @@ namespace hxqstl{
         static void deallocate(T* ptr);
         static void deallocate(T* ptr,size_type n);
 
+        // 指定对齐，al 不小于 alignof(T)；释放时传入相同的 al
+        static T* allocate(size_type n,align_val_t al);
+        static void deallocate(T* ptr,size_type n,align_val_t al);
+
         static void construct(T* ptr);
         static void construct(T* ptr,const T& value);
         static void construct(T* ptr,T&& value);
@@ -34,27 +51,39 @@ namespace hxqstl{
 
     template<class T>
     T* allocator<T>::allocate(){
-        return static_cast<T*>(::operator new(sizeof(T)));
+        return allocate(1);
     }
 
     template<class T>
     T* allocator<T>::allocate(size_type n){
-        if(n == 0){
-            return nullptr;
-        }
-        return static_cast<T*>(::operator new(n * sizeof(T)));
+        return allocate(n,align_val_t(alignof(T)));
     }
 
     template<class T>
     void allocator<T>::deallocate(T* ptr){
-        if(ptr == nullptr) return;
-        ::operator delete(ptr);
+        deallocate(ptr,1);
+    }
+
+    template<class T>
+    void allocator<T>::deallocate(T* ptr,size_type n){
+        deallocate(ptr,n,align_val_t(alignof(T)));
     }
 
     template<class T>
-    void allocator<T>::deallocate(T* ptr,size_type){
+    T* allocator<T>::allocate(size_type n,align_val_t al){
+        if(n == 0){
+            return nullptr;
+        }
+        T* p = static_cast<T*>(hxqstl::aligned_new(n * sizeof(T),al));
+        MYSTL_PROFILE_ALLOC(T,p,n);
+        return p;
+    }
+
+    template<class T>
+    void allocator<T>::deallocate(T* ptr,size_type n,align_val_t al){
         if(ptr == nullptr) return;
-        ::operator delete(ptr);
+        MYSTL_PROFILE_DEALLOC(T,ptr,n);
+        hxqstl::aligned_delete(ptr,al);
     }
 
     template<class T>
@@ -86,6 +115,73 @@ namespace hxqstl{
 
     template<class T>
     void allocator<T>::destroy(T* first,T* last){
-        hxqstl::destory(first,last);
+        hxqstl::destroy(first,last);
     }
-}
\ No newline at end of file
+
+    // 按 Align 对齐分配，并把字节数上调到 Align 的倍数
+    // Align 取缓存行大小时，数组的首尾都不会和其他对象共享缓存行
+    template<class T,size_t Align>
+    class aligned_allocator : public allocator<T>
+    {
+        static_assert((Align & (Align - 1)) == 0,"aligned_allocator alignment must be a power of two");
+        static_assert(Align >= alignof(T),"aligned_allocator alignment must not be less than alignof(T)");
+    public:
+        typedef typename allocator<T>::size_type size_type;
+
+        static constexpr size_t alignment = Align;
+
+    public:
+        static T* allocate() {return allocate(1);}
+        static T* allocate(size_type n)
+        {
+            if(n == 0) return nullptr;
+            T* p = static_cast<T*>(hxqstl::aligned_new(round_bytes(n),align_val_t(Align)));
+            MYSTL_PROFILE_ALLOC(T,p,n);
+            return p;
+        }
+
+        static void deallocate(T* ptr) {deallocate(ptr,1);}
+        static void deallocate(T* ptr,size_type n)
+        {
+            if(ptr == nullptr) return;
+            MYSTL_PROFILE_DEALLOC(T,ptr,n);
+            hxqstl::aligned_delete(ptr,align_val_t(Align));
+        }
+
+    private:
+        static size_t round_bytes(size_type n) noexcept
+        {
+            return (n * sizeof(T) + Align - 1) & ~(Align - 1);
+        }
+    };
+
+    template<class T,size_t Align>
+    constexpr size_t aligned_allocator<T,Align>::alignment;
+
+    // 从 alloc 内存池分配：不超过 ESmallObjectBytes 的请求取自空闲链表，更大的交给 malloc
+    // 短字符串的堆缓冲区、链表节点这类频繁申请释放的小块内存可以用它代替 allocator<T>
+    template<class T>
+    class pool_allocator : public allocator<T>
+    {
+    public:
+        typedef typename allocator<T>::size_type size_type;
+
+    public:
+        static T* allocate() {return allocate(1);}
+        static T* allocate(size_type n)
+        {
+            if(n == 0) return nullptr;
+            T* p = static_cast<T*>(alloc::allocate(n * sizeof(T),align_val_t(alignof(T))));
+            MYSTL_PROFILE_ALLOC(T,p,n);
+            return p;
+        }
+
+        static void deallocate(T* ptr) {deallocate(ptr,1);}
+        static void deallocate(T* ptr,size_type n)
+        {
+            if(ptr == nullptr) return;
+            MYSTL_PROFILE_DEALLOC(T,ptr,n);
+            alloc::deallocate(ptr,n * sizeof(T),align_val_t(alignof(T)));
+        }
+    };
+}
@@ -0,0 +1,752 @@
+#pragma once
+
+// basic_string
+// 带短字符串优化(SSO)的字符串，对象大小为三个指针(64 位下 24 字节)
+// 短模式：字符直接存放在对象内部，char 最多 22 个字符加结尾的 '\0'，不申请堆内存
+// 长模式：存放堆缓冲区的容量、长度和指针，缓冲区由 Alloc 分配，扩容策略与 vector 相同(grow_capacity)
+// 两种模式用首字节的最低位区分：短模式首字节存 size << 1，长模式的容量字段带上 long_flag，
+// 缓冲区的字符数总是偶数(大端机器上不超过 2^56)，所以这一位不会和容量本身冲突
+// 查找和比较都转给 basic_string_view，char 走 SSE2 加速的版本
+// 可以隐式转换成 string_view，参数写成 string_view 的函数同时接受 string 和字面量，不会复制
+
+#include <initializer_list>
+
+#include "allocator.h"
+#include "iterator.h"
+#include "string_view.h"
+#include "util.h"
+#include "vector.h"
+#include "exceptdef.h"
+
+namespace hxqstl{
+    template<class CharT,class Traits = char_traits<CharT>,class Alloc = hxqstl::allocator<CharT>>
+    class basic_string{
+        static_assert(std::is_trivial<CharT>::value,"basic_string requires a trivial character type");
+        public:
+            typedef Traits traits_type;
+            typedef Alloc allocator_type;
+            typedef Alloc data_allocator;
+
+            typedef CharT value_type;
+            typedef CharT* pointer;
+            typedef const CharT* const_pointer;
+            typedef CharT& reference;
+            typedef const CharT& const_reference;
+            typedef size_t size_type;
+            typedef ptrdiff_t difference_type;
+
+            typedef CharT* iterator;
+            typedef const CharT* const_iterator;
+            typedef hxqstl::reverse_iterator<iterator> reverse_iterator;
+            typedef hxqstl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+            typedef basic_string_view<CharT,Traits> view_type;
+
+            static constexpr size_type npos = static_cast<size_type>(-1);
+
+        private:
+            // cap 是缓冲区的字符数(包括 '\0')，带 long_flag
+            struct long_rep
+            {
+                size_type cap;
+                size_type size;
+                CharT* data;
+            };
+
+            enum{kShortSlots = (sizeof(long_rep) - alignof(CharT)) / sizeof(CharT)};
+
+            struct short_rep
+            {
+                unsigned char size;
+                CharT data[kShortSlots];
+            };
+
+            union rep
+            {
+                long_rep l;
+                short_rep s;
+            };
+
+            static_assert(sizeof(short_rep) == sizeof(long_rep),"basic_string short layout mismatch");
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            static constexpr size_type long_flag = size_type(1) << (sizeof(size_type) * 8 - 8);
+#else
+            static constexpr size_type long_flag = 1;
+#endif
+
+            rep r_;
+
+        public:
+            // 对象内部能存放的最多字符数
+            static constexpr size_type short_capacity = kShortSlots - 1;
+
+        public:
+            basic_string() noexcept {init_short();}
+
+            basic_string(const CharT* s) {init(s,traits_type::length(s));}
+            basic_string(const CharT* s,size_type n) {init(s,n);}
+
+            basic_string(size_type n,CharT ch)
+            {
+                traits_type::assign(init_storage(n),n,ch);
+            }
+
+            basic_string(const basic_string& rhs,size_type pos,size_type count = npos)
+            {
+                THROW_OUT_OF_RANGE_IF(pos > rhs.size(),"basic_string<CharT>: pos out of range");
+                init(rhs.data() + pos,hxqstl::min(count,rhs.size() - pos));
+            }
+
+            template<class Iter,typename std::enable_if<
+                hxqstl::is_input_iterator<Iter>::value,int>::type = 0>
+            basic_string(Iter first,Iter last)
+            {
+                range_init(first,last,iterator_category(first));
+            }
+
+            basic_string(std::initializer_list<CharT> ilist) {init(ilist.begin(),ilist.size());}
+
+            explicit basic_string(view_type v) {init(v.data(),v.size());}
+
+            basic_string(const basic_string& rhs)
+            {
+                if(rhs.is_long()) init(rhs.data(),rhs.size());
+                else r_ = rhs.r_;
+            }
+
+            basic_string(basic_string&& rhs) noexcept
+            {
+                r_ = rhs.r_;
+                rhs.init_short();
+            }
+
+            basic_string& operator=(const basic_string& rhs)
+            {
+                if(this != &rhs) assign(rhs.data(),rhs.size());
+                return *this;
+            }
+            basic_string& operator=(basic_string&& rhs) noexcept
+            {
+                if(this != &rhs){
+                    release();
+                    r_ = rhs.r_;
+                    rhs.init_short();
+                }
+                return *this;
+            }
+            basic_string& operator=(const CharT* s) {return assign(s,traits_type::length(s));}
+            basic_string& operator=(CharT ch) {return assign(size_type(1),ch);}
+            basic_string& operator=(std::initializer_list<CharT> ilist) {return assign(ilist.begin(),ilist.size());}
+            basic_string& operator=(view_type v) {return assign(v.data(),v.size());}
+
+            ~basic_string() {release();}
+
+        public:
+            iterator begin() noexcept {return ptr();}
+            const_iterator begin() const noexcept {return ptr();}
+            iterator end() noexcept {return ptr() + size();}
+            const_iterator end() const noexcept {return ptr() + size();}
+
+            reverse_iterator rbegin() noexcept {return reverse_iterator(end());}
+            const_reverse_iterator rbegin() const noexcept {return const_reverse_iterator(end());}
+            reverse_iterator rend() noexcept {return reverse_iterator(begin());}
+            const_reverse_iterator rend() const noexcept {return const_reverse_iterator(begin());}
+
+            const_iterator cbegin() const noexcept {return begin();}
+            const_iterator cend() const noexcept {return end();}
+
+            bool empty() const noexcept {return size() == 0;}
+            size_type size() const noexcept {return is_long() ? r_.l.size : (r_.s.size >> 1);}
+            size_type length() const noexcept {return size();}
+            size_type capacity() const noexcept {return is_long() ? slots() - 1 : size_type(short_capacity);}
+            // 缓冲区的字符数要留出最高字节给 long_flag
+            size_type max_size() const noexcept {return (static_cast<size_type>(-1) >> 8) / sizeof(CharT) - 1;}
+
+            void reserve(size_type n);
+            void shrink_to_fit();
+
+            reference operator[](size_type n)
+            {
+                MYSTL_DEBUG(n <= size());
+                return ptr()[n];
+            }
+            const_reference operator[](size_type n) const
+            {
+                MYSTL_DEBUG(n <= size());
+                return ptr()[n];
+            }
+            reference at(size_type n)
+            {
+                THROW_OUT_OF_RANGE_IF(n >= size(),"basic_string<CharT>::at() subscript out of range");
+                return ptr()[n];
+            }
+            const_reference at(size_type n) const
+            {
+                THROW_OUT_OF_RANGE_IF(n >= size(),"basic_string<CharT>::at() subscript out of range");
+                return ptr()[n];
+            }
+
+            reference front() {MYSTL_DEBUG(!empty()); return ptr()[0];}
+            const_reference front() const {MYSTL_DEBUG(!empty()); return ptr()[0];}
+            reference back() {MYSTL_DEBUG(!empty()); return ptr()[size() - 1];}
+            const_reference back() const {MYSTL_DEBUG(!empty()); return ptr()[size() - 1];}
+
+            CharT* data() noexcept {return ptr();}
+            const CharT* data() const noexcept {return ptr();}
+            const CharT* c_str() const noexcept {return ptr();}
+
+            operator view_type() const noexcept {return view_type(ptr(),size());}
+            view_type view() const noexcept {return view_type(ptr(),size());}
+
+            allocator_type get_allocator() const {return allocator_type();}
+
+        public:
+            basic_string& assign(const basic_string& rhs) {return *this = rhs;}
+            basic_string& assign(basic_string&& rhs) noexcept {return *this = hxqstl::move(rhs);}
+            basic_string& assign(const basic_string& rhs,size_type pos,size_type count = npos)
+            { return assign(view_type(rhs).substr(pos,count)); }
+            basic_string& assign(const CharT* s,size_type n);
+            basic_string& assign(const CharT* s) {return assign(s,traits_type::length(s));}
+            basic_string& assign(size_type n,CharT ch);
+            template<class Iter,typename std::enable_if<
+                hxqstl::is_input_iterator<Iter>::value,int>::type = 0>
+            basic_string& assign(Iter first,Iter last)
+            {
+                basic_string tmp(first,last);
+                swap(tmp);
+                return *this;
+            }
+            basic_string& assign(std::initializer_list<CharT> ilist) {return assign(ilist.begin(),ilist.size());}
+            basic_string& assign(view_type v) {return assign(v.data(),v.size());}
+
+            void clear() noexcept {set_size(0);}
+
+            void push_back(CharT ch)
+            {
+                const size_type sz = size();
+                if(sz < capacity()){
+                    ptr()[sz] = ch;
+                    set_size(sz + 1);
+                }
+                else{
+                    replace_aux(sz,0,&ch,1);
+                }
+            }
+
+            void pop_back()
+            {
+                MYSTL_DEBUG(!empty());
+                set_size(size() - 1);
+            }
+
+            basic_string& append(const basic_string& rhs) {return append(rhs.data(),rhs.size());}
+            basic_string& append(const basic_string& rhs,size_type pos,size_type count = npos)
+            { return append(view_type(rhs).substr(pos,count)); }
+            basic_string& append(const CharT* s,size_type n);
+            basic_string& append(const CharT* s) {return append(s,traits_type::length(s));}
+            basic_string& append(size_type n,CharT ch)
+            {
+                traits_type::assign(replace_aux(size(),0,nullptr,n),n,ch);
+                return *this;
+            }
+            template<class Iter,typename std::enable_if<
+                hxqstl::is_input_iterator<Iter>::value,int>::type = 0>
+            basic_string& append(Iter first,Iter last)
+            {
+                append_range(first,last,iterator_category(first));
+                return *this;
+            }
+            basic_string& append(std::initializer_list<CharT> ilist) {return append(ilist.begin(),ilist.size());}
+            basic_string& append(view_type v) {return append(v.data(),v.size());}
+
+            basic_string& operator+=(const basic_string& rhs) {return append(rhs.data(),rhs.size());}
+            basic_string& operator+=(const CharT* s) {return append(s);}
+            basic_string& operator+=(CharT ch) {push_back(ch); return *this;}
+            basic_string& operator+=(std::initializer_list<CharT> ilist) {return append(ilist);}
+            basic_string& operator+=(view_type v) {return append(v);}
+
+            basic_string& insert(size_type pos,const basic_string& rhs) {return replace(pos,0,rhs.data(),rhs.size());}
+            basic_string& insert(size_type pos,const CharT* s,size_type n) {return replace(pos,0,s,n);}
+            basic_string& insert(size_type pos,const CharT* s) {return replace(pos,0,s,traits_type::length(s));}
+            basic_string& insert(size_type pos,size_type n,CharT ch) {return replace(pos,0,n,ch);}
+            basic_string& insert(size_type pos,view_type v) {return replace(pos,0,v.data(),v.size());}
+            iterator insert(const_iterator pos,CharT ch)
+            {
+                const size_type i = static_cast<size_type>(pos - cbegin());
+                replace(i,0,size_type(1),ch);
+                return begin() + i;
+            }
+            iterator insert(const_iterator pos,size_type n,CharT ch)
+            {
+                const size_type i = static_cast<size_type>(pos - cbegin());
+                replace(i,0,n,ch);
+                return begin() + i;
+            }
+            template<class Iter,typename std::enable_if<
+                hxqstl::is_input_iterator<Iter>::value,int>::type = 0>
+            iterator insert(const_iterator pos,Iter first,Iter last)
+            {
+                const size_type i = static_cast<size_type>(pos - cbegin());
+                const basic_string tmp(first,last);
+                replace(i,0,tmp.data(),tmp.size());
+                return begin() + i;
+            }
+
+            basic_string& erase(size_type pos = 0,size_type n = npos)
+            {
+                THROW_OUT_OF_RANGE_IF(pos > size(),"basic_string<CharT>::erase() pos out of range");
+                replace_aux(pos,hxqstl::min(n,size() - pos),nullptr,0);
+                return *this;
+            }
+            iterator erase(const_iterator pos)
+            {
+                MYSTL_DEBUG(pos >= cbegin() && pos < cend());
+                return erase(pos,pos + 1);
+            }
+            iterator erase(const_iterator first,const_iterator last)
+            {
+                const size_type i = static_cast<size_type>(first - cbegin());
+                replace_aux(i,static_cast<size_type>(last - first),nullptr,0);
+                return begin() + i;
+            }
+
+            basic_string& replace(size_type pos,size_type n,const basic_string& rhs)
+            { return replace(pos,n,rhs.data(),rhs.size()); }
+            basic_string& replace(size_type pos,size_type n,const CharT* s,size_type n2)
+            {
+                THROW_OUT_OF_RANGE_IF(pos > size(),"basic_string<CharT>::replace() pos out of range");
+                replace_aux(pos,hxqstl::min(n,size() - pos),s,n2);
+                return *this;
+            }
+            basic_string& replace(size_type pos,size_type n,const CharT* s)
+            { return replace(pos,n,s,traits_type::length(s)); }
+            basic_string& replace(size_type pos,size_type n,size_type n2,CharT ch)
+            {
+                THROW_OUT_OF_RANGE_IF(pos > size(),"basic_string<CharT>::replace() pos out of range");
+                traits_type::assign(replace_aux(pos,hxqstl::min(n,size() - pos),nullptr,n2),n2,ch);
+                return *this;
+            }
+            basic_string& replace(size_type pos,size_type n,view_type v)
+            { return replace(pos,n,v.data(),v.size()); }
+            basic_string& replace(const_iterator first,const_iterator last,view_type v)
+            {
+                replace_aux(static_cast<size_type>(first - cbegin()),static_cast<size_type>(last - first),
+                            v.data(),v.size());
+                return *this;
+            }
+
+            void resize(size_type n) {resize(n,CharT());}
+            void resize(size_type n,CharT ch)
+            {
+                const size_type sz = size();
+                if(n <= sz) set_size(n);
+                else append(n - sz,ch);
+            }
+
+            void swap(basic_string& rhs) noexcept
+            {
+                const rep tmp = r_;
+                r_ = rhs.r_;
+                rhs.r_ = tmp;
+            }
+
+            basic_string substr(size_type pos = 0,size_type count = npos) const
+            { return basic_string(view().substr(pos,count)); }
+
+            size_type copy(CharT* dst,size_type count,size_type pos = 0) const
+            { return view().copy(dst,count,pos); }
+
+            // 比较和查找都转给 view_type
+            int compare(view_type v) const noexcept {return view().compare(v);}
+            int compare(size_type pos1,size_type n1,view_type v) const
+            { return view().compare(pos1,n1,v); }
+            int compare(size_type pos1,size_type n1,view_type v,size_type pos2,size_type n2) const
+            { return view().compare(pos1,n1,v,pos2,n2); }
+
+            bool starts_with(view_type v) const noexcept {return view().starts_with(v);}
+            bool starts_with(CharT ch) const noexcept {return view().starts_with(ch);}
+            bool ends_with(view_type v) const noexcept {return view().ends_with(v);}
+            bool ends_with(CharT ch) const noexcept {return view().ends_with(ch);}
+
+            size_type find(view_type v,size_type pos = 0) const noexcept {return view().find(v,pos);}
+            size_type find(CharT ch,size_type pos = 0) const noexcept {return view().find(ch,pos);}
+            size_type find(const CharT* s,size_type pos,size_type n) const noexcept {return view().find(s,pos,n);}
+
+            size_type rfind(view_type v,size_type pos = npos) const noexcept {return view().rfind(v,pos);}
+            size_type rfind(CharT ch,size_type pos = npos) const noexcept {return view().rfind(ch,pos);}
+            size_type rfind(const CharT* s,size_type pos,size_type n) const noexcept {return view().rfind(s,pos,n);}
+
+            size_type find_first_of(view_type v,size_type pos = 0) const noexcept
+            { return view().find_first_of(v,pos); }
+            size_type find_first_of(CharT ch,size_type pos = 0) const noexcept
+            { return view().find_first_of(ch,pos); }
+            size_type find_first_of(const CharT* s,size_type pos,size_type n) const noexcept
+            { return view().find_first_of(s,pos,n); }
+
+            size_type find_first_not_of(view_type v,size_type pos = 0) const noexcept
+            { return view().find_first_not_of(v,pos); }
+            size_type find_first_not_of(CharT ch,size_type pos = 0) const noexcept
+            { return view().find_first_not_of(ch,pos); }
+            size_type find_first_not_of(const CharT* s,size_type pos,size_type n) const noexcept
+            { return view().find_first_not_of(s,pos,n); }
+
+            size_type find_last_of(view_type v,size_type pos = npos) const noexcept
+            { return view().find_last_of(v,pos); }
+            size_type find_last_of(CharT ch,size_type pos = npos) const noexcept
+            { return view().find_last_of(ch,pos); }
+            size_type find_last_of(const CharT* s,size_type pos,size_type n) const noexcept
+            { return view().find_last_of(s,pos,n); }
+
+            size_type find_last_not_of(view_type v,size_type pos = npos) const noexcept
+            { return view().find_last_not_of(v,pos); }
+            size_type find_last_not_of(CharT ch,size_type pos = npos) const noexcept
+            { return view().find_last_not_of(ch,pos); }
+            size_type find_last_not_of(const CharT* s,size_type pos,size_type n) const noexcept
+            { return view().find_last_not_of(s,pos,n); }
+
+        private:
+            bool is_long() const noexcept
+            { return (*reinterpret_cast<const unsigned char*>(&r_) & 1) != 0; }
+
+            CharT* ptr() noexcept {return is_long() ? r_.l.data : r_.s.data;}
+            const CharT* ptr() const noexcept {return is_long() ? r_.l.data : r_.s.data;}
+
+            // 长模式下缓冲区的字符数
+            size_type slots() const noexcept {return r_.l.cap & ~long_flag;}
+
+            // cap 个字符加 '\0'，向上取偶数
+            static size_type slots_for(size_type cap) noexcept {return (cap + 2) & ~size_type(1);}
+
+            void set_size(size_type n) noexcept
+            {
+                if(is_long()){
+                    r_.l.size = n;
+                    r_.l.data[n] = CharT();
+                }
+                else{
+                    r_.s.size = static_cast<unsigned char>(n << 1);
+                    r_.s.data[n] = CharT();
+                }
+            }
+
+            void init_short() noexcept
+            {
+                r_.s.size = 0;
+                r_.s.data[0] = CharT();
+            }
+
+            void set_long(CharT* p,size_type nslots,size_type n) noexcept
+            {
+                r_.l.cap = nslots | long_flag;
+                r_.l.size = n;
+                r_.l.data = p;
+                p[n] = CharT();
+            }
+
+            void release() noexcept
+            {
+                if(is_long()) data_allocator::deallocate(r_.l.data,slots());
+            }
+
+            // 准备好 n 个字符的存储并设置长度，返回首字符的位置
+            CharT* init_storage(size_type n);
+
+            void init(const CharT* s,size_type n) {traits_type::copy(init_storage(n),s,n);}
+
+            template<class Iter>
+            void range_init(Iter first,Iter last,input_iterator_tag);
+            template<class Iter>
+            void range_init(Iter first,Iter last,forward_iterator_tag);
+
+            template<class Iter>
+            void append_range(Iter first,Iter last,input_iterator_tag)
+            {
+                for(;first != last;++first) push_back(*first);
+            }
+            template<class Iter>
+            void append_range(Iter first,Iter last,forward_iterator_tag)
+            {
+                const size_type n = static_cast<size_type>(hxqstl::distance(first,last));
+                const size_type sz = size();
+                CharT* p = replace_aux(sz,0,nullptr,n);
+                try{
+                    for(;first != last;++first,++p) *p = *first;
+                }
+                catch(...){
+                    set_size(sz);
+                    throw;
+                }
+            }
+
+            // 按 vector 的策略计算容纳 new_size 个字符的新容量
+            size_type grow_to(size_type new_size) const noexcept
+            { return hxqstl::grow_capacity(capacity(),new_size - capacity(),max_size()); }
+
+            // 把 [pos,pos+n1) 换成 n2 个字符，src 为 nullptr 时只留出空位；返回空位的起始位置
+            CharT* replace_aux(size_type pos,size_type n1,const CharT* src,size_type n2);
+
+            // 重新分配到正好容纳 cap 个字符
+            void reallocate(size_type cap);
+    };
+
+    /*****************************************************************************************/
+
+    template<class CharT,class Traits,class Alloc>
+    constexpr typename basic_string<CharT,Traits,Alloc>::size_type basic_string<CharT,Traits,Alloc>::npos;
+    template<class CharT,class Traits,class Alloc>
+    constexpr typename basic_string<CharT,Traits,Alloc>::size_type basic_string<CharT,Traits,Alloc>::long_flag;
+    template<class CharT,class Traits,class Alloc>
+    constexpr typename basic_string<CharT,Traits,Alloc>::size_type basic_string<CharT,Traits,Alloc>::short_capacity;
+
+    template<class CharT,class Traits,class Alloc>
+    CharT* basic_string<CharT,Traits,Alloc>::init_storage(size_type n){
+        if(n <= short_capacity){
+            r_.s.size = static_cast<unsigned char>(n << 1);
+            r_.s.data[n] = CharT();
+            return r_.s.data;
+        }
+        THROW_LENGTH_ERROR_IF(n > max_size(),"basic_string<CharT>'s size too big");
+        const size_type nslots = slots_for(n);
+        CharT* p = data_allocator::allocate(nslots);
+        set_long(p,nslots,n);
+        return p;
+    }
+
+    template<class CharT,class Traits,class Alloc>
+    template<class Iter>
+    void basic_string<CharT,Traits,Alloc>::range_init(Iter first,Iter last,input_iterator_tag){
+        init_short();
+        try{
+            for(;first != last;++first) push_back(*first);
+        }
+        catch(...){
+            release();
+            throw;
+        }
+    }
+
+    template<class CharT,class Traits,class Alloc>
+    template<class Iter>
+    void basic_string<CharT,Traits,Alloc>::range_init(Iter first,Iter last,forward_iterator_tag){
+        CharT* p = init_storage(static_cast<size_type>(hxqstl::distance(first,last)));
+        try{
+            for(;first != last;++first,++p) *p = *first;
+        }
+        catch(...){
+            release();
+            throw;
+        }
+    }
+
+    template<class CharT,class Traits,class Alloc>
+    CharT* basic_string<CharT,Traits,Alloc>::replace_aux(size_type pos,size_type n1,const CharT* src,size_type n2){
+        const size_type sz = size();
+        MYSTL_DEBUG(pos <= sz && n1 <= sz - pos);
+        THROW_LENGTH_ERROR_IF(n2 > max_size() - (sz - n1),"basic_string<CharT>'s size too big");
+        const size_type new_size = sz - n1 + n2;
+        const size_type tail = sz - pos - n1;
+        CharT* old = ptr();
+        if(new_size <= capacity()){
+            // 源字符在自身内部时，移动尾部可能覆盖它，先复制出来
+            if(src != nullptr && !(src + n2 <= old || old + sz <= src)){
+                const basic_string tmp(src,n2);
+                return replace_aux(pos,n1,tmp.data(),n2);
+            }
+            if(n1 != n2) traits_type::move(old + pos + n2,old + pos + n1,tail);
+            if(src != nullptr) traits_type::copy(old + pos,src,n2);
+            set_size(new_size);
+            return old + pos;
+        }
+        // 新缓冲区写完后才释放旧的，src 指向自身时也安全
+        const size_type nslots = slots_for(grow_to(new_size));
+        CharT* p = data_allocator::allocate(nslots);
+        traits_type::copy(p,old,pos);
+        if(src != nullptr) traits_type::copy(p + pos,src,n2);
+        traits_type::copy(p + pos + n2,old + pos + n1,tail);
+        release();
+        set_long(p,nslots,new_size);
+        return p + pos;
+    }
+
+    template<class CharT,class Traits,class Alloc>
+    void basic_string<CharT,Traits,Alloc>::reallocate(size_type cap){
+        const size_type sz = size();
+        const size_type nslots = slots_for(cap);
+        CharT* p = data_allocator::allocate(nslots);
+        traits_type::copy(p,ptr(),sz);
+        release();
+        set_long(p,nslots,sz);
+    }
+
+    template<class CharT,class Traits,class Alloc>
+    void basic_string<CharT,Traits,Alloc>::reserve(size_type n){
+        THROW_LENGTH_ERROR_IF(n > max_size(),"n can not larger than max_size() in basic_string<CharT>::reserve(n)");
+        if(n > capacity()) reallocate(n);
+    }
+
+    // 长度回到短模式的范围内时搬回对象内部
+    template<class CharT,class Traits,class Alloc>
+    void basic_string<CharT,Traits,Alloc>::shrink_to_fit(){
+        if(!is_long()) return;
+        const size_type sz = size();
+        if(sz <= short_capacity){
+            CharT* old = r_.l.data;
+            const size_type nslots = slots();
+            r_.s.size = static_cast<unsigned char>(sz << 1);
+            traits_type::copy(r_.s.data,old,sz);
+            r_.s.data[sz] = CharT();
+            data_allocator::deallocate(old,nslots);
+        }
+        else if(slots_for(sz) < slots()){
+            reallocate(sz);
+        }
+    }
+
+    template<class CharT,class Traits,class Alloc>
+    basic_string<CharT,Traits,Alloc>& basic_string<CharT,Traits,Alloc>::assign(const CharT* s,size_type n){
+        if(n <= capacity()){
+            traits_type::move(ptr(),s,n);
+            set_size(n);
+            return *this;
+        }
+        // n 超过容量时 s 不可能指向自身
+        THROW_LENGTH_ERROR_IF(n > max_size(),"basic_string<CharT>'s size too big");
+        const size_type nslots = slots_for(n);
+        CharT* p = data_allocator::allocate(nslots);
+        traits_type::copy(p,s,n);
+        release();
+        set_long(p,nslots,n);
+        return *this;
+    }
+
+    template<class CharT,class Traits,class Alloc>
+    basic_string<CharT,Traits,Alloc>& basic_string<CharT,Traits,Alloc>::assign(size_type n,CharT ch){
+        if(n > capacity()){
+            basic_string tmp(n,ch);
+            swap(tmp);
+        }
+        else{
+            traits_type::assign(ptr(),n,ch);
+            set_size(n);
+        }
+        return *this;
+    }
+
+    // 容量足够时直接复制到末尾，源字符即使在自身内部也不会和目标重叠
+    template<class CharT,class Traits,class Alloc>
+    basic_string<CharT,Traits,Alloc>& basic_string<CharT,Traits,Alloc>::append(const CharT* s,size_type n){
+        const size_type sz = size();
+        if(n <= capacity() - sz){
+            traits_type::copy(ptr() + sz,s,n);
+            set_size(sz + n);
+        }
+        else{
+            replace_aux(sz,0,s,n);
+        }
+        return *this;
+    }
+
+    /*****************************************************************************************/
+    // 非成员函数
+
+    template<class CharT,class Traits,class Alloc>
+    basic_string<CharT,Traits,Alloc> operator+(const basic_string<CharT,Traits,Alloc>& lhs,
+                                               const basic_string<CharT,Traits,Alloc>& rhs)
+    {
+        basic_string<CharT,Traits,Alloc> result;
+        result.reserve(lhs.size() + rhs.size());
+        result.append(lhs).append(rhs);
+        return result;
+    }
+
+    template<class CharT,class Traits,class Alloc>
+    basic_string<CharT,Traits,Alloc> operator+(const basic_string<CharT,Traits,Alloc>& lhs,const CharT* rhs)
+    {
+        basic_string<CharT,Traits,Alloc> result(lhs);
+        result.append(rhs);
+        return result;
+    }
+
+    template<class CharT,class Traits,class Alloc>
+    basic_string<CharT,Traits,Alloc> operator+(const CharT* lhs,const basic_string<CharT,Traits,Alloc>& rhs)
+    {
+        basic_string<CharT,Traits,Alloc> result(lhs);
+        result.append(rhs);
+        return result;
+    }
+
+    template<class CharT,class Traits,class Alloc>
+    basic_string<CharT,Traits,Alloc> operator+(const basic_string<CharT,Traits,Alloc>& lhs,CharT rhs)
+    {
+        basic_string<CharT,Traits,Alloc> result(lhs);
+        result.push_back(rhs);
+        return result;
+    }
+
+    // 左侧是右值时在它的缓冲区上追加，连加时只在容量不够时重新分配
+    template<class CharT,class Traits,class Alloc>
+    basic_string<CharT,Traits,Alloc> operator+(basic_string<CharT,Traits,Alloc>&& lhs,
+                                               const basic_string<CharT,Traits,Alloc>& rhs)
+    {
+        return hxqstl::move(lhs.append(rhs));
+    }
+
+    template<class CharT,class Traits,class Alloc>
+    basic_string<CharT,Traits,Alloc> operator+(basic_string<CharT,Traits,Alloc>&& lhs,const CharT* rhs)
+    {
+        return hxqstl::move(lhs.append(rhs));
+    }
+
+    template<class CharT,class Traits,class Alloc>
+    basic_string<CharT,Traits,Alloc> operator+(basic_string<CharT,Traits,Alloc>&& lhs,CharT rhs)
+    {
+        lhs.push_back(rhs);
+        return hxqstl::move(lhs);
+    }
+
+    // 与 basic_string、C 字符串比较；与 string_view 比较由 string_view 的运算符处理
+    #define HXQSTL_STRING_COMPARE(OP)                                                               \
+    template<class CharT,class Traits,class Alloc>                                                  \
+    bool operator OP(const basic_string<CharT,Traits,Alloc>& lhs,                                   \
+                     const basic_string<CharT,Traits,Alloc>& rhs) noexcept                          \
+    { return lhs.view() OP rhs.view(); }                                                            \
+    template<class CharT,class Traits,class Alloc>                                                  \
+    bool operator OP(const basic_string<CharT,Traits,Alloc>& lhs,const CharT* rhs)                  \
+    { return lhs.view() OP basic_string_view<CharT,Traits>(rhs); }                                  \
+    template<class CharT,class Traits,class Alloc>                                                  \
+    bool operator OP(const CharT* lhs,const basic_string<CharT,Traits,Alloc>& rhs)                  \
+    { return basic_string_view<CharT,Traits>(lhs) OP rhs.view(); }
+
+    HXQSTL_STRING_COMPARE(==)
+    HXQSTL_STRING_COMPARE(!=)
+    HXQSTL_STRING_COMPARE(<)
+    HXQSTL_STRING_COMPARE(>)
+    HXQSTL_STRING_COMPARE(<=)
+    HXQSTL_STRING_COMPARE(>=)
+
+    #undef HXQSTL_STRING_COMPARE
+
+    template<class CharT,class Traits,class Alloc>
+    void swap(basic_string<CharT,Traits,Alloc>& lhs,basic_string<CharT,Traits,Alloc>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    template<class CharT,class Traits,class Alloc>
+    struct hash<basic_string<CharT,Traits,Alloc>>
+    {
+        size_t operator()(const basic_string<CharT,Traits,Alloc>& s) const noexcept
+        {
+            return strops::hash_bytes(s.data(),s.size() * sizeof(CharT));
+        }
+    };
+
+    typedef basic_string<char> string;
+    typedef basic_string<wchar_t> wstring;
+    typedef basic_string<char16_t> u16string;
+    typedef basic_string<char32_t> u32string;
+
+    // 超出短模式的缓冲区从内存池分配，适合大量频繁创建销毁的中等长度字符串
+    typedef basic_string<char,char_traits<char>,pool_allocator<char>> pool_string;
+}
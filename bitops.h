@@ -0,0 +1,73 @@
+#pragma once
+
+// 64 位字上的位运算工具
+// GCC/Clang 下映射到 __builtin_*，开启 -mpopcnt/-mbmi 后各自是一条指令
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hxqstl{
+    namespace bits{
+        constexpr size_t word_bits = 64;
+
+        inline unsigned popcount(uint64_t x) noexcept{
+#if defined(__GNUC__)
+            return static_cast<unsigned>(__builtin_popcountll(x));
+#else
+            x = x - ((x >> 1) & 0x5555555555555555ull);
+            x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+            x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+            return static_cast<unsigned>((x * 0x0101010101010101ull) >> 56);
+#endif
+        }
+
+        // x 不能为 0
+        inline unsigned countr_zero(uint64_t x) noexcept{
+#if defined(__GNUC__)
+            return static_cast<unsigned>(__builtin_ctzll(x));
+#else
+            unsigned n = 0;
+            while((x & 1) == 0){ x >>= 1; ++n; }
+            return n;
+#endif
+        }
+
+        // x 不能为 0
+        inline unsigned countl_zero(uint64_t x) noexcept{
+#if defined(__GNUC__)
+            return static_cast<unsigned>(__builtin_clzll(x));
+#else
+            unsigned n = 0;
+            while((x & (1ull << 63)) == 0){ x <<= 1; ++n; }
+            return n;
+#endif
+        }
+
+        // 低 n 位全为 1 的掩码，n 取值 [0,64]
+        inline uint64_t low_mask(size_t n) noexcept{
+            return n >= word_bits ? ~uint64_t(0) : ((uint64_t(1) << n) - 1);
+        }
+
+        // 存放 n 个位需要的字数
+        inline size_t words_for(size_t n) noexcept{
+            return (n + word_bits - 1) / word_bits;
+        }
+
+        // 统计 [p,p+n) 中所有字的置位数
+        // 四路累加打断依赖链，让多条 popcnt 并行执行
+        inline size_t popcount_words(const uint64_t* p,size_t n) noexcept{
+            size_t c0 = 0,c1 = 0,c2 = 0,c3 = 0;
+            size_t i = 0;
+            for(;i + 4 <= n;i += 4){
+                c0 += popcount(p[i]);
+                c1 += popcount(p[i + 1]);
+                c2 += popcount(p[i + 2]);
+                c3 += popcount(p[i + 3]);
+            }
+            for(;i < n;++i){
+                c0 += popcount(p[i]);
+            }
+            return c0 + c1 + c2 + c3;
+        }
+    }
+}
@@ -0,0 +1,952 @@
+#pragma once
+
+// btree
+// btree_map/btree_set 的底层 B+ 树
+// 每个节点约占四条 cache line，键在节点内连续存放：算术类型配合默认比较器时节点内做无分支的线性计数
+// (编译器可以向量化)，其他类型做无分支二分查找
+// 元素只存放在叶子中，叶子之间双向链接，范围遍历只顺序访问叶子内的数组
+// 内部节点只保存分隔键，满足 children[i] 中的键 < keys[i] <= children[i + 1] 中的键
+// 节点从 alloc 内存池申请；任何插入、删除都会使迭代器和引用失效
+// 要求键和值的移动构造/移动赋值不抛出异常
+
+#include <cstdint>
+#include <new>
+
+#include "algobase.h"
+#include "alloc.h"
+#include "construct.h"
+#include "flat_map.h"
+#include "functional.h"
+#include "iterator.h"
+#include "uninitialized.h"
+#include "util.h"
+#include "vector.h"
+#include "exceptdef.h"
+
+namespace hxqstl{
+    namespace bt{
+        // 节点的目标大小
+        enum{ kNodeBytes = 256 };
+
+        // set 的叶子不保存值，用空类型占位
+        struct no_value {};
+
+        template<class Key,class T>
+        struct slot_bytes : std::integral_constant<size_t,sizeof(Key) + sizeof(T)> {};
+        template<class Key>
+        struct slot_bytes<Key,void> : std::integral_constant<size_t,sizeof(Key)> {};
+
+        // 每个节点最多保存的键数，限制在 [4,128]
+        template<class Key,class T>
+        struct node_slots
+        {
+            static constexpr size_t raw = (kNodeBytes - 4 * sizeof(void*)) / slot_bytes<Key,T>::value;
+            static constexpr size_t value = raw < 4 ? 4 : (raw > 128 ? 128 : raw);
+        };
+
+        template<class Key,class T>
+        constexpr size_t node_slots<Key,T>::raw;
+        template<class Key,class T>
+        constexpr size_t node_slots<Key,T>::value;
+
+        // 未初始化的定长数组，[0,count) 部分已构造
+        template<class V,size_t N>
+        struct slot_array
+        {
+            typename std::aligned_storage<sizeof(V),alignof(V)>::type raw[N];
+
+            V* data() noexcept {return reinterpret_cast<V*>(raw);}
+            const V* data() const noexcept {return reinterpret_cast<const V*>(raw);}
+        };
+
+        // 在已构造的 [0,count) 的 pos 处插入，后面的元素右移一格
+        template<class V,class Arg>
+        void slot_insert(V* a,size_t count,size_t pos,Arg&& v){
+            if(pos == count){
+                hxqstl::construct(a + count,hxqstl::forward<Arg>(v));
+                return;
+            }
+            hxqstl::construct(a + count,hxqstl::move(a[count - 1]));
+            hxqstl::move_backward(a + pos,a + count - 1,a + count);
+            a[pos] = hxqstl::forward<Arg>(v);
+        }
+
+        // 删除 [0,count) 中 pos 处的元素，后面的元素左移一格
+        template<class V>
+        void slot_erase(V* a,size_t count,size_t pos){
+            hxqstl::move(a + pos + 1,a + count,a + pos);
+            hxqstl::destroy(a + count - 1);
+        }
+
+        // 把 src 的 n 个元素移到 dst 的未初始化区域，并析构 src 中的原对象
+        template<class V>
+        void slot_transfer(V* dst,V* src,size_t n){
+            hxqstl::uninitialized_move(src,src + n,dst);
+            hxqstl::destroy(src,src + n);
+        }
+
+        template<class Key,size_t N>
+        struct node_base
+        {
+            uint16_t count;
+            bool leaf;
+            slot_array<Key,N> keys;
+
+            Key* key_data() noexcept {return keys.data();}
+            const Key* key_data() const noexcept {return keys.data();}
+            Key& key(size_t i) noexcept {return keys.data()[i];}
+            const Key& key(size_t i) const noexcept {return keys.data()[i];}
+        };
+
+        // 叶子中与键平行的值数组，set 的特化为空
+        template<class T,size_t N>
+        struct leaf_values
+        {
+            slot_array<T,N> vals;
+
+            T& value(size_t i) noexcept {return vals.data()[i];}
+            const T& value(size_t i) const noexcept {return vals.data()[i];}
+
+            void value_insert(size_t count,size_t pos,T&& v)
+            { slot_insert(vals.data(),count,pos,hxqstl::move(v)); }
+            void value_erase(size_t count,size_t pos)
+            { slot_erase(vals.data(),count,pos); }
+            // 把本节点 [spos,spos + n) 的值移到 dst 的 dpos 处
+            void value_transfer(leaf_values& dst,size_t dpos,size_t spos,size_t n)
+            { slot_transfer(dst.vals.data() + dpos,vals.data() + spos,n); }
+            // 从 src 的 spos 处取走一个值插入到本节点的 dpos 处
+            void value_borrow(leaf_values& src,size_t count,size_t dpos,size_t src_count,size_t spos)
+            {
+                slot_insert(vals.data(),count,dpos,hxqstl::move(src.vals.data()[spos]));
+                slot_erase(src.vals.data(),src_count,spos);
+            }
+            void value_destroy(size_t n) {hxqstl::destroy(vals.data(),vals.data() + n);}
+            template<class V>
+            void value_construct(size_t pos,const V& v) {hxqstl::construct(vals.data() + pos,v.second);}
+        };
+
+        template<size_t N>
+        struct leaf_values<void,N>
+        {
+            void value_insert(size_t,size_t,no_value&&) {}
+            void value_erase(size_t,size_t) {}
+            void value_transfer(leaf_values&,size_t,size_t,size_t) {}
+            void value_borrow(leaf_values&,size_t,size_t,size_t,size_t) {}
+            void value_destroy(size_t) {}
+            template<class V>
+            void value_construct(size_t,const V&) {}
+        };
+
+        template<class Key,class T,size_t N>
+        struct leaf_node : node_base<Key,N>,leaf_values<T,N>
+        {
+            leaf_node* prev;
+            leaf_node* next;
+        };
+
+        template<class Key,size_t N>
+        struct inner_node : node_base<Key,N>
+        {
+            node_base<Key,N>* children[N + 1];
+        };
+
+        // 迭代器解引用的结果：map 为 pair<const Key&,T&> 代理对象，set 为 const Key&
+        template<class Key,class T,class ValueRef>
+        struct iter_ref
+        {
+            typedef hxqstl::pair<Key,T> value_type;
+            typedef hxqstl::pair<const Key&,ValueRef> reference;
+
+            // operator-> 需要返回指针，用一个保存代理对象的小结构转接
+            struct pointer
+            {
+                reference ref;
+                reference* operator->() {return &ref;}
+            };
+
+            template<class Leaf>
+            static reference make(Leaf* leaf,size_t i) {return reference(leaf->key(i),leaf->value(i));}
+            template<class Leaf>
+            static pointer make_pointer(Leaf* leaf,size_t i) {return pointer{make(leaf,i)};}
+        };
+
+        template<class Key,class ValueRef>
+        struct iter_ref<Key,void,ValueRef>
+        {
+            typedef Key value_type;
+            typedef const Key& reference;
+            typedef const Key* pointer;
+
+            template<class Leaf>
+            static reference make(Leaf* leaf,size_t i) {return leaf->key(i);}
+            template<class Leaf>
+            static pointer make_pointer(Leaf* leaf,size_t i) {return &leaf->key(i);}
+        };
+    }
+
+    // B+ 树的迭代器：所在叶子和叶子内的下标
+    // end() 为最右叶子的 (leaf,count)，空树为 (nullptr,0)
+    template<class Key,class T,size_t N,class ValueRef>
+    struct btree_iterator : public iterator<bidirectional_iterator_tag,typename bt::iter_ref<Key,T,ValueRef>::value_type>
+    {
+        typedef bt::iter_ref<Key,T,ValueRef> ref_traits;
+        typedef typename ref_traits::reference reference;
+        typedef typename ref_traits::pointer pointer;
+        typedef bt::leaf_node<Key,T,N> leaf_type;
+        typedef btree_iterator self;
+
+        leaf_type* leaf;
+        size_t pos;
+
+        btree_iterator() noexcept : leaf(nullptr),pos(0) {}
+        btree_iterator(leaf_type* l,size_t p) noexcept : leaf(l),pos(p) {}
+
+        // 只允许 iterator 转换为 const_iterator，反方向会绕过 const
+        template<class R,typename std::enable_if<!std::is_same<R,ValueRef>::value &&
+                                                 std::is_convertible<R,ValueRef>::value,int>::type = 0>
+        btree_iterator(const btree_iterator<Key,T,N,R>& rhs) noexcept : leaf(rhs.leaf),pos(rhs.pos) {}
+
+        const Key& key() const {return leaf->key(pos);}
+        ValueRef value() const {return leaf->value(pos);}
+
+        reference operator*() const {return ref_traits::make(leaf,pos);}
+        pointer operator->() const {return ref_traits::make_pointer(leaf,pos);}
+
+        self& operator++()
+        {
+            if(++pos == leaf->count && leaf->next != nullptr){
+                leaf = leaf->next;
+                pos = 0;
+            }
+            return *this;
+        }
+        self operator++(int) {self tmp = *this;++*this;return tmp;}
+        self& operator--()
+        {
+            if(pos == 0){
+                leaf = leaf->prev;
+                pos = leaf->count;
+            }
+            --pos;
+            return *this;
+        }
+        self operator--(int) {self tmp = *this;--*this;return tmp;}
+
+        bool operator==(const self& rhs) const {return leaf == rhs.leaf && pos == rhs.pos;}
+        bool operator!=(const self& rhs) const {return !(*this == rhs);}
+    };
+
+    // T 为 void 时是集合，叶子只保存键
+    template<class Key,class T,class Compare>
+    class btree{
+        public:
+            typedef Key key_type;
+            typedef Compare key_compare;
+            typedef size_t size_type;
+            typedef ptrdiff_t difference_type;
+
+            static constexpr size_t node_slots = bt::node_slots<Key,T>::value;
+            // 删除后低于该数量时向兄弟借或合并
+            static constexpr size_t min_leaf = node_slots / 2;
+            static constexpr size_t min_inner = (node_slots - 1) / 2;
+
+            typedef bt::node_base<Key,node_slots> node_type;
+            typedef bt::leaf_node<Key,T,node_slots> leaf_type;
+            typedef bt::inner_node<Key,node_slots> inner_type;
+
+            // 插入时先把值构造在这里，再移动进叶子
+            typedef typename std::conditional<std::is_void<T>::value,bt::no_value,T>::type value_holder;
+
+            typedef btree_iterator<Key,T,node_slots,
+                typename std::conditional<std::is_void<T>::value,const Key&,
+                    typename std::add_lvalue_reference<T>::type>::type> iterator;
+            typedef btree_iterator<Key,T,node_slots,
+                typename std::conditional<std::is_void<T>::value,const Key&,
+                    typename std::add_lvalue_reference<const T>::type>::type> const_iterator;
+
+        private:
+            enum{ kMaxHeight = 64 };
+
+            // 从根到叶子经过的内部节点和所走的孩子下标
+            struct path
+            {
+                inner_type* node[kMaxHeight];
+                size_type idx[kMaxHeight];
+                size_type depth;
+            };
+
+            typedef std::integral_constant<bool,std::is_arithmetic<Key>::value &&
+                                                std::is_same<Compare,hxqstl::less<Key>>::value> linear_search;
+            typedef std::integral_constant<bool,!std::is_void<T>::value> is_map;
+
+            node_type* root_;
+            leaf_type* leftmost_;
+            leaf_type* rightmost_;
+            size_type size_;
+            key_compare comp_;
+
+        public:
+            explicit btree(const Compare& comp = Compare())
+            :root_(nullptr),leftmost_(nullptr),rightmost_(nullptr),size_(0),comp_(comp) {}
+
+            btree(const btree& rhs)
+            :root_(nullptr),leftmost_(nullptr),rightmost_(nullptr),size_(0),comp_(rhs.comp_)
+            {
+                assign_sorted(rhs.begin(),rhs.size());
+            }
+
+            btree(btree&& rhs) noexcept
+            :root_(rhs.root_),leftmost_(rhs.leftmost_),rightmost_(rhs.rightmost_),size_(rhs.size_),
+             comp_(rhs.comp_)
+            {
+                rhs.root_ = nullptr;
+                rhs.leftmost_ = nullptr;
+                rhs.rightmost_ = nullptr;
+                rhs.size_ = 0;
+            }
+
+            btree& operator=(const btree& rhs)
+            {
+                if(this != &rhs){
+                    btree tmp(rhs);
+                    swap(tmp);
+                }
+                return *this;
+            }
+            btree& operator=(btree&& rhs) noexcept
+            {
+                btree tmp(hxqstl::move(rhs));
+                swap(tmp);
+                return *this;
+            }
+
+            ~btree() {clear();}
+
+        public:
+            iterator begin() noexcept {return iterator(leftmost_,0);}
+            const_iterator begin() const noexcept {return const_iterator(leftmost_,0);}
+            iterator end() noexcept {return iterator(rightmost_,rightmost_ ? rightmost_->count : 0);}
+            const_iterator end() const noexcept
+            { return const_iterator(rightmost_,rightmost_ ? rightmost_->count : 0); }
+
+            bool empty() const noexcept {return size_ == 0;}
+            size_type size() const noexcept {return size_;}
+            key_compare key_comp() const {return comp_;}
+
+            void clear() noexcept
+            {
+                if(root_ != nullptr) free_subtree(root_);
+                root_ = nullptr;
+                leftmost_ = nullptr;
+                rightmost_ = nullptr;
+                size_ = 0;
+            }
+
+            void swap(btree& rhs) noexcept
+            {
+                hxqstl::swap(root_,rhs.root_);
+                hxqstl::swap(leftmost_,rhs.leftmost_);
+                hxqstl::swap(rightmost_,rhs.rightmost_);
+                hxqstl::swap(size_,rhs.size_);
+                hxqstl::swap(comp_,rhs.comp_);
+            }
+
+            iterator lower_bound(const key_type& key)
+            {
+                if(root_ == nullptr) return end();
+                leaf_type* leaf = descend(key);
+                return make_iter(leaf,lower_pos(leaf,key));
+            }
+            const_iterator lower_bound(const key_type& key) const
+            { return const_cast<btree*>(this)->lower_bound(key); }
+
+            iterator upper_bound(const key_type& key)
+            {
+                if(root_ == nullptr) return end();
+                leaf_type* leaf = descend(key);
+                return make_iter(leaf,upper_pos(leaf,key));
+            }
+            const_iterator upper_bound(const key_type& key) const
+            { return const_cast<btree*>(this)->upper_bound(key); }
+
+            iterator find(const key_type& key)
+            {
+                if(root_ == nullptr) return end();
+                leaf_type* leaf = descend(key);
+                const size_type pos = lower_pos(leaf,key);
+                if(pos == leaf->count || comp_(key,leaf->key(pos))) return end();
+                return iterator(leaf,pos);
+            }
+            const_iterator find(const key_type& key) const
+            { return const_cast<btree*>(this)->find(key); }
+
+            // 键不存在时才用 args 构造值并插入
+            template<class K,class... Args>
+            hxqstl::pair<iterator,bool> try_emplace(K&& key,Args&&... args);
+
+            iterator erase(const_iterator pos);
+            iterator erase(const_iterator first,const_iterator last);
+            size_type erase(const key_type& key);
+
+            // 用 [first,first + n) 中严格递增的元素自底向上重建整棵树，叶子全部填满
+            // 元素为 map 的 pair 或 set 的键
+            template<class Iter>
+            void assign_sorted(Iter first,size_type n);
+
+        private:
+            static leaf_type* new_leaf()
+            {
+                void* p = alloc::allocate(sizeof(leaf_type),align_val_t(alignof(leaf_type)));
+                leaf_type* leaf = ::new(p) leaf_type;
+                leaf->count = 0;
+                leaf->leaf = true;
+                leaf->prev = nullptr;
+                leaf->next = nullptr;
+                return leaf;
+            }
+            static inner_type* new_inner()
+            {
+                void* p = alloc::allocate(sizeof(inner_type),align_val_t(alignof(inner_type)));
+                inner_type* inner = ::new(p) inner_type;
+                inner->count = 0;
+                inner->leaf = false;
+                return inner;
+            }
+
+            static void free_node(node_type* n) noexcept
+            {
+                hxqstl::destroy(n->key_data(),n->key_data() + n->count);
+                if(n->leaf){
+                    leaf_type* leaf = static_cast<leaf_type*>(n);
+                    leaf->value_destroy(leaf->count);
+                    alloc::deallocate(leaf,sizeof(leaf_type),align_val_t(alignof(leaf_type)));
+                }
+                else{
+                    alloc::deallocate(n,sizeof(inner_type),align_val_t(alignof(inner_type)));
+                }
+            }
+            static void free_subtree(node_type* n) noexcept
+            {
+                if(!n->leaf){
+                    inner_type* inner = static_cast<inner_type*>(n);
+                    for(size_type i = 0;i <= inner->count;++i){
+                        free_subtree(inner->children[i]);
+                    }
+                }
+                free_node(n);
+            }
+
+            // 节点内第一个不小于 key 的位置
+            size_type lower_pos(const node_type* n,const key_type& key) const
+            { return lower_pos(n,key,linear_search{}); }
+            size_type lower_pos(const node_type* n,const key_type& key,std::true_type) const noexcept
+            {
+                const Key* k = n->key_data();
+                size_type r = 0;
+                for(size_type i = 0;i < n->count;++i){
+                    r += k[i] < key ? 1 : 0;
+                }
+                return r;
+            }
+            size_type lower_pos(const node_type* n,const key_type& key,std::false_type) const
+            {
+                const Key* k = n->key_data();
+                return static_cast<size_type>(hxqstl::branchless_lower_bound(k,n->count,key,comp_) - k);
+            }
+
+            // 节点内第一个大于 key 的位置
+            size_type upper_pos(const node_type* n,const key_type& key) const
+            { return upper_pos(n,key,linear_search{}); }
+            size_type upper_pos(const node_type* n,const key_type& key,std::true_type) const noexcept
+            {
+                const Key* k = n->key_data();
+                size_type r = 0;
+                for(size_type i = 0;i < n->count;++i){
+                    r += key < k[i] ? 0 : 1;
+                }
+                return r;
+            }
+            size_type upper_pos(const node_type* n,const key_type& key,std::false_type) const
+            {
+                const Key* k = n->key_data();
+                const Compare& comp = comp_;
+                return static_cast<size_type>(hxqstl::branchless_lower_bound(k,n->count,key,
+                    [&comp](const Key& x,const Key& y){ return !comp(y,x); }) - k);
+            }
+
+            // 找到 key 所属的叶子
+            leaf_type* descend(const key_type& key) const
+            {
+                node_type* n = root_;
+                while(!n->leaf){
+                    n = static_cast<inner_type*>(n)->children[upper_pos(n,key)];
+                }
+                return static_cast<leaf_type*>(n);
+            }
+            leaf_type* descend(const key_type& key,path& p) const
+            {
+                node_type* n = root_;
+                p.depth = 0;
+                while(!n->leaf){
+                    const size_type i = upper_pos(n,key);
+                    p.node[p.depth] = static_cast<inner_type*>(n);
+                    p.idx[p.depth] = i;
+                    ++p.depth;
+                    n = static_cast<inner_type*>(n)->children[i];
+                }
+                return static_cast<leaf_type*>(n);
+            }
+
+            // 叶子末尾的位置规范化为下一个叶子的开头
+            iterator make_iter(leaf_type* leaf,size_type pos) const noexcept
+            {
+                if(pos == leaf->count && leaf->next != nullptr){
+                    return iterator(leaf->next,0);
+                }
+                return iterator(leaf,pos);
+            }
+
+            static leaf_type* leaf_at(inner_type* n,size_type i) noexcept
+            { return static_cast<leaf_type*>(n->children[i]); }
+            static inner_type* inner_at(inner_type* n,size_type i) noexcept
+            { return static_cast<inner_type*>(n->children[i]); }
+
+            static void leaf_insert(leaf_type* leaf,size_type pos,Key&& k,value_holder&& v)
+            {
+                bt::slot_insert(leaf->key_data(),leaf->count,pos,hxqstl::move(k));
+                leaf->value_insert(leaf->count,pos,hxqstl::move(v));
+                ++leaf->count;
+            }
+            // 把 src 的 spos 处的元素移到 dst 的 dpos 处
+            static void leaf_borrow(leaf_type* dst,size_type dpos,leaf_type* src,size_type spos)
+            {
+                bt::slot_insert(dst->key_data(),dst->count,dpos,hxqstl::move(src->key(spos)));
+                bt::slot_erase(src->key_data(),src->count,spos);
+                dst->value_borrow(*src,dst->count,dpos,src->count,spos);
+                ++dst->count;
+                --src->count;
+            }
+
+            // 在 children[i] 之后插入新的孩子 right，分隔键为 k
+            static void inner_insert(inner_type* n,size_type i,Key&& k,node_type* right)
+            {
+                bt::slot_insert(n->key_data(),n->count,i,hxqstl::move(k));
+                for(size_type j = n->count + 1;j > i + 1;--j){
+                    n->children[j] = n->children[j - 1];
+                }
+                n->children[i + 1] = right;
+                ++n->count;
+            }
+            static void inner_erase(inner_type* n,size_type key_pos,size_type child_pos)
+            {
+                bt::slot_erase(n->key_data(),n->count,key_pos);
+                for(size_type j = child_pos;j < n->count;++j){
+                    n->children[j] = n->children[j + 1];
+                }
+                --n->count;
+            }
+
+            iterator insert_split(path& p,leaf_type* leaf,size_type pos,Key& k,value_holder& v);
+            void insert_parent(path& p,Key&& sep,node_type* right,node_type** spare);
+            void erase_at(path& p,leaf_type* leaf,size_type pos);
+            void rebalance_leaf(path& p,leaf_type* leaf);
+            void rebalance_inner(path& p,size_type d);
+            void merge_leaves(inner_type* parent,size_type i);
+            void merge_inner(inner_type* parent,size_type i);
+
+            // 批量构建时从输入元素中取键
+            template<class V>
+            static const Key& key_of(const V& v,std::true_type) {return v.first;}
+            template<class V>
+            static const Key& key_of(const V& v,std::false_type) {return v;}
+    };
+
+    /*****************************************************************************************/
+
+    template<class Key,class T,class Compare>
+    constexpr size_t btree<Key,T,Compare>::node_slots;
+    template<class Key,class T,class Compare>
+    constexpr size_t btree<Key,T,Compare>::min_leaf;
+    template<class Key,class T,class Compare>
+    constexpr size_t btree<Key,T,Compare>::min_inner;
+
+    template<class Key,class T,class Compare>
+    template<class K,class... Args>
+    hxqstl::pair<typename btree<Key,T,Compare>::iterator,bool>
+    btree<Key,T,Compare>::try_emplace(K&& key,Args&&... args){
+        if(root_ == nullptr){
+            leaf_type* leaf = new_leaf();
+            root_ = leaf;
+            leftmost_ = leaf;
+            rightmost_ = leaf;
+        }
+        path p;
+        leaf_type* leaf = descend(key,p);
+        const size_type pos = lower_pos(leaf,key);
+        if(pos < leaf->count && !comp_(key,leaf->key(pos))){
+            return hxqstl::pair<iterator,bool>(iterator(leaf,pos),false);
+        }
+
+        // 先构造好键和值，之后的结构调整只有不抛异常的移动
+        Key k(hxqstl::forward<K>(key));
+        value_holder v(hxqstl::forward<Args>(args)...);
+        iterator it;
+        if(leaf->count < node_slots){
+            leaf_insert(leaf,pos,hxqstl::move(k),hxqstl::move(v));
+            it = iterator(leaf,pos);
+        }
+        else{
+            it = insert_split(p,leaf,pos,k,v);
+        }
+        ++size_;
+        return hxqstl::pair<iterator,bool>(it,true);
+    }
+
+    // 叶子已满时插入：先准备好分隔键和所有要用到的新节点，之后的操作不再抛出异常
+    // 在最右叶子末尾追加时不平分，新叶子只放新元素，顺序插入时叶子都是满的
+    template<class Key,class T,class Compare>
+    typename btree<Key,T,Compare>::iterator
+    btree<Key,T,Compare>::insert_split(path& p,leaf_type* leaf,size_type pos,Key& k,value_holder& v){
+        const size_type move_n = (leaf == rightmost_ && pos == node_slots) ? 0 : node_slots / 2;
+        const size_type keep = node_slots - move_n;
+        // 新元素落在右半边开头时，它就是新的分隔键
+        Key sep(pos == keep ? k : leaf->key(keep));
+
+        // 自底向上连续满的内部节点都要分裂，一直满到根时还需要新的根
+        size_type need = 1;
+        size_type d = p.depth;
+        while(d > 0 && p.node[d - 1]->count == node_slots){
+            --d;
+            ++need;
+        }
+        if(d == 0) ++need;
+
+        node_type* spare[kMaxHeight + 2];
+        size_type made = 0;
+        try{
+            spare[made++] = new_leaf();
+            while(made < need){
+                spare[made++] = new_inner();
+            }
+        }
+        catch(...){
+            while(made > 0) free_node(spare[--made]);
+            throw;
+        }
+
+        leaf_type* right = static_cast<leaf_type*>(spare[0]);
+        bt::slot_transfer(right->key_data(),leaf->key_data() + keep,move_n);
+        leaf->value_transfer(*right,0,keep,move_n);
+        leaf->count = static_cast<uint16_t>(keep);
+        right->count = static_cast<uint16_t>(move_n);
+
+        right->prev = leaf;
+        right->next = leaf->next;
+        if(leaf->next != nullptr) leaf->next->prev = right;
+        else rightmost_ = right;
+        leaf->next = right;
+
+        leaf_type* target = leaf;
+        if(pos >= keep){
+            target = right;
+            pos -= keep;
+        }
+        leaf_insert(target,pos,hxqstl::move(k),hxqstl::move(v));
+        insert_parent(p,hxqstl::move(sep),right,spare + 1);
+        return iterator(target,pos);
+    }
+
+    // 把新节点 right 挂到路径上的父节点，父节点满了就继续向上分裂
+    template<class Key,class T,class Compare>
+    void btree<Key,T,Compare>::insert_parent(path& p,Key&& sep,node_type* right,node_type** spare){
+        size_type d = p.depth;
+        while(d > 0){
+            --d;
+            inner_type* n = p.node[d];
+            const size_type i = p.idx[d];
+            if(n->count < node_slots){
+                inner_insert(n,i,hxqstl::move(sep),right);
+                return;
+            }
+            // keys[0,m) 留下，keys[m] 上移，keys[m + 1,N) 和 children[m + 1,N] 移到新节点
+            const size_type m = node_slots / 2;
+            const size_type rn = node_slots - m - 1;
+            inner_type* sibling = static_cast<inner_type*>(*spare++);
+            bt::slot_transfer(sibling->key_data(),n->key_data() + m + 1,rn);
+            for(size_type j = 0;j <= rn;++j){
+                sibling->children[j] = n->children[m + 1 + j];
+            }
+            sibling->count = static_cast<uint16_t>(rn);
+            Key up(hxqstl::move(n->key(m)));
+            hxqstl::destroy(n->key_data() + m);
+            n->count = static_cast<uint16_t>(m);
+
+            if(i <= m) inner_insert(n,i,hxqstl::move(sep),right);
+            else inner_insert(sibling,i - m - 1,hxqstl::move(sep),right);
+            sep = hxqstl::move(up);
+            right = sibling;
+        }
+        inner_type* root = static_cast<inner_type*>(*spare);
+        hxqstl::construct(root->key_data(),hxqstl::move(sep));
+        root->children[0] = root_;
+        root->children[1] = right;
+        root->count = 1;
+        root_ = root;
+    }
+
+    template<class Key,class T,class Compare>
+    typename btree<Key,T,Compare>::size_type
+    btree<Key,T,Compare>::erase(const key_type& key){
+        if(root_ == nullptr) return 0;
+        path p;
+        leaf_type* leaf = descend(key,p);
+        const size_type pos = lower_pos(leaf,key);
+        if(pos == leaf->count || comp_(key,leaf->key(pos))) return 0;
+        erase_at(p,leaf,pos);
+        return 1;
+    }
+
+    // 删除后节点会合并或借位，返回值通过被删除的键重新定位
+    template<class Key,class T,class Compare>
+    typename btree<Key,T,Compare>::iterator
+    btree<Key,T,Compare>::erase(const_iterator pos){
+        MYSTL_DEBUG(pos != end());
+        Key key(pos.key());
+        path p;
+        leaf_type* leaf = descend(key,p);
+        MYSTL_DEBUG(leaf == pos.leaf);
+        erase_at(p,leaf,pos.pos);
+        return lower_bound(key);
+    }
+
+    template<class Key,class T,class Compare>
+    typename btree<Key,T,Compare>::iterator
+    btree<Key,T,Compare>::erase(const_iterator first,const_iterator last){
+        if(first == last) return iterator(first.leaf,first.pos);
+        // last 会在删除过程中失效，先记下它的键
+        const bool to_end = last == end();
+        if(to_end){
+            while(first != end()) first = erase(first);
+            return end();
+        }
+        Key last_key(last.key());
+        iterator it(first.leaf,first.pos);
+        while(comp_(it.key(),last_key)){
+            it = erase(it);
+        }
+        return it;
+    }
+
+    template<class Key,class T,class Compare>
+    void btree<Key,T,Compare>::erase_at(path& p,leaf_type* leaf,size_type pos){
+        bt::slot_erase(leaf->key_data(),leaf->count,pos);
+        leaf->value_erase(leaf->count,pos);
+        --leaf->count;
+        --size_;
+        if(p.depth == 0){
+            if(leaf->count == 0) clear();
+            return;
+        }
+        if(leaf->count < min_leaf) rebalance_leaf(p,leaf);
+    }
+
+    // 叶子不足半满：兄弟有富余时借一个，否则与兄弟合并
+    template<class Key,class T,class Compare>
+    void btree<Key,T,Compare>::rebalance_leaf(path& p,leaf_type* leaf){
+        inner_type* parent = p.node[p.depth - 1];
+        const size_type i = p.idx[p.depth - 1];
+        if(i > 0){
+            leaf_type* left = leaf_at(parent,i - 1);
+            if(left->count > min_leaf){
+                Key sep(left->key(left->count - 1));
+                leaf_borrow(leaf,0,left,left->count - 1);
+                parent->key(i - 1) = hxqstl::move(sep);
+                return;
+            }
+        }
+        if(i < parent->count){
+            leaf_type* right = leaf_at(parent,i + 1);
+            if(right->count > min_leaf){
+                Key sep(right->key(1));
+                leaf_borrow(leaf,leaf->count,right,0);
+                parent->key(i) = hxqstl::move(sep);
+                return;
+            }
+        }
+        merge_leaves(parent,i > 0 ? i - 1 : i);
+        rebalance_inner(p,p.depth - 1);
+    }
+
+    // 内部节点不足半满：通过父节点与兄弟旋转一个键，否则合并，合并后继续检查父节点
+    template<class Key,class T,class Compare>
+    void btree<Key,T,Compare>::rebalance_inner(path& p,size_type d){
+        while(true){
+            inner_type* n = p.node[d];
+            if(d == 0){
+                if(n->count == 0){
+                    root_ = n->children[0];
+                    free_node(n);
+                }
+                return;
+            }
+            if(n->count >= min_inner) return;
+
+            inner_type* parent = p.node[d - 1];
+            const size_type j = p.idx[d - 1];
+            if(j > 0){
+                inner_type* left = inner_at(parent,j - 1);
+                if(left->count > min_inner){
+                    bt::slot_insert(n->key_data(),n->count,0,hxqstl::move(parent->key(j - 1)));
+                    for(size_type c = n->count + 1;c > 0;--c){
+                        n->children[c] = n->children[c - 1];
+                    }
+                    n->children[0] = left->children[left->count];
+                    ++n->count;
+                    parent->key(j - 1) = hxqstl::move(left->key(left->count - 1));
+                    hxqstl::destroy(left->key_data() + left->count - 1);
+                    --left->count;
+                    return;
+                }
+            }
+            if(j < parent->count){
+                inner_type* right = inner_at(parent,j + 1);
+                if(right->count > min_inner){
+                    hxqstl::construct(n->key_data() + n->count,hxqstl::move(parent->key(j)));
+                    n->children[n->count + 1] = right->children[0];
+                    ++n->count;
+                    parent->key(j) = hxqstl::move(right->key(0));
+                    inner_erase(right,0,0);
+                    return;
+                }
+            }
+            merge_inner(parent,j > 0 ? j - 1 : j);
+            --d;
+        }
+    }
+
+    // 把 children[i + 1] 并入 children[i]
+    template<class Key,class T,class Compare>
+    void btree<Key,T,Compare>::merge_leaves(inner_type* parent,size_type i){
+        leaf_type* left = leaf_at(parent,i);
+        leaf_type* right = leaf_at(parent,i + 1);
+        bt::slot_transfer(left->key_data() + left->count,right->key_data(),right->count);
+        right->value_transfer(*left,left->count,0,right->count);
+        left->count = static_cast<uint16_t>(left->count + right->count);
+        right->count = 0;
+
+        left->next = right->next;
+        if(right->next != nullptr) right->next->prev = left;
+        else rightmost_ = left;
+        free_node(right);
+        inner_erase(parent,i,i + 1);
+    }
+
+    template<class Key,class T,class Compare>
+    void btree<Key,T,Compare>::merge_inner(inner_type* parent,size_type i){
+        inner_type* left = inner_at(parent,i);
+        inner_type* right = inner_at(parent,i + 1);
+        hxqstl::construct(left->key_data() + left->count,hxqstl::move(parent->key(i)));
+        bt::slot_transfer(left->key_data() + left->count + 1,right->key_data(),right->count);
+        for(size_type c = 0;c <= right->count;++c){
+            left->children[left->count + 1 + c] = right->children[c];
+        }
+        left->count = static_cast<uint16_t>(left->count + right->count + 1);
+        right->count = 0;
+        free_node(right);
+        inner_erase(parent,i,i + 1);
+    }
+
+    // 先均匀地填满每个叶子，再逐层把相邻节点分组挂到新的内部节点下
+    // 每个节点的最小键另存一份，作为上一层的分隔键
+    template<class Key,class T,class Compare>
+    template<class Iter>
+    void btree<Key,T,Compare>::assign_sorted(Iter first,size_type n){
+        clear();
+        if(n == 0) return;
+
+        const size_type leaf_count = (n + node_slots - 1) / node_slots;
+        hxqstl::vector<node_type*> level;
+        hxqstl::vector<Key> mins;
+        try{
+            level.reserve(leaf_count);
+            mins.reserve(leaf_count);
+
+            const Key* last_key = nullptr;
+            size_type rest = n;
+            for(size_type li = 0;li < leaf_count;++li){
+                const size_type cnt = rest / (leaf_count - li);
+                leaf_type* leaf = new_leaf();
+                leaf->prev = rightmost_;
+                if(rightmost_ != nullptr) rightmost_->next = leaf;
+                else leftmost_ = leaf;
+                rightmost_ = leaf;
+                level.push_back(leaf);
+
+                for(size_type k = 0;k < cnt;++k,++first){
+                    auto&& v = *first;
+                    const Key& key = key_of(v,is_map{});
+                    MYSTL_DEBUG(last_key == nullptr || comp_(*last_key,key));
+                    hxqstl::construct(leaf->key_data() + k,key);
+                    try{
+                        leaf->value_construct(k,v);
+                    }
+                    catch(...){
+                        hxqstl::destroy(leaf->key_data() + k);
+                        throw;
+                    }
+                    ++leaf->count;
+                    last_key = leaf->key_data() + k;
+                }
+                mins.push_back(leaf->key(0));
+                rest -= cnt;
+            }
+
+            while(level.size() > 1){
+                const size_type child_count = level.size();
+                const size_type parent_count = (child_count + node_slots) / (node_slots + 1);
+                hxqstl::vector<node_type*> up;
+                hxqstl::vector<Key> up_mins;
+                up.reserve(parent_count);
+                up_mins.reserve(parent_count);
+                try{
+                    size_type c = 0;
+                    rest = child_count;
+                    for(size_type pi = 0;pi < parent_count;++pi){
+                        const size_type take = rest / (parent_count - pi);
+                        inner_type* inner = new_inner();
+                        up.push_back(inner);
+                        inner->children[0] = level[c];
+                        level[c] = nullptr;
+                        up_mins.push_back(hxqstl::move(mins[c]));
+                        ++c;
+                        for(size_type k = 1;k < take;++k,++c){
+                            hxqstl::construct(inner->key_data() + inner->count,hxqstl::move(mins[c]));
+                            ++inner->count;
+                            inner->children[inner->count] = level[c];
+                            level[c] = nullptr;
+                        }
+                        rest -= take;
+                    }
+                }
+                catch(...){
+                    for(size_type i = 0;i < up.size();++i) free_subtree(up[i]);
+                    throw;
+                }
+                level.swap(up);
+                mins.swap(up_mins);
+            }
+            root_ = level[0];
+            size_ = n;
+        }
+        catch(...){
+            for(size_type i = 0;i < level.size();++i){
+                if(level[i] != nullptr) free_subtree(level[i]);
+            }
+            root_ = nullptr;
+            leftmost_ = nullptr;
+            rightmost_ = nullptr;
+            size_ = 0;
+            throw;
+        }
+    }
+}
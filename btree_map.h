@@ -0,0 +1,179 @@
+#pragma once
+
+// btree_map
+// 基于 B+ 树的有序映射，键和值在叶子中分别连续存放
+// 查找 O(log n)，但树高只有红黑树的几分之一，且每层只访问一个连续的节点
+// 迭代器解引用得到 pair<const Key&,T&> 的代理对象(与 flat_map 相同)
+// 任何插入、删除都会使迭代器和引用失效(与 std::map 不同)
+
+#include <initializer_list>
+
+#include "btree.h"
+
+namespace hxqstl{
+    template<class Key,class T,class Compare = hxqstl::less<Key>>
+    class btree_map{
+        private:
+            typedef btree<Key,T,Compare> base_type;
+            base_type tree_;
+
+        public:
+            typedef Key key_type;
+            typedef T mapped_type;
+            typedef hxqstl::pair<Key,T> value_type;
+            typedef Compare key_compare;
+
+            typedef typename base_type::size_type size_type;
+            typedef typename base_type::difference_type difference_type;
+            typedef typename base_type::iterator iterator;
+            typedef typename base_type::const_iterator const_iterator;
+            typedef typename iterator::reference reference;
+            typedef typename const_iterator::reference const_reference;
+
+        public:
+            btree_map() : tree_() {}
+
+            explicit btree_map(const Compare& comp) : tree_(comp) {}
+
+            template<class InputIter,typename std::enable_if<
+                hxqstl::is_input_iterator<InputIter>::value,int>::type = 0>
+            btree_map(InputIter first,InputIter last,const Compare& comp = Compare())
+            :tree_(comp)
+            {
+                insert(first,last);
+            }
+
+            btree_map(std::initializer_list<value_type> ilist,const Compare& comp = Compare())
+            :tree_(comp)
+            {
+                insert(ilist.begin(),ilist.end());
+            }
+
+            btree_map(const btree_map& rhs) = default;
+            btree_map(btree_map&& rhs) noexcept = default;
+            btree_map& operator=(const btree_map& rhs) = default;
+            btree_map& operator=(btree_map&& rhs) noexcept = default;
+            ~btree_map() = default;
+
+        public:
+            iterator begin() noexcept {return tree_.begin();}
+            const_iterator begin() const noexcept {return tree_.begin();}
+            iterator end() noexcept {return tree_.end();}
+            const_iterator end() const noexcept {return tree_.end();}
+            const_iterator cbegin() const noexcept {return begin();}
+            const_iterator cend() const noexcept {return end();}
+
+            bool empty() const noexcept {return tree_.empty();}
+            size_type size() const noexcept {return tree_.size();}
+            size_type max_size() const noexcept {return static_cast<size_type>(-1) / sizeof(value_type);}
+
+            key_compare key_comp() const {return tree_.key_comp();}
+
+            mapped_type& operator[](const key_type& key)
+            { return try_emplace(key).first.value(); }
+            mapped_type& operator[](key_type&& key)
+            { return try_emplace(hxqstl::move(key)).first.value(); }
+
+            mapped_type& at(const key_type& key)
+            {
+                iterator it = find(key);
+                THROW_OUT_OF_RANGE_IF(it == end(),"btree_map<Key,T> no such element exists");
+                return it.value();
+            }
+            const mapped_type& at(const key_type& key) const
+            {
+                const_iterator it = find(key);
+                THROW_OUT_OF_RANGE_IF(it == end(),"btree_map<Key,T> no such element exists");
+                return it.value();
+            }
+
+            hxqstl::pair<iterator,bool> insert(const value_type& value)
+            { return try_emplace(value.first,value.second); }
+            hxqstl::pair<iterator,bool> insert(value_type&& value)
+            { return try_emplace(hxqstl::move(value.first),hxqstl::move(value.second)); }
+
+            template<class InputIter>
+            void insert(InputIter first,InputIter last)
+            {
+                for(;first != last;++first){
+                    insert(*first);
+                }
+            }
+            void insert(std::initializer_list<value_type> ilist)
+            { insert(ilist.begin(),ilist.end()); }
+
+            template<class... Args>
+            hxqstl::pair<iterator,bool> emplace(Args&&... args)
+            {
+                value_type tmp(hxqstl::forward<Args>(args)...);
+                return insert(hxqstl::move(tmp));
+            }
+
+            template<class K,class... Args>
+            hxqstl::pair<iterator,bool> try_emplace(K&& key,Args&&... args)
+            { return tree_.try_emplace(hxqstl::forward<K>(key),hxqstl::forward<Args>(args)...); }
+
+            template<class M>
+            hxqstl::pair<iterator,bool> insert_or_assign(const key_type& key,M&& obj)
+            {
+                auto res = try_emplace(key,hxqstl::forward<M>(obj));
+                if(!res.second){
+                    res.first.value() = hxqstl::forward<M>(obj);
+                }
+                return res;
+            }
+
+            // 用严格按键递增的数据整体重建，自底向上建树，比逐个插入快得多且叶子全满
+            void bulk_load(const hxqstl::vector<value_type>& sorted)
+            { tree_.assign_sorted(sorted.begin(),sorted.size()); }
+            template<class ForwardIter>
+            void bulk_load(ForwardIter first,ForwardIter last)
+            { tree_.assign_sorted(first,static_cast<size_type>(hxqstl::distance(first,last))); }
+
+            iterator erase(const_iterator pos) {return tree_.erase(pos);}
+            iterator erase(const_iterator first,const_iterator last) {return tree_.erase(first,last);}
+            size_type erase(const key_type& key) {return tree_.erase(key);}
+
+            void clear() noexcept {tree_.clear();}
+            void swap(btree_map& rhs) noexcept {tree_.swap(rhs.tree_);}
+
+            iterator lower_bound(const key_type& key) {return tree_.lower_bound(key);}
+            const_iterator lower_bound(const key_type& key) const {return tree_.lower_bound(key);}
+            iterator upper_bound(const key_type& key) {return tree_.upper_bound(key);}
+            const_iterator upper_bound(const key_type& key) const {return tree_.upper_bound(key);}
+            hxqstl::pair<iterator,iterator> equal_range(const key_type& key)
+            { return hxqstl::pair<iterator,iterator>(lower_bound(key),upper_bound(key)); }
+            hxqstl::pair<const_iterator,const_iterator> equal_range(const key_type& key) const
+            { return hxqstl::pair<const_iterator,const_iterator>(lower_bound(key),upper_bound(key)); }
+
+            iterator find(const key_type& key) {return tree_.find(key);}
+            const_iterator find(const key_type& key) const {return tree_.find(key);}
+            bool contains(const key_type& key) const {return find(key) != end();}
+            size_type count(const key_type& key) const {return contains(key) ? 1 : 0;}
+    };
+
+    /*****************************************************************************************/
+
+    template<class Key,class T,class Compare>
+    bool operator==(const btree_map<Key,T,Compare>& lhs,const btree_map<Key,T,Compare>& rhs)
+    {
+        if(lhs.size() != rhs.size()) return false;
+        auto r = rhs.begin();
+        for(auto l = lhs.begin();l != lhs.end();++l,++r){
+            if(!(l.key() == r.key()) || !(l.value() == r.value())) return false;
+        }
+        return true;
+    }
+
+    template<class Key,class T,class Compare>
+    bool operator!=(const btree_map<Key,T,Compare>& lhs,const btree_map<Key,T,Compare>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template<class Key,class T,class Compare>
+    void swap(btree_map<Key,T,Compare>& lhs,btree_map<Key,T,Compare>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+}
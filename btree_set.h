@@ -0,0 +1,136 @@
+#pragma once
+
+// btree_set
+// 基于 B+ 树的有序集合，叶子中只保存连续的键数组
+// 任何插入、删除都会使迭代器和引用失效(与 std::set 不同)
+
+#include <initializer_list>
+
+#include "btree.h"
+
+namespace hxqstl{
+    template<class Key,class Compare = hxqstl::less<Key>>
+    class btree_set{
+        private:
+            typedef btree<Key,void,Compare> base_type;
+            base_type tree_;
+
+        public:
+            typedef Key key_type;
+            typedef Key value_type;
+            typedef Compare key_compare;
+            typedef Compare value_compare;
+
+            typedef typename base_type::size_type size_type;
+            typedef typename base_type::difference_type difference_type;
+            typedef const Key& reference;
+            typedef const Key& const_reference;
+
+            // 集合的元素不可修改，iterator 与 const_iterator 相同
+            typedef typename base_type::const_iterator iterator;
+            typedef typename base_type::const_iterator const_iterator;
+
+        public:
+            btree_set() : tree_() {}
+
+            explicit btree_set(const Compare& comp) : tree_(comp) {}
+
+            template<class InputIter,typename std::enable_if<
+                hxqstl::is_input_iterator<InputIter>::value,int>::type = 0>
+            btree_set(InputIter first,InputIter last,const Compare& comp = Compare())
+            :tree_(comp)
+            {
+                insert(first,last);
+            }
+
+            btree_set(std::initializer_list<value_type> ilist,const Compare& comp = Compare())
+            :tree_(comp)
+            {
+                insert(ilist.begin(),ilist.end());
+            }
+
+            btree_set(const btree_set& rhs) = default;
+            btree_set(btree_set&& rhs) noexcept = default;
+            btree_set& operator=(const btree_set& rhs) = default;
+            btree_set& operator=(btree_set&& rhs) noexcept = default;
+            ~btree_set() = default;
+
+        public:
+            const_iterator begin() const noexcept {return tree_.begin();}
+            const_iterator end() const noexcept {return tree_.end();}
+            const_iterator cbegin() const noexcept {return begin();}
+            const_iterator cend() const noexcept {return end();}
+
+            bool empty() const noexcept {return tree_.empty();}
+            size_type size() const noexcept {return tree_.size();}
+            size_type max_size() const noexcept {return static_cast<size_type>(-1) / sizeof(value_type);}
+
+            key_compare key_comp() const {return tree_.key_comp();}
+            value_compare value_comp() const {return tree_.key_comp();}
+
+            hxqstl::pair<iterator,bool> insert(const value_type& value)
+            { return tree_.try_emplace(value); }
+            hxqstl::pair<iterator,bool> insert(value_type&& value)
+            { return tree_.try_emplace(hxqstl::move(value)); }
+
+            template<class InputIter>
+            void insert(InputIter first,InputIter last)
+            {
+                for(;first != last;++first){
+                    insert(*first);
+                }
+            }
+            void insert(std::initializer_list<value_type> ilist)
+            { insert(ilist.begin(),ilist.end()); }
+
+            template<class... Args>
+            hxqstl::pair<iterator,bool> emplace(Args&&... args)
+            {
+                value_type tmp(hxqstl::forward<Args>(args)...);
+                return insert(hxqstl::move(tmp));
+            }
+
+            // 用严格递增的数据整体重建，自底向上建树，比逐个插入快得多且叶子全满
+            void bulk_load(const hxqstl::vector<value_type>& sorted)
+            { tree_.assign_sorted(sorted.begin(),sorted.size()); }
+            template<class ForwardIter>
+            void bulk_load(ForwardIter first,ForwardIter last)
+            { tree_.assign_sorted(first,static_cast<size_type>(hxqstl::distance(first,last))); }
+
+            iterator erase(const_iterator pos) {return tree_.erase(pos);}
+            iterator erase(const_iterator first,const_iterator last) {return tree_.erase(first,last);}
+            size_type erase(const key_type& key) {return tree_.erase(key);}
+
+            void clear() noexcept {tree_.clear();}
+            void swap(btree_set& rhs) noexcept {tree_.swap(rhs.tree_);}
+
+            const_iterator lower_bound(const key_type& key) const {return tree_.lower_bound(key);}
+            const_iterator upper_bound(const key_type& key) const {return tree_.upper_bound(key);}
+            hxqstl::pair<const_iterator,const_iterator> equal_range(const key_type& key) const
+            { return hxqstl::pair<const_iterator,const_iterator>(lower_bound(key),upper_bound(key)); }
+
+            const_iterator find(const key_type& key) const {return tree_.find(key);}
+            bool contains(const key_type& key) const {return find(key) != end();}
+            size_type count(const key_type& key) const {return contains(key) ? 1 : 0;}
+    };
+
+    /*****************************************************************************************/
+
+    template<class Key,class Compare>
+    bool operator==(const btree_set<Key,Compare>& lhs,const btree_set<Key,Compare>& rhs)
+    {
+        return lhs.size() == rhs.size() && hxqstl::equal(lhs.begin(),lhs.end(),rhs.begin());
+    }
+
+    template<class Key,class Compare>
+    bool operator!=(const btree_set<Key,Compare>& lhs,const btree_set<Key,Compare>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template<class Key,class Compare>
+    void swap(btree_set<Key,Compare>& lhs,btree_set<Key,Compare>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+}
@@ -0,0 +1,494 @@
+#pragma once
+
+// circular_buffer
+// 容量固定的环形缓冲区：只在构造或 set_capacity 时申请一次内存，之后的 push/pop 都不再分配
+// 满了以后 push_back 覆盖最旧的元素(队头)，push_front 覆盖最新的元素(队尾)，适合做滑动窗口
+// 元素在内存中最多分成两段连续区间：array_one() 是从队头到缓冲区末尾的部分，array_two() 是绕回开头的部分，
+// 两段都可以直接交给 memcpy 或向量化的计算核；linearize() 原地把元素挪成一段连续区间
+// 迭代器是分段迭代器，copy/fill 等 algobase 算法会逐段走指针版本
+// 要求元素的移动构造/移动赋值不抛出异常
+
+#include <initializer_list>
+
+#include "algobase.h"
+#include "allocator.h"
+#include "construct.h"
+#include "iterator.h"
+#include "uninitialized.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace hxqstl{
+    // 按逻辑下标访问的随机访问迭代器，下标 0 为队头
+    template<class CB,class Ref,class Ptr>
+    struct cb_iterator : public iterator<random_access_iterator_tag,typename CB::value_type>
+    {
+        typedef typename CB::value_type value_type;
+        typedef Ptr pointer;
+        typedef Ref reference;
+        typedef typename CB::size_type size_type;
+        typedef ptrdiff_t difference_type;
+        typedef cb_iterator self;
+
+        CB* cb;
+        size_type idx;
+
+        cb_iterator() noexcept : cb(nullptr),idx(0) {}
+        cb_iterator(CB* c,size_type i) noexcept : cb(c),idx(i) {}
+
+        // 允许 iterator 转换为 const_iterator
+        template<class R,class P>
+        cb_iterator(const cb_iterator<typename std::remove_const<CB>::type,R,P>& rhs) noexcept
+            :cb(rhs.cb),idx(rhs.idx) {}
+
+        reference operator*() const {return (*cb)[idx];}
+        pointer operator->() const {return &(operator*());}
+        reference operator[](difference_type n) const {return (*cb)[idx + n];}
+
+        self& operator++() {++idx;return *this;}
+        self operator++(int) {self tmp = *this;++idx;return tmp;}
+        self& operator--() {--idx;return *this;}
+        self operator--(int) {self tmp = *this;--idx;return tmp;}
+        self& operator+=(difference_type n) {idx += n;return *this;}
+        self& operator-=(difference_type n) {idx -= n;return *this;}
+        self operator+(difference_type n) const {return self(cb,idx + n);}
+        self operator-(difference_type n) const {return self(cb,idx - n);}
+        difference_type operator-(const self& rhs) const {
+            return static_cast<difference_type>(idx) - static_cast<difference_type>(rhs.idx);
+        }
+
+        bool operator==(const self& rhs) const {return idx == rhs.idx;}
+        bool operator!=(const self& rhs) const {return idx != rhs.idx;}
+        bool operator<(const self& rhs) const {return idx < rhs.idx;}
+        bool operator>(const self& rhs) const {return rhs < *this;}
+        bool operator<=(const self& rhs) const {return !(rhs < *this);}
+        bool operator>=(const self& rhs) const {return !(*this < rhs);}
+    };
+
+    template<class T>
+    class circular_buffer{
+        public:
+            typedef hxqstl::allocator<T> allocator_type;
+            typedef hxqstl::allocator<T> data_allocator;
+
+            typedef typename allocator_type::value_type value_type;
+            typedef typename allocator_type::pointer pointer;
+            typedef typename allocator_type::const_pointer const_pointer;
+            typedef typename allocator_type::reference reference;
+            typedef typename allocator_type::const_reference const_reference;
+            typedef typename allocator_type::size_type size_type;
+            typedef typename allocator_type::difference_type difference_type;
+
+            typedef cb_iterator<circular_buffer,T&,T*> iterator;
+            typedef cb_iterator<const circular_buffer,const T&,const T*> const_iterator;
+            typedef hxqstl::reverse_iterator<iterator> reverse_iterator;
+            typedef hxqstl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+            // 一段连续存放的元素：起始地址和个数
+            typedef hxqstl::pair<pointer,size_type> array_range;
+            typedef hxqstl::pair<const_pointer,size_type> const_array_range;
+
+        private:
+            pointer buf_;
+            size_type cap_;
+            size_type head_;    // 队头所在的物理下标
+            size_type size_;
+
+        public:
+            circular_buffer() noexcept : buf_(nullptr),cap_(0),head_(0),size_(0) {}
+
+            explicit circular_buffer(size_type capacity)
+            :buf_(nullptr),cap_(0),head_(0),size_(0)
+            {
+                init_space(capacity);
+            }
+
+            circular_buffer(size_type capacity,size_type n,const value_type& value)
+            :buf_(nullptr),cap_(0),head_(0),size_(0)
+            {
+                MYSTL_DEBUG(n <= capacity);
+                init_space(capacity);
+                fill_assign(n,value);
+            }
+
+            // 容量取 [first,last) 的长度
+            template<class ForwardIter,typename std::enable_if<
+                hxqstl::is_forward_iterator<ForwardIter>::value,int>::type = 0>
+            circular_buffer(ForwardIter first,ForwardIter last)
+            :buf_(nullptr),cap_(0),head_(0),size_(0)
+            {
+                init_space(static_cast<size_type>(hxqstl::distance(first,last)));
+                range_assign(first,last);
+            }
+
+            circular_buffer(std::initializer_list<value_type> ilist)
+            :circular_buffer(ilist.begin(),ilist.end()) {}
+
+            circular_buffer(const circular_buffer& rhs)
+            :buf_(nullptr),cap_(0),head_(0),size_(0)
+            {
+                init_space(rhs.cap_);
+                range_assign(rhs.begin(),rhs.end());
+            }
+
+            circular_buffer(circular_buffer&& rhs) noexcept
+            :buf_(rhs.buf_),cap_(rhs.cap_),head_(rhs.head_),size_(rhs.size_)
+            {
+                rhs.buf_ = nullptr;
+                rhs.cap_ = 0;
+                rhs.head_ = 0;
+                rhs.size_ = 0;
+            }
+
+            circular_buffer& operator=(const circular_buffer& rhs)
+            {
+                if(this != &rhs){
+                    circular_buffer tmp(rhs);
+                    swap(tmp);
+                }
+                return *this;
+            }
+
+            circular_buffer& operator=(circular_buffer&& rhs) noexcept
+            {
+                circular_buffer tmp(hxqstl::move(rhs));
+                swap(tmp);
+                return *this;
+            }
+
+            ~circular_buffer()
+            {
+                clear();
+                data_allocator::deallocate(buf_,cap_);
+            }
+
+        public:
+            iterator begin() noexcept {return iterator(this,0);}
+            const_iterator begin() const noexcept {return const_iterator(this,0);}
+            iterator end() noexcept {return iterator(this,size_);}
+            const_iterator end() const noexcept {return const_iterator(this,size_);}
+            const_iterator cbegin() const noexcept {return begin();}
+            const_iterator cend() const noexcept {return end();}
+            reverse_iterator rbegin() noexcept {return reverse_iterator(end());}
+            const_reverse_iterator rbegin() const noexcept {return const_reverse_iterator(end());}
+            reverse_iterator rend() noexcept {return reverse_iterator(begin());}
+            const_reverse_iterator rend() const noexcept {return const_reverse_iterator(begin());}
+
+            bool empty() const noexcept {return size_ == 0;}
+            bool full() const noexcept {return size_ == cap_;}
+            size_type size() const noexcept {return size_;}
+            size_type capacity() const noexcept {return cap_;}
+            size_type max_size() const noexcept {return static_cast<size_type>(-1) / sizeof(T);}
+
+            reference operator[](size_type n)
+            {
+                MYSTL_DEBUG(n < size_);
+                return buf_[physical(n)];
+            }
+            const_reference operator[](size_type n) const
+            {
+                MYSTL_DEBUG(n < size_);
+                return buf_[physical(n)];
+            }
+            reference at(size_type n)
+            {
+                THROW_OUT_OF_RANGE_IF(!(n < size_),"circular_buffer<T>::at() subscript out of range");
+                return (*this)[n];
+            }
+            const_reference at(size_type n) const
+            {
+                THROW_OUT_OF_RANGE_IF(!(n < size_),"circular_buffer<T>::at() subscript out of range");
+                return (*this)[n];
+            }
+
+            reference front()
+            {
+                MYSTL_DEBUG(!empty());
+                return buf_[head_];
+            }
+            const_reference front() const
+            {
+                MYSTL_DEBUG(!empty());
+                return buf_[head_];
+            }
+            reference back()
+            {
+                MYSTL_DEBUG(!empty());
+                return buf_[physical(size_ - 1)];
+            }
+            const_reference back() const
+            {
+                MYSTL_DEBUG(!empty());
+                return buf_[physical(size_ - 1)];
+            }
+
+            // 两段连续区间，按逻辑顺序先 one 后 two；没有绕回时 array_two() 为空
+            array_range array_one() noexcept
+            { return array_range(buf_ + head_,first_part()); }
+            const_array_range array_one() const noexcept
+            { return const_array_range(buf_ + head_,first_part()); }
+            array_range array_two() noexcept
+            { return array_range(buf_,size_ - first_part()); }
+            const_array_range array_two() const noexcept
+            { return const_array_range(buf_,size_ - first_part()); }
+
+            bool is_linearized() const noexcept {return head_ + size_ <= cap_;}
+
+            // 原地把元素挪成从 buf_ 开始的一段连续区间并返回首地址，已经连续时不移动
+            pointer linearize() noexcept;
+
+            // 满时覆盖队头(最旧的元素)
+            void push_back(const value_type& value) {emplace_back(value);}
+            void push_back(value_type&& value) {emplace_back(hxqstl::move(value));}
+
+            template<class... Args>
+            void emplace_back(Args&&... args);
+
+            // 满时覆盖队尾(最新的元素)
+            void push_front(const value_type& value) {emplace_front(value);}
+            void push_front(value_type&& value) {emplace_front(hxqstl::move(value));}
+
+            template<class... Args>
+            void emplace_front(Args&&... args);
+
+            void pop_front()
+            {
+                MYSTL_DEBUG(!empty());
+                hxqstl::destroy(buf_ + head_);
+                head_ = head_ + 1 == cap_ ? 0 : head_ + 1;
+                --size_;
+            }
+            void pop_back()
+            {
+                MYSTL_DEBUG(!empty());
+                hxqstl::destroy(buf_ + physical(size_ - 1));
+                --size_;
+            }
+
+            // 丢弃最旧的 n 个元素
+            void erase_begin(size_type n);
+
+            void clear() noexcept
+            {
+                const size_type one = first_part();
+                hxqstl::destroy(buf_ + head_,buf_ + head_ + one);
+                hxqstl::destroy(buf_,buf_ + (size_ - one));
+                head_ = 0;
+                size_ = 0;
+            }
+
+            // 重新申请容量为 n 的缓冲区，保留最新的 min(size(),n) 个元素
+            void set_capacity(size_type n);
+
+            void swap(circular_buffer& rhs) noexcept
+            {
+                hxqstl::swap(buf_,rhs.buf_);
+                hxqstl::swap(cap_,rhs.cap_);
+                hxqstl::swap(head_,rhs.head_);
+                hxqstl::swap(size_,rhs.size_);
+            }
+
+        private:
+            template<class Iter>
+            friend struct segmented_iterator_traits;
+
+            // 逻辑下标换算成物理下标，n 不超过 size_ 时不会绕回两次，用比较代替取模
+            size_type physical(size_type n) const noexcept
+            {
+                return n < cap_ - head_ ? head_ + n : n - (cap_ - head_);
+            }
+            size_type first_part() const noexcept
+            {
+                return hxqstl::min(size_,cap_ - head_);
+            }
+
+            void init_space(size_type n)
+            {
+                THROW_LENGTH_ERROR_IF(n > max_size(),"circular_buffer<T>'s capacity too big");
+                buf_ = n == 0 ? nullptr : data_allocator::allocate(n);
+                cap_ = n;
+            }
+            // 以下两个函数在构造函数中使用，失败时释放缓冲区
+            void fill_assign(size_type n,const value_type& value);
+            template<class Iter>
+            void range_assign(Iter first,Iter last);
+
+            static void reverse_range(pointer first,pointer last) noexcept
+            {
+                while(first < last){
+                    hxqstl::iter_swap(first++,--last);
+                }
+            }
+    };
+
+    // 让 copy/fill 等算法把 circular_buffer 的区间拆成至多两段指针区间处理
+    // 第 0 段是 [head_,cap_)，第 1 段是绕回开头的 [0,tail)
+    template<class CB,class Ref,class Ptr>
+    struct segmented_iterator_traits<cb_iterator<CB,Ref,Ptr>>
+    {
+        typedef m_true_type is_segmented;
+        typedef cb_iterator<CB,Ref,Ptr> iterator;
+        typedef typename CB::size_type size_type;
+        typedef Ptr local_iterator;
+
+        struct segment_iterator
+        {
+            CB* cb;
+            size_type k;
+
+            segment_iterator& operator++() {++k;return *this;}
+            segment_iterator& operator--() {--k;return *this;}
+            bool operator==(const segment_iterator& rhs) const {return k == rhs.k;}
+            bool operator!=(const segment_iterator& rhs) const {return k != rhs.k;}
+        };
+
+        static segment_iterator segment(const iterator& it) noexcept
+        { return segment_iterator{it.cb,it.idx < it.cb->cap_ - it.cb->head_ ? size_type(0) : size_type(1)}; }
+        static local_iterator local(const iterator& it) noexcept
+        { return it.cb->buf_ + it.cb->physical(it.idx); }
+        static local_iterator begin(const segment_iterator& seg) noexcept
+        { return seg.k == 0 ? seg.cb->buf_ + seg.cb->head_ : seg.cb->buf_; }
+        static local_iterator end(const segment_iterator& seg) noexcept
+        { return seg.k == 0 ? seg.cb->buf_ + seg.cb->cap_ : seg.cb->buf_ + seg.cb->physical(seg.cb->size_); }
+    };
+
+    /*****************************************************************************************/
+
+    template<class T>
+    void circular_buffer<T>::fill_assign(size_type n,const value_type& value){
+        try{
+            hxqstl::uninitialized_fill_n(buf_,n,value);
+        }
+        catch(...){
+            data_allocator::deallocate(buf_,cap_);
+            buf_ = nullptr;
+            cap_ = 0;
+            throw;
+        }
+        size_ = n;
+    }
+
+    template<class T>
+    template<class Iter>
+    void circular_buffer<T>::range_assign(Iter first,Iter last){
+        try{
+            hxqstl::uninitialized_copy(first,last,buf_);
+        }
+        catch(...){
+            data_allocator::deallocate(buf_,cap_);
+            buf_ = nullptr;
+            cap_ = 0;
+            throw;
+        }
+        size_ = static_cast<size_type>(hxqstl::distance(first,last));
+    }
+
+    template<class T>
+    template<class... Args>
+    void circular_buffer<T>::emplace_back(Args&&... args){
+        if(cap_ == 0) return;
+        if(size_ == cap_){
+            // 队尾的下一个位置就是队头，覆盖后队头后移一格
+            buf_[head_] = value_type(hxqstl::forward<Args>(args)...);
+            head_ = head_ + 1 == cap_ ? 0 : head_ + 1;
+            return;
+        }
+        data_allocator::construct(buf_ + physical(size_),hxqstl::forward<Args>(args)...);
+        ++size_;
+    }
+
+    template<class T>
+    template<class... Args>
+    void circular_buffer<T>::emplace_front(Args&&... args){
+        if(cap_ == 0) return;
+        const size_type pos = head_ == 0 ? cap_ - 1 : head_ - 1;
+        if(size_ == cap_){
+            // 队头的前一个位置就是队尾
+            buf_[pos] = value_type(hxqstl::forward<Args>(args)...);
+            head_ = pos;
+            return;
+        }
+        data_allocator::construct(buf_ + pos,hxqstl::forward<Args>(args)...);
+        head_ = pos;
+        ++size_;
+    }
+
+    template<class T>
+    void circular_buffer<T>::erase_begin(size_type n){
+        MYSTL_DEBUG(n <= size_);
+        const size_type one = hxqstl::min(n,cap_ - head_);
+        hxqstl::destroy(buf_ + head_,buf_ + head_ + one);
+        hxqstl::destroy(buf_,buf_ + (n - one));
+        head_ = size_ == n ? 0 : physical(n);
+        size_ -= n;
+    }
+
+    template<class T>
+    typename circular_buffer<T>::pointer circular_buffer<T>::linearize() noexcept{
+        if(is_linearized()) return buf_ + head_;
+        // 绕回时前一段在 [head_,cap_)，后一段在 [0,b)
+        // 先把前一段左移紧贴在后一段之后，得到 [后一段,前一段]，再把 [0,size_) 循环左移 b 个位置
+        const size_type a = cap_ - head_;
+        const size_type b = size_ - a;
+        if(b + a < cap_){
+            for(size_type i = 0;i < a;++i){
+                pointer dst = buf_ + b + i;
+                pointer src = buf_ + head_ + i;
+                if(dst < buf_ + head_){
+                    data_allocator::construct(dst,hxqstl::move(*src));
+                }
+                else{
+                    *dst = hxqstl::move(*src);
+                }
+            }
+            hxqstl::destroy(buf_ + hxqstl::max(head_,b + a),buf_ + cap_);
+        }
+        reverse_range(buf_,buf_ + b);
+        reverse_range(buf_ + b,buf_ + size_);
+        reverse_range(buf_,buf_ + size_);
+        head_ = 0;
+        return buf_;
+    }
+
+    template<class T>
+    void circular_buffer<T>::set_capacity(size_type n){
+        if(n == cap_) return;
+        THROW_LENGTH_ERROR_IF(n > max_size(),"circular_buffer<T>'s capacity too big");
+        pointer fresh = n == 0 ? nullptr : data_allocator::allocate(n);
+        const size_type keep = hxqstl::min(size_,n);
+        const size_type drop = size_ - keep;
+        try{
+            hxqstl::uninitialized_move(begin() + drop,end(),fresh);
+        }
+        catch(...){
+            data_allocator::deallocate(fresh,n);
+            throw;
+        }
+        clear();
+        data_allocator::deallocate(buf_,cap_);
+        buf_ = fresh;
+        cap_ = n;
+        head_ = 0;
+        size_ = keep;
+    }
+
+    /*****************************************************************************************/
+
+    template<class T>
+    bool operator==(const circular_buffer<T>& lhs,const circular_buffer<T>& rhs)
+    {
+        return lhs.size() == rhs.size() && hxqstl::equal(lhs.begin(),lhs.end(),rhs.begin());
+    }
+
+    template<class T>
+    bool operator!=(const circular_buffer<T>& lhs,const circular_buffer<T>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template<class T>
+    void swap(circular_buffer<T>& lhs,circular_buffer<T>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+}
@@ -0,0 +1,297 @@
+#pragma once
+
+// concurrent_hash_map
+// 按哈希值分片的并发哈希表：每个分片是一个独立的 flat_hash_map，带自己的读写自旋锁
+// 不同分片上的操作完全互不影响，没有任何全局锁；同一分片上读操作可以并行，写操作互斥
+// 分片下标取混合后哈希值的高位，分片内部的 flat_hash_map 用的是低位，两者互不相关
+// 不提供迭代器：元素只能在持有分片锁时通过 find 复制出来或通过 visit 回调访问
+// 回调在持锁状态下执行，不能在回调中再访问同一个 concurrent_hash_map
+
+#include <atomic>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#include "alloc.h"
+#include "concurrent_queue.h"
+#include "construct.h"
+#include "flat_hash_map.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace hxqstl{
+    // 自旋等待时让出流水线
+    inline void cpu_relax() noexcept{
+#if defined(__SSE2__) || defined(_M_X64)
+        _mm_pause();
+#endif
+    }
+
+    // 读写自旋锁
+    // state_ 的第 0 位表示写者持有，第 1 位表示有写者在等待，其余位为读者计数
+    // 有写者等待时新的读者不再进入，避免读多写少时写者饿死
+    class rw_spinlock{
+        private:
+            enum : uint32_t { kWriter = 1,kPending = 2,kReader = 4 };
+            std::atomic<uint32_t> state_;
+
+        public:
+            rw_spinlock() noexcept : state_(0) {}
+            rw_spinlock(const rw_spinlock&) = delete;
+            rw_spinlock& operator=(const rw_spinlock&) = delete;
+
+            void lock_shared() noexcept
+            {
+                while(true){
+                    uint32_t s = state_.load(std::memory_order_relaxed);
+                    if((s & (kWriter | kPending)) == 0 &&
+                       state_.compare_exchange_weak(s,s + kReader,std::memory_order_acquire,
+                                                    std::memory_order_relaxed)){
+                        return;
+                    }
+                    cpu_relax();
+                }
+            }
+            void unlock_shared() noexcept {state_.fetch_sub(kReader,std::memory_order_release);}
+
+            void lock() noexcept
+            {
+                while(true){
+                    uint32_t s = state_.load(std::memory_order_relaxed);
+                    // 没有读者也没有写者时，连同等待位一起换成写者位
+                    if((s & ~static_cast<uint32_t>(kPending)) == 0 &&
+                       state_.compare_exchange_weak(s,kWriter,std::memory_order_acquire,
+                                                    std::memory_order_relaxed)){
+                        return;
+                    }
+                    if((s & kPending) == 0) state_.fetch_or(kPending,std::memory_order_relaxed);
+                    cpu_relax();
+                }
+            }
+            void unlock() noexcept {state_.fetch_and(~static_cast<uint32_t>(kWriter),std::memory_order_release);}
+    };
+
+    template<class Key,class T,class Hash = hxqstl::hash<Key>,class KeyEqual = hxqstl::equal_to<Key>>
+    class concurrent_hash_map{
+        public:
+            typedef flat_hash_map<Key,T,Hash,KeyEqual> shard_map;
+            typedef Key key_type;
+            typedef T mapped_type;
+            typedef typename shard_map::value_type value_type;
+            typedef Hash hasher;
+            typedef KeyEqual key_equal;
+            typedef size_t size_type;
+
+        private:
+            // 每个分片独占 cache line，相邻分片的锁不会伪共享
+            struct alignas(ECacheLineSize) shard
+            {
+                mutable rw_spinlock lock;
+                shard_map map;
+
+                shard(const Hash& hash,const KeyEqual& equal) : lock(),map(0,hash,equal) {}
+            };
+
+            struct read_guard
+            {
+                const shard& s;
+                explicit read_guard(const shard& sh) noexcept : s(sh) {s.lock.lock_shared();}
+                ~read_guard() {s.lock.unlock_shared();}
+            };
+            struct write_guard
+            {
+                shard& s;
+                explicit write_guard(shard& sh) noexcept : s(sh) {s.lock.lock();}
+                ~write_guard() {s.lock.unlock();}
+            };
+
+            shard* shards_;
+            size_type shard_count_;
+            unsigned shard_shift_;      // 哈希值右移多少位得到分片下标
+            hasher hash_;
+
+        public:
+            // shard_count 为 0 时取硬件线程数的 4 倍，向上取整为 2 的幂
+            explicit concurrent_hash_map(size_type shard_count = 0,const Hash& hash = Hash(),
+                                         const KeyEqual& equal = KeyEqual());
+
+            concurrent_hash_map(const concurrent_hash_map&) = delete;
+            concurrent_hash_map& operator=(const concurrent_hash_map&) = delete;
+
+            ~concurrent_hash_map()
+            {
+                hxqstl::destroy(shards_,shards_ + shard_count_);
+                aligned_delete(shards_,align_val_t(alignof(shard)));
+            }
+
+        public:
+            // 找到时把值复制到 out
+            bool find(const key_type& key,mapped_type& out) const
+            {
+                const shard& s = shard_for(key);
+                read_guard guard(s);
+                auto it = s.map.find(key);
+                if(it == s.map.end()) return false;
+                out = it->second;
+                return true;
+            }
+
+            bool contains(const key_type& key) const
+            {
+                const shard& s = shard_for(key);
+                read_guard guard(s);
+                return s.map.contains(key);
+            }
+
+            // 持读锁调用 f(const value_type&)，返回是否找到
+            template<class F>
+            bool visit(const key_type& key,F f) const
+            {
+                const shard& s = shard_for(key);
+                read_guard guard(s);
+                auto it = s.map.find(key);
+                if(it == s.map.end()) return false;
+                f(*it);
+                return true;
+            }
+
+            // 持写锁调用 f(value_type&)，可以原地修改值
+            template<class F>
+            bool visit(const key_type& key,F f)
+            {
+                shard& s = shard_for(key);
+                write_guard guard(s);
+                auto it = s.map.find(key);
+                if(it == s.map.end()) return false;
+                f(*it);
+                return true;
+            }
+
+            // 逐个分片持读锁遍历，看到的不是整个表的一致快照
+            template<class F>
+            void visit_all(F f) const
+            {
+                for(size_type i = 0;i < shard_count_;++i){
+                    read_guard guard(shards_[i]);
+                    for(const auto& v : shards_[i].map) f(v);
+                }
+            }
+
+            // 返回是否插入了新元素，键已存在时不做任何修改
+            bool insert(const value_type& value)
+            {
+                shard& s = shard_for(value.first);
+                write_guard guard(s);
+                return s.map.insert(value).second;
+            }
+            bool insert(value_type&& value)
+            {
+                shard& s = shard_for(value.first);
+                write_guard guard(s);
+                return s.map.insert(hxqstl::move(value)).second;
+            }
+
+            template<class... Args>
+            bool try_emplace(const key_type& key,Args&&... args)
+            {
+                shard& s = shard_for(key);
+                write_guard guard(s);
+                return s.map.try_emplace(key,hxqstl::forward<Args>(args)...).second;
+            }
+
+            // 返回是否插入了新元素，键已存在时覆盖原值
+            template<class M>
+            bool insert_or_assign(const key_type& key,M&& obj)
+            {
+                shard& s = shard_for(key);
+                write_guard guard(s);
+                return s.map.insert_or_assign(key,hxqstl::forward<M>(obj)).second;
+            }
+
+            size_type erase(const key_type& key)
+            {
+                shard& s = shard_for(key);
+                write_guard guard(s);
+                return s.map.erase(key);
+            }
+
+            // 以下操作逐个分片加锁，并发修改时结果只是近似值
+            size_type size() const
+            {
+                size_type n = 0;
+                for(size_type i = 0;i < shard_count_;++i){
+                    read_guard guard(shards_[i]);
+                    n += shards_[i].map.size();
+                }
+                return n;
+            }
+            bool empty() const {return size() == 0;}
+
+            void clear()
+            {
+                for(size_type i = 0;i < shard_count_;++i){
+                    write_guard guard(shards_[i]);
+                    shards_[i].map.clear();
+                }
+            }
+
+            // 按均匀分布为每个分片预留空间
+            void reserve(size_type n)
+            {
+                const size_type per_shard = (n + shard_count_ - 1) / shard_count_;
+                for(size_type i = 0;i < shard_count_;++i){
+                    write_guard guard(shards_[i]);
+                    shards_[i].map.reserve(per_shard);
+                }
+            }
+
+            size_type shard_count() const noexcept {return shard_count_;}
+            hasher hash_function() const {return hash_;}
+
+        private:
+            size_type shard_index(const key_type& key) const
+            {
+                // 只有一个分片时移位量为 64，需要单独处理
+                if(shard_count_ == 1) return 0;
+                return swiss::mix(static_cast<size_type>(hash_(key))) >> shard_shift_;
+            }
+            shard& shard_for(const key_type& key) {return shards_[shard_index(key)];}
+            const shard& shard_for(const key_type& key) const {return shards_[shard_index(key)];}
+    };
+
+    /*****************************************************************************************/
+
+    template<class Key,class T,class Hash,class KeyEqual>
+    concurrent_hash_map<Key,T,Hash,KeyEqual>::concurrent_hash_map(size_type shard_count,const Hash& hash,
+                                                                  const KeyEqual& equal)
+    :shards_(nullptr),shard_count_(1),shard_shift_(0),hash_(hash)
+    {
+        if(shard_count == 0){
+            const size_type hw = std::thread::hardware_concurrency();
+            shard_count = (hw == 0 ? 4 : hw) * 4;
+        }
+        THROW_LENGTH_ERROR_IF(shard_count > (static_cast<size_type>(1) << 16),
+                              "concurrent_hash_map<Key,T> too many shards");
+        unsigned bits = 0;
+        while(shard_count_ < shard_count){
+            shard_count_ <<= 1;
+            ++bits;
+        }
+        shard_shift_ = static_cast<unsigned>(sizeof(size_type) * 8) - bits;
+
+        shards_ = static_cast<shard*>(aligned_new(shard_count_ * sizeof(shard),align_val_t(alignof(shard))));
+        size_type i = 0;
+        try{
+            for(;i < shard_count_;++i){
+                hxqstl::construct(shards_ + i,hash,equal);
+            }
+        }
+        catch(...){
+            hxqstl::destroy(shards_,shards_ + i);
+            aligned_delete(shards_,align_val_t(alignof(shard)));
+            throw;
+        }
+    }
+}
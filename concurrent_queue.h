@@ -0,0 +1,460 @@
+#pragma once
+
+// 无锁的有界队列
+// spsc_queue : 单生产者单消费者环形队列
+// mpmc_queue : 多生产者多消费者环形队列，每个槽位带序号(Dmitry Vyukov 的 bounded MPMC queue)
+// 容量向上取整为 2 的幂，读写下标单调递增，用掩码定位槽位
+// 读写下标各自独占一条 cache line，避免生产者与消费者之间的伪共享
+
+#include <atomic>
+#include <cstddef>
+
+#include "allocator.h"
+#include "construct.h"
+#include "util.h"
+#include "iterator.h"
+#include "exceptdef.h"
+
+namespace hxqstl{
+    enum{ECacheLineSize = 64};
+
+    // 向上取整到 2 的幂，至少为 2
+    inline size_t queue_round_up(size_t n){
+        size_t cap = 2;
+        while(cap < n){
+            THROW_LENGTH_ERROR_IF(cap > (static_cast<size_t>(-1) >> 1),"queue capacity too big");
+            cap <<= 1;
+        }
+        return cap;
+    }
+
+    /*****************************************************************************************/
+    // spsc_queue
+    // 生产者只写 tail_，消费者只写 head_，各自缓存对方的下标以减少 cache line 的来回传递
+    template<class T>
+    class spsc_queue{
+        public:
+            typedef hxqstl::allocator<T> allocator_type;
+            typedef hxqstl::allocator<T> data_allocator;
+
+            typedef typename allocator_type::value_type value_type;
+            typedef typename allocator_type::pointer pointer;
+            typedef typename allocator_type::size_type size_type;
+
+        private:
+            pointer buffer_;
+            size_type mask_;
+
+            alignas(ECacheLineSize) std::atomic<size_type> head_;
+            size_type cached_tail_;     // 消费者看到的 tail_
+
+            alignas(ECacheLineSize) std::atomic<size_type> tail_;
+            size_type cached_head_;     // 生产者看到的 head_
+
+        public:
+            explicit spsc_queue(size_type capacity)
+            :buffer_(nullptr),mask_(queue_round_up(capacity) - 1),
+             head_(0),cached_tail_(0),tail_(0),cached_head_(0)
+            {
+                buffer_ = data_allocator::allocate(mask_ + 1);
+            }
+
+            spsc_queue(const spsc_queue&) = delete;
+            spsc_queue& operator=(const spsc_queue&) = delete;
+
+            ~spsc_queue()
+            {
+                size_type head = head_.load(std::memory_order_relaxed);
+                const size_type tail = tail_.load(std::memory_order_relaxed);
+                for(;head != tail;++head){
+                    data_allocator::destroy(buffer_ + (head & mask_));
+                }
+                data_allocator::deallocate(buffer_,mask_ + 1);
+            }
+
+        public:
+            // 生产者接口
+            template<class... Args>
+            bool try_emplace(Args&&... args);
+
+            bool try_push(const value_type& value)
+            { return try_emplace(value); }
+            bool try_push(value_type&& value)
+            { return try_emplace(hxqstl::move(value)); }
+
+            // 最多写入 n 个元素，返回实际写入的个数，只发布一次 tail_
+            template<class InputIter>
+            size_type try_push_n(InputIter first,size_type n);
+
+            // 消费者接口
+            bool try_pop(value_type& value);
+
+            // 最多取出 n 个元素到 result，返回实际取出的个数，只发布一次 head_
+            template<class OutputIter>
+            size_type try_pop_n(OutputIter result,size_type n);
+
+            // 以下结果在并发时只是近似值
+            size_type size() const noexcept
+            {
+                // 先读 head_：之后读到的 tail_ 不会小于它
+                const size_type head = head_.load(std::memory_order_acquire);
+                const size_type tail = tail_.load(std::memory_order_acquire);
+                return tail > head ? tail - head : 0;
+            }
+            bool empty() const noexcept
+            { return size() == 0; }
+            size_type capacity() const noexcept
+            { return mask_ + 1; }
+
+        private:
+            size_type free_slots(size_type tail);
+            size_type ready_slots(size_type head);
+    };
+
+    // 缓存的 head_ 不够用时才去读共享的 head_
+    template<class T>
+    typename spsc_queue<T>::size_type spsc_queue<T>::free_slots(size_type tail){
+        size_type free = capacity() - (tail - cached_head_);
+        if(free == 0){
+            cached_head_ = head_.load(std::memory_order_acquire);
+            free = capacity() - (tail - cached_head_);
+        }
+        return free;
+    }
+
+    template<class T>
+    typename spsc_queue<T>::size_type spsc_queue<T>::ready_slots(size_type head){
+        size_type ready = cached_tail_ - head;
+        if(ready == 0){
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            ready = cached_tail_ - head;
+        }
+        return ready;
+    }
+
+    template<class T>
+    template<class... Args>
+    bool spsc_queue<T>::try_emplace(Args&&... args){
+        const size_type tail = tail_.load(std::memory_order_relaxed);
+        if(free_slots(tail) == 0){
+            return false;
+        }
+        data_allocator::construct(buffer_ + (tail & mask_),hxqstl::forward<Args>(args)...);
+        tail_.store(tail + 1,std::memory_order_release);
+        return true;
+    }
+
+    template<class T>
+    template<class InputIter>
+    typename spsc_queue<T>::size_type spsc_queue<T>::try_push_n(InputIter first,size_type n){
+        const size_type tail = tail_.load(std::memory_order_relaxed);
+        size_type free = free_slots(tail);
+        if(free < n){
+            // 不够时再刷新一次，尽量多写
+            cached_head_ = head_.load(std::memory_order_acquire);
+            free = capacity() - (tail - cached_head_);
+        }
+        const size_type cnt = free < n ? free : n;
+        size_type i = 0;
+        try{
+            for(;i < cnt;++i,++first){
+                data_allocator::construct(buffer_ + ((tail + i) & mask_),*first);
+            }
+        }
+        catch(...){
+            // 已经构造的元素照常发布
+            tail_.store(tail + i,std::memory_order_release);
+            throw;
+        }
+        tail_.store(tail + cnt,std::memory_order_release);
+        return cnt;
+    }
+
+    template<class T>
+    bool spsc_queue<T>::try_pop(value_type& value){
+        const size_type head = head_.load(std::memory_order_relaxed);
+        if(ready_slots(head) == 0){
+            return false;
+        }
+        pointer p = buffer_ + (head & mask_);
+        value = hxqstl::move(*p);
+        data_allocator::destroy(p);
+        head_.store(head + 1,std::memory_order_release);
+        return true;
+    }
+
+    template<class T>
+    template<class OutputIter>
+    typename spsc_queue<T>::size_type spsc_queue<T>::try_pop_n(OutputIter result,size_type n){
+        const size_type head = head_.load(std::memory_order_relaxed);
+        size_type ready = ready_slots(head);
+        if(ready < n){
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            ready = cached_tail_ - head;
+        }
+        const size_type cnt = ready < n ? ready : n;
+        size_type i = 0;
+        try{
+            for(;i < cnt;++i,++result){
+                pointer p = buffer_ + ((head + i) & mask_);
+                *result = hxqstl::move(*p);
+                data_allocator::destroy(p);
+            }
+        }
+        catch(...){
+            // 已经析构的元素照常出队，写入失败的元素留在队首
+            head_.store(head + i,std::memory_order_release);
+            throw;
+        }
+        head_.store(head + cnt,std::memory_order_release);
+        return cnt;
+    }
+
+    /*****************************************************************************************/
+    // mpmc_queue
+    // 每个槽位保存一个序号 seq：
+    //   seq == pos         槽位空闲，可以写入第 pos 个元素
+    //   seq == pos + 1     槽位已写入第 pos 个元素，可以读取
+    //   读取后 seq 置为 pos + capacity，留给下一轮的写入
+    template<class T>
+    struct mpmc_cell
+    {
+        std::atomic<size_t> seq;
+        typename std::aligned_storage<sizeof(T),alignof(T)>::type storage;
+
+        T* data() noexcept {return reinterpret_cast<T*>(&storage);}
+    };
+
+    template<class T>
+    class mpmc_queue{
+        public:
+            typedef hxqstl::allocator<mpmc_cell<T>> allocator_type;
+            typedef hxqstl::allocator<mpmc_cell<T>> cell_allocator;
+
+            typedef T value_type;
+            typedef T* pointer;
+            typedef size_t size_type;
+
+        private:
+            typedef mpmc_cell<T> cell;
+
+            cell* buffer_;
+            size_type mask_;
+
+            alignas(ECacheLineSize) std::atomic<size_type> enqueue_pos_;
+            alignas(ECacheLineSize) std::atomic<size_type> dequeue_pos_;
+
+        public:
+            explicit mpmc_queue(size_type capacity);
+
+            mpmc_queue(const mpmc_queue&) = delete;
+            mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+            ~mpmc_queue();
+
+        public:
+            template<class... Args>
+            bool try_emplace(Args&&... args);
+
+            bool try_push(const value_type& value)
+            { return try_emplace(value); }
+            bool try_push(value_type&& value)
+            { return try_emplace(hxqstl::move(value)); }
+
+            bool try_pop(value_type& value);
+
+            // 一次 CAS 占据最多 n 个连续槽位，返回实际写入/取出的个数
+            template<class InputIter>
+            size_type try_push_n(InputIter first,size_type n);
+
+            template<class OutputIter>
+            size_type try_pop_n(OutputIter result,size_type n);
+
+            // 并发时只是近似值
+            size_type size() const noexcept
+            {
+                const size_type tail = enqueue_pos_.load(std::memory_order_acquire);
+                const size_type head = dequeue_pos_.load(std::memory_order_acquire);
+                return tail > head ? tail - head : 0;
+            }
+            bool empty() const noexcept
+            { return size() == 0; }
+            size_type capacity() const noexcept
+            { return mask_ + 1; }
+
+        private:
+            size_type claim(std::atomic<size_type>& pos_ref,size_type n,size_type ready_offset,size_type& pos);
+
+            // 槽位一旦被占据就必须写入，所以可能抛异常的构造先在槽位外完成
+            template<class... Args>
+            bool emplace_dispatch(std::true_type,Args&&... args);
+            template<class... Args>
+            bool emplace_dispatch(std::false_type,Args&&... args);
+
+            template<class InputIter>
+            size_type push_n_dispatch(InputIter first,size_type n,std::true_type);
+            template<class InputIter>
+            size_type push_n_dispatch(InputIter first,size_type n,std::false_type);
+
+            // 析构第 pos 个元素并把槽位留给下一轮写入
+            void release_slot(size_type pos) noexcept
+            {
+                cell& c = buffer_[pos & mask_];
+                hxqstl::destroy(c.data());
+                c.seq.store(pos + mask_ + 1,std::memory_order_release);
+            }
+
+            // 取出时的移动赋值可能抛异常，已占据的槽位 [pos + first,pos + last) 无论如何都要释放，否则队列会卡在这里
+            struct release_guard
+            {
+                mpmc_queue* q;
+                size_type pos;
+                size_type first;
+                size_type last;
+
+                ~release_guard()
+                {
+                    for(;first != last;++first) q->release_slot(pos + first);
+                }
+            };
+    };
+
+    template<class T>
+    mpmc_queue<T>::mpmc_queue(size_type capacity)
+    :buffer_(nullptr),mask_(queue_round_up(capacity) - 1),enqueue_pos_(0),dequeue_pos_(0)
+    {
+        buffer_ = cell_allocator::allocate(mask_ + 1);
+        for(size_type i = 0;i <= mask_;++i){
+            ::new (static_cast<void*>(&buffer_[i].seq)) std::atomic<size_type>(i);
+        }
+    }
+
+    template<class T>
+    mpmc_queue<T>::~mpmc_queue(){
+        size_type head = dequeue_pos_.load(std::memory_order_relaxed);
+        const size_type tail = enqueue_pos_.load(std::memory_order_relaxed);
+        for(;head != tail;++head){
+            hxqstl::destroy(buffer_[head & mask_].data());
+        }
+        cell_allocator::deallocate(buffer_,mask_ + 1);
+    }
+
+    // 从 pos_ref 开始数出最多 n 个已就绪的槽位(seq == pos + i + ready_offset)，
+    // 然后用一次 CAS 把它们全部占下，返回占到的个数，起始位置写入 pos
+    template<class T>
+    typename mpmc_queue<T>::size_type
+    mpmc_queue<T>::claim(std::atomic<size_type>& pos_ref,size_type n,size_type ready_offset,size_type& pos){
+        pos = pos_ref.load(std::memory_order_relaxed);
+        for(;;){
+            size_type cnt = 0;
+            bool stale = false;
+            for(;cnt < n;++cnt){
+                const size_type seq = buffer_[(pos + cnt) & mask_].seq.load(std::memory_order_acquire);
+                const ptrdiff_t diff = static_cast<ptrdiff_t>(seq - (pos + cnt + ready_offset));
+                if(diff != 0){
+                    // diff > 0 说明 pos 已经被别的线程推进过了
+                    stale = cnt == 0 && diff > 0;
+                    break;
+                }
+            }
+            if(cnt == 0 && !stale){
+                return 0;
+            }
+            if(cnt != 0 && pos_ref.compare_exchange_weak(pos,pos + cnt,std::memory_order_relaxed)){
+                return cnt;
+            }
+            if(stale){
+                pos = pos_ref.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    template<class T>
+    template<class... Args>
+    bool mpmc_queue<T>::try_emplace(Args&&... args){
+        static_assert(std::is_nothrow_move_constructible<T>::value,
+                      "mpmc_queue requires a nothrow move constructible value_type");
+        return emplace_dispatch(std::is_nothrow_constructible<T,Args&&...>{},
+                                hxqstl::forward<Args>(args)...);
+    }
+
+    template<class T>
+    template<class... Args>
+    bool mpmc_queue<T>::emplace_dispatch(std::true_type,Args&&... args){
+        size_type pos;
+        if(claim(enqueue_pos_,1,0,pos) == 0){
+            return false;
+        }
+        cell& c = buffer_[pos & mask_];
+        hxqstl::construct(c.data(),hxqstl::forward<Args>(args)...);
+        c.seq.store(pos + 1,std::memory_order_release);
+        return true;
+    }
+
+    template<class T>
+    template<class... Args>
+    bool mpmc_queue<T>::emplace_dispatch(std::false_type,Args&&... args){
+        value_type tmp(hxqstl::forward<Args>(args)...);
+        return emplace_dispatch(std::true_type{},hxqstl::move(tmp));
+    }
+
+    template<class T>
+    bool mpmc_queue<T>::try_pop(value_type& value){
+        size_type pos;
+        if(claim(dequeue_pos_,1,1,pos) == 0){
+            return false;
+        }
+        release_guard guard = {this,pos,0,1};
+        value = hxqstl::move(*buffer_[pos & mask_].data());
+        return true;
+    }
+
+    template<class T>
+    template<class InputIter>
+    typename mpmc_queue<T>::size_type mpmc_queue<T>::try_push_n(InputIter first,size_type n){
+        return push_n_dispatch(first,n,std::is_nothrow_constructible<T,
+                               typename iterator_traits<InputIter>::reference>{});
+    }
+
+    template<class T>
+    template<class InputIter>
+    typename mpmc_queue<T>::size_type
+    mpmc_queue<T>::push_n_dispatch(InputIter first,size_type n,std::true_type){
+        size_type pos;
+        const size_type cnt = claim(enqueue_pos_,n,0,pos);
+        for(size_type i = 0;i < cnt;++i,++first){
+            cell& c = buffer_[(pos + i) & mask_];
+            hxqstl::construct(c.data(),*first);
+            c.seq.store(pos + i + 1,std::memory_order_release);
+        }
+        return cnt;
+    }
+
+    // 拷贝可能抛异常时不能批量占据槽位，逐个写入
+    template<class T>
+    template<class InputIter>
+    typename mpmc_queue<T>::size_type
+    mpmc_queue<T>::push_n_dispatch(InputIter first,size_type n,std::false_type){
+        size_type cnt = 0;
+        for(;cnt < n;++cnt,++first){
+            if(!try_emplace(*first)) break;
+        }
+        return cnt;
+    }
+
+    template<class T>
+    template<class OutputIter>
+    typename mpmc_queue<T>::size_type mpmc_queue<T>::try_pop_n(OutputIter result,size_type n){
+        size_type pos;
+        const size_type cnt = claim(dequeue_pos_,n,1,pos);
+        // 写入 result 抛异常时，本批中剩下的元素随槽位一起释放
+        release_guard guard = {this,pos,0,cnt};
+        for(;guard.first < cnt;++result){
+            const size_type i = guard.first;
+            *result = hxqstl::move(*buffer_[(pos + i) & mask_].data());
+            ++guard.first;
+            release_slot(pos + i);
+        }
+        return cnt;
+    }
+}
@@ -0,0 +1,513 @@
+#pragma once
+
+// concurrent_vector
+// 只追加的并发 vector：多个线程可以同时 push_back/emplace_back，也可以同时按下标读取
+// 存储由若干段组成，第 k 段容量为 EFirstSegment << k，已有的段永远不会搬移，
+// 所以元素的引用和指针在增长过程中保持有效
+// 注意：某个下标的元素只有在对应的 push_back 返回之后才对其他线程可见，
+// 读线程需要通过其他同步手段(例如把返回的下标发布出去)得知元素已经构造完毕
+
+#include <atomic>
+#include <initializer_list>
+
+#include "allocator.h"
+#include "construct.h"
+#include "uninitialized.h"
+#include "iterator.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace hxqstl{
+    enum{EFirstSegment = 16};
+    enum{ESegmentCount = 64 - 4};   // 64 - log2(EFirstSegment)
+
+    // 构造失败而没有元素的下标区间 [first,last)，析构时需要跳过
+    struct cv_broken_range
+    {
+        size_t first;
+        size_t last;
+        cv_broken_range* next;
+    };
+
+    // 每个线程缓存一个记录节点，写入操作在占据下标之前先取到手，
+    // 构造失败时直接使用，处理异常的过程中不再分配内存
+    inline cv_broken_range*& cv_spare_range() noexcept{
+        struct holder
+        {
+            cv_broken_range* node;
+            ~holder() {delete node;}
+        };
+        static thread_local holder h = {nullptr};
+        return h.node;
+    }
+
+    // 取出本线程缓存的节点，没有时新申请
+    inline cv_broken_range* cv_take_range(){
+        cv_broken_range*& spare = cv_spare_range();
+        cv_broken_range* node = spare;
+        spare = nullptr;
+        return node != nullptr ? node : new cv_broken_range;
+    }
+
+    // 没有用上的节点还给本线程
+    inline void cv_return_range(cv_broken_range* node) noexcept{
+        cv_broken_range*& spare = cv_spare_range();
+        if(spare == nullptr){
+            spare = node;
+        }
+        else{
+            delete node;
+        }
+    }
+
+    template<class CV,class Ref,class Ptr>
+    struct cv_iterator : public iterator<random_access_iterator_tag,typename CV::value_type>
+    {
+        typedef typename CV::value_type value_type;
+        typedef Ptr pointer;
+        typedef Ref reference;
+        typedef typename CV::size_type size_type;
+        typedef ptrdiff_t difference_type;
+        typedef cv_iterator self;
+
+        CV* cv;
+        size_type idx;
+
+        cv_iterator() noexcept : cv(nullptr),idx(0) {}
+        cv_iterator(CV* c,size_type i) noexcept : cv(c),idx(i) {}
+
+        // 允许 iterator 转换为 const_iterator
+        template<class R,class P>
+        cv_iterator(const cv_iterator<typename std::remove_const<CV>::type,R,P>& rhs) noexcept
+            :cv(rhs.cv),idx(rhs.idx) {}
+
+        reference operator*() const {return (*cv)[idx];}
+        pointer operator->() const {return &(operator*());}
+        reference operator[](difference_type n) const {return (*cv)[idx + n];}
+
+        self& operator++() {++idx;return *this;}
+        self operator++(int) {self tmp = *this;++idx;return tmp;}
+        self& operator--() {--idx;return *this;}
+        self operator--(int) {self tmp = *this;--idx;return tmp;}
+        self& operator+=(difference_type n) {idx += n;return *this;}
+        self& operator-=(difference_type n) {idx -= n;return *this;}
+        self operator+(difference_type n) const {return self(cv,idx + n);}
+        self operator-(difference_type n) const {return self(cv,idx - n);}
+        difference_type operator-(const self& rhs) const {
+            return static_cast<difference_type>(idx) - static_cast<difference_type>(rhs.idx);
+        }
+
+        bool operator==(const self& rhs) const {return idx == rhs.idx;}
+        bool operator!=(const self& rhs) const {return idx != rhs.idx;}
+        bool operator<(const self& rhs) const {return idx < rhs.idx;}
+        bool operator>(const self& rhs) const {return rhs < *this;}
+        bool operator<=(const self& rhs) const {return !(rhs < *this);}
+        bool operator>=(const self& rhs) const {return !(*this < rhs);}
+    };
+
+    template<class T>
+    class concurrent_vector{
+        public:
+            typedef hxqstl::allocator<T> allocator_type;
+            typedef hxqstl::allocator<T> data_allocator;
+
+            typedef typename allocator_type::value_type value_type;
+            typedef typename allocator_type::pointer pointer;
+            typedef typename allocator_type::const_pointer const_pointer;
+            typedef typename allocator_type::reference reference;
+            typedef typename allocator_type::const_reference const_reference;
+            typedef typename allocator_type::size_type size_type;
+            typedef typename allocator_type::difference_type difference_type;
+
+            typedef cv_iterator<concurrent_vector,T&,T*> iterator;
+            typedef cv_iterator<const concurrent_vector,const T&,const T*> const_iterator;
+
+            allocator_type get_allocator() {return data_allocator();}
+
+        private:
+            std::atomic<pointer> segments_[ESegmentCount];
+            // 独占一条 cache line，避免 push_back 的竞争拖累段表的读取
+            alignas(64) std::atomic<size_type> size_;
+            std::atomic<cv_broken_range*> broken_;
+
+        public:
+            concurrent_vector() noexcept
+            { init_table(); }
+
+            // 委托给默认构造函数，之后填充元素时抛出异常会经过析构函数释放已构造的元素和段
+            explicit concurrent_vector(size_type n) : concurrent_vector()
+            {
+                grow_by(n,value_type());
+            }
+
+            concurrent_vector(size_type n,const value_type& value) : concurrent_vector()
+            {
+                grow_by(n,value);
+            }
+
+            template<class Iter,typename std::enable_if<
+                hxqstl::is_input_iterator<Iter>::value,int>::type = 0>
+            concurrent_vector(Iter first,Iter last) : concurrent_vector()
+            {
+                for(;first != last;++first){
+                    emplace_back(*first);
+                }
+            }
+
+            concurrent_vector(std::initializer_list<value_type> ilist) : concurrent_vector()
+            {
+                grow_by(ilist.begin(),ilist.end());
+            }
+
+            concurrent_vector(const concurrent_vector&) = delete;
+            concurrent_vector& operator=(const concurrent_vector&) = delete;
+
+            ~concurrent_vector()
+            {
+                clear();
+                release_segments();
+            }
+
+        public:
+            // 以下接口可以被多个线程同时调用
+            template<class... Args>
+            iterator emplace_back(Args&&... args);
+
+            iterator push_back(const value_type& value)
+            { return emplace_back(value); }
+            iterator push_back(value_type&& value)
+            { return emplace_back(hxqstl::move(value)); }
+
+            // 一次性占据 n 个连续下标，返回第一个新元素的位置
+            iterator grow_by(size_type n,const value_type& value);
+
+            template<class ForwardIter,typename std::enable_if<
+                hxqstl::is_forward_iterator<ForwardIter>::value,int>::type = 0>
+            iterator grow_by(ForwardIter first,ForwardIter last);
+
+            // 预先分配能容纳 n 个元素的段
+            void reserve(size_type n);
+
+            reference operator[](size_type n)
+            {
+                return *slot(n);
+            }
+            const_reference operator[](size_type n) const
+            {
+                return *slot(n);
+            }
+
+            reference at(size_type n)
+            {
+                THROW_OUT_OF_RANGE_IF(!(n < size()),"concurrent_vector<T>::at() subscript out of range");
+                return (*this)[n];
+            }
+            const_reference at(size_type n) const
+            {
+                THROW_OUT_OF_RANGE_IF(!(n < size()),"concurrent_vector<T>::at() subscript out of range");
+                return (*this)[n];
+            }
+
+            reference front()
+            {
+                MYSTL_DEBUG(!empty());
+                return (*this)[0];
+            }
+            const_reference front() const
+            {
+                MYSTL_DEBUG(!empty());
+                return (*this)[0];
+            }
+            reference back()
+            {
+                MYSTL_DEBUG(!empty());
+                return (*this)[size() - 1];
+            }
+            const_reference back() const
+            {
+                MYSTL_DEBUG(!empty());
+                return (*this)[size() - 1];
+            }
+
+            iterator begin() noexcept {return iterator(this,0);}
+            const_iterator begin() const noexcept {return const_iterator(this,0);}
+            iterator end() noexcept {return iterator(this,size());}
+            const_iterator end() const noexcept {return const_iterator(this,size());}
+            const_iterator cbegin() const noexcept {return begin();}
+            const_iterator cend() const noexcept {return end();}
+
+            // size 包含已经占据但可能还在构造中的元素
+            size_type size() const noexcept
+            { return size_.load(std::memory_order_acquire); }
+            bool empty() const noexcept
+            { return size() == 0; }
+            size_type capacity() const noexcept;
+            size_type max_size() const noexcept
+            { return static_cast<size_type>(-1) / sizeof(T); }
+
+            // 以下接口不是线程安全的
+            void clear();
+
+        private:
+            static size_type segment_index(size_type n) noexcept;
+            static size_type segment_base(size_type k) noexcept
+            { return static_cast<size_type>(EFirstSegment) * ((size_type(1) << k) - 1); }
+            static size_type segment_size(size_type k) noexcept
+            { return static_cast<size_type>(EFirstSegment) << k; }
+
+            void init_table() noexcept;
+            pointer ensure_segment(size_type k);
+            pointer slot(size_type n) const noexcept;
+            void mark_broken(cv_broken_range* node,size_type first,size_type last) noexcept;
+            void destroy_range(size_type first,size_type last) noexcept;
+            void release_segments() noexcept;
+
+            template<class Iter>
+            friend struct segmented_iterator_traits;
+    };
+
+    // 让 copy/fill 等算法逐段处理 concurrent_vector 的区间，每段内部走针对指针的实现
+    template<class CV,class Ref,class Ptr>
+    struct segmented_iterator_traits<cv_iterator<CV,Ref,Ptr>>
+    {
+        typedef m_true_type is_segmented;
+        typedef cv_iterator<CV,Ref,Ptr> iterator;
+        typedef typename CV::size_type size_type;
+        typedef Ptr local_iterator;
+
+        struct segment_iterator
+        {
+            CV* cv;
+            size_type k;
+
+            segment_iterator& operator++() {++k;return *this;}
+            segment_iterator& operator--() {--k;return *this;}
+            bool operator==(const segment_iterator& rhs) const {return k == rhs.k;}
+            bool operator!=(const segment_iterator& rhs) const {return k != rhs.k;}
+        };
+
+        static segment_iterator segment(const iterator& it) noexcept
+        { return segment_iterator{it.cv,CV::segment_index(it.idx)}; }
+        // 尾后位置可能正好落在尚未分配的段的起点，此时偏移为 0，不会越过任何已分配的内存
+        static local_iterator local(const iterator& it) noexcept
+        {
+            const size_type k = CV::segment_index(it.idx);
+            return it.cv->segments_[k].load(std::memory_order_acquire) + (it.idx - CV::segment_base(k));
+        }
+        static local_iterator begin(const segment_iterator& seg) noexcept
+        { return seg.cv->segments_[seg.k].load(std::memory_order_acquire); }
+        static local_iterator end(const segment_iterator& seg) noexcept
+        { return begin(seg) + CV::segment_size(seg.k); }
+    };
+
+    /*****************************************************************************************/
+
+    // 第 k 段覆盖下标 [F*(2^k - 1),F*(2^(k+1) - 1))，F = EFirstSegment
+    template<class T>
+    typename concurrent_vector<T>::size_type
+    concurrent_vector<T>::segment_index(size_type n) noexcept{
+        const size_type q = n / EFirstSegment + 1;
+#if defined(__GNUC__)
+        return static_cast<size_type>(63 - __builtin_clzll(static_cast<unsigned long long>(q)));
+#else
+        size_type k = 0;
+        for(size_type v = q;v > 1;v >>= 1) ++k;
+        return k;
+#endif
+    }
+
+    template<class T>
+    void concurrent_vector<T>::init_table() noexcept{
+        for(size_type i = 0;i < ESegmentCount;++i){
+            segments_[i].store(nullptr,std::memory_order_relaxed);
+        }
+        size_.store(0,std::memory_order_relaxed);
+        broken_.store(nullptr,std::memory_order_relaxed);
+    }
+
+    // 段由第一个需要它的线程分配，竞争失败的线程归还自己申请的内存
+    template<class T>
+    typename concurrent_vector<T>::pointer
+    concurrent_vector<T>::ensure_segment(size_type k){
+        pointer seg = segments_[k].load(std::memory_order_acquire);
+        if(seg != nullptr){
+            return seg;
+        }
+        pointer fresh = data_allocator::allocate(segment_size(k));
+        if(segments_[k].compare_exchange_strong(seg,fresh,std::memory_order_acq_rel,
+                                                std::memory_order_acquire)){
+            return fresh;
+        }
+        data_allocator::deallocate(fresh,segment_size(k));
+        return seg;
+    }
+
+    template<class T>
+    typename concurrent_vector<T>::pointer
+    concurrent_vector<T>::slot(size_type n) const noexcept{
+        const size_type k = segment_index(n);
+        return segments_[k].load(std::memory_order_acquire) + (n - segment_base(k));
+    }
+
+    // node 由调用方在占据下标之前通过 cv_take_range 取得
+    template<class T>
+    void concurrent_vector<T>::mark_broken(cv_broken_range* node,size_type first,size_type last) noexcept{
+        if(first == last){
+            cv_return_range(node);
+            return;
+        }
+        node->first = first;
+        node->last = last;
+        node->next = broken_.load(std::memory_order_relaxed);
+        while(!broken_.compare_exchange_weak(node->next,node,std::memory_order_release,
+                                             std::memory_order_relaxed)){
+        }
+    }
+
+    template<class T>
+    template<class... Args>
+    typename concurrent_vector<T>::iterator
+    concurrent_vector<T>::emplace_back(Args&&... args){
+        cv_broken_range* node = cv_take_range();
+        const size_type n = size_.fetch_add(1,std::memory_order_acq_rel);
+        try{
+            THROW_LENGTH_ERROR_IF(n >= max_size(),"concurrent_vector<T>'s size too big");
+            const size_type k = segment_index(n);
+            pointer p = ensure_segment(k) + (n - segment_base(k));
+            data_allocator::construct(p,hxqstl::forward<Args>(args)...);
+        }
+        catch(...){
+            // 下标已经发布，无法收回，只能记下来让析构跳过
+            mark_broken(node,n,n + 1);
+            throw;
+        }
+        cv_return_range(node);
+        return iterator(this,n);
+    }
+
+    template<class T>
+    typename concurrent_vector<T>::iterator
+    concurrent_vector<T>::grow_by(size_type n,const value_type& value){
+        cv_broken_range* node = cv_take_range();
+        const size_type first = size_.fetch_add(n,std::memory_order_acq_rel);
+        const size_type last = first + n;
+        size_type cur = first;
+        try{
+            // 新区间可能跨越多个段，逐段批量填充
+            while(cur != last){
+                const size_type k = segment_index(cur);
+                const size_type seg_end = hxqstl::min(last,segment_base(k + 1));
+                pointer p = ensure_segment(k) + (cur - segment_base(k));
+                hxqstl::uninitialized_fill_n(p,seg_end - cur,value);
+                cur = seg_end;
+            }
+        }
+        catch(...){
+            mark_broken(node,cur,last);
+            throw;
+        }
+        cv_return_range(node);
+        return iterator(this,first);
+    }
+
+    template<class T>
+    template<class ForwardIter,typename std::enable_if<
+        hxqstl::is_forward_iterator<ForwardIter>::value,int>::type>
+    typename concurrent_vector<T>::iterator
+    concurrent_vector<T>::grow_by(ForwardIter first,ForwardIter last){
+        const size_type n = static_cast<size_type>(hxqstl::distance(first,last));
+        cv_broken_range* node = cv_take_range();
+        const size_type start = size_.fetch_add(n,std::memory_order_acq_rel);
+        const size_type stop = start + n;
+        size_type cur = start;
+        try{
+            while(cur != stop){
+                const size_type k = segment_index(cur);
+                const size_type seg_end = hxqstl::min(stop,segment_base(k + 1));
+                pointer p = ensure_segment(k) + (cur - segment_base(k));
+                hxqstl::uninitialized_copy_n(first,seg_end - cur,p);
+                hxqstl::advance(first,seg_end - cur);
+                cur = seg_end;
+            }
+        }
+        catch(...){
+            mark_broken(node,cur,stop);
+            throw;
+        }
+        cv_return_range(node);
+        return iterator(this,start);
+    }
+
+    template<class T>
+    void concurrent_vector<T>::reserve(size_type n){
+        if(n == 0) return;
+        const size_type last = segment_index(n - 1);
+        for(size_type k = 0;k <= last;++k){
+            ensure_segment(k);
+        }
+    }
+
+    // 容量为连续已分配段的总和
+    template<class T>
+    typename concurrent_vector<T>::size_type
+    concurrent_vector<T>::capacity() const noexcept{
+        size_type k = 0;
+        while(k < ESegmentCount && segments_[k].load(std::memory_order_acquire) != nullptr){
+            ++k;
+        }
+        return segment_base(k);
+    }
+
+    // 分配段时失败的话，段内占据的下标都已记为损坏，没有元素需要析构
+    template<class T>
+    void concurrent_vector<T>::destroy_range(size_type first,size_type last) noexcept{
+        while(first < last){
+            const size_type k = segment_index(first);
+            const size_type stop = hxqstl::min(last,segment_base(k + 1));
+            pointer seg = segments_[k].load(std::memory_order_relaxed);
+            if(seg != nullptr){
+                hxqstl::destroy(seg + (first - segment_base(k)),seg + (stop - segment_base(k)));
+            }
+            first = stop;
+        }
+    }
+
+    // 损坏区间按起点排序后，只析构区间之间的元素，复杂度 O(size + broken^2)
+    template<class T>
+    void concurrent_vector<T>::clear(){
+        const size_type n = size_.load(std::memory_order_acquire);
+        cv_broken_range* broken = broken_.exchange(nullptr,std::memory_order_acq_rel);
+        // 损坏区间通常只有几个，插入排序即可
+        cv_broken_range* sorted = nullptr;
+        while(broken != nullptr){
+            cv_broken_range* node = broken;
+            broken = broken->next;
+            cv_broken_range** pos = &sorted;
+            while(*pos != nullptr && (*pos)->first < node->first){
+                pos = &(*pos)->next;
+            }
+            node->next = *pos;
+            *pos = node;
+        }
+        size_type cur = 0;
+        while(sorted != nullptr){
+            destroy_range(cur,sorted->first);
+            cur = sorted->last;
+            cv_broken_range* next = sorted->next;
+            delete sorted;
+            sorted = next;
+        }
+        destroy_range(cur,n);
+        size_.store(0,std::memory_order_release);
+    }
+
+    template<class T>
+    void concurrent_vector<T>::release_segments() noexcept{
+        for(size_type k = 0;k < ESegmentCount;++k){
+            pointer seg = segments_[k].exchange(nullptr,std::memory_order_relaxed);
+            if(seg != nullptr){
+                data_allocator::deallocate(seg,segment_size(k));
+            }
+        }
+    }
+}
@@ -3,6 +3,7 @@
 #include <new>
 #include "typetraits.h"
 #include "iterator.h"
+#include "util.h"
 
 #ifdef _MSC_VER
 #pragma warning(push)
@@ -10,26 +11,48 @@
 #endif
 
 namespace hxqstl{
+    // 常量求值时不能使用 placement new
+    // 平凡类型的对象在编译期已经存在(例如 static_vector 的内联数组)，改为赋值
     template<class Ty>
-    void construct(Ty* ptr){
+    struct construct_by_assign
+        : std::integral_constant<bool,std::is_trivially_move_assignable<Ty>::value &&
+                                      std::is_trivially_destructible<Ty>::value> {};
+
+    template<class Ty,class... Args>
+    constexpr void construct_dispatch(std::true_type,Ty* ptr,Args&&... args){
+        if(hxqstl::is_constant_evaluated()){
+            *ptr = Ty(hxqstl::forward<Args>(args)...);
+        }
+        else{
+            ::new ((void*)ptr) Ty(hxqstl::forward<Args>(args)...);
+        }
+    }
+
+    template<class Ty,class... Args>
+    void construct_dispatch(std::false_type,Ty* ptr,Args&&... args){
+        ::new ((void*)ptr) Ty(hxqstl::forward<Args>(args)...);
+    }
+
+    template<class Ty>
+    constexpr void construct(Ty* ptr){
         // 全局new
         // placement new需要学习一下
-        ::new ((void*)ptr) Ty();
+        construct_dispatch(construct_by_assign<Ty>{},ptr);
     }
 
     template<class Ty1,class Ty2>
-    void construct(Ty1* ptr,const Ty2& value){
-        ::new ((void*)ptr) Ty1(value);
+    constexpr void construct(Ty1* ptr,const Ty2& value){
+        construct_dispatch(construct_by_assign<Ty1>{},ptr,value);
     }
 
     template<class Ty,class... Args>
-    void construct(Ty* ptr,Args&&... args){
-        ::new ((void*)ptr) Ty(hxqstl::forward<Args>(args)...);
+    constexpr void construct(Ty* ptr,Args&&... args){
+        construct_dispatch(construct_by_assign<Ty>{},ptr,hxqstl::forward<Args>(args)...);
     }
 
     // destroy 将对象析构
     template<class Ty>
-    void destory_one(Ty*,std::true_type) {}
+    constexpr void destroy_one(Ty*,std::true_type) {}
 
     template<class Ty>
     void destroy_one(Ty* pointer,std::false_type){
@@ -38,25 +61,25 @@ namespace hxqstl{
         }
     }
 
+    template<class Ty>
+    constexpr void destroy(Ty* pointer){
+        destroy_one(pointer,std::is_trivially_destructible<Ty>{});
+    }
+
     template<class ForwardIter>
-    void destroy_cat(ForwardIter,ForwardIter,std::true_type){
+    constexpr void destroy_cat(ForwardIter,ForwardIter,std::true_type){
 
     }
 
     template<class ForwardIter>
     void destroy_cat(ForwardIter first,ForwardIter last,std::false_type){
         for(;first != last;++first){
-            destroy(&*first);
+            hxqstl::destroy(&*first);
         }
     }
 
-    template<class Ty>
-    void destroy(Ty* pointer){
-        destroy_one(pointer,std::is_trivially_destructible<Ty>{});
-    }
-
     template<class ForwardIter>
-    void destroy(ForwardIter first,ForwardIter last){
+    constexpr void destroy(ForwardIter first,ForwardIter last){
         destroy_cat(first,last,std::is_trivially_destructible<
         typename iterator_traits<ForwardIter>::value_type>{});
     }
@@ -0,0 +1,503 @@
+#pragma once
+
+// dynamic_bitset
+// 运行期长度的位集合，以 64 位字连续存放，作为 vector<bool> 的替代
+// 按字并行完成 & | ^ 和移位，count/any/all/find_first/find_next 每次处理 64 位
+// 不变式：最后一个字中超出 size() 的高位始终为 0
+
+#include <cstdint>
+
+#include "algobase.h"
+#include "bitops.h"
+#include "iterator.h"
+#include "vector.h"
+#include "exceptdef.h"
+
+namespace hxqstl{
+    class dynamic_bitset{
+        public:
+            typedef uint64_t block_type;
+            typedef size_t size_type;
+
+            static constexpr size_type bits_per_block = bits::word_bits;
+            static constexpr size_type npos = static_cast<size_type>(-1);
+
+            // operator[] 返回的代理对象
+            class reference
+            {
+                friend class dynamic_bitset;
+                block_type* block_;
+                block_type mask_;
+                reference(block_type* b,size_type pos) noexcept
+                :block_(b),mask_(block_type(1) << (pos % bits_per_block)) {}
+            public:
+                operator bool() const noexcept {return (*block_ & mask_) != 0;}
+                bool operator~() const noexcept {return (*block_ & mask_) == 0;}
+                reference& operator=(bool x) noexcept
+                {
+                    if(x) *block_ |= mask_;
+                    else *block_ &= ~mask_;
+                    return *this;
+                }
+                reference& operator=(const reference& rhs) noexcept {return *this = bool(rhs);}
+                reference& flip() noexcept
+                {
+                    *block_ ^= mask_;
+                    return *this;
+                }
+            };
+
+            // 遍历置位位置的前向迭代器，解引用得到位的下标
+            class set_bit_iterator : public iterator<forward_iterator_tag,size_type,ptrdiff_t,
+                                                     const size_type*,size_type>
+            {
+                const block_type* blocks_;
+                size_type nblocks_;
+                size_type index_;       // 当前字的下标
+                block_type cur_;        // 当前字中尚未访问的置位
+            public:
+                set_bit_iterator() noexcept : blocks_(nullptr),nblocks_(0),index_(0),cur_(0) {}
+                set_bit_iterator(const block_type* b,size_type n) noexcept
+                :blocks_(b),nblocks_(n),index_(0),cur_(n ? b[0] : 0)
+                {
+                    skip_empty();
+                }
+
+                size_type operator*() const noexcept
+                { return index_ * bits_per_block + bits::countr_zero(cur_); }
+
+                set_bit_iterator& operator++() noexcept
+                {
+                    cur_ &= cur_ - 1;       // 清掉最低的置位
+                    skip_empty();
+                    return *this;
+                }
+                set_bit_iterator operator++(int) noexcept
+                {
+                    set_bit_iterator tmp = *this;
+                    ++*this;
+                    return tmp;
+                }
+
+                // 到达末尾的迭代器 index_ == nblocks_
+                bool operator==(const set_bit_iterator& rhs) const noexcept
+                { return index_ == rhs.index_ && cur_ == rhs.cur_; }
+                bool operator!=(const set_bit_iterator& rhs) const noexcept
+                { return !(*this == rhs); }
+
+                static set_bit_iterator end_of(size_type n) noexcept
+                {
+                    set_bit_iterator it;
+                    it.index_ = n;
+                    return it;
+                }
+
+            private:
+                void skip_empty() noexcept
+                {
+                    while(cur_ == 0){
+                        if(++index_ >= nblocks_){
+                            index_ = nblocks_;
+                            return;
+                        }
+                        cur_ = blocks_[index_];
+                    }
+                }
+            };
+
+            // 置位下标构成的区间，可直接用于 range-for
+            struct set_bit_range
+            {
+                set_bit_iterator first;
+                set_bit_iterator last;
+                set_bit_iterator begin() const noexcept {return first;}
+                set_bit_iterator end() const noexcept {return last;}
+            };
+
+        private:
+            hxqstl::vector<block_type> blocks_;
+            size_type nbits_;
+
+        public:
+            dynamic_bitset() noexcept : blocks_(),nbits_(0) {}
+
+            explicit dynamic_bitset(size_type n)
+            :blocks_(bits::words_for(n),block_type(0)),nbits_(n) {}
+
+            // 所有位置为 value；只接受 bool，整数实参走下面按整数初始化的重载，不会产生歧义
+            template<class B,typename std::enable_if<std::is_same<B,bool>::value,int>::type = 0>
+            dynamic_bitset(size_type n,B value)
+            :blocks_(bits::words_for(n),value ? ~block_type(0) : block_type(0)),nbits_(n)
+            {
+                trim();
+            }
+
+            // 用一个整数初始化低 64 位
+            dynamic_bitset(size_type n,unsigned long long value)
+            :blocks_(bits::words_for(n),block_type(0)),nbits_(n)
+            {
+                if(!blocks_.empty()) blocks_[0] = value;
+                trim();
+            }
+
+            dynamic_bitset(const dynamic_bitset& rhs) = default;
+            dynamic_bitset(dynamic_bitset&& rhs) noexcept
+            :blocks_(hxqstl::move(rhs.blocks_)),nbits_(rhs.nbits_)
+            {
+                rhs.nbits_ = 0;
+            }
+
+            dynamic_bitset& operator=(const dynamic_bitset& rhs) = default;
+            dynamic_bitset& operator=(dynamic_bitset&& rhs) noexcept
+            {
+                blocks_ = hxqstl::move(rhs.blocks_);
+                nbits_ = rhs.nbits_;
+                rhs.nbits_ = 0;
+                return *this;
+            }
+
+            ~dynamic_bitset() = default;
+
+        public:
+            size_type size() const noexcept {return nbits_;}
+            size_type num_blocks() const noexcept {return blocks_.size();}
+            bool empty() const noexcept {return nbits_ == 0;}
+            size_type capacity() const noexcept {return blocks_.capacity() * bits_per_block;}
+
+            // 直接访问底层的字数组，便于与其他位图做批量运算或序列化
+            block_type* data() noexcept {return blocks_.data();}
+            const block_type* data() const noexcept {return blocks_.data();}
+
+            void reserve(size_type n) {blocks_.reserve(bits::words_for(n));}
+            void shrink_to_fit() {blocks_.shrink_to_fit();}
+
+            void resize(size_type n,bool value = false);
+            void clear() noexcept
+            {
+                blocks_.clear();
+                nbits_ = 0;
+            }
+
+            void push_back(bool value)
+            {
+                if(nbits_ % bits_per_block == 0){
+                    blocks_.push_back(block_type(0));
+                }
+                ++nbits_;
+                set(nbits_ - 1,value);
+            }
+            void pop_back()
+            {
+                MYSTL_DEBUG(nbits_ > 0);
+                --nbits_;
+                if(nbits_ % bits_per_block == 0){
+                    blocks_.pop_back();
+                }
+                else{
+                    trim();
+                }
+            }
+
+            bool test(size_type pos) const
+            {
+                MYSTL_DEBUG(pos < nbits_);
+                return (blocks_[pos / bits_per_block] >> (pos % bits_per_block)) & 1;
+            }
+            bool at(size_type pos) const
+            {
+                THROW_OUT_OF_RANGE_IF(!(pos < nbits_),"dynamic_bitset::at() subscript out of range");
+                return test(pos);
+            }
+            bool operator[](size_type pos) const {return test(pos);}
+            reference operator[](size_type pos)
+            {
+                MYSTL_DEBUG(pos < nbits_);
+                return reference(&blocks_[pos / bits_per_block],pos);
+            }
+
+            dynamic_bitset& set(size_type pos,bool value = true)
+            {
+                MYSTL_DEBUG(pos < nbits_);
+                const block_type mask = block_type(1) << (pos % bits_per_block);
+                if(value) blocks_[pos / bits_per_block] |= mask;
+                else blocks_[pos / bits_per_block] &= ~mask;
+                return *this;
+            }
+            dynamic_bitset& reset(size_type pos) {return set(pos,false);}
+            dynamic_bitset& flip(size_type pos)
+            {
+                MYSTL_DEBUG(pos < nbits_);
+                blocks_[pos / bits_per_block] ^= block_type(1) << (pos % bits_per_block);
+                return *this;
+            }
+
+            dynamic_bitset& set() noexcept
+            {
+                hxqstl::fill_n(blocks_.data(),blocks_.size(),~block_type(0));
+                trim();
+                return *this;
+            }
+            dynamic_bitset& reset() noexcept
+            {
+                hxqstl::fill_n(blocks_.data(),blocks_.size(),block_type(0));
+                return *this;
+            }
+            dynamic_bitset& flip() noexcept
+            {
+                for(size_type i = 0;i < blocks_.size();++i){
+                    blocks_[i] = ~blocks_[i];
+                }
+                trim();
+                return *this;
+            }
+
+            size_type count() const noexcept
+            { return bits::popcount_words(blocks_.data(),blocks_.size()); }
+            bool any() const noexcept;
+            bool none() const noexcept {return !any();}
+            bool all() const noexcept;
+
+            // 第一个置位的下标，没有则返回 npos
+            size_type find_first() const noexcept {return find_from(0);}
+            // pos 之后(不含 pos)第一个置位的下标，没有则返回 npos
+            size_type find_next(size_type pos) const noexcept
+            {
+                if(pos >= nbits_ || ++pos == nbits_) return npos;
+                const size_type i = pos / bits_per_block;
+                const block_type w = blocks_[i] >> (pos % bits_per_block);
+                if(w != 0) return pos + bits::countr_zero(w);
+                return find_from(i + 1);
+            }
+
+            // 遍历所有置位：for(size_t i : bs.set_bits())
+            set_bit_range set_bits() const noexcept
+            {
+                return set_bit_range{set_bit_iterator(blocks_.data(),blocks_.size()),
+                                     set_bit_iterator::end_of(blocks_.size())};
+            }
+
+            // 对每个置位的下标调用 f，比迭代器少一次比较，适合热循环
+            template<class Func>
+            void for_each_set(Func f) const
+            {
+                for(size_type i = 0;i < blocks_.size();++i){
+                    block_type w = blocks_[i];
+                    while(w != 0){
+                        f(i * bits_per_block + bits::countr_zero(w));
+                        w &= w - 1;
+                    }
+                }
+            }
+
+            // 两个集合长度必须相同
+            dynamic_bitset& operator&=(const dynamic_bitset& rhs) noexcept;
+            dynamic_bitset& operator|=(const dynamic_bitset& rhs) noexcept;
+            dynamic_bitset& operator^=(const dynamic_bitset& rhs) noexcept;
+            dynamic_bitset& operator-=(const dynamic_bitset& rhs) noexcept;   // 差集 *this & ~rhs
+            dynamic_bitset& operator<<=(size_type n) noexcept;
+            dynamic_bitset& operator>>=(size_type n) noexcept;
+
+            dynamic_bitset operator<<(size_type n) const {return dynamic_bitset(*this) <<= n;}
+            dynamic_bitset operator>>(size_type n) const {return dynamic_bitset(*this) >>= n;}
+            dynamic_bitset operator~() const {return dynamic_bitset(*this).flip();}
+
+            bool intersects(const dynamic_bitset& rhs) const noexcept;
+            bool is_subset_of(const dynamic_bitset& rhs) const noexcept;
+
+            bool operator==(const dynamic_bitset& rhs) const noexcept
+            {
+                return nbits_ == rhs.nbits_ &&
+                       hxqstl::equal(blocks_.begin(),blocks_.end(),rhs.blocks_.begin());
+            }
+            bool operator!=(const dynamic_bitset& rhs) const noexcept {return !(*this == rhs);}
+
+            void swap(dynamic_bitset& rhs) noexcept
+            {
+                blocks_.swap(rhs.blocks_);
+                hxqstl::swap(nbits_,rhs.nbits_);
+            }
+
+        private:
+            // 清掉最后一个字中超出 size() 的位
+            void trim() noexcept
+            {
+                const size_type extra = nbits_ % bits_per_block;
+                if(extra != 0){
+                    blocks_.back() &= bits::low_mask(extra);
+                }
+            }
+
+            size_type find_from(size_type first_block) const noexcept
+            {
+                for(size_type i = first_block;i < blocks_.size();++i){
+                    if(blocks_[i] != 0){
+                        return i * bits_per_block + bits::countr_zero(blocks_[i]);
+                    }
+                }
+                return npos;
+            }
+    };
+
+    /*****************************************************************************************/
+
+    inline void dynamic_bitset::resize(size_type n,bool value){
+        const size_type old_bits = nbits_;
+        blocks_.resize(bits::words_for(n),value ? ~block_type(0) : block_type(0));
+        nbits_ = n;
+        // 原来最后一个字中空出来的高位也要填上
+        if(value && n > old_bits && old_bits % bits_per_block != 0){
+            blocks_[old_bits / bits_per_block] |= ~bits::low_mask(old_bits % bits_per_block);
+        }
+        trim();
+    }
+
+    // 按四个字一组做或运算再判断，减少分支
+    inline bool dynamic_bitset::any() const noexcept{
+        const block_type* p = blocks_.data();
+        const size_type n = blocks_.size();
+        size_type i = 0;
+        for(;i + 4 <= n;i += 4){
+            if((p[i] | p[i + 1] | p[i + 2] | p[i + 3]) != 0) return true;
+        }
+        for(;i < n;++i){
+            if(p[i] != 0) return true;
+        }
+        return false;
+    }
+
+    inline bool dynamic_bitset::all() const noexcept{
+        const size_type full = nbits_ / bits_per_block;
+        block_type acc = ~block_type(0);
+        for(size_type i = 0;i < full;++i){
+            acc &= blocks_[i];
+        }
+        if(acc != ~block_type(0)) return false;
+        const size_type extra = nbits_ % bits_per_block;
+        return extra == 0 || blocks_[full] == bits::low_mask(extra);
+    }
+
+    inline dynamic_bitset& dynamic_bitset::operator&=(const dynamic_bitset& rhs) noexcept{
+        MYSTL_DEBUG(nbits_ == rhs.nbits_);
+        block_type* a = blocks_.data();
+        const block_type* b = rhs.blocks_.data();
+        for(size_type i = 0,n = blocks_.size();i < n;++i) a[i] &= b[i];
+        return *this;
+    }
+
+    inline dynamic_bitset& dynamic_bitset::operator|=(const dynamic_bitset& rhs) noexcept{
+        MYSTL_DEBUG(nbits_ == rhs.nbits_);
+        block_type* a = blocks_.data();
+        const block_type* b = rhs.blocks_.data();
+        for(size_type i = 0,n = blocks_.size();i < n;++i) a[i] |= b[i];
+        return *this;
+    }
+
+    inline dynamic_bitset& dynamic_bitset::operator^=(const dynamic_bitset& rhs) noexcept{
+        MYSTL_DEBUG(nbits_ == rhs.nbits_);
+        block_type* a = blocks_.data();
+        const block_type* b = rhs.blocks_.data();
+        for(size_type i = 0,n = blocks_.size();i < n;++i) a[i] ^= b[i];
+        return *this;
+    }
+
+    inline dynamic_bitset& dynamic_bitset::operator-=(const dynamic_bitset& rhs) noexcept{
+        MYSTL_DEBUG(nbits_ == rhs.nbits_);
+        block_type* a = blocks_.data();
+        const block_type* b = rhs.blocks_.data();
+        for(size_type i = 0,n = blocks_.size();i < n;++i) a[i] &= ~b[i];
+        return *this;
+    }
+
+    // 向高位移动：第 i 位移到第 i+n 位
+    inline dynamic_bitset& dynamic_bitset::operator<<=(size_type n) noexcept{
+        if(n >= nbits_) return reset();
+        if(n == 0) return *this;
+        const size_type ws = n / bits_per_block;
+        const size_type bs = n % bits_per_block;
+        const size_type last = blocks_.size() - 1;
+        block_type* p = blocks_.data();
+        if(bs == 0){
+            for(size_type i = last;i >= ws;--i){     // ws >= 1，不会回绕
+                p[i] = p[i - ws];
+            }
+        }
+        else{
+            for(size_type i = last;i > ws;--i){
+                p[i] = (p[i - ws] << bs) | (p[i - ws - 1] >> (bits_per_block - bs));
+            }
+            p[ws] = p[0] << bs;
+        }
+        hxqstl::fill_n(p,ws,block_type(0));
+        trim();
+        return *this;
+    }
+
+    // 向低位移动：第 i 位移到第 i-n 位
+    inline dynamic_bitset& dynamic_bitset::operator>>=(size_type n) noexcept{
+        if(n >= nbits_) return reset();
+        if(n == 0) return *this;
+        const size_type ws = n / bits_per_block;
+        const size_type bs = n % bits_per_block;
+        const size_type nb = blocks_.size();
+        const size_type last = nb - ws - 1;
+        block_type* p = blocks_.data();
+        if(bs == 0){
+            for(size_type i = 0;i <= last;++i){
+                p[i] = p[i + ws];
+            }
+        }
+        else{
+            for(size_type i = 0;i < last;++i){
+                p[i] = (p[i + ws] >> bs) | (p[i + ws + 1] << (bits_per_block - bs));
+            }
+            p[last] = p[nb - 1] >> bs;
+        }
+        hxqstl::fill_n(p + last + 1,ws,block_type(0));
+        return *this;
+    }
+
+    inline bool dynamic_bitset::intersects(const dynamic_bitset& rhs) const noexcept{
+        const size_type n = hxqstl::min(blocks_.size(),rhs.blocks_.size());
+        for(size_type i = 0;i < n;++i){
+            if((blocks_[i] & rhs.blocks_[i]) != 0) return true;
+        }
+        return false;
+    }
+
+    inline bool dynamic_bitset::is_subset_of(const dynamic_bitset& rhs) const noexcept{
+        MYSTL_DEBUG(nbits_ == rhs.nbits_);
+        for(size_type i = 0;i < blocks_.size();++i){
+            if((blocks_[i] & ~rhs.blocks_[i]) != 0) return false;
+        }
+        return true;
+    }
+
+    inline dynamic_bitset operator&(const dynamic_bitset& lhs,const dynamic_bitset& rhs)
+    {
+        dynamic_bitset tmp(lhs);
+        return tmp &= rhs;
+    }
+
+    inline dynamic_bitset operator|(const dynamic_bitset& lhs,const dynamic_bitset& rhs)
+    {
+        dynamic_bitset tmp(lhs);
+        return tmp |= rhs;
+    }
+
+    inline dynamic_bitset operator^(const dynamic_bitset& lhs,const dynamic_bitset& rhs)
+    {
+        dynamic_bitset tmp(lhs);
+        return tmp ^= rhs;
+    }
+
+    inline dynamic_bitset operator-(const dynamic_bitset& lhs,const dynamic_bitset& rhs)
+    {
+        dynamic_bitset tmp(lhs);
+        return tmp -= rhs;
+    }
+
+    inline void swap(dynamic_bitset& lhs,dynamic_bitset& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+}
@@ -0,0 +1,196 @@
+#pragma once
+
+// flat_hash_set
+// 基于 flat_hashtable 的无序集合，元素直接存放在槽位数组中
+// 插入、删除会使所有迭代器和引用失效(与 std::unordered_set 不同)
+
+#include <initializer_list>
+
+#include "flat_hashtable.h"
+
+namespace hxqstl{
+    template<class Key,class Hash = hxqstl::hash<Key>,class KeyEqual = hxqstl::equal_to<Key>>
+    class flat_hash_set{
+        private:
+            typedef flat_hashtable<Key,Key,hxqstl::identity<Key>,Hash,KeyEqual> base_type;
+            base_type ht_;
+
+            template<class K>
+            using enable_if_transparent = typename std::enable_if<
+                swiss::is_transparent<Hash>::value && swiss::is_transparent<KeyEqual>::value &&
+                !std::is_same<K,Key>::value,int>::type;
+
+        public:
+            typedef typename base_type::allocator_type allocator_type;
+            typedef Key key_type;
+            typedef Key value_type;
+            typedef typename base_type::hasher hasher;
+            typedef typename base_type::key_equal key_equal;
+
+            typedef typename base_type::size_type size_type;
+            typedef typename base_type::difference_type difference_type;
+            typedef typename base_type::pointer pointer;
+            typedef typename base_type::const_pointer const_pointer;
+            typedef typename base_type::reference reference;
+            typedef typename base_type::const_reference const_reference;
+
+            // 集合的元素不可修改，iterator 与 const_iterator 相同
+            typedef typename base_type::const_iterator iterator;
+            typedef typename base_type::const_iterator const_iterator;
+
+            allocator_type get_allocator() const {return ht_.get_allocator();}
+
+        public:
+            flat_hash_set() : ht_(0) {}
+
+            explicit flat_hash_set(size_type bucket_count,const Hash& hash = Hash(),const KeyEqual& equal = KeyEqual())
+            :ht_(bucket_count,hash,equal) {}
+
+            template<class InputIter,typename std::enable_if<
+                hxqstl::is_input_iterator<InputIter>::value,int>::type = 0>
+            flat_hash_set(InputIter first,InputIter last,size_type bucket_count = 0,
+                          const Hash& hash = Hash(),const KeyEqual& equal = KeyEqual())
+            :ht_(bucket_count,hash,equal)
+            {
+                insert(first,last);
+            }
+
+            flat_hash_set(std::initializer_list<value_type> ilist,size_type bucket_count = 0,
+                          const Hash& hash = Hash(),const KeyEqual& equal = KeyEqual())
+            :ht_(hxqstl::max(bucket_count,static_cast<size_type>(ilist.size())),hash,equal)
+            {
+                insert(ilist.begin(),ilist.end());
+            }
+
+            flat_hash_set(const flat_hash_set& rhs) : ht_(rhs.ht_) {}
+            flat_hash_set(flat_hash_set&& rhs) noexcept : ht_(hxqstl::move(rhs.ht_)) {}
+
+            flat_hash_set& operator=(const flat_hash_set& rhs)
+            {
+                ht_ = rhs.ht_;
+                return *this;
+            }
+            flat_hash_set& operator=(flat_hash_set&& rhs) noexcept
+            {
+                ht_ = hxqstl::move(rhs.ht_);
+                return *this;
+            }
+            flat_hash_set& operator=(std::initializer_list<value_type> ilist)
+            {
+                ht_.clear();
+                ht_.reserve(ilist.size());
+                insert(ilist.begin(),ilist.end());
+                return *this;
+            }
+
+            ~flat_hash_set() = default;
+
+        public:
+            iterator begin() const noexcept {return ht_.begin();}
+            iterator end() const noexcept {return ht_.end();}
+            const_iterator cbegin() const noexcept {return ht_.cbegin();}
+            const_iterator cend() const noexcept {return ht_.cend();}
+
+            bool empty() const noexcept {return ht_.empty();}
+            size_type size() const noexcept {return ht_.size();}
+            size_type max_size() const noexcept {return ht_.max_size();}
+            size_type capacity() const noexcept {return ht_.capacity();}
+
+            template<class... Args>
+            hxqstl::pair<iterator,bool> emplace(Args&&... args)
+            {
+                auto res = ht_.emplace_unique(hxqstl::forward<Args>(args)...);
+                return hxqstl::pair<iterator,bool>(res.first,res.second);
+            }
+
+            hxqstl::pair<iterator,bool> insert(const value_type& value)
+            {
+                auto res = ht_.insert_unique(value);
+                return hxqstl::pair<iterator,bool>(res.first,res.second);
+            }
+            hxqstl::pair<iterator,bool> insert(value_type&& value)
+            {
+                auto res = ht_.insert_unique(hxqstl::move(value));
+                return hxqstl::pair<iterator,bool>(res.first,res.second);
+            }
+
+            template<class InputIter>
+            void insert(InputIter first,InputIter last)
+            {
+                insert_range(first,last,iterator_category(first));
+            }
+            void insert(std::initializer_list<value_type> ilist)
+            { insert(ilist.begin(),ilist.end()); }
+
+            void erase(const_iterator it)
+            { ht_.erase_at(typename base_type::iterator(it.ctrl,it.slot)); }
+            size_type erase(const key_type& key) {return ht_.erase_key(key);}
+
+            void clear() {ht_.clear();}
+            void swap(flat_hash_set& rhs) noexcept {ht_.swap(rhs.ht_);}
+
+            const_iterator find(const key_type& key) const {return ht_.find_key(key);}
+            bool contains(const key_type& key) const {return ht_.find_key(key) != end();}
+            size_type count(const key_type& key) const {return contains(key) ? 1 : 0;}
+
+            // 异构查找：Hash 和 KeyEqual 都声明 is_transparent 时可用
+            template<class K,enable_if_transparent<K> = 0>
+            const_iterator find(const K& key) const {return ht_.find_key(key);}
+            template<class K,enable_if_transparent<K> = 0>
+            bool contains(const K& key) const {return ht_.find_key(key) != end();}
+            template<class K,enable_if_transparent<K> = 0>
+            size_type count(const K& key) const {return contains(key) ? 1 : 0;}
+            template<class K,enable_if_transparent<K> = 0>
+            size_type erase(const K& key) {return ht_.erase_key(key);}
+
+            void reserve(size_type n) {ht_.reserve(n);}
+            void rehash(size_type n) {ht_.rehash(n);}
+
+            size_type bucket_count() const noexcept {return ht_.bucket_count();}
+            float load_factor() const noexcept {return ht_.load_factor();}
+            float max_load_factor() const noexcept {return ht_.max_load_factor();}
+
+            hasher hash_function() const {return ht_.hash_fcn();}
+            key_equal key_eq() const {return ht_.key_eq();}
+
+        private:
+            template<class InputIter>
+            void insert_range(InputIter first,InputIter last,hxqstl::input_iterator_tag)
+            {
+                for(;first != last;++first){
+                    ht_.insert_unique(*first);
+                }
+            }
+
+            template<class ForwardIter>
+            void insert_range(ForwardIter first,ForwardIter last,hxqstl::forward_iterator_tag)
+            {
+                ht_.reserve(ht_.size() + static_cast<size_type>(hxqstl::distance(first,last)));
+                insert_range(first,last,hxqstl::input_iterator_tag{});
+            }
+    };
+
+    template<class Key,class Hash,class KeyEqual>
+    bool operator==(const flat_hash_set<Key,Hash,KeyEqual>& lhs,
+                    const flat_hash_set<Key,Hash,KeyEqual>& rhs)
+    {
+        if(lhs.size() != rhs.size()) return false;
+        for(auto it = lhs.begin();it != lhs.end();++it){
+            if(!rhs.contains(*it)) return false;
+        }
+        return true;
+    }
+
+    template<class Key,class Hash,class KeyEqual>
+    bool operator!=(const flat_hash_set<Key,Hash,KeyEqual>& lhs,
+                    const flat_hash_set<Key,Hash,KeyEqual>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template<class Key,class Hash,class KeyEqual>
+    void swap(flat_hash_set<Key,Hash,KeyEqual>& lhs,flat_hash_set<Key,Hash,KeyEqual>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+}
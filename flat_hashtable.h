@@ -0,0 +1,829 @@
+#pragma once
+
+// flat_hashtable
+// 开放寻址的哈希表(Swiss table 布局)，flat_hash_map/flat_hash_set 的底层实现
+// 元素直接存放在槽位数组中，与控制字节数组共用一次内存分配：
+//   [ slot 0 ... slot cap-1 | ctrl 0 ... ctrl cap-1 | sentinel | ctrl 0 ... ctrl W-2 的副本 ]
+// 每个槽位对应一个控制字节：
+//   kEmpty    (0x80)   空槽
+//   kDeleted  (0xFE)   已删除的墓碑
+//   kSentinel (0xFF)   控制数组末尾的哨兵，供迭代器停止
+//   0 ~ 127           槽位已使用，值为哈希值的低 7 位(H2)
+// 查找时按组(SSE2 下 16 个，否则 8 个)比较控制字节，只有 H2 相同的槽位才会去比较键
+// 容量总是 2^k - 1，探测序列以组为单位做三角数跳跃
+
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HXQSTL_HASH_SSE2 1
+#endif
+
+#include "algobase.h"
+#include "allocator.h"
+#include "construct.h"
+#include "functional.h"
+#include "iterator.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace hxqstl{
+    namespace swiss{
+        typedef signed char ctrl_t;
+
+        enum : ctrl_t
+        {
+            kEmpty = -128,
+            kDeleted = -2,
+            kSentinel = -1
+        };
+
+        inline bool is_full(ctrl_t c) noexcept {return c >= 0;}
+
+        inline unsigned trailing_zeros(uint64_t x) noexcept{
+#if defined(__GNUC__)
+            return static_cast<unsigned>(__builtin_ctzll(x));
+#else
+            unsigned n = 0;
+            while((x & 1) == 0){ x >>= 1; ++n; }
+            return n;
+#endif
+        }
+
+        // 匹配结果的位掩码，Shift 为每个槽位占用的位数的对数(SSE2 为 0，SWAR 为 3)
+        template<class T,int Shift>
+        class bitmask
+        {
+            T mask_;
+        public:
+            explicit bitmask(T mask) noexcept : mask_(mask) {}
+
+            explicit operator bool() const noexcept {return mask_ != 0;}
+
+            // 最低的匹配槽位
+            unsigned lowest() const noexcept
+            { return trailing_zeros(static_cast<uint64_t>(mask_)) >> Shift; }
+
+            bitmask& operator++() noexcept
+            {
+                mask_ &= (mask_ - 1);
+                return *this;
+            }
+
+            unsigned operator*() const noexcept {return lowest();}
+        };
+
+#ifdef HXQSTL_HASH_SSE2
+        struct group
+        {
+            enum{kWidth = 16};
+
+            __m128i ctrl;
+
+            explicit group(const ctrl_t* pos) noexcept
+            { ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos)); }
+
+            bitmask<uint32_t,0> match(ctrl_t h2) const noexcept
+            {
+                return bitmask<uint32_t,0>(static_cast<uint32_t>(
+                    _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2),ctrl))));
+            }
+
+            bitmask<uint32_t,0> match_empty() const noexcept
+            { return match(static_cast<ctrl_t>(kEmpty)); }
+
+            // kEmpty 和 kDeleted 都小于 kSentinel
+            bitmask<uint32_t,0> match_empty_or_deleted() const noexcept
+            {
+                return bitmask<uint32_t,0>(static_cast<uint32_t>(
+                    _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(kSentinel),ctrl))));
+            }
+        };
+#else
+        // 没有 SSE2 时用 64 位整数一次比较 8 个控制字节
+        struct group
+        {
+            enum{kWidth = 8};
+
+            uint64_t ctrl;
+
+            static constexpr uint64_t kLsbs = 0x0101010101010101ULL;
+            static constexpr uint64_t kMsbs = 0x8080808080808080ULL;
+
+            explicit group(const ctrl_t* pos) noexcept
+            { std::memcpy(&ctrl,pos,sizeof(ctrl)); }
+
+            // 可能有假阳性，调用方总会再比较一次键
+            bitmask<uint64_t,3> match(ctrl_t h2) const noexcept
+            {
+                const uint64_t x = ctrl ^ (kLsbs * static_cast<unsigned char>(h2));
+                return bitmask<uint64_t,3>((x - kLsbs) & ~x & kMsbs);
+            }
+
+            bitmask<uint64_t,3> match_empty() const noexcept
+            { return bitmask<uint64_t,3>((ctrl & (~ctrl << 6)) & kMsbs); }
+
+            bitmask<uint64_t,3> match_empty_or_deleted() const noexcept
+            { return bitmask<uint64_t,3>((ctrl & (~ctrl << 7)) & kMsbs); }
+        };
+#endif
+
+        enum{kWidth = group::kWidth};
+
+        // 空表共享的控制字节，保证对空表的查找不需要特判
+        inline const ctrl_t* empty_group() noexcept{
+            alignas(16) static const ctrl_t g[kWidth] = {
+                kSentinel,kEmpty,kEmpty,kEmpty,kEmpty,kEmpty,kEmpty,kEmpty
+#if HXQSTL_HASH_SSE2
+                ,kEmpty,kEmpty,kEmpty,kEmpty,kEmpty,kEmpty,kEmpty,kEmpty
+#endif
+            };
+            return g;
+        }
+
+        // 以组为单位的三角数探测：offset, offset + W, offset + 3W, offset + 6W ...
+        class probe_seq
+        {
+            size_t mask_;
+            size_t offset_;
+            size_t index_;
+        public:
+            probe_seq(size_t hash,size_t mask) noexcept
+                :mask_(mask),offset_(hash & mask),index_(0) {}
+
+            size_t offset() const noexcept {return offset_;}
+            size_t offset(size_t i) const noexcept {return (offset_ + i) & mask_;}
+
+            void next() noexcept
+            {
+                index_ += kWidth;
+                offset_ = (offset_ + index_) & mask_;
+            }
+
+            size_t index() const noexcept {return index_;}
+        };
+
+        // 最大负载因子 7/8
+        inline size_t capacity_to_growth(size_t cap) noexcept{
+            if(kWidth == 8 && cap == 7) return 6;
+            return cap - cap / 8;
+        }
+
+        // 能放下 n 个元素的最小容量(2^k - 1)
+        inline size_t normalize_capacity(size_t n) noexcept{
+            size_t cap = 1;
+            while(capacity_to_growth(cap) < n) cap = cap * 2 + 1;
+            return cap;
+        }
+
+        // 对用户哈希值再做一次混合，避免整数恒等哈希导致低位聚集
+        inline size_t mix(size_t h) noexcept{
+            const uint64_t k = 0x9E3779B97F4A7C15ULL;
+#if defined(__SIZEOF_INT128__)
+            __extension__ typedef unsigned __int128 uint128;    // 避免 -Wpedantic 警告
+            const uint128 x = static_cast<uint128>(h) * k;
+            return static_cast<size_t>(static_cast<uint64_t>(x) ^ static_cast<uint64_t>(x >> 64));
+#else
+            const uint64_t x = static_cast<uint64_t>(h) * k;
+            return static_cast<size_t>(x ^ (x >> 32));
+#endif
+        }
+
+        inline size_t h1(size_t hash) noexcept {return hash >> 7;}
+        inline ctrl_t h2(size_t hash) noexcept {return static_cast<ctrl_t>(hash & 0x7F);}
+
+        // 槽位布局：默认直接存放 Value
+        template<class Value>
+        struct slot_policy
+        {
+            typedef Value slot_type;
+            // 表内部构造、搬迁元素时使用的类型
+            typedef Value mutable_value;
+
+            static Value* element(slot_type* s) noexcept {return s;}
+            static mutable_value* mutable_element(slot_type* s) noexcept {return s;}
+        };
+
+        // pair<const Key,T> 在表内按 pair<Key,T> 构造，扩容搬迁时可以移动键而不必拷贝
+        // 对外经由 union 的另一个成员以 pair<const Key,T> 的形式访问，键仍然不可修改
+        template<class Key,class T>
+        struct slot_policy<hxqstl::pair<const Key,T>>
+        {
+            typedef hxqstl::pair<const Key,T> value_type;
+            typedef hxqstl::pair<Key,T> mutable_value;
+
+            union slot_type
+            {
+                value_type value;
+                mutable_value mutable_val;
+
+                slot_type() {}
+                ~slot_type() {}
+            };
+            static_assert(sizeof(slot_type) == sizeof(value_type) && alignof(slot_type) == alignof(value_type),
+                          "pair<const Key,T> and pair<Key,T> must share one layout");
+
+            // 只做地址换算，不解引用，空表的 nullptr 也可以传入
+            static value_type* element(slot_type* s) noexcept {return reinterpret_cast<value_type*>(s);}
+            static mutable_value* mutable_element(slot_type* s) noexcept {return reinterpret_cast<mutable_value*>(s);}
+
+            static const Key& key(const mutable_value& v) noexcept {return v.first;}
+        };
+
+        // 只有哈希和比较函数都声明了 is_transparent 才开放异构查找
+        template<class T,class = void>
+        struct is_transparent : std::false_type {};
+
+        template<class T>
+        struct is_transparent<T,decltype((void)sizeof(typename T::is_transparent))> : std::true_type {};
+    }
+
+    template<class Value,class Table>
+    struct flat_hash_iterator;
+
+    template<class Value,class Table>
+    struct flat_hash_const_iterator;
+
+    template<class Value,class Table>
+    struct flat_hash_iterator_base : public hxqstl::iterator<hxqstl::forward_iterator_tag,Value>
+    {
+        const swiss::ctrl_t* ctrl;
+        Value* slot;
+
+        flat_hash_iterator_base() noexcept : ctrl(nullptr),slot(nullptr) {}
+        flat_hash_iterator_base(const swiss::ctrl_t* c,Value* s) noexcept : ctrl(c),slot(s) {}
+
+        // 跳过空槽和墓碑，遇到哨兵停止
+        void skip_empty() noexcept
+        {
+            while(!swiss::is_full(*ctrl) && *ctrl != swiss::kSentinel){
+                ++ctrl;
+                ++slot;
+            }
+        }
+
+        void incr() noexcept
+        {
+            ++ctrl;
+            ++slot;
+            skip_empty();
+        }
+
+        bool operator==(const flat_hash_iterator_base& rhs) const noexcept {return ctrl == rhs.ctrl;}
+        bool operator!=(const flat_hash_iterator_base& rhs) const noexcept {return ctrl != rhs.ctrl;}
+    };
+
+    template<class Value,class Table>
+    struct flat_hash_iterator : public flat_hash_iterator_base<Value,Table>
+    {
+        typedef flat_hash_iterator_base<Value,Table> base;
+        typedef Value value_type;
+        typedef Value* pointer;
+        typedef Value& reference;
+        typedef flat_hash_iterator self;
+
+        flat_hash_iterator() noexcept {}
+        flat_hash_iterator(const swiss::ctrl_t* c,Value* s) noexcept : base(c,s) {}
+
+        reference operator*() const {return *this->slot;}
+        pointer operator->() const {return this->slot;}
+
+        self& operator++() {this->incr();return *this;}
+        self operator++(int) {self tmp = *this;this->incr();return tmp;}
+    };
+
+    template<class Value,class Table>
+    struct flat_hash_const_iterator : public flat_hash_iterator_base<Value,Table>
+    {
+        typedef flat_hash_iterator_base<Value,Table> base;
+        typedef Value value_type;
+        typedef const Value* pointer;
+        typedef const Value& reference;
+        typedef flat_hash_const_iterator self;
+
+        flat_hash_const_iterator() noexcept {}
+        flat_hash_const_iterator(const swiss::ctrl_t* c,Value* s) noexcept : base(c,s) {}
+        flat_hash_const_iterator(const flat_hash_iterator<Value,Table>& rhs) noexcept : base(rhs.ctrl,rhs.slot) {}
+
+        reference operator*() const {return *this->slot;}
+        pointer operator->() const {return this->slot;}
+
+        self& operator++() {this->incr();return *this;}
+        self operator++(int) {self tmp = *this;this->incr();return tmp;}
+    };
+
+    // 模板参数：Value 元素类型，Key 键类型，KeyOfValue 从元素取键，Hash 哈希函数，KeyEqual 键比较
+    template<class Value,class Key,class KeyOfValue,class Hash,class KeyEqual>
+    class flat_hashtable{
+        public:
+            typedef hxqstl::allocator<Value> allocator_type;
+            typedef hxqstl::allocator<unsigned char> raw_allocator;
+
+            typedef Key key_type;
+            typedef Value value_type;
+            typedef Hash hasher;
+            typedef KeyEqual key_equal;
+
+            typedef size_t size_type;
+            typedef ptrdiff_t difference_type;
+            typedef value_type* pointer;
+            typedef const value_type* const_pointer;
+            typedef value_type& reference;
+            typedef const value_type& const_reference;
+
+            typedef flat_hash_iterator<Value,flat_hashtable> iterator;
+            typedef flat_hash_const_iterator<Value,flat_hashtable> const_iterator;
+
+            allocator_type get_allocator() const {return allocator_type();}
+
+        private:
+            typedef swiss::ctrl_t ctrl_t;
+            typedef swiss::slot_policy<Value> policy;
+            typedef typename policy::slot_type slot_type;
+            typedef typename policy::mutable_value mutable_value;
+            typedef hxqstl::allocator<mutable_value> mutable_allocator;
+            typedef hxqstl::allocator<size_type> hash_allocator;
+
+            ctrl_t* ctrl_;
+            slot_type* slots_;
+            size_type size_;
+            size_type capacity_;
+            size_type growth_left_;
+            hasher hash_;
+            key_equal equal_;
+            KeyOfValue get_key_;
+
+        public:
+            explicit flat_hashtable(size_type bucket_count = 0,const Hash& hash = Hash(),const KeyEqual& equal = KeyEqual())
+            :ctrl_(const_cast<ctrl_t*>(swiss::empty_group())),slots_(nullptr),size_(0),capacity_(0),
+             growth_left_(0),hash_(hash),equal_(equal)
+            {
+                if(bucket_count != 0){
+                    initialize_slots(swiss::normalize_capacity(bucket_count));
+                }
+            }
+
+            flat_hashtable(const flat_hashtable& rhs)
+            :flat_hashtable(0,rhs.hash_,rhs.equal_)
+            {
+                copy_init(rhs);
+            }
+
+            flat_hashtable(flat_hashtable&& rhs) noexcept
+            :ctrl_(rhs.ctrl_),slots_(rhs.slots_),size_(rhs.size_),capacity_(rhs.capacity_),
+             growth_left_(rhs.growth_left_),hash_(rhs.hash_),equal_(rhs.equal_)
+            {
+                rhs.reset_empty();
+            }
+
+            flat_hashtable& operator=(const flat_hashtable& rhs)
+            {
+                if(this != &rhs){
+                    flat_hashtable tmp(rhs);
+                    swap(tmp);
+                }
+                return *this;
+            }
+
+            flat_hashtable& operator=(flat_hashtable&& rhs) noexcept
+            {
+                flat_hashtable tmp(hxqstl::move(rhs));
+                swap(tmp);
+                return *this;
+            }
+
+            ~flat_hashtable()
+            { destroy_slots(); }
+
+        public:
+            iterator begin() noexcept
+            {
+                iterator it(ctrl_,element_at(0));
+                it.skip_empty();
+                return it;
+            }
+            const_iterator begin() const noexcept
+            {
+                const_iterator it(ctrl_,element_at(0));
+                it.skip_empty();
+                return it;
+            }
+            iterator end() noexcept
+            { return iterator(ctrl_ + capacity_,element_at(capacity_)); }
+            const_iterator end() const noexcept
+            { return const_iterator(ctrl_ + capacity_,element_at(capacity_)); }
+            const_iterator cbegin() const noexcept {return begin();}
+            const_iterator cend() const noexcept {return end();}
+
+            bool empty() const noexcept {return size_ == 0;}
+            size_type size() const noexcept {return size_;}
+            size_type max_size() const noexcept {return static_cast<size_type>(-1) / sizeof(value_type);}
+            size_type capacity() const noexcept {return capacity_;}
+            size_type bucket_count() const noexcept {return capacity_;}
+            float load_factor() const noexcept
+            { return capacity_ == 0 ? 0.0f : static_cast<float>(size_) / static_cast<float>(capacity_); }
+            float max_load_factor() const noexcept {return 0.875f;}
+
+            hasher hash_fcn() const {return hash_;}
+            key_equal key_eq() const {return equal_;}
+
+            // 查找键所在的位置，找不到返回 end()
+            template<class K>
+            iterator find_key(const K& key)
+            {
+                const size_type i = find_index(key,hash_key(key));
+                return i == capacity_ ? end() : iterator_at(i);
+            }
+            template<class K>
+            const_iterator find_key(const K& key) const
+            {
+                const size_type i = find_index(key,hash_key(key));
+                return i == capacity_ ? end() : const_iterator(ctrl_ + i,element_at(i));
+            }
+
+            // find_or_prepare_insert 的结果：键所在或预留给它的槽位，以及是否需要构造新元素
+            struct insert_slot
+            {
+                size_type index;
+                size_type hash;
+                bool inserted;
+            };
+
+            // 查找键，找不到时预留一个插入位置
+            template<class K>
+            insert_slot find_or_prepare_insert(const K& key);
+
+            // 在 find_or_prepare_insert 预留的位置上构造元素
+            template<class... Args>
+            void construct_at(const insert_slot& s,Args&&... args)
+            {
+                mutable_allocator::construct(policy::mutable_element(slots_ + s.index),hxqstl::forward<Args>(args)...);
+                commit_insert(s.index,s.hash);
+            }
+
+            template<class... Args>
+            hxqstl::pair<iterator,bool> emplace_unique(Args&&... args);
+
+            template<class V>
+            hxqstl::pair<iterator,bool> insert_unique(V&& value);
+
+            template<class K>
+            size_type erase_key(const K& key);
+            void erase_at(iterator it);
+
+            void clear();
+            void reserve(size_type n);
+            void rehash(size_type n);
+            void swap(flat_hashtable& rhs) noexcept;
+
+            iterator iterator_at(size_type i) noexcept
+            { return iterator(ctrl_ + i,element_at(i)); }
+
+        private:
+            pointer element_at(size_type i) const noexcept
+            { return policy::element(slots_ + i); }
+
+            // 取得尚未放进表中的元素的键
+            const key_type& key_of(const mutable_value& v,std::true_type) const
+            { return get_key_(v); }
+            const key_type& key_of(const mutable_value& v,std::false_type) const noexcept
+            { return policy::key(v); }
+            const key_type& key_of(const mutable_value& v) const
+            { return key_of(v,std::is_same<mutable_value,value_type>{}); }
+
+            template<class Val>
+            hxqstl::pair<iterator,bool> insert_unique_dispatch(Val&& value,std::true_type);
+            template<class Val>
+            hxqstl::pair<iterator,bool> insert_unique_dispatch(Val&& value,std::false_type)
+            { return emplace_unique(hxqstl::forward<Val>(value)); }
+
+            template<class K>
+            size_type hash_key(const K& key) const
+            { return swiss::mix(static_cast<size_type>(hash_(key))); }
+
+            template<class K>
+            size_type find_index(const K& key,size_type hash) const;
+
+            size_type find_first_non_full(size_type hash) const noexcept;
+            void commit_insert(size_type i,size_type hash) noexcept;
+            void set_ctrl(size_type i,ctrl_t h) noexcept;
+
+            void initialize_slots(size_type cap);
+            void resize(size_type new_cap);
+            void rehash_and_grow_if_necessary();
+            void destroy_slots() noexcept;
+            void reset_empty() noexcept;
+            void copy_init(const flat_hashtable& rhs);
+
+            static size_type alloc_size(size_type cap) noexcept
+            { return cap * sizeof(slot_type) + cap + swiss::kWidth; }
+            // 槽位数组在分配的开头，按 slot_type 的对齐申请，超过默认对齐的类型也能正确放置
+            static align_val_t slot_align() noexcept
+            { return align_val_t(alignof(slot_type)); }
+    };
+
+    /*****************************************************************************************/
+
+    // 写控制字节时同时维护数组尾部的副本，使得任意位置起的整组读取都不需要回绕
+    template<class V,class K,class KOV,class H,class E>
+    void flat_hashtable<V,K,KOV,H,E>::set_ctrl(size_type i,ctrl_t h) noexcept{
+        ctrl_[i] = h;
+        ctrl_[((i - (swiss::kWidth - 1)) & capacity_) + ((swiss::kWidth - 1) & capacity_)] = h;
+    }
+
+    template<class V,class K,class KOV,class H,class E>
+    void flat_hashtable<V,K,KOV,H,E>::initialize_slots(size_type cap){
+        unsigned char* mem = raw_allocator::allocate(alloc_size(cap),slot_align());
+        slots_ = reinterpret_cast<slot_type*>(mem);
+        ctrl_ = reinterpret_cast<ctrl_t*>(mem + cap * sizeof(slot_type));
+        std::memset(ctrl_,static_cast<unsigned char>(swiss::kEmpty),cap + swiss::kWidth);
+        ctrl_[cap] = swiss::kSentinel;
+        capacity_ = cap;
+        growth_left_ = swiss::capacity_to_growth(cap) - size_;
+    }
+
+    template<class V,class K,class KOV,class H,class E>
+    void flat_hashtable<V,K,KOV,H,E>::destroy_slots() noexcept{
+        if(capacity_ == 0) return;
+        for(size_type i = 0;i != capacity_;++i){
+            if(swiss::is_full(ctrl_[i])){
+                hxqstl::destroy(policy::mutable_element(slots_ + i));
+            }
+        }
+        raw_allocator::deallocate(reinterpret_cast<unsigned char*>(slots_),alloc_size(capacity_),slot_align());
+        reset_empty();
+    }
+
+    template<class V,class K,class KOV,class H,class E>
+    void flat_hashtable<V,K,KOV,H,E>::reset_empty() noexcept{
+        ctrl_ = const_cast<ctrl_t*>(swiss::empty_group());
+        slots_ = nullptr;
+        size_ = 0;
+        capacity_ = 0;
+        growth_left_ = 0;
+    }
+
+    template<class V,class K,class KOV,class H,class E>
+    void flat_hashtable<V,K,KOV,H,E>::copy_init(const flat_hashtable& rhs){
+        if(rhs.size_ == 0) return;
+        reserve(rhs.size_);
+        for(size_type j = 0;j != rhs.capacity_;++j){
+            if(swiss::is_full(rhs.ctrl_[j])){
+                const size_type hash = hash_key(get_key_(*rhs.element_at(j)));
+                const size_type i = find_first_non_full(hash);
+                mutable_allocator::construct(policy::mutable_element(slots_ + i),
+                                             *policy::mutable_element(rhs.slots_ + j));
+                commit_insert(i,hash);
+            }
+        }
+    }
+
+    template<class V,class K,class KOV,class H,class E>
+    template<class Key2>
+    typename flat_hashtable<V,K,KOV,H,E>::size_type
+    flat_hashtable<V,K,KOV,H,E>::find_index(const Key2& key,size_type hash) const{
+        if(size_ == 0) return capacity_;
+        swiss::probe_seq seq(swiss::h1(hash),capacity_);
+        const ctrl_t h2 = swiss::h2(hash);
+        for(;;){
+            swiss::group g(ctrl_ + seq.offset());
+            for(auto m = g.match(h2);m;++m){
+                const size_type i = seq.offset(*m);
+                if(equal_(get_key_(*element_at(i)),key)){
+                    return i;
+                }
+            }
+            // 组内有空槽说明探测序列到此为止
+            if(g.match_empty()) return capacity_;
+            seq.next();
+            MYSTL_DEBUG(seq.index() <= capacity_ && "full table!");
+        }
+    }
+
+    template<class V,class K,class KOV,class H,class E>
+    typename flat_hashtable<V,K,KOV,H,E>::size_type
+    flat_hashtable<V,K,KOV,H,E>::find_first_non_full(size_type hash) const noexcept{
+        swiss::probe_seq seq(swiss::h1(hash),capacity_);
+        for(;;){
+            swiss::group g(ctrl_ + seq.offset());
+            auto m = g.match_empty_or_deleted();
+            if(m){
+                return seq.offset(m.lowest());
+            }
+            seq.next();
+            MYSTL_DEBUG(seq.index() <= capacity_ && "full table!");
+        }
+    }
+
+    template<class V,class K,class KOV,class H,class E>
+    void flat_hashtable<V,K,KOV,H,E>::commit_insert(size_type i,size_type hash) noexcept{
+        ++size_;
+        // 复用墓碑不消耗增长余量
+        growth_left_ -= (ctrl_[i] == swiss::kEmpty) ? 1 : 0;
+        set_ctrl(i,swiss::h2(hash));
+    }
+
+    template<class V,class K,class KOV,class H,class E>
+    template<class Key2>
+    typename flat_hashtable<V,K,KOV,H,E>::insert_slot
+    flat_hashtable<V,K,KOV,H,E>::find_or_prepare_insert(const Key2& key){
+        const size_type hash = hash_key(key);
+        const size_type found = find_index(key,hash);
+        if(found != capacity_){
+            return insert_slot{found,hash,false};
+        }
+        size_type i = find_first_non_full(hash);
+        if(growth_left_ == 0 && ctrl_[i] != swiss::kDeleted){
+            rehash_and_grow_if_necessary();
+            i = find_first_non_full(hash);
+        }
+        return insert_slot{i,hash,true};
+    }
+
+    // 先在栈上构造元素拿到键，未找到时再移动进表
+    template<class V,class K,class KOV,class H,class E>
+    template<class... Args>
+    hxqstl::pair<typename flat_hashtable<V,K,KOV,H,E>::iterator,bool>
+    flat_hashtable<V,K,KOV,H,E>::emplace_unique(Args&&... args){
+        mutable_value tmp(hxqstl::forward<Args>(args)...);
+        const insert_slot s = find_or_prepare_insert(key_of(tmp));
+        if(s.inserted){
+            construct_at(s,hxqstl::move(tmp));
+        }
+        return hxqstl::pair<iterator,bool>(iterator_at(s.index),s.inserted);
+    }
+
+    // 参数不是 value_type 时(例如 pair<Key,T>)先构造出元素再取键
+    template<class V,class K,class KOV,class H,class E>
+    template<class Val>
+    hxqstl::pair<typename flat_hashtable<V,K,KOV,H,E>::iterator,bool>
+    flat_hashtable<V,K,KOV,H,E>::insert_unique(Val&& value){
+        return insert_unique_dispatch(hxqstl::forward<Val>(value),
+            std::is_same<typename std::decay<Val>::type,value_type>{});
+    }
+
+    template<class V,class K,class KOV,class H,class E>
+    template<class Val>
+    hxqstl::pair<typename flat_hashtable<V,K,KOV,H,E>::iterator,bool>
+    flat_hashtable<V,K,KOV,H,E>::insert_unique_dispatch(Val&& value,std::true_type){
+        const insert_slot s = find_or_prepare_insert(get_key_(value));
+        if(s.inserted){
+            construct_at(s,hxqstl::forward<Val>(value));
+        }
+        return hxqstl::pair<iterator,bool>(iterator_at(s.index),s.inserted);
+    }
+
+    template<class V,class K,class KOV,class H,class E>
+    template<class Key2>
+    typename flat_hashtable<V,K,KOV,H,E>::size_type
+    flat_hashtable<V,K,KOV,H,E>::erase_key(const Key2& key){
+        const size_type i = find_index(key,hash_key(key));
+        if(i == capacity_) return 0;
+        erase_at(iterator_at(i));
+        return 1;
+    }
+
+    // 删除只留下墓碑，由下一次增长时的 rehash 回收
+    template<class V,class K,class KOV,class H,class E>
+    void flat_hashtable<V,K,KOV,H,E>::erase_at(iterator it){
+        const size_type i = static_cast<size_type>(it.ctrl - ctrl_);
+        MYSTL_DEBUG(i < capacity_ && swiss::is_full(ctrl_[i]));
+        hxqstl::destroy(policy::mutable_element(slots_ + i));
+        --size_;
+        set_ctrl(i,swiss::kDeleted);
+    }
+
+    template<class V,class K,class KOV,class H,class E>
+    void flat_hashtable<V,K,KOV,H,E>::clear(){
+        if(capacity_ == 0) return;
+        for(size_type i = 0;i != capacity_;++i){
+            if(swiss::is_full(ctrl_[i])){
+                hxqstl::destroy(policy::mutable_element(slots_ + i));
+            }
+        }
+        std::memset(ctrl_,static_cast<unsigned char>(swiss::kEmpty),capacity_ + swiss::kWidth);
+        ctrl_[capacity_] = swiss::kSentinel;
+        size_ = 0;
+        growth_left_ = swiss::capacity_to_growth(capacity_);
+    }
+
+    // 墓碑较多时原地重建，否则容量翻倍
+    template<class V,class K,class KOV,class H,class E>
+    void flat_hashtable<V,K,KOV,H,E>::rehash_and_grow_if_necessary(){
+        if(capacity_ == 0){
+            resize(1);
+        }
+        else if(size_ * 32 <= capacity_ * 25){
+            resize(capacity_);
+        }
+        else{
+            resize(capacity_ * 2 + 1);
+        }
+    }
+
+    // 先为所有旧元素算好哈希，再分配新数组，哈希抛出或分配失败时表保持原样
+    // 搬迁用 move_if_noexcept：移动不会抛出时直接移动，之后不会再失败；
+    // 否则拷贝，旧元素留在原处，拷贝抛出时析构已搬入的元素、释放新数组即可恢复旧表
+    template<class V,class K,class KOV,class H,class E>
+    void flat_hashtable<V,K,KOV,H,E>::resize(size_type new_cap){
+        const size_type old_size = size_;
+        size_type* hashes = old_size == 0 ? nullptr : hash_allocator::allocate(old_size);
+        unsigned char* mem = nullptr;
+        try{
+            for(size_type i = 0,k = 0;k != old_size;++i){
+                if(swiss::is_full(ctrl_[i])){
+                    hashes[k++] = hash_key(get_key_(*element_at(i)));
+                }
+            }
+            mem = raw_allocator::allocate(alloc_size(new_cap),slot_align());
+        }
+        catch(...){
+            hash_allocator::deallocate(hashes,old_size);
+            throw;
+        }
+
+        ctrl_t* old_ctrl = ctrl_;
+        slot_type* old_slots = slots_;
+        const size_type old_cap = capacity_;
+        const size_type old_growth = growth_left_;
+
+        size_ = 0;
+        slots_ = reinterpret_cast<slot_type*>(mem);
+        ctrl_ = reinterpret_cast<ctrl_t*>(mem + new_cap * sizeof(slot_type));
+        std::memset(ctrl_,static_cast<unsigned char>(swiss::kEmpty),new_cap + swiss::kWidth);
+        ctrl_[new_cap] = swiss::kSentinel;
+        capacity_ = new_cap;
+        growth_left_ = swiss::capacity_to_growth(new_cap);
+        try{
+            for(size_type i = 0,k = 0;k != old_size;++i){
+                if(swiss::is_full(old_ctrl[i])){
+                    const size_type hash = hashes[k++];
+                    const size_type j = find_first_non_full(hash);
+                    mutable_allocator::construct(policy::mutable_element(slots_ + j),
+                        hxqstl::move_if_noexcept(*policy::mutable_element(old_slots + i)));
+                    commit_insert(j,hash);
+                }
+            }
+        }
+        catch(...){
+            for(size_type i = 0;i != new_cap;++i){
+                if(swiss::is_full(ctrl_[i])){
+                    hxqstl::destroy(policy::mutable_element(slots_ + i));
+                }
+            }
+            raw_allocator::deallocate(mem,alloc_size(new_cap),slot_align());
+            hash_allocator::deallocate(hashes,old_size);
+            ctrl_ = old_ctrl;
+            slots_ = old_slots;
+            capacity_ = old_cap;
+            size_ = old_size;
+            growth_left_ = old_growth;
+            throw;
+        }
+        MYSTL_DEBUG(size_ == old_size);
+        hash_allocator::deallocate(hashes,old_size);
+        if(old_cap != 0){
+            for(size_type i = 0;i != old_cap;++i){
+                if(swiss::is_full(old_ctrl[i])){
+                    hxqstl::destroy(policy::mutable_element(old_slots + i));
+                }
+            }
+            raw_allocator::deallocate(reinterpret_cast<unsigned char*>(old_slots),alloc_size(old_cap),slot_align());
+        }
+    }
+
+    template<class V,class K,class KOV,class H,class E>
+    void flat_hashtable<V,K,KOV,H,E>::reserve(size_type n){
+        if(n > size_ + growth_left_){
+            resize(swiss::normalize_capacity(n));
+        }
+    }
+
+    template<class V,class K,class KOV,class H,class E>
+    void flat_hashtable<V,K,KOV,H,E>::rehash(size_type n){
+        const size_type need = hxqstl::max(n,size_);
+        if(need == 0){
+            if(size_ == 0){
+                destroy_slots();
+            }
+            return;
+        }
+        const size_type cap = swiss::normalize_capacity(need);
+        if(cap != capacity_ || growth_left_ + size_ < swiss::capacity_to_growth(capacity_)){
+            resize(cap);
+        }
+    }
+
+    template<class V,class K,class KOV,class H,class E>
+    void flat_hashtable<V,K,KOV,H,E>::swap(flat_hashtable& rhs) noexcept{
+        hxqstl::swap(ctrl_,rhs.ctrl_);
+        hxqstl::swap(slots_,rhs.slots_);
+        hxqstl::swap(size_,rhs.size_);
+        hxqstl::swap(capacity_,rhs.capacity_);
+        hxqstl::swap(growth_left_,rhs.growth_left_);
+        hxqstl::swap(hash_,rhs.hash_);
+        hxqstl::swap(equal_,rhs.equal_);
+    }
+}
@@ -0,0 +1,498 @@
+#pragma once
+
+// flat_map
+// 以两个有序的 hxqstl::vector 分别保存键和值的有序映射
+// 键单独连续存放，查找时只访问键数组，cache 利用率比红黑树和 vector<pair> 都高
+// 适合读多写少的中小规模数据：查找 O(log n)，单个插入/删除 O(n)，
+// 批量插入 insert(first,last) 先排序再与原有数据做一次归并，为 O(n + m log m)
+// 批量插入提供强异常保证：比较器或元素搬运抛出时容器保持原样
+// 任何插入/删除都会使迭代器和引用失效
+
+#include <initializer_list>
+
+#include "algo.h"
+#include "functional.h"
+#include "iterator.h"
+#include "util.h"
+#include "vector.h"
+#include "exceptdef.h"
+
+namespace hxqstl{
+    // 无分支的二分查找，返回第一个不小于 key 的位置
+    // 循环内只有一次比较和一次条件赋值，编译器会生成 cmov，避免分支预测失败
+    template<class T,class K,class Compare>
+    const T* branchless_lower_bound(const T* first,size_t n,const K& key,Compare comp){
+        if(n == 0) return first;
+        while(n > 1){
+            const size_t half = n / 2;
+            first = comp(first[half - 1],key) ? first + half : first;
+            n -= half;
+        }
+        return first + (comp(*first,key) ? 1 : 0);
+    }
+
+    // 撤销一次 move_if_noexcept：只有当时确实发生了移动才需要把元素搬回原处
+    template<class T>
+    void undo_move_if_noexcept(T& dst,T& src,std::true_type) {dst = hxqstl::move(src);}
+    template<class T>
+    void undo_move_if_noexcept(T&,T&,std::false_type) noexcept {}
+    template<class T>
+    void undo_move_if_noexcept(T& dst,T& src){
+        hxqstl::undo_move_if_noexcept(dst,src,std::integral_constant<bool,
+            std::is_nothrow_move_constructible<T>::value || !std::is_copy_constructible<T>::value>());
+    }
+
+    // flat_map 和 flat_set 的批量插入：把 buf 中的新元素合并进以有序数组 keys 为键的容器
+    // KeyOf 从 buf 的元素取键；Store 负责写入新数组，提供
+    //   reserve(n)、size()、push_new(elem)、push_old(i)、undo_old(i,p)、commit()
+    // 分三步完成，任何一步抛出时容器保持原样：
+    //   1. 对 buf 排序去重，只改动 buf
+    //   2. 只做比较，记下每个新元素在原数组中的插入位置，键已存在的记为 dropped
+    //   3. 按计划搬运，不再调用比较器；原有元素以 move_if_noexcept 搬出，
+    //      中途抛出时按同样的计划重放，由 undo_old 把第 p 个输出搬回原有的第 i 个位置
+    template<class Buf,class Keys,class Store,class KeyOf,class Compare>
+    void flat_merge_insert(Buf& buf,const Keys& keys,Store& store,KeyOf key_of,const Compare& comp){
+        typedef typename Keys::size_type size_type;
+        typedef typename Buf::value_type elem_type;
+        if(buf.empty()) return;
+
+        // 键相等时保留先出现的元素
+        hxqstl::stable_sort(buf.begin(),buf.end(),[&](const elem_type& a,const elem_type& b){
+            return comp(key_of(a),key_of(b));
+        });
+        auto buf_end = hxqstl::unique(buf.begin(),buf.end(),[&](const elem_type& a,const elem_type& b){
+            return !comp(key_of(a),key_of(b));
+        });
+
+        const size_type n = keys.size();
+        const size_type m = static_cast<size_type>(buf_end - buf.begin());
+        const size_type dropped = static_cast<size_type>(-1);
+        hxqstl::vector<size_type> pos(m);
+        size_type added = 0;
+        for(size_type i = 0,b = 0;b < m;++b){
+            while(i < n && comp(keys[i],key_of(buf[b]))) ++i;
+            // 键已存在时保留原有元素
+            if(i < n && !comp(key_of(buf[b]),keys[i])) pos[b] = dropped;
+            else {pos[b] = i;++added;}
+        }
+        if(added == 0) return;
+
+        store.reserve(n + added);
+        size_type i = 0,b = 0;
+        try{
+            while(i < n || b < m){
+                if(b < m && pos[b] == dropped){
+                    ++b;
+                }
+                else if(b < m && pos[b] == i){
+                    store.push_new(hxqstl::move(buf[b]));
+                    ++b;
+                }
+                else{
+                    store.push_old(i);
+                    ++i;
+                }
+            }
+        }
+        catch(...){
+            for(size_type p = 0,j = 0,c = 0;p < store.size();){
+                if(c < m && pos[c] == dropped){
+                    ++c;
+                }
+                else if(c < m && pos[c] == j){
+                    ++c;++p;
+                }
+                else{
+                    store.undo_old(j,p);
+                    ++j;++p;
+                }
+            }
+            throw;
+        }
+        store.commit();
+    }
+
+    // flat_map 的迭代器，同时指向键数组和值数组的同一位置
+    // 解引用得到 pair<const Key&,T&> 的代理对象
+    template<class Key,class T,class ValueRef>
+    struct flat_map_iterator : public iterator<random_access_iterator_tag,hxqstl::pair<Key,T>>
+    {
+        typedef hxqstl::pair<const Key&,ValueRef> reference;
+        typedef ptrdiff_t difference_type;
+        typedef flat_map_iterator self;
+
+        // operator-> 需要返回指针，用一个保存代理对象的小结构转接
+        struct arrow_proxy
+        {
+            reference ref;
+            reference* operator->() {return &ref;}
+        };
+        typedef arrow_proxy pointer;
+
+        typedef typename std::conditional<std::is_const<typename std::remove_reference<ValueRef>::type>::value,
+                                          const T*,T*>::type value_pointer;
+
+        const Key* kp;
+        value_pointer vp;
+
+        flat_map_iterator() noexcept : kp(nullptr),vp(nullptr) {}
+        flat_map_iterator(const Key* k,value_pointer v) noexcept : kp(k),vp(v) {}
+
+        // 允许 iterator 转换为 const_iterator
+        template<class R>
+        flat_map_iterator(const flat_map_iterator<Key,T,R>& rhs) noexcept : kp(rhs.kp),vp(rhs.vp) {}
+
+        const Key& key() const {return *kp;}
+        ValueRef value() const {return *vp;}
+
+        reference operator*() const {return reference(*kp,*vp);}
+        pointer operator->() const {return pointer{reference(*kp,*vp)};}
+        reference operator[](difference_type n) const {return reference(kp[n],vp[n]);}
+
+        self& operator++() {++kp;++vp;return *this;}
+        self operator++(int) {self tmp = *this;++*this;return tmp;}
+        self& operator--() {--kp;--vp;return *this;}
+        self operator--(int) {self tmp = *this;--*this;return tmp;}
+        self& operator+=(difference_type n) {kp += n;vp += n;return *this;}
+        self& operator-=(difference_type n) {kp -= n;vp -= n;return *this;}
+        self operator+(difference_type n) const {return self(kp + n,vp + n);}
+        self operator-(difference_type n) const {return self(kp - n,vp - n);}
+        difference_type operator-(const self& rhs) const {return kp - rhs.kp;}
+
+        bool operator==(const self& rhs) const {return kp == rhs.kp;}
+        bool operator!=(const self& rhs) const {return kp != rhs.kp;}
+        bool operator<(const self& rhs) const {return kp < rhs.kp;}
+        bool operator>(const self& rhs) const {return rhs.kp < kp;}
+        bool operator<=(const self& rhs) const {return !(rhs.kp < kp);}
+        bool operator>=(const self& rhs) const {return !(kp < rhs.kp);}
+    };
+
+    template<class Key,class T,class Compare = hxqstl::less<Key>>
+    class flat_map{
+        public:
+            typedef Key key_type;
+            typedef T mapped_type;
+            typedef hxqstl::pair<Key,T> value_type;
+            typedef Compare key_compare;
+            typedef hxqstl::vector<Key> key_container_type;
+            typedef hxqstl::vector<T> mapped_container_type;
+
+            typedef size_t size_type;
+            typedef ptrdiff_t difference_type;
+
+            typedef flat_map_iterator<Key,T,T&> iterator;
+            typedef flat_map_iterator<Key,T,const T&> const_iterator;
+            typedef typename iterator::reference reference;
+            typedef typename const_iterator::reference const_reference;
+
+            // 比较两个 value_type 的键
+            class value_compare
+            {
+                friend class flat_map;
+                Compare comp;
+                explicit value_compare(Compare c) : comp(c) {}
+            public:
+                bool operator()(const value_type& lhs,const value_type& rhs) const
+                { return comp(lhs.first,rhs.first); }
+            };
+
+        private:
+            key_container_type keys_;
+            mapped_container_type values_;
+            key_compare comp_;
+
+        public:
+            flat_map() : keys_(),values_(),comp_() {}
+
+            explicit flat_map(const Compare& comp) : keys_(),values_(),comp_(comp) {}
+
+            template<class InputIter,typename std::enable_if<
+                hxqstl::is_input_iterator<InputIter>::value,int>::type = 0>
+            flat_map(InputIter first,InputIter last,const Compare& comp = Compare())
+            :keys_(),values_(),comp_(comp)
+            {
+                insert(first,last);
+            }
+
+            flat_map(std::initializer_list<value_type> ilist,const Compare& comp = Compare())
+            :keys_(),values_(),comp_(comp)
+            {
+                insert(ilist.begin(),ilist.end());
+            }
+
+            flat_map(const flat_map& rhs) = default;
+            flat_map(flat_map&& rhs) noexcept
+            :keys_(hxqstl::move(rhs.keys_)),values_(hxqstl::move(rhs.values_)),comp_(rhs.comp_) {}
+
+            flat_map& operator=(const flat_map& rhs) = default;
+            flat_map& operator=(flat_map&& rhs) noexcept
+            {
+                keys_ = hxqstl::move(rhs.keys_);
+                values_ = hxqstl::move(rhs.values_);
+                comp_ = rhs.comp_;
+                return *this;
+            }
+
+            ~flat_map() = default;
+
+        public:
+            iterator begin() noexcept {return iterator(keys_.data(),values_.data());}
+            const_iterator begin() const noexcept {return const_iterator(keys_.data(),values_.data());}
+            iterator end() noexcept {return iterator(keys_.data() + size(),values_.data() + size());}
+            const_iterator end() const noexcept {return const_iterator(keys_.data() + size(),values_.data() + size());}
+            const_iterator cbegin() const noexcept {return begin();}
+            const_iterator cend() const noexcept {return end();}
+
+            bool empty() const noexcept {return keys_.empty();}
+            size_type size() const noexcept {return keys_.size();}
+            size_type max_size() const noexcept {return keys_.max_size();}
+            size_type capacity() const noexcept {return keys_.capacity();}
+
+            void reserve(size_type n)
+            {
+                keys_.reserve(n);
+                values_.reserve(n);
+            }
+            void shrink_to_fit()
+            {
+                keys_.shrink_to_fit();
+                values_.shrink_to_fit();
+            }
+
+            // 直接访问底层的键/值数组，便于批量计算
+            const key_container_type& keys() const noexcept {return keys_;}
+            const mapped_container_type& values() const noexcept {return values_;}
+
+            key_compare key_comp() const {return comp_;}
+            value_compare value_comp() const {return value_compare(comp_);}
+
+            mapped_type& operator[](const key_type& key)
+            { return try_emplace(key).first.value(); }
+            mapped_type& operator[](key_type&& key)
+            { return try_emplace(hxqstl::move(key)).first.value(); }
+
+            mapped_type& at(const key_type& key)
+            {
+                iterator it = find(key);
+                THROW_OUT_OF_RANGE_IF(it == end(),"flat_map<Key,T> no such element exists");
+                return it.value();
+            }
+            const mapped_type& at(const key_type& key) const
+            {
+                const_iterator it = find(key);
+                THROW_OUT_OF_RANGE_IF(it == end(),"flat_map<Key,T> no such element exists");
+                return it.value();
+            }
+
+            hxqstl::pair<iterator,bool> insert(const value_type& value)
+            { return try_emplace(value.first,value.second); }
+            hxqstl::pair<iterator,bool> insert(value_type&& value)
+            { return try_emplace(hxqstl::move(value.first),hxqstl::move(value.second)); }
+
+            template<class... Args>
+            hxqstl::pair<iterator,bool> emplace(Args&&... args)
+            {
+                value_type tmp(hxqstl::forward<Args>(args)...);
+                return insert(hxqstl::move(tmp));
+            }
+
+            template<class K,class... Args>
+            hxqstl::pair<iterator,bool> try_emplace(K&& key,Args&&... args);
+
+            template<class M>
+            hxqstl::pair<iterator,bool> insert_or_assign(const key_type& key,M&& obj)
+            {
+                auto res = try_emplace(key,hxqstl::forward<M>(obj));
+                if(!res.second){
+                    res.first.value() = hxqstl::forward<M>(obj);
+                }
+                return res;
+            }
+
+            // 批量插入：先把新元素排序去重，再与现有数据做一次线性归并，只分配一次内存
+            // 已存在的键保留原值，新元素中重复的键保留先出现的那个
+            template<class InputIter>
+            void insert(InputIter first,InputIter last);
+            void insert(std::initializer_list<value_type> ilist)
+            { insert(ilist.begin(),ilist.end()); }
+
+            iterator erase(const_iterator pos);
+            iterator erase(const_iterator first,const_iterator last);
+            size_type erase(const key_type& key);
+
+            void clear()
+            {
+                keys_.clear();
+                values_.clear();
+            }
+
+            void swap(flat_map& rhs) noexcept
+            {
+                keys_.swap(rhs.keys_);
+                values_.swap(rhs.values_);
+                hxqstl::swap(comp_,rhs.comp_);
+            }
+
+            iterator lower_bound(const key_type& key)
+            { return iterator_at(lower_index(key)); }
+            const_iterator lower_bound(const key_type& key) const
+            { return const_iterator_at(lower_index(key)); }
+            iterator upper_bound(const key_type& key)
+            {
+                const size_type i = lower_index(key);
+                return iterator_at(i < size() && !comp_(key,keys_[i]) ? i + 1 : i);
+            }
+            const_iterator upper_bound(const key_type& key) const
+            {
+                const size_type i = lower_index(key);
+                return const_iterator_at(i < size() && !comp_(key,keys_[i]) ? i + 1 : i);
+            }
+            hxqstl::pair<iterator,iterator> equal_range(const key_type& key)
+            { return hxqstl::pair<iterator,iterator>(lower_bound(key),upper_bound(key)); }
+            hxqstl::pair<const_iterator,const_iterator> equal_range(const key_type& key) const
+            { return hxqstl::pair<const_iterator,const_iterator>(lower_bound(key),upper_bound(key)); }
+
+            iterator find(const key_type& key)
+            {
+                const size_type i = find_index(key);
+                return i == size() ? end() : iterator_at(i);
+            }
+            const_iterator find(const key_type& key) const
+            {
+                const size_type i = find_index(key);
+                return i == size() ? end() : const_iterator_at(i);
+            }
+            bool contains(const key_type& key) const {return find_index(key) != size();}
+            size_type count(const key_type& key) const {return contains(key) ? 1 : 0;}
+
+        private:
+            // insert(first,last) 归并时写入的新数组，见 flat_merge_insert
+            struct merge_store
+            {
+                flat_map& self;
+                key_container_type keys;
+                mapped_container_type values;
+
+                void reserve(size_type n) {keys.reserve(n);values.reserve(n);}
+                size_type size() const noexcept {return keys.size();}
+                void push_new(value_type&& v)
+                {
+                    keys.emplace_back(hxqstl::move(v.first));
+                    values.emplace_back(hxqstl::move(v.second));
+                }
+                void push_old(size_type i)
+                {
+                    keys.emplace_back(hxqstl::move_if_noexcept(self.keys_[i]));
+                    values.emplace_back(hxqstl::move_if_noexcept(self.values_[i]));
+                }
+                // 值可能还没有搬出
+                void undo_old(size_type i,size_type p)
+                {
+                    hxqstl::undo_move_if_noexcept(self.keys_[i],keys[p]);
+                    if(p < values.size()) hxqstl::undo_move_if_noexcept(self.values_[i],values[p]);
+                }
+                void commit() noexcept {self.keys_.swap(keys);self.values_.swap(values);}
+            };
+
+            size_type lower_index(const key_type& key) const
+            {
+                return static_cast<size_type>(
+                    hxqstl::branchless_lower_bound(keys_.data(),keys_.size(),key,comp_) - keys_.data());
+            }
+            size_type find_index(const key_type& key) const
+            {
+                const size_type i = lower_index(key);
+                return (i < size() && !comp_(key,keys_[i])) ? i : size();
+            }
+            iterator iterator_at(size_type i)
+            { return iterator(keys_.data() + i,values_.data() + i); }
+            const_iterator const_iterator_at(size_type i) const
+            { return const_iterator(keys_.data() + i,values_.data() + i); }
+    };
+
+    /*****************************************************************************************/
+
+    template<class Key,class T,class Compare>
+    template<class K,class... Args>
+    hxqstl::pair<typename flat_map<Key,T,Compare>::iterator,bool>
+    flat_map<Key,T,Compare>::try_emplace(K&& key,Args&&... args){
+        const size_type i = lower_index(key);
+        if(i < size() && !comp_(key,keys_[i])){
+            return hxqstl::pair<iterator,bool>(iterator_at(i),false);
+        }
+        keys_.emplace(keys_.begin() + i,hxqstl::forward<K>(key));
+        try{
+            values_.emplace(values_.begin() + i,hxqstl::forward<Args>(args)...);
+        }
+        catch(...){
+            // 保持两个数组长度一致
+            keys_.erase(keys_.begin() + i);
+            throw;
+        }
+        return hxqstl::pair<iterator,bool>(iterator_at(i),true);
+    }
+
+    template<class Key,class T,class Compare>
+    template<class InputIter>
+    void flat_map<Key,T,Compare>::insert(InputIter first,InputIter last){
+        hxqstl::vector<value_type> buf;
+        for(;first != last;++first){
+            buf.emplace_back(*first);
+        }
+        merge_store store = {*this,key_container_type(),mapped_container_type()};
+        hxqstl::flat_merge_insert(buf,keys_,store,hxqstl::selectfirst<value_type>(),comp_);
+    }
+
+    template<class Key,class T,class Compare>
+    typename flat_map<Key,T,Compare>::iterator
+    flat_map<Key,T,Compare>::erase(const_iterator pos){
+        const size_type i = static_cast<size_type>(pos.kp - keys_.data());
+        keys_.erase(keys_.begin() + i);
+        values_.erase(values_.begin() + i);
+        return iterator_at(i);
+    }
+
+    template<class Key,class T,class Compare>
+    typename flat_map<Key,T,Compare>::iterator
+    flat_map<Key,T,Compare>::erase(const_iterator first,const_iterator last){
+        const size_type i = static_cast<size_type>(first.kp - keys_.data());
+        const size_type j = static_cast<size_type>(last.kp - keys_.data());
+        keys_.erase(keys_.begin() + i,keys_.begin() + j);
+        values_.erase(values_.begin() + i,values_.begin() + j);
+        return iterator_at(i);
+    }
+
+    template<class Key,class T,class Compare>
+    typename flat_map<Key,T,Compare>::size_type
+    flat_map<Key,T,Compare>::erase(const key_type& key){
+        const size_type i = find_index(key);
+        if(i == size()) return 0;
+        keys_.erase(keys_.begin() + i);
+        values_.erase(values_.begin() + i);
+        return 1;
+    }
+
+    template<class Key,class T,class Compare>
+    bool operator==(const flat_map<Key,T,Compare>& lhs,const flat_map<Key,T,Compare>& rhs)
+    {
+        if(lhs.size() != rhs.size()) return false;
+        for(size_t i = 0;i < lhs.size();++i){
+            if(!(lhs.keys()[i] == rhs.keys()[i]) || !(lhs.values()[i] == rhs.values()[i])){
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<class Key,class T,class Compare>
+    bool operator!=(const flat_map<Key,T,Compare>& lhs,const flat_map<Key,T,Compare>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template<class Key,class T,class Compare>
+    void swap(flat_map<Key,T,Compare>& lhs,flat_map<Key,T,Compare>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+}
@@ -0,0 +1,208 @@
+#pragma once
+
+// flat_set
+// 以有序 hxqstl::vector 保存元素的有序集合，查找使用无分支二分
+// 批量插入 insert(first,last) 先排序去重，再与原有数据做一次归并
+// 批量插入提供强异常保证：比较器或元素搬运抛出时容器保持原样
+// 任何插入/删除都会使迭代器和引用失效
+
+#include <initializer_list>
+
+#include "flat_map.h"
+
+namespace hxqstl{
+    template<class Key,class Compare = hxqstl::less<Key>>
+    class flat_set{
+        public:
+            typedef Key key_type;
+            typedef Key value_type;
+            typedef Compare key_compare;
+            typedef Compare value_compare;
+            typedef hxqstl::vector<Key> container_type;
+
+            typedef size_t size_type;
+            typedef ptrdiff_t difference_type;
+            typedef const Key& reference;
+            typedef const Key& const_reference;
+
+            // 集合的元素不可修改，iterator 与 const_iterator 相同
+            typedef const Key* iterator;
+            typedef const Key* const_iterator;
+
+        private:
+            container_type data_;
+            key_compare comp_;
+
+        public:
+            flat_set() : data_(),comp_() {}
+
+            explicit flat_set(const Compare& comp) : data_(),comp_(comp) {}
+
+            template<class InputIter,typename std::enable_if<
+                hxqstl::is_input_iterator<InputIter>::value,int>::type = 0>
+            flat_set(InputIter first,InputIter last,const Compare& comp = Compare())
+            :data_(),comp_(comp)
+            {
+                insert(first,last);
+            }
+
+            flat_set(std::initializer_list<value_type> ilist,const Compare& comp = Compare())
+            :data_(),comp_(comp)
+            {
+                insert(ilist.begin(),ilist.end());
+            }
+
+            flat_set(const flat_set& rhs) = default;
+            flat_set(flat_set&& rhs) noexcept : data_(hxqstl::move(rhs.data_)),comp_(rhs.comp_) {}
+
+            flat_set& operator=(const flat_set& rhs) = default;
+            flat_set& operator=(flat_set&& rhs) noexcept
+            {
+                data_ = hxqstl::move(rhs.data_);
+                comp_ = rhs.comp_;
+                return *this;
+            }
+
+            ~flat_set() = default;
+
+        public:
+            iterator begin() const noexcept {return data_.data();}
+            iterator end() const noexcept {return data_.data() + data_.size();}
+            const_iterator cbegin() const noexcept {return begin();}
+            const_iterator cend() const noexcept {return end();}
+
+            bool empty() const noexcept {return data_.empty();}
+            size_type size() const noexcept {return data_.size();}
+            size_type max_size() const noexcept {return data_.max_size();}
+            size_type capacity() const noexcept {return data_.capacity();}
+
+            void reserve(size_type n) {data_.reserve(n);}
+            void shrink_to_fit() {data_.shrink_to_fit();}
+
+            const container_type& keys() const noexcept {return data_;}
+
+            key_compare key_comp() const {return comp_;}
+            value_compare value_comp() const {return comp_;}
+
+            hxqstl::pair<iterator,bool> insert(const value_type& value)
+            { return emplace_key(value); }
+            hxqstl::pair<iterator,bool> insert(value_type&& value)
+            { return emplace_key(hxqstl::move(value)); }
+
+            template<class... Args>
+            hxqstl::pair<iterator,bool> emplace(Args&&... args)
+            { return emplace_key(value_type(hxqstl::forward<Args>(args)...)); }
+
+            template<class InputIter>
+            void insert(InputIter first,InputIter last);
+            void insert(std::initializer_list<value_type> ilist)
+            { insert(ilist.begin(),ilist.end()); }
+
+            iterator erase(const_iterator pos)
+            {
+                const size_type i = static_cast<size_type>(pos - begin());
+                data_.erase(data_.begin() + i);
+                return begin() + i;
+            }
+            iterator erase(const_iterator first,const_iterator last)
+            {
+                const size_type i = static_cast<size_type>(first - begin());
+                data_.erase(data_.begin() + i,data_.begin() + (last - begin()));
+                return begin() + i;
+            }
+            size_type erase(const key_type& key)
+            {
+                iterator it = find(key);
+                if(it == end()) return 0;
+                erase(it);
+                return 1;
+            }
+
+            void clear() {data_.clear();}
+
+            void swap(flat_set& rhs) noexcept
+            {
+                data_.swap(rhs.data_);
+                hxqstl::swap(comp_,rhs.comp_);
+            }
+
+            iterator lower_bound(const key_type& key) const
+            { return hxqstl::branchless_lower_bound(begin(),size(),key,comp_); }
+            iterator upper_bound(const key_type& key) const
+            {
+                iterator it = lower_bound(key);
+                return (it != end() && !comp_(key,*it)) ? it + 1 : it;
+            }
+            hxqstl::pair<iterator,iterator> equal_range(const key_type& key) const
+            { return hxqstl::pair<iterator,iterator>(lower_bound(key),upper_bound(key)); }
+
+            iterator find(const key_type& key) const
+            {
+                iterator it = lower_bound(key);
+                return (it != end() && !comp_(key,*it)) ? it : end();
+            }
+            bool contains(const key_type& key) const {return find(key) != end();}
+            size_type count(const key_type& key) const {return contains(key) ? 1 : 0;}
+
+        private:
+            // insert(first,last) 归并时写入的新数组，见 flat_merge_insert
+            struct merge_store
+            {
+                flat_set& self;
+                container_type data;
+
+                void reserve(size_type n) {data.reserve(n);}
+                size_type size() const noexcept {return data.size();}
+                void push_new(Key&& key) {data.emplace_back(hxqstl::move(key));}
+                void push_old(size_type i) {data.emplace_back(hxqstl::move_if_noexcept(self.data_[i]));}
+                void undo_old(size_type i,size_type p) {hxqstl::undo_move_if_noexcept(self.data_[i],data[p]);}
+                void commit() noexcept {self.data_.swap(data);}
+            };
+
+            template<class K>
+            hxqstl::pair<iterator,bool> emplace_key(K&& key)
+            {
+                const size_type i = static_cast<size_type>(lower_bound(key) - begin());
+                if(i < size() && !comp_(key,data_[i])){
+                    return hxqstl::pair<iterator,bool>(begin() + i,false);
+                }
+                data_.emplace(data_.begin() + i,hxqstl::forward<K>(key));
+                return hxqstl::pair<iterator,bool>(begin() + i,true);
+            }
+    };
+
+    /*****************************************************************************************/
+
+    template<class Key,class Compare>
+    template<class InputIter>
+    void flat_set<Key,Compare>::insert(InputIter first,InputIter last){
+        container_type buf;
+        for(;first != last;++first){
+            buf.emplace_back(*first);
+        }
+        merge_store store = {*this,container_type()};
+        hxqstl::flat_merge_insert(buf,data_,store,hxqstl::identity<Key>(),comp_);
+    }
+
+    template<class Key,class Compare>
+    bool operator==(const flat_set<Key,Compare>& lhs,const flat_set<Key,Compare>& rhs)
+    {
+        if(lhs.size() != rhs.size()) return false;
+        for(auto a = lhs.begin(),b = rhs.begin();a != lhs.end();++a,++b){
+            if(!(*a == *b)) return false;
+        }
+        return true;
+    }
+
+    template<class Key,class Compare>
+    bool operator!=(const flat_set<Key,Compare>& lhs,const flat_set<Key,Compare>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template<class Key,class Compare>
+    void swap(flat_set<Key,Compare>& lhs,flat_set<Key,Compare>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+// 函数对象：比较、相等、哈希
+
+#include <cstddef>
+#include <functional>
+
+namespace hxqstl{
+    template<class Arg1,class Arg2,class Result>
+    struct binary_function
+    {
+        typedef Arg1 first_argument_type;
+        typedef Arg2 second_argument_type;
+        typedef Result result_type;
+    };
+
+    // 小于
+    template<class T>
+    struct less : public binary_function<T,T,bool>
+    {
+        bool operator()(const T& x,const T& y) const {return x < y;}
+    };
+
+    // 大于
+    template<class T>
+    struct greater : public binary_function<T,T,bool>
+    {
+        bool operator()(const T& x,const T& y) const {return x > y;}
+    };
+
+    // 等于
+    template<class T>
+    struct equal_to : public binary_function<T,T,bool>
+    {
+        bool operator()(const T& x,const T& y) const {return x == y;}
+    };
+
+    // 证同：返回元素本身
+    template<class T>
+    struct identity
+    {
+        const T& operator()(const T& x) const {return x;}
+    };
+
+    // 选取 pair 的第一个元素
+    template<class Pair>
+    struct selectfirst
+    {
+        typedef typename Pair::first_type result_type;
+
+        const result_type& operator()(const Pair& x) const {return x.first;}
+    };
+
+    // 哈希函数对象
+    // 整数和指针直接使用其值，由容器负责再做一次混合；其余类型交给 std::hash
+    template<class Key>
+    struct hash
+    {
+        size_t operator()(const Key& key) const
+        {
+            return std::hash<Key>()(key);
+        }
+    };
+
+    template<class T>
+    struct hash<T*>
+    {
+        size_t operator()(T* p) const noexcept
+        {
+            return reinterpret_cast<size_t>(p);
+        }
+    };
+
+    #define HXQSTL_TRIVIAL_HASH_FCN(Type)           \
+    template<> struct hash<Type>                    \
+    {                                               \
+        size_t operator()(Type val) const noexcept  \
+        { return static_cast<size_t>(val); }        \
+    };
+
+    HXQSTL_TRIVIAL_HASH_FCN(bool)
+    HXQSTL_TRIVIAL_HASH_FCN(char)
+    HXQSTL_TRIVIAL_HASH_FCN(signed char)
+    HXQSTL_TRIVIAL_HASH_FCN(unsigned char)
+    HXQSTL_TRIVIAL_HASH_FCN(wchar_t)
+    HXQSTL_TRIVIAL_HASH_FCN(char16_t)
+    HXQSTL_TRIVIAL_HASH_FCN(char32_t)
+    HXQSTL_TRIVIAL_HASH_FCN(short)
+    HXQSTL_TRIVIAL_HASH_FCN(unsigned short)
+    HXQSTL_TRIVIAL_HASH_FCN(int)
+    HXQSTL_TRIVIAL_HASH_FCN(unsigned int)
+    HXQSTL_TRIVIAL_HASH_FCN(long)
+    HXQSTL_TRIVIAL_HASH_FCN(unsigned long)
+    HXQSTL_TRIVIAL_HASH_FCN(long long)
+    HXQSTL_TRIVIAL_HASH_FCN(unsigned long long)
+
+    #undef HXQSTL_TRIVIAL_HASH_FCN
+}
@@ -0,0 +1,336 @@
+#pragma once
+
+// 堆内存剖析器
+// 定义 MYSTL_HEAP_PROFILE 后 allocator<T> 会在分配/释放时调用这里的钩子，
+// 未定义时钩子不会被编译进去，没有任何开销
+// 统计内容：按类型 T 统计存活字节数，按分配大小(2 的幂分桶)统计存活字节数，
+// 每 N 次分配采样一次调用栈，可按需导出 pprof 可读的 heap profile
+
+#include <atomic>
+#include <mutex>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <typeinfo>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+#if defined(__GLIBC__) || defined(__APPLE__)
+#include <execinfo.h>
+#define MYSTL_HAS_BACKTRACE 1
+#endif
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+namespace hxqstl{
+    enum{EProfileMaxDepth = 32};
+    enum{EProfileBuckets = 64};
+
+    // 每个类型 T 一条记录，首次使用时挂到全局链表上
+    // next 在发布之前写好，之后不再修改；链表头用 release 发布、acquire 读取，遍历不需要加锁
+    struct heap_type_record
+    {
+        const char* name;
+        std::atomic<size_t> live_bytes;
+        std::atomic<size_t> live_objects;
+        std::atomic<size_t> total_bytes;
+        std::atomic<size_t> total_allocs;
+        heap_type_record* next;
+
+        explicit heap_type_record(const char* n);
+    };
+
+    // 一次被采样的分配，weight 是采样时的采样率，即这一个采样代表的分配次数
+    struct heap_sample
+    {
+        size_t bytes;
+        size_t weight;
+        int depth;
+        void* frames[EProfileMaxDepth];
+    };
+
+    class heap_profiler{
+    public:
+        template<class T>
+        static void on_allocate(void* p,size_t n);
+        template<class T>
+        static void on_deallocate(void* p,size_t n);
+
+        // 每 rate 次分配采样一次调用栈，0 表示不采样
+        static void set_sample_rate(size_t rate);
+        static size_t sample_rate();
+
+        // 按类型和大小分桶输出统计
+        static void report(FILE* out);
+        // 输出 pprof 兼容的 heap profile(legacy 文本格式)
+        static void dump_heap_profile(FILE* out);
+        static bool write_heap_profile(const char* path);
+
+        static std::atomic<heap_type_record*>& M_type_list();
+
+    private:
+        template<class T>
+        static heap_type_record& M_record();
+
+        static std::atomic<size_t>& M_rate();
+        static std::atomic<size_t>* M_bucket_bytes();
+        static std::atomic<size_t>* M_bucket_count();
+        static std::mutex& M_sample_lock();
+        static std::unordered_map<void*,heap_sample>& M_samples();
+        static std::atomic<size_t>& M_live_samples();
+
+        static size_t M_bucket_index(size_t bytes);
+        static size_t M_should_sample();
+        static void M_record_sample(void* p,size_t bytes,size_t weight);
+        static void M_erase_sample(void* p);
+        static const char* M_demangle(const char* name);
+    };
+
+    inline std::atomic<heap_type_record*>& heap_profiler::M_type_list(){
+        static std::atomic<heap_type_record*> head(nullptr);
+        return head;
+    }
+
+    inline heap_type_record::heap_type_record(const char* n)
+        :name(n),live_bytes(0),live_objects(0),total_bytes(0),total_allocs(0),next(nullptr)
+    {
+        // 函数内静态变量的初始化是线程安全的，这里只需要保证链表插入是原子的
+        // 加锁只是为了串行化插入，report 不加锁，靠 release 发布看到完整的记录
+        static std::mutex lock;
+        std::lock_guard<std::mutex> guard(lock);
+        next = heap_profiler::M_type_list().load(std::memory_order_relaxed);
+        heap_profiler::M_type_list().store(this,std::memory_order_release);
+    }
+
+    template<class T>
+    heap_type_record& heap_profiler::M_record(){
+        static heap_type_record rec(M_demangle(typeid(T).name()));
+        return rec;
+    }
+
+    inline std::atomic<size_t>& heap_profiler::M_rate(){
+        static std::atomic<size_t> rate(0);
+        return rate;
+    }
+
+    inline std::atomic<size_t>* heap_profiler::M_bucket_bytes(){
+        static std::atomic<size_t> buckets[EProfileBuckets] = {};
+        return buckets;
+    }
+
+    inline std::atomic<size_t>* heap_profiler::M_bucket_count(){
+        static std::atomic<size_t> buckets[EProfileBuckets] = {};
+        return buckets;
+    }
+
+    inline std::mutex& heap_profiler::M_sample_lock(){
+        static std::mutex lock;
+        return lock;
+    }
+
+    inline std::unordered_map<void*,heap_sample>& heap_profiler::M_samples(){
+        static std::unordered_map<void*,heap_sample> samples;
+        return samples;
+    }
+
+    inline std::atomic<size_t>& heap_profiler::M_live_samples(){
+        static std::atomic<size_t> n(0);
+        return n;
+    }
+
+    inline void heap_profiler::set_sample_rate(size_t rate){
+        M_rate().store(rate,std::memory_order_relaxed);
+    }
+
+    inline size_t heap_profiler::sample_rate(){
+        return M_rate().load(std::memory_order_relaxed);
+    }
+
+    // 桶 i 存放大小在 [2^i,2^(i+1)) 的分配
+    inline size_t heap_profiler::M_bucket_index(size_t bytes){
+        if(bytes == 0) return 0;
+#if defined(__GNUC__)
+        return static_cast<size_t>(63 - __builtin_clzll(static_cast<unsigned long long>(bytes)));
+#else
+        size_t i = 0;
+        while(bytes >>= 1) ++i;
+        return i;
+#endif
+    }
+
+    // 每个线程自己倒数，不需要同步；需要采样时返回当前的采样率，否则返回 0
+    inline size_t heap_profiler::M_should_sample(){
+        const size_t rate = sample_rate();
+        if(rate == 0) return 0;
+        static thread_local size_t countdown = 0;
+        if(countdown == 0 || countdown > rate){
+            countdown = rate;
+        }
+        return --countdown == 0 ? rate : 0;
+    }
+
+    inline void heap_profiler::M_record_sample(void* p,size_t bytes,size_t weight){
+        heap_sample s;
+        s.bytes = bytes;
+        s.weight = weight;
+#ifdef MYSTL_HAS_BACKTRACE
+        s.depth = ::backtrace(s.frames,EProfileMaxDepth);
+#else
+        s.depth = 0;
+#endif
+        std::lock_guard<std::mutex> guard(M_sample_lock());
+        M_samples()[p] = s;
+        M_live_samples().fetch_add(1,std::memory_order_relaxed);
+    }
+
+    inline void heap_profiler::M_erase_sample(void* p){
+        // 没有存活的采样时直接返回，不用加锁
+        if(M_live_samples().load(std::memory_order_relaxed) == 0) return;
+        std::lock_guard<std::mutex> guard(M_sample_lock());
+        if(M_samples().erase(p) != 0){
+            M_live_samples().fetch_sub(1,std::memory_order_relaxed);
+        }
+    }
+
+    inline const char* heap_profiler::M_demangle(const char* name){
+#if defined(__GNUG__)
+        int status = 0;
+        // 结果只在类型记录创建时申请一次，生命周期与程序相同
+        char* res = abi::__cxa_demangle(name,nullptr,nullptr,&status);
+        if(status == 0 && res != nullptr) return res;
+#endif
+        return name;
+    }
+
+    template<class T>
+    void heap_profiler::on_allocate(void* p,size_t n){
+        if(p == nullptr) return;
+        const size_t bytes = n * sizeof(T);
+        heap_type_record& rec = M_record<T>();
+        rec.live_bytes.fetch_add(bytes,std::memory_order_relaxed);
+        rec.live_objects.fetch_add(n,std::memory_order_relaxed);
+        rec.total_bytes.fetch_add(bytes,std::memory_order_relaxed);
+        rec.total_allocs.fetch_add(1,std::memory_order_relaxed);
+        const size_t b = M_bucket_index(bytes);
+        M_bucket_bytes()[b].fetch_add(bytes,std::memory_order_relaxed);
+        M_bucket_count()[b].fetch_add(1,std::memory_order_relaxed);
+        if(const size_t weight = M_should_sample()){
+            M_record_sample(p,bytes,weight);
+        }
+    }
+
+    template<class T>
+    void heap_profiler::on_deallocate(void* p,size_t n){
+        if(p == nullptr) return;
+        const size_t bytes = n * sizeof(T);
+        heap_type_record& rec = M_record<T>();
+        rec.live_bytes.fetch_sub(bytes,std::memory_order_relaxed);
+        rec.live_objects.fetch_sub(n,std::memory_order_relaxed);
+        const size_t b = M_bucket_index(bytes);
+        M_bucket_bytes()[b].fetch_sub(bytes,std::memory_order_relaxed);
+        M_bucket_count()[b].fetch_sub(1,std::memory_order_relaxed);
+        M_erase_sample(p);
+    }
+
+    inline void heap_profiler::report(FILE* out){
+        std::fprintf(out,"%-48s %16s %12s %16s %12s\n",
+                     "type","live_bytes","live_objs","total_bytes","allocs");
+        for(heap_type_record* r = M_type_list().load(std::memory_order_acquire);r != nullptr;r = r->next){
+            std::fprintf(out,"%-48s %16zu %12zu %16zu %12zu\n",r->name,
+                         r->live_bytes.load(std::memory_order_relaxed),
+                         r->live_objects.load(std::memory_order_relaxed),
+                         r->total_bytes.load(std::memory_order_relaxed),
+                         r->total_allocs.load(std::memory_order_relaxed));
+        }
+        std::fprintf(out,"\n%-24s %16s %12s\n","size bucket","live_bytes","live_allocs");
+        for(size_t i = 0;i < EProfileBuckets;++i){
+            const size_t cnt = M_bucket_count()[i].load(std::memory_order_relaxed);
+            if(cnt == 0) continue;
+            std::fprintf(out,"[2^%-2zu, 2^%-2zu)%12s %16zu %12zu\n",i,i + 1,"",
+                         M_bucket_bytes()[i].load(std::memory_order_relaxed),cnt);
+        }
+    }
+
+    // 格式参考 gperftools 的 legacy heap profile：
+    //   heap profile: <inuse_objs>: <inuse_bytes> [<alloc_objs>: <alloc_bytes>] @ heapprofile
+    //   <objs>: <bytes> [<objs>: <bytes>] @ <pc> <pc> ...
+    //   MAPPED_LIBRARIES:
+    //   /proc/self/maps 的内容
+    // 采样按次数进行，输出时每个采样乘以它被采样时的采样率做无偏估计，中途修改采样率不影响已有的采样
+    inline void heap_profiler::dump_heap_profile(FILE* out){
+        std::vector<heap_sample> samples;
+        {
+            std::lock_guard<std::mutex> guard(M_sample_lock());
+            samples.reserve(M_samples().size());
+            for(const auto& kv : M_samples()){
+                samples.push_back(kv.second);
+            }
+        }
+        // 调用栈相同的采样合并为一条
+        // 排序下标而不是元素，避免 std::sort 内部的 swap 与 hxqstl::swap 产生 ADL 歧义
+        std::vector<size_t> order(samples.size());
+        for(size_t i = 0;i < samples.size();++i) order[i] = i;
+        auto stack_less = [&samples](size_t x,size_t y){
+            const heap_sample& a = samples[x];
+            const heap_sample& b = samples[y];
+            if(a.depth != b.depth) return a.depth < b.depth;
+            return std::memcmp(a.frames,b.frames,a.depth * sizeof(void*)) < 0;
+        };
+        auto stack_equal = [&samples](size_t x,size_t y){
+            const heap_sample& a = samples[x];
+            const heap_sample& b = samples[y];
+            return a.depth == b.depth &&
+                   std::memcmp(a.frames,b.frames,a.depth * sizeof(void*)) == 0;
+        };
+        std::sort(order.begin(),order.end(),stack_less);
+
+        size_t total_objs = 0;
+        size_t total_bytes = 0;
+        for(const auto& s : samples){
+            total_objs += s.weight;
+            total_bytes += s.bytes * s.weight;
+        }
+
+        std::fprintf(out,"heap profile: %zu: %zu [%zu: %zu] @ heapprofile\n",
+                     total_objs,total_bytes,total_objs,total_bytes);
+        for(size_t i = 0;i < order.size();){
+            size_t j = i;
+            size_t objs = 0;
+            size_t bytes = 0;
+            while(j < order.size() && stack_equal(order[i],order[j])){
+                objs += samples[order[j]].weight;
+                bytes += samples[order[j]].bytes * samples[order[j]].weight;
+                ++j;
+            }
+            std::fprintf(out,"%zu: %zu [%zu: %zu] @",objs,bytes,objs,bytes);
+            const heap_sample& s = samples[order[i]];
+            for(int k = 0;k < s.depth;++k){
+                std::fprintf(out," %p",s.frames[k]);
+            }
+            std::fputc('\n',out);
+            i = j;
+        }
+
+        // pprof 需要映射表来符号化地址
+        std::fprintf(out,"\nMAPPED_LIBRARIES:\n");
+        if(FILE* maps = std::fopen("/proc/self/maps","r")){
+            char buf[4096];
+            size_t len;
+            while((len = std::fread(buf,1,sizeof(buf),maps)) > 0){
+                std::fwrite(buf,1,len,out);
+            }
+            std::fclose(maps);
+        }
+    }
+
+    inline bool heap_profiler::write_heap_profile(const char* path){
+        FILE* out = std::fopen(path,"w");
+        if(out == nullptr) return false;
+        dump_heap_profile(out);
+        return std::fclose(out) == 0;
+    }
+}
@@ -0,0 +1,1056 @@
+#pragma once
+
+// immutable_vector
+// 基于 RRB 树(relaxed radix balanced tree)的持久化 vector：任何修改都返回新版本，原来的版本保持不变
+// 新旧版本共享没有改动的节点，复制(快照)是 O(1)，push_back/set/pop_back 只复制根到叶子的一条路径，O(log32 n)
+// 节点带原子引用计数，不同线程可以同时读取、复制、销毁共享节点的各个版本
+// concat 和 take/drop 会产生不满的("relaxed")节点，内部节点总是保存累计大小表，
+// 查找时先按基数(下标右移)猜测子节点，再沿大小表向后修正，满树上猜测一次命中
+// transient 是批量修改模式：只被自己引用的节点直接原地修改，被其他版本共享的节点先复制再修改
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <new>
+
+#include "algobase.h"
+#include "alloc.h"
+#include "construct.h"
+#include "iterator.h"
+#include "uninitialized.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace hxqstl{
+    namespace rrb{
+        enum{ kBits = 5 };
+        enum{ kBranch = 1 << kBits };
+        // 拼接后允许比最少节点数多出的节点个数，越大拼接越快、查找时向后修正的步数越多
+        enum{ kExtras = 2 };
+
+        struct node_base
+        {
+            std::atomic<uint32_t> refs;
+            uint32_t count;     // 叶子为元素个数，内部节点为子节点个数
+        };
+
+        template<class T>
+        struct leaf_node : node_base
+        {
+            typename std::aligned_storage<sizeof(T),alignof(T)>::type raw[kBranch];
+
+            T* data() noexcept {return reinterpret_cast<T*>(raw);}
+            const T* data() const noexcept {return reinterpret_cast<const T*>(raw);}
+        };
+
+        struct inner_node : node_base
+        {
+            node_base* children[kBranch];
+            size_t sizes[kBranch];      // sizes[i] 为前 i + 1 棵子树的元素总数
+        };
+
+        // immutable_vector 和 transient 共用的树，负责节点的引用计数和所有修改算法
+        // 修改操作都是"原地"的：引用计数为 1 的节点直接改，否则先复制，
+        // 所以先复制一份 tree(只增加根的引用计数)再修改，得到的就是路径复制后的新版本
+        template<class T>
+        class tree{
+            public:
+                typedef T value_type;
+                typedef size_t size_type;
+                typedef leaf_node<T> leaf_type;
+
+            private:
+                node_base* root_;
+                size_type size_;
+                unsigned height_;       // 叶子的高度为 0
+
+            public:
+                tree() noexcept : root_(nullptr),size_(0),height_(0) {}
+                tree(const tree& rhs) noexcept : root_(rhs.root_),size_(rhs.size_),height_(rhs.height_)
+                {
+                    retain(root_);
+                }
+                tree(tree&& rhs) noexcept : root_(rhs.root_),size_(rhs.size_),height_(rhs.height_)
+                {
+                    rhs.root_ = nullptr;
+                    rhs.size_ = 0;
+                    rhs.height_ = 0;
+                }
+                tree& operator=(const tree& rhs) noexcept
+                {
+                    tree tmp(rhs);
+                    swap(tmp);
+                    return *this;
+                }
+                tree& operator=(tree&& rhs) noexcept
+                {
+                    tree tmp(hxqstl::move(rhs));
+                    swap(tmp);
+                    return *this;
+                }
+                ~tree() {release(root_,height_);}
+
+            public:
+                size_type size() const noexcept {return size_;}
+
+                // 返回第 n 个元素所在的叶子，n 改为叶子内的偏移
+                const leaf_type* leaf_at(size_type& n) const noexcept
+                {
+                    const node_base* node = root_;
+                    for(unsigned h = height_;h > 0;--h){
+                        const inner_node* in = static_cast<const inner_node*>(node);
+                        node = in->children[child_index(in,h,n)];
+                    }
+                    return static_cast<const leaf_type*>(node);
+                }
+
+                const value_type& operator[](size_type n) const noexcept
+                {
+                    const leaf_type* leaf = leaf_at(n);
+                    return leaf->data()[n];
+                }
+
+                template<class... Args>
+                void emplace_back(Args&&... args);
+                void pop_back();
+                template<class V>
+                void set(size_type n,V&& value);
+                void take(size_type n);
+                void drop(size_type n);
+                void append(const tree& rhs);
+
+                // 按顺序对每个叶子调用 f(const T* first,const T* last)
+                template<class F>
+                void for_each_chunk(F& f) const
+                {
+                    if(root_ != nullptr) chunks(root_,height_,f);
+                }
+
+                void clear() noexcept
+                {
+                    release(root_,height_);
+                    root_ = nullptr;
+                    size_ = 0;
+                    height_ = 0;
+                }
+
+                void swap(tree& rhs) noexcept
+                {
+                    hxqstl::swap(root_,rhs.root_);
+                    hxqstl::swap(size_,rhs.size_);
+                    hxqstl::swap(height_,rhs.height_);
+                }
+
+            private:
+                static leaf_type* as_leaf(node_base* n) noexcept {return static_cast<leaf_type*>(n);}
+                static inner_node* as_inner(node_base* n) noexcept {return static_cast<inner_node*>(n);}
+
+                static void retain(node_base* n) noexcept
+                {
+                    if(n != nullptr) n->refs.fetch_add(1,std::memory_order_relaxed);
+                }
+                static void release(node_base* n,unsigned height) noexcept;
+                static bool unique(const node_base* n) noexcept
+                {
+                    return n->refs.load(std::memory_order_acquire) == 1;
+                }
+
+                static size_type subtree_size(const node_base* n,unsigned height) noexcept
+                {
+                    return height == 0 ? n->count : static_cast<const inner_node*>(n)->sizes[n->count - 1];
+                }
+
+                // 高度为 h 的节点中包含相对下标 n 的子节点，n 改为子树内的偏移
+                // 子树最多有 kBranch^h 个元素，所以 n >> (h * kBits) 不会超过真正的位置
+                static unsigned child_index(const inner_node* in,unsigned h,size_type& n) noexcept
+                {
+                    const unsigned shift = h * kBits;
+                    size_type c = shift < sizeof(size_type) * 8 ? n >> shift : 0;
+                    while(in->sizes[c] <= n) ++c;
+                    if(c != 0) n -= in->sizes[c - 1];
+                    return static_cast<unsigned>(c);
+                }
+
+                static leaf_type* new_leaf()
+                {
+                    void* p = alloc::allocate(sizeof(leaf_type),align_val_t(alignof(leaf_type)));
+                    leaf_type* leaf = ::new(p) leaf_type;
+                    leaf->refs.store(1,std::memory_order_relaxed);
+                    leaf->count = 0;
+                    return leaf;
+                }
+                static inner_node* new_inner()
+                {
+                    void* p = alloc::allocate(sizeof(inner_node),align_val_t(alignof(inner_node)));
+                    inner_node* in = ::new(p) inner_node;
+                    in->refs.store(1,std::memory_order_relaxed);
+                    in->count = 0;
+                    return in;
+                }
+
+                static leaf_type* copy_leaf(const leaf_type* src,size_type first,size_type last);
+                static inner_node* copy_inner(const inner_node* src);
+                static leaf_type* edit_leaf(node_base*& slot);
+                static inner_node* edit_inner(node_base*& slot,unsigned height);
+                leaf_type* edit_path(size_type& n);
+
+                template<class... Args>
+                static leaf_type* make_leaf(Args&&... args);
+                static node_base* new_path(unsigned height,node_base* n);
+                static bool can_push(const node_base* n,unsigned height) noexcept;
+                void shrink_root() noexcept;
+
+                static inner_node* concat_sub(node_base* l,unsigned hl,node_base* r,unsigned hr,bool top);
+                static inner_node* rebalance(const inner_node* left,inner_node* mid,const inner_node* right,unsigned h);
+
+                template<class F>
+                static void chunks(const node_base* n,unsigned height,F& f);
+        };
+
+        /*****************************************************************************************/
+
+        template<class T>
+        void tree<T>::release(node_base* n,unsigned height) noexcept{
+            if(n == nullptr || n->refs.fetch_sub(1,std::memory_order_acq_rel) != 1) return;
+            if(height == 0){
+                leaf_type* leaf = as_leaf(n);
+                hxqstl::destroy(leaf->data(),leaf->data() + leaf->count);
+                alloc::deallocate(leaf,sizeof(leaf_type),align_val_t(alignof(leaf_type)));
+            }
+            else{
+                inner_node* in = as_inner(n);
+                for(uint32_t i = 0;i < in->count;++i){
+                    release(in->children[i],height - 1);
+                }
+                alloc::deallocate(in,sizeof(inner_node),align_val_t(alignof(inner_node)));
+            }
+        }
+
+        template<class T>
+        typename tree<T>::leaf_type* tree<T>::copy_leaf(const leaf_type* src,size_type first,size_type last){
+            leaf_type* leaf = new_leaf();
+            try{
+                hxqstl::uninitialized_copy(src->data() + first,src->data() + last,leaf->data());
+            }
+            catch(...){
+                release(leaf,0);
+                throw;
+            }
+            leaf->count = static_cast<uint32_t>(last - first);
+            return leaf;
+        }
+
+        template<class T>
+        inner_node* tree<T>::copy_inner(const inner_node* src){
+            inner_node* in = new_inner();
+            std::memcpy(in->children,src->children,src->count * sizeof(node_base*));
+            std::memcpy(in->sizes,src->sizes,src->count * sizeof(size_t));
+            in->count = src->count;
+            for(uint32_t i = 0;i < in->count;++i){
+                retain(in->children[i]);
+            }
+            return in;
+        }
+
+        template<class T>
+        typename tree<T>::leaf_type* tree<T>::edit_leaf(node_base*& slot){
+            if(unique(slot)) return as_leaf(slot);
+            leaf_type* leaf = copy_leaf(as_leaf(slot),0,slot->count);
+            release(slot,0);
+            slot = leaf;
+            return leaf;
+        }
+
+        template<class T>
+        inner_node* tree<T>::edit_inner(node_base*& slot,unsigned height){
+            if(unique(slot)) return as_inner(slot);
+            inner_node* in = copy_inner(as_inner(slot));
+            release(slot,height);
+            slot = in;
+            return in;
+        }
+
+        // 保证根到第 n 个元素所在叶子的路径上的节点都只被本树引用，之后可以原地修改而不抛出异常
+        // 中途抛出异常时树仍然完整，只是部分节点换成了内容相同的副本
+        template<class T>
+        typename tree<T>::leaf_type* tree<T>::edit_path(size_type& n){
+            node_base** slot = &root_;
+            for(unsigned h = height_;h > 0;--h){
+                inner_node* in = edit_inner(*slot,h);
+                slot = &in->children[child_index(in,h,n)];
+            }
+            return edit_leaf(*slot);
+        }
+
+        template<class T>
+        template<class... Args>
+        typename tree<T>::leaf_type* tree<T>::make_leaf(Args&&... args){
+            leaf_type* leaf = new_leaf();
+            try{
+                hxqstl::construct(leaf->data(),hxqstl::forward<Args>(args)...);
+            }
+            catch(...){
+                release(leaf,0);
+                throw;
+            }
+            leaf->count = 1;
+            return leaf;
+        }
+
+        // 在 n 上面套 height 层只有一个子节点的内部节点，失败时释放 n
+        template<class T>
+        node_base* tree<T>::new_path(unsigned height,node_base* n){
+            for(unsigned h = 0;h < height;++h){
+                inner_node* in;
+                try{
+                    in = new_inner();
+                }
+                catch(...){
+                    release(n,h);
+                    throw;
+                }
+                in->children[0] = n;
+                in->sizes[0] = subtree_size(n,h);
+                in->count = 1;
+                n = in;
+            }
+            return n;
+        }
+
+        // 最右路径上是否还有空位
+        template<class T>
+        bool tree<T>::can_push(const node_base* n,unsigned height) noexcept{
+            for(;height > 0;--height){
+                if(n->count < kBranch) return true;
+                n = static_cast<const inner_node*>(n)->children[n->count - 1];
+            }
+            return n->count < kBranch;
+        }
+
+        // 去掉只有一个子节点的根
+        template<class T>
+        void tree<T>::shrink_root() noexcept{
+            while(height_ > 0 && root_->count == 1){
+                node_base* child = as_inner(root_)->children[0];
+                retain(child);
+                release(root_,height_);
+                root_ = child;
+                --height_;
+            }
+        }
+
+        template<class T>
+        template<class... Args>
+        void tree<T>::emplace_back(Args&&... args){
+            if(root_ == nullptr){
+                root_ = make_leaf(hxqstl::forward<Args>(args)...);
+                size_ = 1;
+                height_ = 0;
+                return;
+            }
+            if(!can_push(root_,height_)){
+                // 整棵树已满，新建一条到叶子的路径，和旧根一起挂到新根下
+                node_base* path = new_path(height_,make_leaf(hxqstl::forward<Args>(args)...));
+                inner_node* in;
+                try{
+                    in = new_inner();
+                }
+                catch(...){
+                    release(path,height_);
+                    throw;
+                }
+                in->children[0] = root_;
+                in->sizes[0] = size_;
+                in->children[1] = path;
+                in->sizes[1] = size_ + 1;
+                in->count = 2;
+                root_ = in;
+                ++height_;
+                ++size_;
+                return;
+            }
+            // 先复制最右路径并构造新元素，全部成功后再更新路径上的大小表
+            size_type last = size_ - 1;
+            edit_path(last);
+            node_base* node = root_;
+            unsigned depth = 0;
+            for(unsigned h = height_;h > 0;--h,++depth){
+                inner_node* in = as_inner(node);
+                node_base* child = in->children[in->count - 1];
+                if(!can_push(child,h - 1)){
+                    in->children[in->count] = new_path(h - 1,make_leaf(hxqstl::forward<Args>(args)...));
+                    in->sizes[in->count] = in->sizes[in->count - 1];
+                    ++in->count;
+                    node = nullptr;
+                    ++depth;
+                    break;
+                }
+                node = child;
+            }
+            if(node != nullptr){
+                leaf_type* leaf = as_leaf(node);
+                hxqstl::construct(leaf->data() + leaf->count,hxqstl::forward<Args>(args)...);
+                ++leaf->count;
+            }
+            node = root_;
+            for(unsigned d = 0;d < depth;++d){
+                inner_node* in = as_inner(node);
+                ++in->sizes[in->count - 1];
+                node = in->children[in->count - 1];
+            }
+            ++size_;
+        }
+
+        template<class T>
+        void tree<T>::pop_back(){
+            MYSTL_DEBUG(size_ != 0);
+            if(size_ == 1){
+                clear();
+                return;
+            }
+            size_type last = size_ - 1;
+            edit_path(last);
+            node_base* node = root_;
+            for(unsigned h = height_;h > 0;--h){
+                inner_node* in = as_inner(node);
+                node_base* child = in->children[in->count - 1];
+                // 最后一棵子树只剩这一个元素时整个去掉
+                if(subtree_size(child,h - 1) == 1){
+                    release(child,h - 1);
+                    --in->count;
+                    node = nullptr;
+                    break;
+                }
+                --in->sizes[in->count - 1];
+                node = child;
+            }
+            if(node != nullptr){
+                leaf_type* leaf = as_leaf(node);
+                hxqstl::destroy(leaf->data() + leaf->count - 1);
+                --leaf->count;
+            }
+            --size_;
+            shrink_root();
+        }
+
+        template<class T>
+        template<class V>
+        void tree<T>::set(size_type n,V&& value){
+            leaf_type* leaf = edit_path(n);
+            leaf->data()[n] = hxqstl::forward<V>(value);
+        }
+
+        // 只保留前 n 个元素
+        template<class T>
+        void tree<T>::take(size_type n){
+            if(n >= size_) return;
+            if(n == 0){
+                clear();
+                return;
+            }
+            size_type last = n - 1;
+            edit_path(last);
+            node_base* node = root_;
+            size_type keep = n;
+            for(unsigned h = height_;h > 0;--h){
+                inner_node* in = as_inner(node);
+                size_type off = keep - 1;
+                const unsigned c = child_index(in,h,off);
+                for(uint32_t i = c + 1;i < in->count;++i){
+                    release(in->children[i],h - 1);
+                }
+                in->count = c + 1;
+                in->sizes[c] = keep;
+                keep = off + 1;
+                node = in->children[c];
+            }
+            leaf_type* leaf = as_leaf(node);
+            hxqstl::destroy(leaf->data() + keep,leaf->data() + leaf->count);
+            leaf->count = static_cast<uint32_t>(keep);
+            size_ = n;
+            shrink_root();
+        }
+
+        // 去掉前 n 个元素，要求元素的移动赋值不抛出异常
+        template<class T>
+        void tree<T>::drop(size_type n){
+            if(n == 0) return;
+            if(n >= size_){
+                clear();
+                return;
+            }
+            size_type first = n;
+            edit_path(first);
+            node_base* node = root_;
+            size_type skip = n;
+            for(unsigned h = height_;h > 0;--h){
+                inner_node* in = as_inner(node);
+                size_type off = skip;
+                const unsigned c = child_index(in,h,off);
+                for(unsigned i = 0;i < c;++i){
+                    release(in->children[i],h - 1);
+                }
+                for(uint32_t i = c;i < in->count;++i){
+                    in->children[i - c] = in->children[i];
+                    in->sizes[i - c] = in->sizes[i] - skip;
+                }
+                in->count -= c;
+                skip = off;
+                node = in->children[0];
+            }
+            if(skip != 0){
+                leaf_type* leaf = as_leaf(node);
+                hxqstl::move(leaf->data() + skip,leaf->data() + leaf->count,leaf->data());
+                hxqstl::destroy(leaf->data() + leaf->count - skip,leaf->data() + leaf->count);
+                leaf->count -= static_cast<uint32_t>(skip);
+            }
+            size_ -= n;
+            shrink_root();
+        }
+
+        template<class T>
+        void tree<T>::append(const tree& rhs){
+            if(rhs.size_ == 0) return;
+            if(size_ == 0){
+                *this = rhs;
+                return;
+            }
+            const unsigned h = hxqstl::max(height_,rhs.height_) + 1;
+            inner_node* in = concat_sub(root_,height_,rhs.root_,rhs.height_,true);
+            release(root_,height_);
+            root_ = in;
+            height_ = h;
+            size_ += rhs.size_;
+            shrink_root();
+        }
+
+        // 拼接高度为 hl 的 l 和高度为 hr 的 r(都只借用，不转移引用)
+        // 返回高度为 max(hl,hr) + 1、有一到两个子节点的新节点
+        template<class T>
+        inner_node* tree<T>::concat_sub(node_base* l,unsigned hl,node_base* r,unsigned hr,bool top){
+            if(hl > hr){
+                const inner_node* li = as_inner(l);
+                inner_node* mid = concat_sub(li->children[li->count - 1],hl - 1,r,hr,false);
+                return rebalance(li,mid,nullptr,hl);
+            }
+            if(hl < hr){
+                const inner_node* ri = as_inner(r);
+                inner_node* mid = concat_sub(l,hl,ri->children[0],hr - 1,false);
+                return rebalance(nullptr,mid,ri,hr);
+            }
+            if(hl == 0){
+                inner_node* in = new_inner();
+                const size_type ln = l->count;
+                const size_type rn = r->count;
+                // 整棵树只有两个叶子且能放进一个叶子时直接合并
+                if(top && ln + rn <= kBranch){
+                    leaf_type* leaf = nullptr;
+                    try{
+                        leaf = copy_leaf(as_leaf(l),0,ln);
+                        hxqstl::uninitialized_copy(as_leaf(r)->data(),as_leaf(r)->data() + rn,leaf->data() + ln);
+                    }
+                    catch(...){
+                        release(leaf,0);
+                        release(in,1);
+                        throw;
+                    }
+                    leaf->count = static_cast<uint32_t>(ln + rn);
+                    in->children[0] = leaf;
+                    in->sizes[0] = ln + rn;
+                    in->count = 1;
+                    return in;
+                }
+                retain(l);
+                retain(r);
+                in->children[0] = l;
+                in->sizes[0] = ln;
+                in->children[1] = r;
+                in->sizes[1] = ln + rn;
+                in->count = 2;
+                return in;
+            }
+            const inner_node* li = as_inner(l);
+            const inner_node* ri = as_inner(r);
+            inner_node* mid = concat_sub(li->children[li->count - 1],hl - 1,ri->children[0],hr - 1,false);
+            return rebalance(li,mid,ri,hl);
+        }
+
+        // 把 left 除最后一个之外的子节点、mid 的全部子节点、right 除第一个之外的子节点(都是高度 h - 1 的节点)
+        // 按 RRB 的拼接规划重新分配，使节点数不超过最少可能的节点数加 kExtras，
+        // 再装进一到两个高度为 h 的节点，返回高度为 h + 1 的包装节点；mid 被消耗
+        template<class T>
+        inner_node* tree<T>::rebalance(const inner_node* left,inner_node* mid,const inner_node* right,unsigned h){
+            node_base* all[2 * kBranch];
+            size_type counts[2 * kBranch];
+            size_type n = 0;
+            if(left != nullptr){
+                for(uint32_t i = 0;i + 1 < left->count;++i) all[n++] = left->children[i];
+            }
+            for(uint32_t i = 0;i < mid->count;++i) all[n++] = mid->children[i];
+            if(right != nullptr){
+                for(uint32_t i = 1;i < right->count;++i) all[n++] = right->children[i];
+            }
+
+            size_type total = 0;
+            for(size_type i = 0;i < n;++i){
+                counts[i] = all[i]->count;
+                total += counts[i];
+            }
+
+            // 跳过满的节点，把第一个不满的节点的内容依次并入后面的节点，直到节点数足够少
+            const size_type opt = (total + kBranch - 1) / kBranch;
+            size_type m = n;
+            size_type i = 0;
+            while(m > opt + kExtras){
+                while(counts[i] > kBranch - kExtras / 2) ++i;
+                size_type rest = counts[i];
+                while(rest > 0){
+                    const size_type fill = hxqstl::min(rest + counts[i + 1],static_cast<size_type>(kBranch));
+                    counts[i] = fill;
+                    rest = rest + counts[i + 1] - fill;
+                    ++i;
+                }
+                for(size_type j = i;j + 1 < m;++j) counts[j] = counts[j + 1];
+                --m;
+                --i;
+            }
+
+            // 按规划生成新节点，大小没变的节点直接共享
+            node_base* fresh[2 * kBranch];
+            size_type built = 0;
+            try{
+                size_type j = 0;
+                size_type off = 0;
+                for(;built < m;++built){
+                    fresh[built] = nullptr;
+                    const size_type c = counts[built];
+                    if(off == 0 && all[j]->count == c){
+                        retain(all[j]);
+                        fresh[built] = all[j++];
+                        continue;
+                    }
+                    if(h == 1){
+                        leaf_type* leaf = new_leaf();
+                        fresh[built] = leaf;
+                        while(leaf->count < c){
+                            const leaf_type* src = as_leaf(all[j]);
+                            const size_type take = hxqstl::min(c - leaf->count,src->count - off);
+                            hxqstl::uninitialized_copy(src->data() + off,src->data() + off + take,
+                                                       leaf->data() + leaf->count);
+                            leaf->count += static_cast<uint32_t>(take);
+                            off += take;
+                            if(off == src->count){
+                                ++j;
+                                off = 0;
+                            }
+                        }
+                    }
+                    else{
+                        inner_node* in = new_inner();
+                        fresh[built] = in;
+                        while(in->count < c){
+                            const inner_node* src = as_inner(all[j]);
+                            node_base* child = src->children[off];
+                            retain(child);
+                            in->children[in->count] = child;
+                            in->sizes[in->count] = (in->count == 0 ? 0 : in->sizes[in->count - 1]) +
+                                                   subtree_size(child,h - 2);
+                            ++in->count;
+                            if(++off == src->count){
+                                ++j;
+                                off = 0;
+                            }
+                        }
+                    }
+                }
+            }
+            catch(...){
+                for(size_type k = 0;k <= built && k < m;++k){
+                    release(fresh[k],h - 1);
+                }
+                release(mid,h);
+                throw;
+            }
+            release(mid,h);
+
+            inner_node* wrap = nullptr;
+            inner_node* parts[2] = {nullptr,nullptr};
+            const size_type nparts = m > kBranch ? 2 : 1;
+            try{
+                wrap = new_inner();
+                for(size_type k = 0;k < nparts;++k) parts[k] = new_inner();
+            }
+            catch(...){
+                release(wrap,h + 1);
+                release(parts[0],h);
+                for(size_type k = 0;k < m;++k) release(fresh[k],h - 1);
+                throw;
+            }
+            size_type k = 0;
+            for(size_type p = 0;p < nparts;++p){
+                inner_node* in = parts[p];
+                const size_type stop = hxqstl::min(m,(p + 1) * kBranch);
+                for(;k < stop;++k){
+                    in->children[in->count] = fresh[k];
+                    in->sizes[in->count] = (in->count == 0 ? 0 : in->sizes[in->count - 1]) +
+                                           subtree_size(fresh[k],h - 1);
+                    ++in->count;
+                }
+                wrap->children[p] = in;
+                wrap->sizes[p] = (p == 0 ? 0 : wrap->sizes[p - 1]) + in->sizes[in->count - 1];
+            }
+            wrap->count = static_cast<uint32_t>(nparts);
+            return wrap;
+        }
+
+        template<class T>
+        template<class F>
+        void tree<T>::chunks(const node_base* n,unsigned height,F& f){
+            if(height == 0){
+                const leaf_type* leaf = static_cast<const leaf_type*>(n);
+                f(leaf->data(),leaf->data() + leaf->count);
+                return;
+            }
+            const inner_node* in = static_cast<const inner_node*>(n);
+            for(uint32_t i = 0;i < in->count;++i){
+                chunks(in->children[i],height - 1,f);
+            }
+        }
+    }
+
+    // 只读随机访问迭代器，缓存当前叶子，顺序遍历时每个叶子只查找一次
+    template<class T>
+    struct immutable_vector_iterator : public iterator<random_access_iterator_tag,T,ptrdiff_t,const T*,const T&>
+    {
+        typedef rrb::tree<T> tree_type;
+        typedef T value_type;
+        typedef const T* pointer;
+        typedef const T& reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+        typedef immutable_vector_iterator self;
+
+        const tree_type* tree;
+        size_type idx;
+        // 缓存的叶子覆盖下标 [first,last)
+        const T* leaf;
+        size_type first;
+        size_type last;
+
+        immutable_vector_iterator() noexcept : tree(nullptr),idx(0),leaf(nullptr),first(0),last(0) {}
+        immutable_vector_iterator(const tree_type* t,size_type i) noexcept
+            :tree(t),idx(i),leaf(nullptr),first(0),last(0)
+        {
+            locate();
+        }
+
+        reference operator*() const {return leaf[idx - first];}
+        pointer operator->() const {return &(operator*());}
+        reference operator[](difference_type n) const {return (*tree)[idx + n];}
+
+        self& operator++()
+        {
+            if(++idx >= last) locate();
+            return *this;
+        }
+        self operator++(int) {self tmp = *this;++*this;return tmp;}
+        self& operator--()
+        {
+            if(idx-- == first || idx >= last) locate();
+            return *this;
+        }
+        self operator--(int) {self tmp = *this;--*this;return tmp;}
+        self& operator+=(difference_type n)
+        {
+            idx += n;
+            if(idx < first || idx >= last) locate();
+            return *this;
+        }
+        self& operator-=(difference_type n) {return *this += -n;}
+        self operator+(difference_type n) const {self tmp = *this;return tmp += n;}
+        self operator-(difference_type n) const {self tmp = *this;return tmp += -n;}
+        difference_type operator-(const self& rhs) const {
+            return static_cast<difference_type>(idx) - static_cast<difference_type>(rhs.idx);
+        }
+
+        bool operator==(const self& rhs) const {return idx == rhs.idx;}
+        bool operator!=(const self& rhs) const {return idx != rhs.idx;}
+        bool operator<(const self& rhs) const {return idx < rhs.idx;}
+        bool operator>(const self& rhs) const {return rhs < *this;}
+        bool operator<=(const self& rhs) const {return !(rhs < *this);}
+        bool operator>=(const self& rhs) const {return !(*this < rhs);}
+
+        private:
+            // 尾后位置不缓存叶子
+            void locate() noexcept
+            {
+                if(idx < tree->size()){
+                    size_type off = idx;
+                    const auto* node = tree->leaf_at(off);
+                    leaf = node->data();
+                    first = idx - off;
+                    last = first + node->count;
+                }
+            }
+    };
+
+    template<class T>
+    class immutable_vector_transient;
+
+    template<class T>
+    class immutable_vector{
+        friend class immutable_vector_transient<T>;
+
+        public:
+            typedef T value_type;
+            typedef size_t size_type;
+            typedef ptrdiff_t difference_type;
+            typedef const T* pointer;
+            typedef const T* const_pointer;
+            typedef const T& reference;
+            typedef const T& const_reference;
+
+            // 元素不可修改，iterator 与 const_iterator 相同
+            typedef immutable_vector_iterator<T> iterator;
+            typedef immutable_vector_iterator<T> const_iterator;
+            typedef hxqstl::reverse_iterator<iterator> reverse_iterator;
+            typedef hxqstl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+            typedef immutable_vector_transient<T> transient_type;
+
+        private:
+            typedef rrb::tree<T> tree_type;
+            tree_type tree_;
+
+            explicit immutable_vector(const tree_type& t) noexcept : tree_(t) {}
+            explicit immutable_vector(tree_type&& t) noexcept : tree_(hxqstl::move(t)) {}
+
+        public:
+            immutable_vector() noexcept : tree_() {}
+
+            immutable_vector(size_type n,const value_type& value)
+            :tree_()
+            {
+                for(;n > 0;--n){
+                    tree_.emplace_back(value);
+                }
+            }
+
+            template<class InputIter,typename std::enable_if<
+                hxqstl::is_input_iterator<InputIter>::value,int>::type = 0>
+            immutable_vector(InputIter first,InputIter last)
+            :tree_()
+            {
+                for(;first != last;++first){
+                    tree_.emplace_back(*first);
+                }
+            }
+
+            immutable_vector(std::initializer_list<value_type> ilist)
+            :immutable_vector(ilist.begin(),ilist.end()) {}
+
+            // 复制只增加根节点的引用计数
+            immutable_vector(const immutable_vector& rhs) = default;
+            immutable_vector(immutable_vector&& rhs) noexcept = default;
+            immutable_vector& operator=(const immutable_vector& rhs) = default;
+            immutable_vector& operator=(immutable_vector&& rhs) noexcept = default;
+            ~immutable_vector() = default;
+
+        public:
+            const_iterator begin() const noexcept {return const_iterator(&tree_,0);}
+            const_iterator end() const noexcept {return const_iterator(&tree_,size());}
+            const_iterator cbegin() const noexcept {return begin();}
+            const_iterator cend() const noexcept {return end();}
+            const_reverse_iterator rbegin() const noexcept {return const_reverse_iterator(end());}
+            const_reverse_iterator rend() const noexcept {return const_reverse_iterator(begin());}
+
+            bool empty() const noexcept {return size() == 0;}
+            size_type size() const noexcept {return tree_.size();}
+            size_type max_size() const noexcept {return static_cast<size_type>(-1) / sizeof(T);}
+
+            const_reference operator[](size_type n) const
+            {
+                MYSTL_DEBUG(n < size());
+                return tree_[n];
+            }
+            const_reference at(size_type n) const
+            {
+                THROW_OUT_OF_RANGE_IF(!(n < size()),"immutable_vector<T>::at() subscript out of range");
+                return tree_[n];
+            }
+            const_reference front() const
+            {
+                MYSTL_DEBUG(!empty());
+                return tree_[0];
+            }
+            const_reference back() const
+            {
+                MYSTL_DEBUG(!empty());
+                return tree_[size() - 1];
+            }
+
+            // 以下操作都不修改当前对象，返回修改后的新版本
+            immutable_vector push_back(const value_type& value) const {return emplace_back(value);}
+            immutable_vector push_back(value_type&& value) const {return emplace_back(hxqstl::move(value));}
+
+            template<class... Args>
+            immutable_vector emplace_back(Args&&... args) const
+            {
+                tree_type t(tree_);
+                t.emplace_back(hxqstl::forward<Args>(args)...);
+                return immutable_vector(hxqstl::move(t));
+            }
+
+            immutable_vector pop_back() const
+            {
+                MYSTL_DEBUG(!empty());
+                tree_type t(tree_);
+                t.pop_back();
+                return immutable_vector(hxqstl::move(t));
+            }
+
+            immutable_vector set(size_type n,const value_type& value) const
+            {
+                THROW_OUT_OF_RANGE_IF(!(n < size()),"immutable_vector<T>::set() subscript out of range");
+                tree_type t(tree_);
+                t.set(n,value);
+                return immutable_vector(hxqstl::move(t));
+            }
+            immutable_vector set(size_type n,value_type&& value) const
+            {
+                THROW_OUT_OF_RANGE_IF(!(n < size()),"immutable_vector<T>::set() subscript out of range");
+                tree_type t(tree_);
+                t.set(n,hxqstl::move(value));
+                return immutable_vector(hxqstl::move(t));
+            }
+
+            // 用 f(旧值) 的结果替换第 n 个元素
+            template<class F>
+            immutable_vector update(size_type n,F f) const
+            {
+                return set(n,f(at(n)));
+            }
+
+            // 前 n 个元素 / 去掉前 n 个元素后的部分，O(log n)
+            immutable_vector take(size_type n) const
+            {
+                tree_type t(tree_);
+                t.take(n);
+                return immutable_vector(hxqstl::move(t));
+            }
+            immutable_vector drop(size_type n) const
+            {
+                tree_type t(tree_);
+                t.drop(n);
+                return immutable_vector(hxqstl::move(t));
+            }
+
+            // 拼接，两边的节点尽量共享，只在接缝处重新分配，O(log n)
+            immutable_vector concat(const immutable_vector& rhs) const
+            {
+                tree_type t(tree_);
+                t.append(rhs.tree_);
+                return immutable_vector(hxqstl::move(t));
+            }
+
+            // 基于当前版本创建可原地修改的 transient，O(1)
+            transient_type transient() const {return transient_type(*this);}
+
+            // 按顺序对每段连续存放的元素调用 f(const T* first,const T* last)
+            template<class F>
+            void for_each_chunk(F f) const {tree_.for_each_chunk(f);}
+
+            void swap(immutable_vector& rhs) noexcept {tree_.swap(rhs.tree_);}
+    };
+
+    // immutable_vector 的批量修改模式，不是线程安全的
+    // 第一次修改某个节点时如果它被其他版本共享就先复制，之后对同一节点的修改都原地进行
+    template<class T>
+    class immutable_vector_transient{
+        public:
+            typedef T value_type;
+            typedef size_t size_type;
+            typedef const T& const_reference;
+
+        private:
+            typedef rrb::tree<T> tree_type;
+            tree_type tree_;
+
+        public:
+            immutable_vector_transient() noexcept : tree_() {}
+            explicit immutable_vector_transient(const immutable_vector<T>& v) noexcept : tree_(v.tree_) {}
+
+        public:
+            bool empty() const noexcept {return size() == 0;}
+            size_type size() const noexcept {return tree_.size();}
+
+            const_reference operator[](size_type n) const
+            {
+                MYSTL_DEBUG(n < size());
+                return tree_[n];
+            }
+            const_reference at(size_type n) const
+            {
+                THROW_OUT_OF_RANGE_IF(!(n < size()),"immutable_vector_transient<T>::at() subscript out of range");
+                return tree_[n];
+            }
+
+            void push_back(const value_type& value) {tree_.emplace_back(value);}
+            void push_back(value_type&& value) {tree_.emplace_back(hxqstl::move(value));}
+
+            template<class... Args>
+            void emplace_back(Args&&... args) {tree_.emplace_back(hxqstl::forward<Args>(args)...);}
+
+            void pop_back()
+            {
+                MYSTL_DEBUG(!empty());
+                tree_.pop_back();
+            }
+
+            void set(size_type n,const value_type& value)
+            {
+                THROW_OUT_OF_RANGE_IF(!(n < size()),"immutable_vector_transient<T>::set() subscript out of range");
+                tree_.set(n,value);
+            }
+            void set(size_type n,value_type&& value)
+            {
+                THROW_OUT_OF_RANGE_IF(!(n < size()),"immutable_vector_transient<T>::set() subscript out of range");
+                tree_.set(n,hxqstl::move(value));
+            }
+
+            void take(size_type n) {tree_.take(n);}
+            void drop(size_type n) {tree_.drop(n);}
+            void append(const immutable_vector<T>& rhs) {tree_.append(rhs.tree_);}
+            void clear() noexcept {tree_.clear();}
+
+            // 当前内容的快照，O(1)；之后的修改会先复制被快照共享的节点
+            immutable_vector<T> persistent() const {return immutable_vector<T>(tree_);}
+    };
+
+    /*****************************************************************************************/
+
+    template<class T>
+    immutable_vector<T> operator+(const immutable_vector<T>& lhs,const immutable_vector<T>& rhs)
+    {
+        return lhs.concat(rhs);
+    }
+
+    template<class T>
+    bool operator==(const immutable_vector<T>& lhs,const immutable_vector<T>& rhs)
+    {
+        return lhs.size() == rhs.size() && hxqstl::equal(lhs.begin(),lhs.end(),rhs.begin());
+    }
+
+    template<class T>
+    bool operator!=(const immutable_vector<T>& lhs,const immutable_vector<T>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template<class T>
+    void swap(immutable_vector<T>& lhs,immutable_vector<T>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+}
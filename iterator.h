@@ -9,6 +9,9 @@ namespace hxqstl{
     struct forward_iterator_tag : public input_iterator_tag {};
     struct bidirectional_iterator_tag : public forward_iterator_tag {};
     struct random_access_iterator_tag : public bidirectional_iterator_tag {};
+    // 元素在内存中连续存放的随机访问迭代器，可以用 to_address 换成指针走 memmove 等快速路径
+    // 原生指针的 iterator_category 仍为 random_access_iterator_tag，由 is_contiguous_iterator 单独识别
+    struct contiguous_iterator_tag : public random_access_iterator_tag {};
 
     template<class Category,class T,class Distance = ptrdiff_t,class Pointer = T*,class Reference = T&>
     struct iterator{
@@ -23,7 +26,7 @@ namespace hxqstl{
     template<class T>
     struct has_iterator_cat{
         private:
-        struct two {char a;char b};
+        struct two {char a;char b;};
         // 静态函数模板
         template <class U> static two test(...);
         template <class U> static char test(typename U::iterator_category* = 0);
@@ -42,7 +45,7 @@ namespace hxqstl{
         typedef typename Iterator::value_type value_type;
         typedef typename Iterator::pointer pointer;
         typedef typename Iterator::reference reference;
-        typedef typename Iterator::difference_type difference_Type;
+        typedef typename Iterator::difference_type difference_type;
     };
 
     template<class Iterator,bool>
@@ -68,7 +71,7 @@ namespace hxqstl{
         typedef T value_type;
         typedef T* pointer;
         typedef T& reference;
-        typedef ptrdiff_t diffrence_type;
+        typedef ptrdiff_t difference_type;
     };
 
     template<class T,class U,bool = has_iterator_cat<iterator_traits<T>>::value>
@@ -92,13 +95,54 @@ namespace hxqstl{
     template<class Iter>
     struct is_random_access_iterator : public has_iterator_cat_of<Iter,random_access_iterator_tag> {};
 
+    template<class Iter>
+    struct is_contiguous_iterator : public has_iterator_cat_of<Iter,contiguous_iterator_tag> {};
+
+    template<class T>
+    struct is_contiguous_iterator<T*> : public m_true_type {};
+
+    // 包装后不再保证连续的迭代器(reverse_iterator、move_iterator)把 contiguous 降为 random_access
+    template<class Category>
+    struct non_contiguous_category
+    {
+        typedef Category type;
+    };
+
+    template<>
+    struct non_contiguous_category<contiguous_iterator_tag>
+    {
+        typedef random_access_iterator_tag type;
+    };
+
+    // to_address
+    // 取连续迭代器所指位置的地址，只调用 operator-> 不解引用，对 end() 也可以使用
+    template<class T>
+    constexpr T* to_address(T* p) noexcept{
+        return p;
+    }
+
+    template<class Iter,typename std::enable_if<is_contiguous_iterator<Iter>::value,int>::type = 0>
+    constexpr auto to_address(const Iter& it) noexcept -> decltype(it.operator->()){
+        return it.operator->();
+    }
+
+    // 分段迭代器：元素存放在若干段连续内存中(例如 concurrent_vector)
+    // 容器为自己的迭代器特化本模板，算法据此逐段调用针对指针的快速实现
+    // 特化需要提供 segment_iterator(支持 ++、-- 和 ==)、local_iterator，
+    // 以及静态函数 segment(it)、local(it)、begin(seg)、end(seg)
+    template<class Iter>
+    struct segmented_iterator_traits
+    {
+        typedef m_false_type is_segmented;
+    };
+
     template<class Iterator>
-    struct is_iterator : public m_bool_constant<is_input_iterator<Iterator>::value || is_output_iterator<Iterator>::value{
+    struct is_iterator : public m_bool_constant<is_input_iterator<Iterator>::value || is_output_iterator<Iterator>::value>{
 
     };
 
     template<class Iterator>
-    typename iterator_traits<Iterator>::iterator_category
+    constexpr typename iterator_traits<Iterator>::iterator_category
     iterator_category(const Iterator&){
         typedef typename iterator_traits<Iterator>::iterator_category Category;
         return Category();
@@ -116,7 +160,7 @@ namespace hxqstl{
 
     // 计算迭代器间的距离
     template<class InputIterator>
-    typename iterator_traits<InputIterator>::difference_type
+    constexpr typename iterator_traits<InputIterator>::difference_type
     distance_dispatch(InputIterator first,InputIterator last,input_iterator_tag){    
         typename iterator_traits<InputIterator>::difference_type n = 0;
         while(first != last){
@@ -127,26 +171,26 @@ namespace hxqstl{
     }
 
     template<class RandomIter>
-    typename iterator_traits<RandomIter>::difference_type
+    constexpr typename iterator_traits<RandomIter>::difference_type
     distance_dispatch(RandomIter first,RandomIter last,random_access_iterator_tag){
         return last - first;
     }
 
     template<class InputIterator>
-    typename iterator_traits<InputIterator>::difference_type
+    constexpr typename iterator_traits<InputIterator>::difference_type
     distance(InputIterator first,InputIterator last){
         return distance_dispatch(first,last,iterator_category(first));
     }
 
     template<class InputIterator,class Distance>
-    void advance_dispatch(InputIterator& i,Distance n,input_iterator_tag){
+    constexpr void advance_dispatch(InputIterator& i,Distance n,input_iterator_tag){
         while(n--){
             ++i;
         }
     }
     
     template<class BidirectionalIterator,class Distance>
-    void advance_dispatch(BidirectionalIterator& i,Distance n,bidirectional_iterator_tag){
+    constexpr void advance_dispatch(BidirectionalIterator& i,Distance n,bidirectional_iterator_tag){
         if(n >= 0){
             while(n--) ++i;
         } else{
@@ -155,12 +199,12 @@ namespace hxqstl{
     }
 
     template<class RandomIter,class Distance>
-    void advance_dispatch(RandomIter& i,Distance n,random_access_iterator_tag){
+    constexpr void advance_dispatch(RandomIter& i,Distance n,random_access_iterator_tag){
         i += n;
     }
 
     template<class InputIterator,class Distance>
-    void advance(InputIterator& i,Distance n){
+    constexpr void advance(InputIterator& i,Distance n){
         advance_dispatch(i,n,iterator_category(i));
     }
 
@@ -169,11 +213,12 @@ namespace hxqstl{
         private:
             Iterator current;
         public:
-            typedef typename iterator_traits<Iterator>::iterator_category iterator_category;
+            typedef typename non_contiguous_category<
+                typename iterator_traits<Iterator>::iterator_category>::type iterator_category;
             typedef typename iterator_traits<Iterator>::value_type value_type;
             typedef typename iterator_traits<Iterator>::difference_type difference_type;
             typedef typename iterator_traits<Iterator>::pointer pointer;
-            typedef typename iterator_traits<Iterator>::reference referencel
+            typedef typename iterator_traits<Iterator>::reference reference;
 
             typedef Iterator iterator_type;
             typedef reverse_iterator<Iterator> self;
@@ -227,7 +272,7 @@ namespace hxqstl{
                 return self(current - n);
             }
 
-            self operator-=(difference_type n) const {
+            self& operator-=(difference_type n){
                 current += n;
                 return *this;
             }
@@ -255,6 +300,13 @@ namespace hxqstl{
         return rhs.base() < lhs.base();
     }
 
+    template<class Iterator>
+    typename reverse_iterator<Iterator>::difference_type
+    operator-(const reverse_iterator<Iterator>& lhs,const reverse_iterator<Iterator>& rhs)
+    {
+        return rhs.base() - lhs.base();
+    }
+
     template<class Iterator>
     bool operator!=(const reverse_iterator<Iterator>& lhs,
                     const reverse_iterator<Iterator>& rhs){
@@ -280,4 +332,62 @@ namespace hxqstl{
     {
     return !(lhs < rhs);
     }
+    // move_iterator
+    // 解引用得到右值引用，把"复制一个区间"变成"移动一个区间"
+    template<class Iterator>
+    class move_iterator{
+        private:
+            Iterator current;
+        public:
+            typedef typename non_contiguous_category<
+                typename iterator_traits<Iterator>::iterator_category>::type iterator_category;
+            typedef typename iterator_traits<Iterator>::value_type value_type;
+            typedef typename iterator_traits<Iterator>::difference_type difference_type;
+            typedef Iterator pointer;
+            typedef value_type&& reference;
+
+            typedef Iterator iterator_type;
+            typedef move_iterator<Iterator> self;
+
+        public:
+            move_iterator() : current() {}
+            explicit move_iterator(iterator_type i) : current(i) {}
+
+            iterator_type base() const {return current;}
+
+            reference operator*() const {return static_cast<reference>(*current);}
+            pointer operator->() const {return current;}
+            reference operator[](difference_type n) const {return static_cast<reference>(current[n]);}
+
+            self& operator++() {++current; return *this;}
+            self operator++(int) {self tmp = *this; ++current; return tmp;}
+            self& operator--() {--current; return *this;}
+            self operator--(int) {self tmp = *this; --current; return tmp;}
+
+            self& operator+=(difference_type n) {current += n; return *this;}
+            self& operator-=(difference_type n) {current -= n; return *this;}
+            self operator+(difference_type n) const {return self(current + n);}
+            self operator-(difference_type n) const {return self(current - n);}
+    };
+
+    template<class Iterator>
+    bool operator==(const move_iterator<Iterator>& lhs,const move_iterator<Iterator>& rhs)
+    { return lhs.base() == rhs.base(); }
+
+    template<class Iterator>
+    bool operator!=(const move_iterator<Iterator>& lhs,const move_iterator<Iterator>& rhs)
+    { return !(lhs == rhs); }
+
+    template<class Iterator>
+    bool operator<(const move_iterator<Iterator>& lhs,const move_iterator<Iterator>& rhs)
+    { return lhs.base() < rhs.base(); }
+
+    template<class Iterator>
+    typename move_iterator<Iterator>::difference_type
+    operator-(const move_iterator<Iterator>& lhs,const move_iterator<Iterator>& rhs)
+    { return lhs.base() - rhs.base(); }
+
+    template<class Iterator>
+    move_iterator<Iterator> make_move_iterator(Iterator i)
+    { return move_iterator<Iterator>(i); }
 }
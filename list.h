@@ -0,0 +1,838 @@
+#pragma once
+
+// list
+// 带哨兵节点的双向循环链表
+// 节点从 alloc 内存池中 sizeof(node) 对应的一档分配，不同 list 的节点大小相同，splice 之后由谁释放都可以
+// 每个 list 还有一个节点缓存：erase 掉的节点先留在缓存里(最多 cache_limit 个)，之后的插入直接复用，
+// LRU 这种反复删除、插入的用法不再每次都进出内存池；reserve_nodes 可以预先填满缓存
+// 一次插入 n 个元素(insert(pos,n,value)、区间 insert、复制构造)时用 alloc::allocate_chain 一次取出 n 个节点，只加一次锁
+// splice 只改指针；sort 和 merge 重新链接节点，不移动也不复制元素，迭代器和引用保持有效
+//     lru.splice(lru.begin(),lru,it);     // 把 it 移到表头，O(1)
+
+#include <initializer_list>
+
+#include "algobase.h"
+#include "alloc.h"
+#include "construct.h"
+#include "functional.h"
+#include "iterator.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace hxqstl{
+    struct list_node_base
+    {
+        list_node_base* prev;
+        list_node_base* next;
+    };
+
+    template<class T>
+    struct list_node : public list_node_base
+    {
+        typename std::aligned_storage<sizeof(T),alignof(T)>::type storage;
+
+        T* valptr() noexcept {return reinterpret_cast<T*>(&storage);}
+        const T* valptr() const noexcept {return reinterpret_cast<const T*>(&storage);}
+    };
+
+    template<class T>
+    struct list_iterator : public hxqstl::iterator<hxqstl::bidirectional_iterator_tag,T>
+    {
+        typedef T value_type;
+        typedef T* pointer;
+        typedef T& reference;
+        typedef list_iterator self;
+
+        list_node_base* node_;
+
+        list_iterator() noexcept : node_(nullptr) {}
+        explicit list_iterator(list_node_base* n) noexcept : node_(n) {}
+
+        reference operator*() const {return *static_cast<list_node<T>*>(node_)->valptr();}
+        pointer operator->() const {return static_cast<list_node<T>*>(node_)->valptr();}
+
+        self& operator++() {node_ = node_->next; return *this;}
+        self operator++(int) {self tmp = *this; node_ = node_->next; return tmp;}
+        self& operator--() {node_ = node_->prev; return *this;}
+        self operator--(int) {self tmp = *this; node_ = node_->prev; return tmp;}
+
+        bool operator==(const self& rhs) const noexcept {return node_ == rhs.node_;}
+        bool operator!=(const self& rhs) const noexcept {return node_ != rhs.node_;}
+    };
+
+    template<class T>
+    struct list_const_iterator : public hxqstl::iterator<hxqstl::bidirectional_iterator_tag,T>
+    {
+        typedef T value_type;
+        typedef const T* pointer;
+        typedef const T& reference;
+        typedef list_const_iterator self;
+
+        list_node_base* node_;
+
+        list_const_iterator() noexcept : node_(nullptr) {}
+        explicit list_const_iterator(list_node_base* n) noexcept : node_(n) {}
+        list_const_iterator(const list_iterator<T>& rhs) noexcept : node_(rhs.node_) {}
+
+        reference operator*() const {return *static_cast<list_node<T>*>(node_)->valptr();}
+        pointer operator->() const {return static_cast<list_node<T>*>(node_)->valptr();}
+
+        self& operator++() {node_ = node_->next; return *this;}
+        self operator++(int) {self tmp = *this; node_ = node_->next; return tmp;}
+        self& operator--() {node_ = node_->prev; return *this;}
+        self operator--(int) {self tmp = *this; node_ = node_->prev; return tmp;}
+
+        bool operator==(const self& rhs) const noexcept {return node_ == rhs.node_;}
+        bool operator!=(const self& rhs) const noexcept {return node_ != rhs.node_;}
+    };
+
+    template<class T>
+    class list{
+        public:
+            typedef T value_type;
+            typedef T* pointer;
+            typedef const T* const_pointer;
+            typedef T& reference;
+            typedef const T& const_reference;
+            typedef size_t size_type;
+            typedef ptrdiff_t difference_type;
+
+            typedef list_iterator<T> iterator;
+            typedef list_const_iterator<T> const_iterator;
+            typedef hxqstl::reverse_iterator<iterator> reverse_iterator;
+            typedef hxqstl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+            // 节点缓存的上限，超出的节点还给内存池
+            static constexpr size_type cache_limit = 64;
+
+        private:
+            typedef list_node_base base_node;
+            typedef list_node<T> node;
+
+            static constexpr size_t node_bytes = sizeof(node);
+            static_assert(alignof(node) <= static_cast<size_t>(EMaxPoolAlign),
+                          "list<T> node alignment exceeds the pool alignment");
+
+            base_node head_;        // 哨兵，head_.next 是第一个元素
+            size_type size_;
+            base_node* cache_;      // 空闲节点，用 next 串成单链表
+            size_type cached_;
+
+        public:
+            list() noexcept {init_empty();}
+
+            explicit list(size_type n)
+            {
+                init_with([&]{insert_n(end(),n,[](T* p){hxqstl::construct(p);});});
+            }
+
+            list(size_type n,const value_type& value)
+            {
+                init_with([&]{insert(end(),n,value);});
+            }
+
+            template<class Iter,typename std::enable_if<
+                hxqstl::is_input_iterator<Iter>::value,int>::type = 0>
+            list(Iter first,Iter last)
+            {
+                init_with([&]{insert(end(),first,last);});
+            }
+
+            list(std::initializer_list<value_type> ilist)
+            {
+                init_with([&]{insert(end(),ilist.begin(),ilist.end());});
+            }
+
+            list(const list& rhs)
+            {
+                init_with([&]{insert_copy(end(),rhs.begin(),rhs.size_);});
+            }
+
+            list(list&& rhs) noexcept
+            {
+                init_empty();
+                swap(rhs);
+            }
+
+            list& operator=(const list& rhs)
+            {
+                if(this != &rhs) assign_copy(rhs.begin(),rhs.end());
+                return *this;
+            }
+            list& operator=(list&& rhs) noexcept
+            {
+                if(this != &rhs){
+                    clear();
+                    swap(rhs);
+                }
+                return *this;
+            }
+            list& operator=(std::initializer_list<value_type> ilist)
+            {
+                assign_copy(ilist.begin(),ilist.end());
+                return *this;
+            }
+
+            ~list()
+            {
+                clear();
+                release_cache();
+            }
+
+        public:
+            iterator begin() noexcept {return iterator(head_.next);}
+            const_iterator begin() const noexcept {return const_iterator(head_.next);}
+            iterator end() noexcept {return iterator(&head_);}
+            const_iterator end() const noexcept {return const_iterator(const_cast<base_node*>(&head_));}
+
+            reverse_iterator rbegin() noexcept {return reverse_iterator(end());}
+            const_reverse_iterator rbegin() const noexcept {return const_reverse_iterator(end());}
+            reverse_iterator rend() noexcept {return reverse_iterator(begin());}
+            const_reverse_iterator rend() const noexcept {return const_reverse_iterator(begin());}
+
+            const_iterator cbegin() const noexcept {return begin();}
+            const_iterator cend() const noexcept {return end();}
+
+            bool empty() const noexcept {return size_ == 0;}
+            size_type size() const noexcept {return size_;}
+            size_type max_size() const noexcept {return static_cast<size_type>(-1) / node_bytes;}
+
+            reference front() {MYSTL_DEBUG(!empty()); return *begin();}
+            const_reference front() const {MYSTL_DEBUG(!empty()); return *begin();}
+            reference back() {MYSTL_DEBUG(!empty()); return *iterator(head_.prev);}
+            const_reference back() const {MYSTL_DEBUG(!empty()); return *const_iterator(head_.prev);}
+
+            // 节点缓存
+            size_type cached_nodes() const noexcept {return cached_;}
+            void reserve_nodes(size_type n);
+            void release_cache() noexcept;
+
+        public:
+            void assign(size_type n,const value_type& value);
+            template<class Iter,typename std::enable_if<
+                hxqstl::is_input_iterator<Iter>::value,int>::type = 0>
+            void assign(Iter first,Iter last) {assign_copy(first,last);}
+            void assign(std::initializer_list<value_type> ilist) {assign_copy(ilist.begin(),ilist.end());}
+
+            template<class... Args>
+            iterator emplace(const_iterator pos,Args&&... args)
+            {
+                base_node* n = create_node(hxqstl::forward<Args>(args)...);
+                link_before(pos.node_,n,n);
+                ++size_;
+                return iterator(n);
+            }
+            template<class... Args>
+            reference emplace_front(Args&&... args) {return *emplace(cbegin(),hxqstl::forward<Args>(args)...);}
+            template<class... Args>
+            reference emplace_back(Args&&... args) {return *emplace(cend(),hxqstl::forward<Args>(args)...);}
+
+            void push_front(const value_type& value) {emplace(cbegin(),value);}
+            void push_front(value_type&& value) {emplace(cbegin(),hxqstl::move(value));}
+            void push_back(const value_type& value) {emplace(cend(),value);}
+            void push_back(value_type&& value) {emplace(cend(),hxqstl::move(value));}
+
+            void pop_front() {MYSTL_DEBUG(!empty()); erase(cbegin());}
+            void pop_back() {MYSTL_DEBUG(!empty()); erase(const_iterator(head_.prev));}
+
+            iterator insert(const_iterator pos,const value_type& value) {return emplace(pos,value);}
+            iterator insert(const_iterator pos,value_type&& value) {return emplace(pos,hxqstl::move(value));}
+            iterator insert(const_iterator pos,size_type n,const value_type& value)
+            {
+                return insert_n(pos,n,[&value](T* p){hxqstl::construct(p,value);});
+            }
+            template<class Iter,typename std::enable_if<
+                hxqstl::is_input_iterator<Iter>::value,int>::type = 0>
+            iterator insert(const_iterator pos,Iter first,Iter last)
+            {
+                return insert_range(pos,first,last,iterator_category(first));
+            }
+            iterator insert(const_iterator pos,std::initializer_list<value_type> ilist)
+            {
+                return insert_copy(pos,ilist.begin(),ilist.size());
+            }
+
+            iterator erase(const_iterator pos);
+            iterator erase(const_iterator first,const_iterator last);
+
+            void clear() noexcept {erase(cbegin(),cend());}
+
+            void resize(size_type n) {resize_impl(n,[](T* p){hxqstl::construct(p);});}
+            void resize(size_type n,const value_type& value)
+            {
+                resize_impl(n,[&value](T* p){hxqstl::construct(p,value);});
+            }
+
+            void swap(list& rhs) noexcept;
+
+            // 把 other 中的节点移到 pos 之前，other 可以是自身(单个节点或区间)
+            void splice(const_iterator pos,list& other);
+            void splice(const_iterator pos,list& other,const_iterator it);
+            // 来自其他 list 的区间需要数一遍元素个数
+            void splice(const_iterator pos,list& other,const_iterator first,const_iterator last);
+
+            size_type remove(const value_type& value)
+            {
+                return remove_if([&value](const value_type& x){return x == value;});
+            }
+            template<class Pred>
+            size_type remove_if(Pred pred);
+
+            size_type unique() {return unique(hxqstl::equal_to<value_type>());}
+            template<class BinaryPred>
+            size_type unique(BinaryPred pred);
+
+            void merge(list& other) {merge(other,hxqstl::less<value_type>());}
+            template<class Compare>
+            void merge(list& other,Compare comp);
+
+            void sort() {sort(hxqstl::less<value_type>());}
+            template<class Compare>
+            void sort(Compare comp);
+
+            void reverse() noexcept;
+
+        private:
+            void init_empty() noexcept
+            {
+                head_.prev = &head_;
+                head_.next = &head_;
+                size_ = 0;
+                cache_ = nullptr;
+                cached_ = 0;
+            }
+
+            // 构造函数中插入失败时析构函数不会执行，回滚时放进缓存的节点要在这里还掉
+            template<class F>
+            void init_with(F f)
+            {
+                init_empty();
+                try{
+                    f();
+                }
+                catch(...){
+                    clear();
+                    release_cache();
+                    throw;
+                }
+            }
+
+            static T* value_of(base_node* n) noexcept {return static_cast<node*>(n)->valptr();}
+
+            // 把 [first,last] 这一段接到 pos 之前
+            static void link_before(base_node* pos,base_node* first,base_node* last) noexcept
+            {
+                first->prev = pos->prev;
+                last->next = pos;
+                pos->prev->next = first;
+                pos->prev = last;
+            }
+
+            // 把 [first,last) 从原来的位置摘下，接到 pos 之前
+            static void transfer(base_node* pos,base_node* first,base_node* last) noexcept
+            {
+                if(pos == last) return;
+                base_node* tail = last->prev;
+                first->prev->next = last;
+                last->prev = first->prev;
+                link_before(pos,first,tail);
+            }
+
+            base_node* get_node()
+            {
+                if(cache_ != nullptr){
+                    base_node* n = cache_;
+                    cache_ = n->next;
+                    --cached_;
+                    return n;
+                }
+                return static_cast<base_node*>(alloc::allocate(node_bytes));
+            }
+
+            void put_node(base_node* n) noexcept
+            {
+                if(cached_ < cache_limit){
+                    n->next = cache_;
+                    cache_ = n;
+                    ++cached_;
+                }
+                else{
+                    alloc::deallocate(n,node_bytes);
+                }
+            }
+
+            template<class... Args>
+            base_node* create_node(Args&&... args)
+            {
+                base_node* n = get_node();
+                try{
+                    hxqstl::construct(value_of(n),hxqstl::forward<Args>(args)...);
+                }
+                catch(...){
+                    put_node(n);
+                    throw;
+                }
+                return n;
+            }
+
+            // 取出 n 个未构造的节点，用 next 串成以 nullptr 结尾的链表
+            base_node* take_nodes(size_type n);
+
+            // [first,end) 上的节点已析构，放回缓存，缓存满了之后剩下的一次还给内存池
+            void put_nodes(base_node* first,base_node* end) noexcept;
+
+            // 在 pos 之前插入 n 个元素，gen(p) 在 p 上构造第 i 个元素；任何一个构造失败时整体回滚
+            template<class Gen>
+            iterator insert_n(const_iterator pos,size_type n,Gen gen);
+
+            template<class Iter>
+            iterator insert_copy(const_iterator pos,Iter first,size_type n)
+            {
+                return insert_n(pos,n,[&first](T* p){hxqstl::construct(p,*first); ++first;});
+            }
+
+            // 单趟输入迭代器先逐个插入临时 list，再整段接过来
+            template<class Iter>
+            iterator insert_range(const_iterator pos,Iter first,Iter last,input_iterator_tag)
+            {
+                list tmp;
+                for(;first != last;++first) tmp.emplace_back(*first);
+                if(tmp.empty()) return iterator(pos.node_);
+                iterator result = tmp.begin();
+                splice(pos,tmp);
+                return result;
+            }
+            template<class Iter>
+            iterator insert_range(const_iterator pos,Iter first,Iter last,forward_iterator_tag)
+            {
+                return insert_copy(pos,first,static_cast<size_type>(hxqstl::distance(first,last)));
+            }
+
+            template<class Iter>
+            void assign_copy(Iter first,Iter last);
+
+            template<class Gen>
+            void resize_impl(size_type n,Gen gen);
+
+            template<class Compare>
+            static base_node* merge_chain(base_node*& a,base_node*& b,Compare& comp);
+            // 把若干条以 nullptr 结尾的单链表依次接回环中并补上 prev
+            void relink(base_node* const* chains,size_t n) noexcept;
+    };
+
+    /*****************************************************************************************/
+
+    template<class T>
+    constexpr typename list<T>::size_type list<T>::cache_limit;
+    template<class T>
+    constexpr size_t list<T>::node_bytes;
+
+    template<class T>
+    void list<T>::reserve_nodes(size_type n){
+        if(cached_ >= n) return;
+        FreeList* f = alloc::allocate_chain(node_bytes,n - cached_);
+        while(f != nullptr){
+            FreeList* next = f->next;
+            base_node* p = reinterpret_cast<base_node*>(f);
+            p->next = cache_;
+            cache_ = p;
+            ++cached_;
+            f = next;
+        }
+    }
+
+    template<class T>
+    void list<T>::release_cache() noexcept{
+        FreeList* head = nullptr;
+        FreeList* tail = nullptr;
+        while(cache_ != nullptr){
+            base_node* next = cache_->next;
+            FreeList* f = reinterpret_cast<FreeList*>(cache_);
+            f->next = head;
+            head = f;
+            if(tail == nullptr) tail = f;
+            cache_ = next;
+        }
+        cached_ = 0;
+        alloc::deallocate_chain(head,tail,node_bytes);
+    }
+
+    template<class T>
+    typename list<T>::base_node* list<T>::take_nodes(size_type n){
+        base_node* head = nullptr;
+        base_node** tail = &head;
+        for(;n > 0 && cache_ != nullptr;--n){
+            base_node* p = cache_;
+            cache_ = p->next;
+            --cached_;
+            *tail = p;
+            tail = &p->next;
+        }
+        FreeList* f = n > 0 ? alloc::allocate_chain(node_bytes,n) : nullptr;
+        while(f != nullptr){
+            FreeList* next = f->next;
+            base_node* p = reinterpret_cast<base_node*>(f);
+            *tail = p;
+            tail = &p->next;
+            f = next;
+        }
+        *tail = nullptr;
+        return head;
+    }
+
+    template<class T>
+    void list<T>::put_nodes(base_node* first,base_node* end) noexcept{
+        FreeList* head = nullptr;
+        FreeList* tail = nullptr;
+        while(first != end){
+            base_node* next = first->next;
+            if(cached_ < cache_limit){
+                first->next = cache_;
+                cache_ = first;
+                ++cached_;
+            }
+            else{
+                FreeList* f = reinterpret_cast<FreeList*>(first);
+                f->next = head;
+                head = f;
+                if(tail == nullptr) tail = f;
+            }
+            first = next;
+        }
+        alloc::deallocate_chain(head,tail,node_bytes);
+    }
+
+    template<class T>
+    template<class Gen>
+    typename list<T>::iterator list<T>::insert_n(const_iterator pos,size_type n,Gen gen){
+        if(n == 0) return iterator(pos.node_);
+        THROW_LENGTH_ERROR_IF(size_ > max_size() - n,"list<T>'s size too big");
+        base_node* first = take_nodes(n);
+        // next 已经串好，构造的同时补上 prev
+        base_node* last = nullptr;
+        base_node* cur = first;
+        try{
+            for(;cur != nullptr;cur = cur->next){
+                gen(value_of(cur));
+                cur->prev = last;
+                last = cur;
+            }
+        }
+        catch(...){
+            for(base_node* p = first;p != cur;p = p->next){
+                hxqstl::destroy(value_of(p));
+            }
+            put_nodes(first,nullptr);
+            throw;
+        }
+        link_before(pos.node_,first,last);
+        size_ += n;
+        return iterator(first);
+    }
+
+    template<class T>
+    typename list<T>::iterator list<T>::erase(const_iterator pos){
+        MYSTL_DEBUG(pos != cend());
+        base_node* n = pos.node_;
+        base_node* next = n->next;
+        n->prev->next = next;
+        next->prev = n->prev;
+        hxqstl::destroy(value_of(n));
+        put_node(n);
+        --size_;
+        return iterator(next);
+    }
+
+    template<class T>
+    typename list<T>::iterator list<T>::erase(const_iterator first,const_iterator last){
+        if(first == last) return iterator(last.node_);
+        base_node* f = first.node_;
+        base_node* l = last.node_;
+        f->prev->next = l;
+        base_node* before = f->prev;
+        size_type n = 0;
+        for(base_node* p = f;p != l;p = p->next,++n){
+            hxqstl::destroy(value_of(p));
+        }
+        l->prev = before;
+        size_ -= n;
+        put_nodes(f,l);
+        return iterator(l);
+    }
+
+    // 已有的节点逐个赋值，多出的删除，不够的批量插入
+    template<class T>
+    void list<T>::assign(size_type n,const value_type& value){
+        iterator it = begin();
+        for(;it != end() && n > 0;++it,--n){
+            *it = value;
+        }
+        if(n > 0) insert(cend(),n,value);
+        else erase(it,end());
+    }
+
+    template<class T>
+    template<class Iter>
+    void list<T>::assign_copy(Iter first,Iter last){
+        iterator it = begin();
+        for(;it != end() && first != last;++it,++first){
+            *it = *first;
+        }
+        if(first != last) insert(cend(),first,last);
+        else erase(it,end());
+    }
+
+    template<class T>
+    template<class Gen>
+    void list<T>::resize_impl(size_type n,Gen gen){
+        if(n >= size_){
+            insert_n(cend(),n - size_,gen);
+            return;
+        }
+        // 从较近的一端找到第 n 个位置
+        iterator it;
+        if(n <= size_ / 2){
+            it = begin();
+            for(size_type i = 0;i < n;++i) ++it;
+        }
+        else{
+            it = end();
+            for(size_type i = size_;i > n;--i) --it;
+        }
+        erase(it,end());
+    }
+
+    // 哨兵不属于任何元素，交换后要让首尾节点指回各自的哨兵
+    template<class T>
+    void list<T>::swap(list& rhs) noexcept{
+        hxqstl::swap(head_.prev,rhs.head_.prev);
+        hxqstl::swap(head_.next,rhs.head_.next);
+        hxqstl::swap(size_,rhs.size_);
+        hxqstl::swap(cache_,rhs.cache_);
+        hxqstl::swap(cached_,rhs.cached_);
+        list* sides[2] = {this,&rhs};
+        for(list* l : sides){
+            if(l->size_ == 0){
+                l->head_.prev = &l->head_;
+                l->head_.next = &l->head_;
+            }
+            else{
+                l->head_.next->prev = &l->head_;
+                l->head_.prev->next = &l->head_;
+            }
+        }
+    }
+
+    template<class T>
+    void list<T>::splice(const_iterator pos,list& other){
+        if(this == &other || other.empty()) return;
+        transfer(pos.node_,other.head_.next,&other.head_);
+        size_ += other.size_;
+        other.size_ = 0;
+    }
+
+    template<class T>
+    void list<T>::splice(const_iterator pos,list& other,const_iterator it){
+        base_node* n = it.node_;
+        if(pos.node_ == n || pos.node_ == n->next) return;
+        transfer(pos.node_,n,n->next);
+        ++size_;
+        --other.size_;
+    }
+
+    template<class T>
+    void list<T>::splice(const_iterator pos,list& other,const_iterator first,const_iterator last){
+        if(first == last) return;
+        if(this != &other){
+            const size_type n = static_cast<size_type>(hxqstl::distance(first,last));
+            size_ += n;
+            other.size_ -= n;
+        }
+        transfer(pos.node_,first.node_,last.node_);
+    }
+
+    template<class T>
+    template<class Pred>
+    typename list<T>::size_type list<T>::remove_if(Pred pred){
+        const size_type old_size = size_;
+        for(iterator it = begin();it != end();){
+            if(pred(*it)) it = erase(it);
+            else ++it;
+        }
+        return old_size - size_;
+    }
+
+    template<class T>
+    template<class BinaryPred>
+    typename list<T>::size_type list<T>::unique(BinaryPred pred){
+        const size_type old_size = size_;
+        if(size_ < 2) return 0;
+        iterator prev = begin();
+        for(iterator it = ++begin();it != end();){
+            if(pred(*prev,*it)) it = erase(it);
+            else prev = it++;
+        }
+        return old_size - size_;
+    }
+
+    // 两个 list 都已按 comp 有序；other 中的一段连续比当前元素小的节点一次接过来
+    template<class T>
+    template<class Compare>
+    void list<T>::merge(list& other,Compare comp){
+        if(this == &other) return;
+        base_node* f1 = head_.next;
+        base_node* f2 = other.head_.next;
+        base_node* const e2 = &other.head_;
+        // 每接过来一段就更新两边的大小，comp 抛出异常时两个 list 仍然一致
+        while(f1 != &head_ && f2 != e2){
+            if(comp(*value_of(f2),*value_of(f1))){
+                base_node* run = f2->next;
+                size_type n = 1;
+                while(run != e2 && comp(*value_of(run),*value_of(f1))){
+                    run = run->next;
+                    ++n;
+                }
+                transfer(f1,f2,run);
+                size_ += n;
+                other.size_ -= n;
+                f2 = run;
+            }
+            else{
+                f1 = f1->next;
+            }
+        }
+        if(f2 != e2) transfer(&head_,f2,e2);
+        size_ += other.size_;
+        other.size_ = 0;
+    }
+
+    // 合并两条以 nullptr 结尾的单链表，相等时先取 a，保持稳定；成功后 a、b 置空
+    // comp 抛出异常时把已合并的部分和 a、b 剩下的部分连成一条留在 a 中，节点不会丢失
+    template<class T>
+    template<class Compare>
+    typename list<T>::base_node* list<T>::merge_chain(base_node*& a,base_node*& b,Compare& comp){
+        base_node dummy;
+        dummy.next = nullptr;
+        base_node* tail = &dummy;
+        try{
+            while(a != nullptr && b != nullptr){
+                if(comp(*value_of(b),*value_of(a))){
+                    tail->next = b;
+                    b = b->next;
+                }
+                else{
+                    tail->next = a;
+                    a = a->next;
+                }
+                tail = tail->next;
+            }
+        }
+        catch(...){
+            tail->next = a;
+            while(tail->next != nullptr) tail = tail->next;
+            tail->next = b;
+            a = dummy.next;
+            b = nullptr;
+            throw;
+        }
+        tail->next = a != nullptr ? a : b;
+        a = nullptr;
+        b = nullptr;
+        return dummy.next;
+    }
+
+    template<class T>
+    void list<T>::relink(base_node* const* chains,size_t n) noexcept{
+        base_node* prev = &head_;
+        for(size_t i = 0;i < n;++i){
+            for(base_node* p = chains[i];p != nullptr;p = p->next){
+                prev->next = p;
+                p->prev = prev;
+                prev = p;
+            }
+        }
+        prev->next = &head_;
+        head_.prev = prev;
+    }
+
+    // 自底向上的归并排序，只改 next 指针，最后一趟补上 prev
+    // bins[i] 存放长度为 2^i 的有序段，新节点像二进制加法一样逐级合并
+    // comp 抛出异常时所有节点按任意顺序接回环中，元素个数不变
+    template<class T>
+    template<class Compare>
+    void list<T>::sort(Compare comp){
+        if(size_ < 2) return;
+        head_.prev->next = nullptr;
+        // chains[0] 是还没处理的节点，chains[1] 是正在合并的段，之后是各级 bins
+        base_node* chains[2 + 64] = {};
+        base_node*& rest = chains[0];
+        base_node*& cur = chains[1];
+        base_node** const bins = chains + 2;
+        rest = head_.next;
+        size_t fill = 0;
+        try{
+            while(rest != nullptr){
+                cur = rest;
+                rest = rest->next;
+                cur->next = nullptr;
+                size_t i = 0;
+                for(;i < fill && bins[i] != nullptr;++i){
+                    base_node* merged = merge_chain(bins[i],cur,comp);
+                    cur = merged;
+                }
+                bins[i] = cur;
+                cur = nullptr;
+                if(i == fill) ++fill;
+            }
+            for(size_t i = 0;i < fill;++i){
+                if(bins[i] == nullptr) continue;
+                if(cur == nullptr){
+                    cur = bins[i];
+                    bins[i] = nullptr;
+                }
+                else{
+                    base_node* merged = merge_chain(bins[i],cur,comp);
+                    cur = merged;
+                }
+            }
+        }
+        catch(...){
+            relink(chains,2 + fill);
+            throw;
+        }
+        relink(&cur,1);
+    }
+
+    template<class T>
+    void list<T>::reverse() noexcept{
+        base_node* p = &head_;
+        do{
+            hxqstl::swap(p->prev,p->next);
+            p = p->prev;
+        }while(p != &head_);
+    }
+
+    template<class T>
+    bool operator==(const list<T>& lhs,const list<T>& rhs)
+    {
+        return lhs.size() == rhs.size() && hxqstl::equal(lhs.begin(),lhs.end(),rhs.begin());
+    }
+
+    template<class T>
+    bool operator!=(const list<T>& lhs,const list<T>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template<class T>
+    bool operator<(const list<T>& lhs,const list<T>& rhs)
+    {
+        return hxqstl::lexicographical_compare(lhs.begin(),lhs.end(),rhs.begin(),rhs.end());
+    }
+
+    template<class T>
+    void swap(list<T>& lhs,list<T>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+}
@@ -1,10 +1,15 @@
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 #include <cstdlib>
 #include <climits>
+#include <exception>
+#include <typeinfo>
+#include <type_traits>
 
 #include "algobase.h"
+#include "alloc.h"
 #include "allocator.h"
 #include "construct.h"
 #include "uninitialized.h"
@@ -27,7 +32,7 @@ namespace hxqstl{
             }
             len /= 2;
         }
-        return pair<T*,ptrdiff_t>(tmp,len);
+        return pair<T*,ptrdiff_t>(nullptr,0);
     }
 
     template<class T>
@@ -87,7 +92,7 @@ namespace hxqstl{
             len = hxqstl::distance(first,last);
             allocate_buffer();
             if(len > 0){
-                initialize_buffer(*first,std::is_trivially_default_constructible<T>());
+                initialized_buffer(*first,std::is_trivially_default_constructible<T>());
             }
         }
         catch(...){
@@ -162,4 +167,750 @@ namespace hxqstl{
             }
         }
     };
-}
\ No newline at end of file
+
+    /*****************************************************************************************/
+    // unique_ptr
+    // 独占所有权的智能指针，只能移动不能拷贝，可以放进 hxqstl::vector
+    // 删除器是空类(例如 default_delete)时利用空基类优化，unique_ptr 与裸指针一样大
+
+    template<class T>
+    struct default_delete
+    {
+        constexpr default_delete() noexcept = default;
+        template<class U,typename std::enable_if<std::is_convertible<U*,T*>::value,int>::type = 0>
+        default_delete(const default_delete<U>&) noexcept {}
+
+        void operator()(T* p) const
+        {
+            static_assert(sizeof(T) > 0,"can't delete an incomplete type");
+            delete p;
+        }
+    };
+
+    template<class T>
+    struct default_delete<T[]>
+    {
+        constexpr default_delete() noexcept = default;
+        void operator()(T* p) const
+        {
+            static_assert(sizeof(T) > 0,"can't delete an incomplete type");
+            delete[] p;
+        }
+    };
+
+    // 保存指针和删除器，删除器为空类且不是 final 时作为基类，不占空间
+    template<class Pointer,class Deleter,
+             bool Empty = std::is_empty<Deleter>::value && !std::is_final<Deleter>::value>
+    struct uptr_storage : private Deleter
+    {
+        Pointer ptr;
+        constexpr uptr_storage() : Deleter(),ptr(nullptr) {}
+        template<class D>
+        uptr_storage(Pointer p,D&& d) : Deleter(hxqstl::forward<D>(d)),ptr(p) {}
+        Deleter& deleter() noexcept {return *this;}
+        const Deleter& deleter() const noexcept {return *this;}
+    };
+
+    template<class Pointer,class Deleter>
+    struct uptr_storage<Pointer,Deleter,false>
+    {
+        Deleter del;
+        Pointer ptr;
+        constexpr uptr_storage() : del(),ptr(nullptr) {}
+        template<class D>
+        uptr_storage(Pointer p,D&& d) : del(hxqstl::forward<D>(d)),ptr(p) {}
+        Deleter& deleter() noexcept {return del;}
+        const Deleter& deleter() const noexcept {return del;}
+    };
+
+    template<class T,class Deleter = default_delete<T>>
+    class unique_ptr{
+        public:
+            typedef T* pointer;
+            typedef T element_type;
+            typedef Deleter deleter_type;
+
+        private:
+            uptr_storage<pointer,Deleter> s_;
+
+            template<class U,class E>
+            friend class unique_ptr;
+
+        public:
+            constexpr unique_ptr() noexcept : s_() {}
+            constexpr unique_ptr(std::nullptr_t) noexcept : s_() {}
+            explicit unique_ptr(pointer p) noexcept : s_(p,Deleter()) {}
+            unique_ptr(pointer p,const Deleter& d) noexcept : s_(p,d) {}
+            unique_ptr(pointer p,Deleter&& d) noexcept : s_(p,hxqstl::move(d)) {}
+
+            unique_ptr(unique_ptr&& rhs) noexcept
+            :s_(rhs.release(),hxqstl::forward<Deleter>(rhs.get_deleter())) {}
+
+            // 派生类指针转基类指针
+            template<class U,class E,typename std::enable_if<
+                std::is_convertible<typename unique_ptr<U,E>::pointer,pointer>::value &&
+                !std::is_array<U>::value,int>::type = 0>
+            unique_ptr(unique_ptr<U,E>&& rhs) noexcept
+            :s_(rhs.release(),hxqstl::forward<E>(rhs.get_deleter())) {}
+
+            unique_ptr(const unique_ptr&) = delete;
+            unique_ptr& operator=(const unique_ptr&) = delete;
+
+            unique_ptr& operator=(unique_ptr&& rhs) noexcept
+            {
+                reset(rhs.release());
+                get_deleter() = hxqstl::forward<Deleter>(rhs.get_deleter());
+                return *this;
+            }
+
+            template<class U,class E,typename std::enable_if<
+                std::is_convertible<typename unique_ptr<U,E>::pointer,pointer>::value &&
+                !std::is_array<U>::value,int>::type = 0>
+            unique_ptr& operator=(unique_ptr<U,E>&& rhs) noexcept
+            {
+                reset(rhs.release());
+                get_deleter() = hxqstl::forward<E>(rhs.get_deleter());
+                return *this;
+            }
+
+            unique_ptr& operator=(std::nullptr_t) noexcept
+            {
+                reset();
+                return *this;
+            }
+
+            ~unique_ptr()
+            {
+                if(s_.ptr != nullptr) get_deleter()(s_.ptr);
+            }
+
+        public:
+            T& operator*() const {return *s_.ptr;}
+            pointer operator->() const noexcept {return s_.ptr;}
+            pointer get() const noexcept {return s_.ptr;}
+            explicit operator bool() const noexcept {return s_.ptr != nullptr;}
+
+            Deleter& get_deleter() noexcept {return s_.deleter();}
+            const Deleter& get_deleter() const noexcept {return s_.deleter();}
+
+            pointer release() noexcept
+            {
+                pointer tmp = s_.ptr;
+                s_.ptr = nullptr;
+                return tmp;
+            }
+
+            void reset(pointer p = pointer()) noexcept
+            {
+                pointer old = s_.ptr;
+                s_.ptr = p;
+                if(old != nullptr) get_deleter()(old);
+            }
+
+            void swap(unique_ptr& rhs) noexcept
+            {
+                hxqstl::swap(s_.ptr,rhs.s_.ptr);
+                hxqstl::swap(get_deleter(),rhs.get_deleter());
+            }
+    };
+
+    // 数组版本，提供 operator[]，不提供 * 和 ->
+    template<class T,class Deleter>
+    class unique_ptr<T[],Deleter>{
+        public:
+            typedef T* pointer;
+            typedef T element_type;
+            typedef Deleter deleter_type;
+
+        private:
+            uptr_storage<pointer,Deleter> s_;
+
+        public:
+            constexpr unique_ptr() noexcept : s_() {}
+            constexpr unique_ptr(std::nullptr_t) noexcept : s_() {}
+            explicit unique_ptr(pointer p) noexcept : s_(p,Deleter()) {}
+            unique_ptr(pointer p,const Deleter& d) noexcept : s_(p,d) {}
+            unique_ptr(pointer p,Deleter&& d) noexcept : s_(p,hxqstl::move(d)) {}
+
+            unique_ptr(unique_ptr&& rhs) noexcept
+            :s_(rhs.release(),hxqstl::forward<Deleter>(rhs.get_deleter())) {}
+
+            unique_ptr(const unique_ptr&) = delete;
+            unique_ptr& operator=(const unique_ptr&) = delete;
+
+            unique_ptr& operator=(unique_ptr&& rhs) noexcept
+            {
+                reset(rhs.release());
+                get_deleter() = hxqstl::forward<Deleter>(rhs.get_deleter());
+                return *this;
+            }
+            unique_ptr& operator=(std::nullptr_t) noexcept
+            {
+                reset();
+                return *this;
+            }
+
+            ~unique_ptr()
+            {
+                if(s_.ptr != nullptr) get_deleter()(s_.ptr);
+            }
+
+        public:
+            T& operator[](size_t i) const {return s_.ptr[i];}
+            pointer get() const noexcept {return s_.ptr;}
+            explicit operator bool() const noexcept {return s_.ptr != nullptr;}
+
+            Deleter& get_deleter() noexcept {return s_.deleter();}
+            const Deleter& get_deleter() const noexcept {return s_.deleter();}
+
+            pointer release() noexcept
+            {
+                pointer tmp = s_.ptr;
+                s_.ptr = nullptr;
+                return tmp;
+            }
+
+            void reset(pointer p = pointer()) noexcept
+            {
+                pointer old = s_.ptr;
+                s_.ptr = p;
+                if(old != nullptr) get_deleter()(old);
+            }
+
+            void swap(unique_ptr& rhs) noexcept
+            {
+                hxqstl::swap(s_.ptr,rhs.s_.ptr);
+                hxqstl::swap(get_deleter(),rhs.get_deleter());
+            }
+    };
+
+    template<class T,class... Args>
+    typename std::enable_if<!std::is_array<T>::value,unique_ptr<T>>::type
+    make_unique(Args&&... args)
+    {
+        return unique_ptr<T>(new T(hxqstl::forward<Args>(args)...));
+    }
+
+    template<class T>
+    typename std::enable_if<std::is_array<T>::value && std::extent<T>::value == 0,unique_ptr<T>>::type
+    make_unique(size_t n)
+    {
+        typedef typename std::remove_extent<T>::type elem_type;
+        return unique_ptr<T>(new elem_type[n]());
+    }
+
+    template<class T1,class D1,class T2,class D2>
+    bool operator==(const unique_ptr<T1,D1>& lhs,const unique_ptr<T2,D2>& rhs)
+    { return lhs.get() == rhs.get(); }
+    template<class T1,class D1,class T2,class D2>
+    bool operator!=(const unique_ptr<T1,D1>& lhs,const unique_ptr<T2,D2>& rhs)
+    { return lhs.get() != rhs.get(); }
+    template<class T1,class D1,class T2,class D2>
+    bool operator<(const unique_ptr<T1,D1>& lhs,const unique_ptr<T2,D2>& rhs)
+    { return lhs.get() < rhs.get(); }
+    template<class T,class D>
+    bool operator==(const unique_ptr<T,D>& lhs,std::nullptr_t) noexcept {return !lhs;}
+    template<class T,class D>
+    bool operator==(std::nullptr_t,const unique_ptr<T,D>& rhs) noexcept {return !rhs;}
+    template<class T,class D>
+    bool operator!=(const unique_ptr<T,D>& lhs,std::nullptr_t) noexcept {return bool(lhs);}
+    template<class T,class D>
+    bool operator!=(std::nullptr_t,const unique_ptr<T,D>& rhs) noexcept {return bool(rhs);}
+
+    template<class T,class D>
+    void swap(unique_ptr<T,D>& lhs,unique_ptr<T,D>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    /*****************************************************************************************/
+    // shared_ptr / weak_ptr
+    // 引用计数的策略由模板参数决定：
+    //   sp_atomic  计数用原子操作，可以跨线程共享(默认)
+    //   sp_single  计数是普通整数，只能在一个线程内使用，拷贝时省掉一次原子操作
+    // local_shared_ptr<T> 是 shared_ptr<T,sp_single> 的别名
+    // 控制块从 alloc 内存池分配，make_shared 把控制块和对象放在同一块内存里
+
+    enum sp_lock_policy {sp_single,sp_atomic};
+
+    class bad_weak_ptr : public std::exception
+    {
+    public:
+        const char* what() const noexcept override {return "hxqstl::bad_weak_ptr";}
+    };
+
+    template<sp_lock_policy Lp>
+    struct sp_counter;
+
+    template<>
+    struct sp_counter<sp_single>
+    {
+        typedef long type;
+        static void init(type& c,long v) noexcept {c = v;}
+        static long load(const type& c) noexcept {return c;}
+        static void add(type& c) noexcept {++c;}
+        // 返回减一之后的值
+        static long sub(type& c) noexcept {return --c;}
+        // 计数不为 0 时加一，成功返回 true
+        static bool add_if_nonzero(type& c) noexcept
+        {
+            if(c == 0) return false;
+            ++c;
+            return true;
+        }
+    };
+
+    template<>
+    struct sp_counter<sp_atomic>
+    {
+        typedef std::atomic<long> type;
+        static void init(type& c,long v) noexcept {c.store(v,std::memory_order_relaxed);}
+        static long load(const type& c) noexcept {return c.load(std::memory_order_acquire);}
+        static void add(type& c) noexcept {c.fetch_add(1,std::memory_order_relaxed);}
+        static long sub(type& c) noexcept {return c.fetch_sub(1,std::memory_order_acq_rel) - 1;}
+        static bool add_if_nonzero(type& c) noexcept
+        {
+            long cur = c.load(std::memory_order_relaxed);
+            while(cur != 0){
+                if(c.compare_exchange_weak(cur,cur + 1,std::memory_order_acq_rel,std::memory_order_relaxed)){
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+
+    // 控制块的公共部分
+    // weak_count_ 等于 weak_ptr 的个数，只要还有 shared_ptr 再额外加一
+    template<sp_lock_policy Lp>
+    class sp_counted_base
+    {
+        typedef sp_counter<Lp> counter;
+        typename counter::type use_count_;
+        typename counter::type weak_count_;
+
+    public:
+        sp_counted_base() noexcept
+        {
+            counter::init(use_count_,1);
+            counter::init(weak_count_,1);
+        }
+        virtual ~sp_counted_base() = default;
+        sp_counted_base(const sp_counted_base&) = delete;
+        sp_counted_base& operator=(const sp_counted_base&) = delete;
+
+        // 析构所管理的对象
+        virtual void dispose() noexcept = 0;
+        // 释放控制块自身
+        virtual void destroy() noexcept = 0;
+        virtual void* get_deleter(const std::type_info&) noexcept {return nullptr;}
+
+        void add_ref_copy() noexcept {counter::add(use_count_);}
+        bool add_ref_lock() noexcept {return counter::add_if_nonzero(use_count_);}
+
+        void release() noexcept
+        {
+            if(counter::sub(use_count_) == 0){
+                dispose();
+                weak_release();
+            }
+        }
+
+        void weak_add_ref() noexcept {counter::add(weak_count_);}
+        void weak_release() noexcept
+        {
+            if(counter::sub(weak_count_) == 0){
+                destroy();
+            }
+        }
+
+        long use_count() const noexcept {return counter::load(use_count_);}
+    };
+
+    // 控制块内存从 alloc 分配，按控制块的对齐要求取档位
+    template<class Block>
+    void* sp_allocate_block()
+    {
+        return alloc::allocate(sizeof(Block),align_val_t(alignof(Block)));
+    }
+
+    template<class Block>
+    void sp_deallocate_block(void* p) noexcept
+    {
+        alloc::deallocate(p,sizeof(Block),align_val_t(alignof(Block)));
+    }
+
+    // 保存外部传入的指针和删除器
+    template<class Ptr,class Deleter,sp_lock_policy Lp>
+    class sp_counted_deleter final : public sp_counted_base<Lp>
+    {
+        Ptr ptr_;
+        Deleter del_;
+
+    public:
+        sp_counted_deleter(Ptr p,Deleter d) noexcept : ptr_(p),del_(hxqstl::move(d)) {}
+
+        void dispose() noexcept override {del_(ptr_);}
+        void destroy() noexcept override
+        {
+            this->~sp_counted_deleter();
+            sp_deallocate_block<sp_counted_deleter>(this);
+        }
+        void* get_deleter(const std::type_info& ti) noexcept override
+        { return ti == typeid(Deleter) ? static_cast<void*>(&del_) : nullptr; }
+    };
+
+    // make_shared 使用：对象直接放在控制块后面
+    template<class T,sp_lock_policy Lp>
+    class sp_counted_inplace final : public sp_counted_base<Lp>
+    {
+        typename std::aligned_storage<sizeof(T),alignof(T)>::type storage_;
+
+    public:
+        template<class... Args>
+        explicit sp_counted_inplace(Args&&... args)
+        {
+            ::new (static_cast<void*>(&storage_)) T(hxqstl::forward<Args>(args)...);
+        }
+
+        T* ptr() noexcept {return reinterpret_cast<T*>(&storage_);}
+
+        void dispose() noexcept override {ptr()->~T();}
+        void destroy() noexcept override
+        {
+            this->~sp_counted_inplace();
+            sp_deallocate_block<sp_counted_inplace>(this);
+        }
+    };
+
+    template<class T,sp_lock_policy Lp>
+    class weak_ptr;
+
+    template<class T,sp_lock_policy Lp = sp_atomic>
+    class shared_ptr{
+        public:
+            typedef T element_type;
+            typedef weak_ptr<T,Lp> weak_type;
+
+        private:
+            T* ptr_;
+            sp_counted_base<Lp>* cb_;
+
+            template<class U,sp_lock_policy L> friend class shared_ptr;
+            template<class U,sp_lock_policy L> friend class weak_ptr;
+            template<class U,sp_lock_policy L,class... Args>
+            friend shared_ptr<U,L> allocate_shared_impl(Args&&... args);
+
+            template<class U>
+            using enable_if_convertible = typename std::enable_if<std::is_convertible<U*,T*>::value,int>::type;
+
+            // 供 make_shared 和 weak_ptr::lock 使用，直接接管已经加过计数的控制块
+            struct adopt_tag {};
+            shared_ptr(T* p,sp_counted_base<Lp>* cb,adopt_tag) noexcept : ptr_(p),cb_(cb) {}
+
+        public:
+            constexpr shared_ptr() noexcept : ptr_(nullptr),cb_(nullptr) {}
+            constexpr shared_ptr(std::nullptr_t) noexcept : ptr_(nullptr),cb_(nullptr) {}
+
+            template<class U,enable_if_convertible<U> = 0>
+            explicit shared_ptr(U* p) : shared_ptr(p,default_delete<U>()) {}
+
+            // 分配控制块失败时用 d 释放 p 再抛出异常
+            template<class U,class Deleter,enable_if_convertible<U> = 0>
+            shared_ptr(U* p,Deleter d) : ptr_(p),cb_(nullptr)
+            {
+                typedef sp_counted_deleter<U*,Deleter,Lp> block_type;
+                try{
+                    cb_ = ::new (sp_allocate_block<block_type>()) block_type(p,hxqstl::move(d));
+                }
+                catch(...){
+                    d(p);
+                    throw;
+                }
+            }
+
+            // 别名构造：与 rhs 共享所有权，但指向 p
+            template<class U>
+            shared_ptr(const shared_ptr<U,Lp>& rhs,T* p) noexcept : ptr_(p),cb_(rhs.cb_)
+            {
+                if(cb_) cb_->add_ref_copy();
+            }
+
+            shared_ptr(const shared_ptr& rhs) noexcept : ptr_(rhs.ptr_),cb_(rhs.cb_)
+            {
+                if(cb_) cb_->add_ref_copy();
+            }
+            template<class U,enable_if_convertible<U> = 0>
+            shared_ptr(const shared_ptr<U,Lp>& rhs) noexcept : ptr_(rhs.ptr_),cb_(rhs.cb_)
+            {
+                if(cb_) cb_->add_ref_copy();
+            }
+
+            shared_ptr(shared_ptr&& rhs) noexcept : ptr_(rhs.ptr_),cb_(rhs.cb_)
+            {
+                rhs.ptr_ = nullptr;
+                rhs.cb_ = nullptr;
+            }
+            template<class U,enable_if_convertible<U> = 0>
+            shared_ptr(shared_ptr<U,Lp>&& rhs) noexcept : ptr_(rhs.ptr_),cb_(rhs.cb_)
+            {
+                rhs.ptr_ = nullptr;
+                rhs.cb_ = nullptr;
+            }
+
+            // weak_ptr 已过期时抛出 bad_weak_ptr
+            template<class U,enable_if_convertible<U> = 0>
+            explicit shared_ptr(const weak_ptr<U,Lp>& rhs) : ptr_(rhs.ptr_),cb_(rhs.cb_)
+            {
+                if(cb_ == nullptr || !cb_->add_ref_lock()) throw bad_weak_ptr();
+            }
+
+            template<class U,class Deleter,enable_if_convertible<U> = 0>
+            shared_ptr(unique_ptr<U,Deleter>&& rhs) : ptr_(nullptr),cb_(nullptr)
+            {
+                if(rhs.get() != nullptr){
+                    typedef sp_counted_deleter<U*,Deleter,Lp> block_type;
+                    cb_ = ::new (sp_allocate_block<block_type>()) block_type(rhs.get(),rhs.get_deleter());
+                    ptr_ = rhs.release();
+                }
+            }
+
+            shared_ptr& operator=(const shared_ptr& rhs) noexcept
+            {
+                shared_ptr(rhs).swap(*this);
+                return *this;
+            }
+            template<class U>
+            shared_ptr& operator=(const shared_ptr<U,Lp>& rhs) noexcept
+            {
+                shared_ptr(rhs).swap(*this);
+                return *this;
+            }
+            shared_ptr& operator=(shared_ptr&& rhs) noexcept
+            {
+                shared_ptr(hxqstl::move(rhs)).swap(*this);
+                return *this;
+            }
+            template<class U>
+            shared_ptr& operator=(shared_ptr<U,Lp>&& rhs) noexcept
+            {
+                shared_ptr(hxqstl::move(rhs)).swap(*this);
+                return *this;
+            }
+            template<class U,class Deleter>
+            shared_ptr& operator=(unique_ptr<U,Deleter>&& rhs)
+            {
+                shared_ptr(hxqstl::move(rhs)).swap(*this);
+                return *this;
+            }
+
+            ~shared_ptr()
+            {
+                if(cb_) cb_->release();
+            }
+
+        public:
+            T& operator*() const noexcept {return *ptr_;}
+            T* operator->() const noexcept {return ptr_;}
+            T* get() const noexcept {return ptr_;}
+            explicit operator bool() const noexcept {return ptr_ != nullptr;}
+
+            long use_count() const noexcept {return cb_ ? cb_->use_count() : 0;}
+            bool unique() const noexcept {return use_count() == 1;}
+
+            void reset() noexcept {shared_ptr().swap(*this);}
+            template<class U>
+            void reset(U* p) {shared_ptr(p).swap(*this);}
+            template<class U,class Deleter>
+            void reset(U* p,Deleter d) {shared_ptr(p,hxqstl::move(d)).swap(*this);}
+
+            void swap(shared_ptr& rhs) noexcept
+            {
+                hxqstl::swap(ptr_,rhs.ptr_);
+                hxqstl::swap(cb_,rhs.cb_);
+            }
+
+            // 按控制块排序，用于把 shared_ptr/weak_ptr 放进有序容器
+            template<class U>
+            bool owner_before(const shared_ptr<U,Lp>& rhs) const noexcept {return cb_ < rhs.cb_;}
+            template<class U>
+            bool owner_before(const weak_ptr<U,Lp>& rhs) const noexcept {return cb_ < rhs.cb_;}
+
+            template<class Deleter>
+            Deleter* get_deleter() const noexcept
+            { return cb_ ? static_cast<Deleter*>(cb_->get_deleter(typeid(Deleter))) : nullptr; }
+    };
+
+    template<class T,sp_lock_policy Lp = sp_atomic>
+    class weak_ptr{
+        public:
+            typedef T element_type;
+
+        private:
+            T* ptr_;
+            sp_counted_base<Lp>* cb_;
+
+            template<class U,sp_lock_policy L> friend class shared_ptr;
+            template<class U,sp_lock_policy L> friend class weak_ptr;
+
+            template<class U>
+            using enable_if_convertible = typename std::enable_if<std::is_convertible<U*,T*>::value,int>::type;
+
+        public:
+            constexpr weak_ptr() noexcept : ptr_(nullptr),cb_(nullptr) {}
+
+            template<class U,enable_if_convertible<U> = 0>
+            weak_ptr(const shared_ptr<U,Lp>& rhs) noexcept : ptr_(rhs.ptr_),cb_(rhs.cb_)
+            {
+                if(cb_) cb_->weak_add_ref();
+            }
+
+            weak_ptr(const weak_ptr& rhs) noexcept : ptr_(rhs.ptr_),cb_(rhs.cb_)
+            {
+                if(cb_) cb_->weak_add_ref();
+            }
+            template<class U,enable_if_convertible<U> = 0>
+            weak_ptr(const weak_ptr<U,Lp>& rhs) noexcept : ptr_(nullptr),cb_(rhs.cb_)
+            {
+                // 对象可能已经析构，先锁定再做指针转换
+                if(cb_){
+                    cb_->weak_add_ref();
+                    ptr_ = rhs.lock().get();
+                }
+            }
+
+            weak_ptr(weak_ptr&& rhs) noexcept : ptr_(rhs.ptr_),cb_(rhs.cb_)
+            {
+                rhs.ptr_ = nullptr;
+                rhs.cb_ = nullptr;
+            }
+
+            weak_ptr& operator=(const weak_ptr& rhs) noexcept
+            {
+                weak_ptr(rhs).swap(*this);
+                return *this;
+            }
+            template<class U>
+            weak_ptr& operator=(const shared_ptr<U,Lp>& rhs) noexcept
+            {
+                weak_ptr(rhs).swap(*this);
+                return *this;
+            }
+            weak_ptr& operator=(weak_ptr&& rhs) noexcept
+            {
+                weak_ptr(hxqstl::move(rhs)).swap(*this);
+                return *this;
+            }
+
+            ~weak_ptr()
+            {
+                if(cb_) cb_->weak_release();
+            }
+
+        public:
+            long use_count() const noexcept {return cb_ ? cb_->use_count() : 0;}
+            bool expired() const noexcept {return use_count() == 0;}
+
+            // 对象还活着时返回共享所有权的 shared_ptr，否则返回空
+            shared_ptr<T,Lp> lock() const noexcept
+            {
+                if(cb_ != nullptr && cb_->add_ref_lock()){
+                    return shared_ptr<T,Lp>(ptr_,cb_,typename shared_ptr<T,Lp>::adopt_tag());
+                }
+                return shared_ptr<T,Lp>();
+            }
+
+            void reset() noexcept {weak_ptr().swap(*this);}
+
+            void swap(weak_ptr& rhs) noexcept
+            {
+                hxqstl::swap(ptr_,rhs.ptr_);
+                hxqstl::swap(cb_,rhs.cb_);
+            }
+
+            template<class U>
+            bool owner_before(const shared_ptr<U,Lp>& rhs) const noexcept {return cb_ < rhs.cb_;}
+            template<class U>
+            bool owner_before(const weak_ptr<U,Lp>& rhs) const noexcept {return cb_ < rhs.cb_;}
+    };
+
+    template<class T>
+    using local_shared_ptr = shared_ptr<T,sp_single>;
+    template<class T>
+    using local_weak_ptr = weak_ptr<T,sp_single>;
+
+    // 控制块和对象一次分配
+    template<class T,sp_lock_policy Lp,class... Args>
+    shared_ptr<T,Lp> allocate_shared_impl(Args&&... args)
+    {
+        typedef sp_counted_inplace<T,Lp> block_type;
+        void* mem = sp_allocate_block<block_type>();
+        block_type* cb;
+        try{
+            cb = ::new (mem) block_type(hxqstl::forward<Args>(args)...);
+        }
+        catch(...){
+            sp_deallocate_block<block_type>(mem);
+            throw;
+        }
+        return shared_ptr<T,Lp>(cb->ptr(),cb,typename shared_ptr<T,Lp>::adopt_tag());
+    }
+
+    template<class T,class... Args>
+    shared_ptr<T> make_shared(Args&&... args)
+    {
+        return allocate_shared_impl<T,sp_atomic>(hxqstl::forward<Args>(args)...);
+    }
+
+    // 只在一个线程内使用的对象：引用计数不用原子操作
+    template<class T,class... Args>
+    local_shared_ptr<T> make_local_shared(Args&&... args)
+    {
+        return allocate_shared_impl<T,sp_single>(hxqstl::forward<Args>(args)...);
+    }
+
+    template<class T,class U,sp_lock_policy Lp>
+    shared_ptr<T,Lp> static_pointer_cast(const shared_ptr<U,Lp>& r) noexcept
+    { return shared_ptr<T,Lp>(r,static_cast<T*>(r.get())); }
+
+    template<class T,class U,sp_lock_policy Lp>
+    shared_ptr<T,Lp> const_pointer_cast(const shared_ptr<U,Lp>& r) noexcept
+    { return shared_ptr<T,Lp>(r,const_cast<T*>(r.get())); }
+
+    template<class T,class U,sp_lock_policy Lp>
+    shared_ptr<T,Lp> dynamic_pointer_cast(const shared_ptr<U,Lp>& r) noexcept
+    {
+        T* p = dynamic_cast<T*>(r.get());
+        return p ? shared_ptr<T,Lp>(r,p) : shared_ptr<T,Lp>();
+    }
+
+    template<class T,class U,sp_lock_policy Lp>
+    bool operator==(const shared_ptr<T,Lp>& lhs,const shared_ptr<U,Lp>& rhs) noexcept
+    { return lhs.get() == rhs.get(); }
+    template<class T,class U,sp_lock_policy Lp>
+    bool operator!=(const shared_ptr<T,Lp>& lhs,const shared_ptr<U,Lp>& rhs) noexcept
+    { return lhs.get() != rhs.get(); }
+    template<class T,class U,sp_lock_policy Lp>
+    bool operator<(const shared_ptr<T,Lp>& lhs,const shared_ptr<U,Lp>& rhs) noexcept
+    { return lhs.get() < rhs.get(); }
+    template<class T,sp_lock_policy Lp>
+    bool operator==(const shared_ptr<T,Lp>& lhs,std::nullptr_t) noexcept {return !lhs;}
+    template<class T,sp_lock_policy Lp>
+    bool operator==(std::nullptr_t,const shared_ptr<T,Lp>& rhs) noexcept {return !rhs;}
+    template<class T,sp_lock_policy Lp>
+    bool operator!=(const shared_ptr<T,Lp>& lhs,std::nullptr_t) noexcept {return bool(lhs);}
+    template<class T,sp_lock_policy Lp>
+    bool operator!=(std::nullptr_t,const shared_ptr<T,Lp>& rhs) noexcept {return bool(rhs);}
+
+    template<class T,sp_lock_policy Lp>
+    void swap(shared_ptr<T,Lp>& lhs,shared_ptr<T,Lp>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    template<class T,sp_lock_policy Lp>
+    void swap(weak_ptr<T,Lp>& lhs,weak_ptr<T,Lp>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+}
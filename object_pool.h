@@ -0,0 +1,194 @@
+#pragma once
+
+// object_pool
+// 单一类型的对象池：从 alloc 内存池整块申请 slab，再切成等大的槽位，空闲槽位串成单链表
+// create/destroy 只是链表的取出和放回，不经过 malloc；所有 slab 在对象池析构时一次归还
+// 非线程安全，每个线程使用自己的对象池
+
+#include <new>
+
+#include "algobase.h"
+#include "alloc.h"
+#include "construct.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace hxqstl{
+    template<class T>
+    class object_pool{
+        private:
+            // 空闲时存放链表指针，使用时存放对象
+            union node
+            {
+                node* next;
+                typename std::aligned_storage<sizeof(T),alignof(T)>::type storage;
+            };
+
+            // 每个 slab 的开头记录下一个 slab，之后是槽位数组
+            struct slab_header
+            {
+                slab_header* next;
+                size_t bytes;
+            };
+
+            // 槽位数组相对 slab 起始地址的偏移，保证对象的对齐
+            static constexpr size_t node_offset =
+                (sizeof(slab_header) + alignof(node) - 1) / alignof(node) * alignof(node);
+            // slab 按 node 和 slab_header 中较严格的对齐申请
+            static constexpr size_t slab_align =
+                alignof(node) > alignof(slab_header) ? alignof(node) : alignof(slab_header);
+
+            slab_header* slabs_;
+            node* free_;
+            size_t live_;
+            size_t capacity_;
+            size_t next_count_;         // 下一个 slab 的槽位数
+
+        public:
+            typedef T value_type;
+            typedef size_t size_type;
+
+            // 默认第一个 slab 正好占用内存池的一个最大档位
+            explicit object_pool(size_type initial_count = 0)
+            :slabs_(nullptr),free_(nullptr),live_(0),capacity_(0),
+             next_count_(initial_count != 0 ? initial_count : default_count())
+            {}
+
+            object_pool(const object_pool&) = delete;
+            object_pool& operator=(const object_pool&) = delete;
+
+            object_pool(object_pool&& rhs) noexcept
+            :slabs_(rhs.slabs_),free_(rhs.free_),live_(rhs.live_),capacity_(rhs.capacity_),
+             next_count_(rhs.next_count_)
+            {
+                rhs.slabs_ = nullptr;
+                rhs.free_ = nullptr;
+                rhs.live_ = 0;
+                rhs.capacity_ = 0;
+            }
+
+            // 析构时不会调用仍存活对象的析构函数，调用者应先 destroy 所有对象
+            ~object_pool()
+            {
+                MYSTL_DEBUG(live_ == 0);
+                release_slabs();
+            }
+
+        public:
+            // 分配一个槽位并构造对象
+            template<class... Args>
+            T* create(Args&&... args)
+            {
+                T* p = allocate();
+                try{
+                    hxqstl::construct(p,hxqstl::forward<Args>(args)...);
+                }
+                catch(...){
+                    deallocate(p);
+                    throw;
+                }
+                return p;
+            }
+
+            // 析构对象并归还槽位
+            void destroy(T* p) noexcept
+            {
+                if(p == nullptr) return;
+                hxqstl::destroy(p);
+                deallocate(p);
+            }
+
+            // 只分配/归还未构造的槽位
+            T* allocate()
+            {
+                if(free_ == nullptr) add_slab();
+                node* n = free_;
+                free_ = n->next;
+                ++live_;
+                return reinterpret_cast<T*>(&n->storage);
+            }
+
+            void deallocate(T* p) noexcept
+            {
+                node* n = reinterpret_cast<node*>(p);
+                n->next = free_;
+                free_ = n;
+                --live_;
+            }
+
+            // 预先准备至少 n 个空闲槽位
+            void reserve(size_type n)
+            {
+                if(capacity_ - live_ >= n) return;
+                const size_type saved = next_count_;
+                next_count_ = hxqstl::max(next_count_,n - (capacity_ - live_));
+                add_slab();
+                next_count_ = saved;
+            }
+
+            size_type size() const noexcept {return live_;}
+            size_type capacity() const noexcept {return capacity_;}
+
+            void swap(object_pool& rhs) noexcept
+            {
+                hxqstl::swap(slabs_,rhs.slabs_);
+                hxqstl::swap(free_,rhs.free_);
+                hxqstl::swap(live_,rhs.live_);
+                hxqstl::swap(capacity_,rhs.capacity_);
+                hxqstl::swap(next_count_,rhs.next_count_);
+            }
+
+        private:
+            static size_type default_count() noexcept
+            {
+                const size_type n = (static_cast<size_type>(ESmallObjectBytes) - node_offset) / sizeof(node);
+                return n < 8 ? 8 : n;
+            }
+
+            void add_slab();
+
+            void release_slabs() noexcept
+            {
+                while(slabs_ != nullptr){
+                    slab_header* next = slabs_->next;
+                    alloc::deallocate(slabs_,slabs_->bytes,align_val_t(slab_align));
+                    slabs_ = next;
+                }
+                free_ = nullptr;
+                capacity_ = 0;
+            }
+    };
+
+    /*****************************************************************************************/
+
+    template<class T>
+    constexpr size_t object_pool<T>::node_offset;
+    template<class T>
+    constexpr size_t object_pool<T>::slab_align;
+
+    // 新 slab 的槽位按地址顺序挂到空闲链表上，先分配出去的对象在内存中相邻
+    template<class T>
+    void object_pool<T>::add_slab(){
+        const size_t count = next_count_;
+        const size_t bytes = node_offset + count * sizeof(node);
+        void* mem = alloc::allocate(bytes,align_val_t(slab_align));
+        slab_header* slab = static_cast<slab_header*>(mem);
+        slab->next = slabs_;
+        slab->bytes = bytes;
+        slabs_ = slab;
+
+        node* first = reinterpret_cast<node*>(static_cast<char*>(mem) + node_offset);
+        for(size_t i = 0;i + 1 < count;++i){
+            first[i].next = first + i + 1;
+        }
+        first[count - 1].next = free_;
+        free_ = first;
+        capacity_ += count;
+    }
+
+    template<class T>
+    void swap(object_pool<T>& lhs,object_pool<T>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+}
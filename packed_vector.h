@@ -0,0 +1,418 @@
+#pragma once
+
+// packed_vector
+// 以固定位宽连续存放无符号整数的顺序容器，例如 17 位的 ID 每个只占 17 位
+// 位宽可以在编译期指定 packed_vector<17>，也可以在运行期指定 packed_vector<>(17)
+// 元素按位首尾相接存放在 uint64_t 数组中，末尾多留一个字，使读取跨字元素时无需分支
+// 每 64 个元素正好占 width 个字，批量 unpack/pack 以 64 个元素为一块，
+// 按位宽分派到编译期展开的解码函数，移位量全是常量，便于编译器向量化
+
+#include <cstdint>
+#include <utility>
+
+#include "algobase.h"
+#include "bitops.h"
+#include "iterator.h"
+#include "vector.h"
+#include "exceptdef.h"
+
+namespace hxqstl{
+    namespace packed{
+        constexpr size_t block_values = 64;     // 每块的元素个数
+
+        inline uint64_t width_mask(unsigned width) noexcept{
+            return bits::low_mask(width);
+        }
+
+        // 解码一块：64 个 W 位的值从 in[0..W) 解到 out[0..64)
+        template<class U,unsigned W>
+        void unpack_block(const uint64_t* in,U* out) noexcept{
+            const uint64_t mask = bits::low_mask(W);
+            for(unsigned j = 0;j < block_values;++j){
+                const unsigned bit = j * W;
+                const unsigned word = bit / 64;
+                const unsigned off = bit % 64;
+                uint64_t v = in[word] >> off;
+                if(off + W > 64){
+                    v |= in[word + 1] << (64 - off);
+                }
+                out[j] = static_cast<U>(v & mask);
+            }
+        }
+
+        // 编码一块：64 个值写入 out[0..W)，out 原有内容被覆盖
+        template<class U,unsigned W>
+        void pack_block(const U* in,uint64_t* out) noexcept{
+            const uint64_t mask = bits::low_mask(W);
+            for(unsigned i = 0;i < W;++i){
+                out[i] = 0;
+            }
+            for(unsigned j = 0;j < block_values;++j){
+                const unsigned bit = j * W;
+                const unsigned word = bit / 64;
+                const unsigned off = bit % 64;
+                const uint64_t v = static_cast<uint64_t>(in[j]) & mask;
+                out[word] |= v << off;
+                if(off + W > 64){
+                    out[word + 1] |= v >> (64 - off);
+                }
+            }
+        }
+
+        // 运行期位宽分派到对应的编译期版本
+        template<class U,size_t... I>
+        void unpack_block_dispatch(unsigned width,const uint64_t* in,U* out,std::index_sequence<I...>) noexcept{
+            typedef void (*fn)(const uint64_t*,U*);
+            static constexpr fn table[] = {&unpack_block<U,static_cast<unsigned>(I + 1)>...};
+            table[width - 1](in,out);
+        }
+
+        template<class U,size_t... I>
+        void pack_block_dispatch(unsigned width,const U* in,uint64_t* out,std::index_sequence<I...>) noexcept{
+            typedef void (*fn)(const U*,uint64_t*);
+            static constexpr fn table[] = {&pack_block<U,static_cast<unsigned>(I + 1)>...};
+            table[width - 1](in,out);
+        }
+
+        // 位宽的存放：编译期位宽不占空间，Bits == 0 时在对象里保存运行期位宽
+        template<unsigned Bits>
+        struct width_holder
+        {
+            static_assert(Bits >= 1 && Bits <= 64,"packed_vector width must be in [1,64]");
+            width_holder() noexcept {}
+            static constexpr unsigned width() noexcept {return Bits;}
+        };
+
+        template<>
+        struct width_holder<0>
+        {
+            unsigned width_;
+            explicit width_holder(unsigned w) : width_(w)
+            {
+                THROW_OUT_OF_RANGE_IF(w == 0 || w > 64,"packed_vector width must be in [1,64]");
+            }
+            unsigned width() const noexcept {return width_;}
+        };
+    }
+
+    template<unsigned Bits>
+    class packed_vector;
+
+    // operator[] 和迭代器返回的代理引用
+    template<unsigned Bits>
+    class packed_reference
+    {
+        friend class packed_vector<Bits>;
+        packed_vector<Bits>* pv_;
+        size_t index_;
+    public:
+        packed_reference(packed_vector<Bits>* pv,size_t i) noexcept : pv_(pv),index_(i) {}
+
+        operator uint64_t() const noexcept {return pv_->get(index_);}
+        packed_reference& operator=(uint64_t v) noexcept
+        {
+            pv_->set(index_,v);
+            return *this;
+        }
+        packed_reference& operator=(const packed_reference& rhs) noexcept
+        { return *this = static_cast<uint64_t>(rhs); }
+
+        // 代理对象是右值，交换的是所指向的元素
+        friend void swap(packed_reference lhs,packed_reference rhs) noexcept
+        {
+            const uint64_t tmp = lhs;
+            lhs = static_cast<uint64_t>(rhs);
+            rhs = tmp;
+        }
+    };
+
+    // 随机访问的代理迭代器，保存容器指针和下标
+    template<unsigned Bits,bool IsConst>
+    struct packed_iterator : public iterator<random_access_iterator_tag,uint64_t>
+    {
+        typedef typename std::conditional<IsConst,const packed_vector<Bits>*,packed_vector<Bits>*>::type container_ptr;
+        typedef typename std::conditional<IsConst,uint64_t,packed_reference<Bits>>::type reference;
+        typedef void pointer;
+        typedef ptrdiff_t difference_type;
+        typedef packed_iterator self;
+
+        container_ptr pv;
+        size_t index;
+
+        packed_iterator() noexcept : pv(nullptr),index(0) {}
+        packed_iterator(container_ptr p,size_t i) noexcept : pv(p),index(i) {}
+        template<bool C,typename std::enable_if<IsConst && !C,int>::type = 0>
+        packed_iterator(const packed_iterator<Bits,C>& rhs) noexcept : pv(rhs.pv),index(rhs.index) {}
+
+        reference operator*() const {return make_ref(pv,index);}
+        reference operator[](difference_type n) const {return make_ref(pv,index + n);}
+
+        self& operator++() {++index;return *this;}
+        self operator++(int) {self tmp = *this;++index;return tmp;}
+        self& operator--() {--index;return *this;}
+        self operator--(int) {self tmp = *this;--index;return tmp;}
+        self& operator+=(difference_type n) {index += n;return *this;}
+        self& operator-=(difference_type n) {index -= n;return *this;}
+        self operator+(difference_type n) const {return self(pv,index + n);}
+        self operator-(difference_type n) const {return self(pv,index - n);}
+        difference_type operator-(const self& rhs) const
+        { return static_cast<difference_type>(index) - static_cast<difference_type>(rhs.index); }
+
+        bool operator==(const self& rhs) const {return index == rhs.index;}
+        bool operator!=(const self& rhs) const {return index != rhs.index;}
+        bool operator<(const self& rhs) const {return index < rhs.index;}
+        bool operator>(const self& rhs) const {return rhs.index < index;}
+        bool operator<=(const self& rhs) const {return !(rhs.index < index);}
+        bool operator>=(const self& rhs) const {return !(index < rhs.index);}
+
+    private:
+        static uint64_t make_ref(const packed_vector<Bits>* p,size_t i) {return p->get(i);}
+        static packed_reference<Bits> make_ref(packed_vector<Bits>* p,size_t i) {return packed_reference<Bits>(p,i);}
+    };
+
+    template<unsigned Bits = 0>
+    class packed_vector : private packed::width_holder<Bits>{
+        typedef packed::width_holder<Bits> width_base;
+        public:
+            typedef uint64_t value_type;
+            typedef size_t size_type;
+            typedef ptrdiff_t difference_type;
+            typedef packed_reference<Bits> reference;
+            typedef uint64_t const_reference;
+            typedef packed_iterator<Bits,false> iterator;
+            typedef packed_iterator<Bits,true> const_iterator;
+
+        private:
+            hxqstl::vector<uint64_t> words_;    // 非空时比实际需要多一个字
+            size_type size_;
+
+        public:
+            // 编译期位宽
+            packed_vector() noexcept : width_base(),words_(),size_(0) {}
+
+            template<unsigned B = Bits,typename std::enable_if<B != 0,int>::type = 0>
+            explicit packed_vector(size_type n,value_type value = 0)
+            :width_base(),words_(),size_(0)
+            {
+                resize(n,value);
+            }
+
+            // 运行期位宽
+            template<unsigned B = Bits,typename std::enable_if<B == 0,int>::type = 0>
+            explicit packed_vector(unsigned width,size_type n = 0,value_type value = 0)
+            :width_base(width),words_(),size_(0)
+            {
+                resize(n,value);
+            }
+
+            packed_vector(const packed_vector& rhs) = default;
+            packed_vector(packed_vector&& rhs) noexcept
+            :width_base(rhs),words_(hxqstl::move(rhs.words_)),size_(rhs.size_)
+            {
+                rhs.size_ = 0;
+            }
+
+            packed_vector& operator=(const packed_vector& rhs) = default;
+            packed_vector& operator=(packed_vector&& rhs) noexcept
+            {
+                width_base::operator=(rhs);
+                words_ = hxqstl::move(rhs.words_);
+                size_ = rhs.size_;
+                rhs.size_ = 0;
+                return *this;
+            }
+
+            ~packed_vector() = default;
+
+        public:
+            using width_base::width;
+            value_type max_value() const noexcept {return packed::width_mask(width());}
+
+            iterator begin() noexcept {return iterator(this,0);}
+            const_iterator begin() const noexcept {return const_iterator(this,0);}
+            iterator end() noexcept {return iterator(this,size_);}
+            const_iterator end() const noexcept {return const_iterator(this,size_);}
+            const_iterator cbegin() const noexcept {return begin();}
+            const_iterator cend() const noexcept {return end();}
+
+            bool empty() const noexcept {return size_ == 0;}
+            size_type size() const noexcept {return size_;}
+            size_type capacity() const noexcept
+            { return words_.capacity() < 2 ? 0 : (words_.capacity() - 1) * 64 / width(); }
+            // 底层数组占用的字节数
+            size_type bytes() const noexcept {return words_.size() * sizeof(uint64_t);}
+
+            const uint64_t* data() const noexcept {return words_.data();}
+
+            void reserve(size_type n) {words_.reserve(words_needed(n));}
+            void shrink_to_fit() {words_.shrink_to_fit();}
+
+            value_type get(size_type i) const noexcept
+            {
+                MYSTL_DEBUG(i < size_);
+                const size_type bit = i * width();
+                const uint64_t* p = words_.data() + bit / 64;
+                const unsigned off = static_cast<unsigned>(bit % 64);
+                // 分两步左移，off == 0 时结果为 0 而不是未定义的移位 64 位
+                const uint64_t v = (p[0] >> off) | ((p[1] << 1) << (63 - off));
+                return v & max_value();
+            }
+
+            void set(size_type i,value_type value) noexcept
+            {
+                MYSTL_DEBUG(i < size_);
+                MYSTL_DEBUG((value & ~max_value()) == 0);
+                const unsigned w = width();
+                const uint64_t mask = max_value();
+                value &= mask;
+                const size_type bit = i * w;
+                uint64_t* p = words_.data() + bit / 64;
+                const unsigned off = static_cast<unsigned>(bit % 64);
+                p[0] = (p[0] & ~(mask << off)) | (value << off);
+                if(off + w > 64){
+                    const unsigned hi = off + w - 64;
+                    p[1] = (p[1] & ~bits::low_mask(hi)) | (value >> (w - hi));
+                }
+            }
+
+            value_type operator[](size_type i) const noexcept {return get(i);}
+            reference operator[](size_type i) noexcept {return reference(this,i);}
+            value_type at(size_type i) const
+            {
+                THROW_OUT_OF_RANGE_IF(!(i < size_),"packed_vector::at() subscript out of range");
+                return get(i);
+            }
+            value_type front() const {return get(0);}
+            value_type back() const {return get(size_ - 1);}
+
+            void push_back(value_type value)
+            {
+                const size_type need = words_needed(size_ + 1);
+                if(words_.size() < need){
+                    words_.resize(need,uint64_t(0));
+                }
+                ++size_;
+                set(size_ - 1,value);
+            }
+            void pop_back() noexcept
+            {
+                MYSTL_DEBUG(size_ > 0);
+                set(size_ - 1,0);       // 保持尾部的位为 0
+                --size_;
+            }
+
+            void resize(size_type n,value_type value = 0);
+            void clear() noexcept
+            {
+                words_.clear();
+                size_ = 0;
+            }
+
+            void swap(packed_vector& rhs) noexcept
+            {
+                hxqstl::swap(static_cast<width_base&>(*this),static_cast<width_base&>(rhs));
+                words_.swap(rhs.words_);
+                hxqstl::swap(size_,rhs.size_);
+            }
+
+            // 把 [pos,pos+n) 解码到 out，中间完整的 64 元素块走按位宽特化的快速路径
+            template<class U>
+            void unpack(size_type pos,size_type n,U* out) const;
+
+            // 解码全部元素，out 的原有内容被替换
+            template<class U>
+            void unpack(hxqstl::vector<U>& out) const
+            {
+                out.resize(size_);
+                unpack(0,size_,out.data());
+            }
+
+            // 用 [first,first+n) 替换全部内容，每个值必须能用 width() 位表示
+            template<class U>
+            void pack(const U* first,size_type n);
+
+            template<class U>
+            void pack(const hxqstl::vector<U>& in) {pack(in.data(),in.size());}
+
+        private:
+            size_type words_needed(size_type n) const noexcept
+            { return n == 0 ? 0 : bits::words_for(n * width()) + 1; }
+    };
+
+    /*****************************************************************************************/
+
+    template<unsigned Bits>
+    void packed_vector<Bits>::resize(size_type n,value_type value){
+        if(n <= size_){
+            // 清掉被截掉的元素，保持尾部的位为 0
+            for(size_type i = n;i < size_;++i) set(i,0);
+            size_ = n;
+            words_.resize(words_needed(n));
+            return;
+        }
+        words_.resize(words_needed(n),uint64_t(0));
+        const size_type old = size_;
+        size_ = n;
+        if(value != 0){
+            for(size_type i = old;i < n;++i) set(i,value);
+        }
+    }
+
+    template<unsigned Bits>
+    template<class U>
+    void packed_vector<Bits>::unpack(size_type pos,size_type n,U* out) const{
+        MYSTL_DEBUG(pos + n <= size_);
+        const size_type last = pos + n;
+        // 对齐到块边界前的部分逐个读取
+        for(;pos < last && pos % packed::block_values != 0;++pos){
+            *out++ = static_cast<U>(get(pos));
+        }
+        const unsigned w = width();
+        for(;pos + packed::block_values <= last;pos += packed::block_values){
+            // 第 k 块从第 k*w 个字开始
+            packed::unpack_block_dispatch(w,words_.data() + pos / packed::block_values * w,out,
+                                          std::make_index_sequence<64>());
+            out += packed::block_values;
+        }
+        for(;pos < last;++pos){
+            *out++ = static_cast<U>(get(pos));
+        }
+    }
+
+    template<unsigned Bits>
+    template<class U>
+    void packed_vector<Bits>::pack(const U* first,size_type n){
+        words_.assign(words_needed(n),uint64_t(0));
+        size_ = n;
+        const unsigned w = width();
+        size_type pos = 0;
+        for(;pos + packed::block_values <= n;pos += packed::block_values){
+            packed::pack_block_dispatch(w,first + pos,words_.data() + pos / packed::block_values * w,
+                                        std::make_index_sequence<64>());
+        }
+        for(;pos < n;++pos){
+            set(pos,static_cast<value_type>(first[pos]));
+        }
+    }
+
+    template<unsigned Bits>
+    bool operator==(const packed_vector<Bits>& lhs,const packed_vector<Bits>& rhs)
+    {
+        if(lhs.size() != rhs.size() || lhs.width() != rhs.width()) return false;
+        // 尾部的位始终为 0，可以直接按字比较
+        const size_t n = bits::words_for(lhs.size() * lhs.width());
+        return hxqstl::equal(lhs.data(),lhs.data() + n,rhs.data());
+    }
+
+    template<unsigned Bits>
+    bool operator!=(const packed_vector<Bits>& lhs,const packed_vector<Bits>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template<unsigned Bits>
+    void swap(packed_vector<Bits>& lhs,packed_vector<Bits>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+}
@@ -0,0 +1,344 @@
+#pragma once
+
+// priority_queue
+// 以 hxqstl::vector 为底层容器的 d 叉堆优先队列，默认 4 叉
+// 4 叉堆比二叉堆矮一半，下沉时四个孩子相邻存放，通常落在同一条 cache line 上
+// push_range 批量加入时若新元素较多，直接对整个容器做 O(n) 的 Floyd 建堆
+//
+// indexed_priority_queue
+// 元素用 [0,n) 的整数 id 标识，可以按 id 修改优先级(decrease-key)或删除，适合 Dijkstra、定时器
+
+#include <initializer_list>
+
+#include "algo.h"
+#include "functional.h"
+#include "iterator.h"
+#include "vector.h"
+#include "exceptdef.h"
+
+namespace hxqstl{
+    template<class T,class Container = hxqstl::vector<T>,
+             class Compare = hxqstl::less<typename Container::value_type>,size_t Arity = 4>
+    class priority_queue{
+        static_assert(Arity >= 2,"priority_queue arity must be at least 2");
+        public:
+            typedef Container container_type;
+            typedef Compare value_compare;
+            typedef typename Container::value_type value_type;
+            typedef typename Container::size_type size_type;
+            typedef typename Container::reference reference;
+            typedef typename Container::const_reference const_reference;
+
+            static constexpr size_t arity = Arity;
+
+        private:
+            container_type c_;
+            value_compare comp_;
+
+        public:
+            priority_queue() = default;
+
+            explicit priority_queue(const Compare& comp) : c_(),comp_(comp) {}
+
+            explicit priority_queue(const Container& c,const Compare& comp = Compare())
+            :c_(c),comp_(comp)
+            {
+                hxqstl::make_dary_heap<Arity>(c_.begin(),c_.end(),comp_);
+            }
+
+            explicit priority_queue(Container&& c,const Compare& comp = Compare())
+            :c_(hxqstl::move(c)),comp_(comp)
+            {
+                hxqstl::make_dary_heap<Arity>(c_.begin(),c_.end(),comp_);
+            }
+
+            template<class InputIter,typename std::enable_if<
+                hxqstl::is_input_iterator<InputIter>::value,int>::type = 0>
+            priority_queue(InputIter first,InputIter last,const Compare& comp = Compare())
+            :c_(first,last),comp_(comp)
+            {
+                hxqstl::make_dary_heap<Arity>(c_.begin(),c_.end(),comp_);
+            }
+
+            priority_queue(std::initializer_list<value_type> ilist,const Compare& comp = Compare())
+            :c_(ilist),comp_(comp)
+            {
+                hxqstl::make_dary_heap<Arity>(c_.begin(),c_.end(),comp_);
+            }
+
+        public:
+            const_reference top() const
+            {
+                MYSTL_DEBUG(!empty());
+                return c_.front();
+            }
+
+            bool empty() const noexcept {return c_.empty();}
+            size_type size() const noexcept {return c_.size();}
+
+            void reserve(size_type n) {c_.reserve(n);}
+
+            void push(const value_type& value)
+            {
+                c_.push_back(value);
+                hxqstl::push_dary_heap<Arity>(c_.begin(),c_.end(),comp_);
+            }
+            void push(value_type&& value)
+            {
+                c_.push_back(hxqstl::move(value));
+                hxqstl::push_dary_heap<Arity>(c_.begin(),c_.end(),comp_);
+            }
+
+            template<class... Args>
+            void emplace(Args&&... args)
+            {
+                c_.emplace_back(hxqstl::forward<Args>(args)...);
+                hxqstl::push_dary_heap<Arity>(c_.begin(),c_.end(),comp_);
+            }
+
+            // 批量加入：新元素不少于现有元素的一半时整体重新建堆，否则逐个上浮
+            template<class InputIter>
+            void push_range(InputIter first,InputIter last);
+
+            void pop()
+            {
+                MYSTL_DEBUG(!empty());
+                hxqstl::pop_dary_heap<Arity>(c_.begin(),c_.end(),comp_);
+                c_.pop_back();
+            }
+
+            // 取出堆顶并返回，省掉一次 top() 的拷贝
+            value_type pop_top()
+            {
+                MYSTL_DEBUG(!empty());
+                hxqstl::pop_dary_heap<Arity>(c_.begin(),c_.end(),comp_);
+                value_type result = hxqstl::move(c_.back());
+                c_.pop_back();
+                return result;
+            }
+
+            void clear() noexcept {c_.clear();}
+
+            // 底层容器按堆序排列，可以只读遍历
+            const container_type& container() const noexcept {return c_;}
+
+            void swap(priority_queue& rhs) noexcept
+            {
+                c_.swap(rhs.c_);
+                hxqstl::swap(comp_,rhs.comp_);
+            }
+    };
+
+    template<class T,class Container,class Compare,size_t Arity>
+    constexpr size_t priority_queue<T,Container,Compare,Arity>::arity;
+
+    template<class T,class Container,class Compare,size_t Arity>
+    template<class InputIter>
+    void priority_queue<T,Container,Compare,Arity>::push_range(InputIter first,InputIter last){
+        const size_type old_size = c_.size();
+        try{
+            for(;first != last;++first){
+                c_.push_back(*first);
+            }
+        }
+        catch(...){
+            // 去掉已追加但尚未入堆的元素，保持原有的堆序
+            while(c_.size() > old_size) c_.pop_back();
+            throw;
+        }
+        const size_type added = c_.size() - old_size;
+        if(added == 0) return;
+        if(added >= old_size / 2){
+            hxqstl::make_dary_heap<Arity>(c_.begin(),c_.end(),comp_);
+        }
+        else{
+            for(size_type i = old_size + 1;i <= c_.size();++i){
+                hxqstl::push_dary_heap<Arity>(c_.begin(),c_.begin() + i,comp_);
+            }
+        }
+    }
+
+    template<class T,class Container,class Compare,size_t Arity>
+    void swap(priority_queue<T,Container,Compare,Arity>& lhs,
+              priority_queue<T,Container,Compare,Arity>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    /*****************************************************************************************/
+
+    // 堆中只存放 id，优先级按 id 存放在另一个数组里，pos_ 记录每个 id 在堆中的位置
+    // comp 为 less 时堆顶是优先级最大的 id；做最短路时用 greater 得到小顶堆
+    template<class Priority,class Compare = hxqstl::less<Priority>,size_t Arity = 4>
+    class indexed_priority_queue{
+        static_assert(Arity >= 2,"indexed_priority_queue arity must be at least 2");
+        public:
+            typedef size_t id_type;
+            typedef Priority priority_type;
+            typedef size_t size_type;
+
+            static constexpr size_type npos = static_cast<size_type>(-1);
+
+        private:
+            hxqstl::vector<id_type> heap_;
+            hxqstl::vector<size_type> pos_;         // id 在 heap_ 中的位置，不在队列中为 npos
+            hxqstl::vector<Priority> prio_;         // 按 id 存放的优先级
+            Compare comp_;
+
+        public:
+            indexed_priority_queue() = default;
+
+            // 预先为 [0,n) 的 id 分配空间
+            explicit indexed_priority_queue(size_type n,const Compare& comp = Compare())
+            :heap_(),pos_(n,npos),prio_(n),comp_(comp)
+            {
+                heap_.reserve(n);
+            }
+
+        public:
+            bool empty() const noexcept {return heap_.empty();}
+            size_type size() const noexcept {return heap_.size();}
+
+            bool contains(id_type id) const noexcept {return id < pos_.size() && pos_[id] != npos;}
+
+            id_type top() const
+            {
+                MYSTL_DEBUG(!empty());
+                return heap_.front();
+            }
+            const Priority& top_priority() const
+            {
+                MYSTL_DEBUG(!empty());
+                return prio_[heap_.front()];
+            }
+            const Priority& priority(id_type id) const
+            {
+                MYSTL_DEBUG(contains(id));
+                return prio_[id];
+            }
+
+            // 加入一个 id，id 已在队列中时抛出异常
+            void push(id_type id,const Priority& p);
+
+            // 修改 id 的优先级，按方向上浮或下沉
+            void update(id_type id,const Priority& p);
+
+            // 不在队列中就加入，否则修改优先级
+            void push_or_update(id_type id,const Priority& p)
+            {
+                if(contains(id)) update(id,p);
+                else push(id,p);
+            }
+
+            // decrease-key：只在新优先级更靠近堆顶时修改，返回是否修改
+            bool improve(id_type id,const Priority& p)
+            {
+                if(contains(id) && !comp_(prio_[id],p)) return false;
+                push_or_update(id,p);
+                return true;
+            }
+
+            void pop()
+            {
+                MYSTL_DEBUG(!empty());
+                remove_at(0);
+            }
+
+            bool erase(id_type id)
+            {
+                if(!contains(id)) return false;
+                remove_at(pos_[id]);
+                return true;
+            }
+
+            void clear() noexcept
+            {
+                for(size_type i = 0;i < heap_.size();++i){
+                    pos_[heap_[i]] = npos;
+                }
+                heap_.clear();
+            }
+
+        private:
+            bool higher(id_type a,id_type b) const {return comp_(prio_[b],prio_[a]);}
+
+            void place(size_type i,id_type id) noexcept
+            {
+                heap_[i] = id;
+                pos_[id] = i;
+            }
+
+            void sift_up(size_type i);
+            void sift_down(size_type i);
+            void remove_at(size_type i);
+    };
+
+    template<class Priority,class Compare,size_t Arity>
+    constexpr size_t indexed_priority_queue<Priority,Compare,Arity>::npos;
+
+    template<class Priority,class Compare,size_t Arity>
+    void indexed_priority_queue<Priority,Compare,Arity>::push(id_type id,const Priority& p){
+        THROW_RUNTIME_ERROR_IF(contains(id),"indexed_priority_queue::push() id already present");
+        if(id >= pos_.size()){
+            pos_.resize(id + 1,npos);
+            prio_.resize(id + 1);
+        }
+        prio_[id] = p;
+        heap_.push_back(id);
+        pos_[id] = heap_.size() - 1;
+        sift_up(heap_.size() - 1);
+    }
+
+    template<class Priority,class Compare,size_t Arity>
+    void indexed_priority_queue<Priority,Compare,Arity>::update(id_type id,const Priority& p){
+        MYSTL_DEBUG(contains(id));
+        const bool up = comp_(prio_[id],p);
+        prio_[id] = p;
+        if(up) sift_up(pos_[id]);
+        else sift_down(pos_[id]);
+    }
+
+    template<class Priority,class Compare,size_t Arity>
+    void indexed_priority_queue<Priority,Compare,Arity>::sift_up(size_type i){
+        const id_type id = heap_[i];
+        while(i > 0){
+            const size_type parent = (i - 1) / Arity;
+            if(!higher(id,heap_[parent])) break;
+            place(i,heap_[parent]);
+            i = parent;
+        }
+        place(i,id);
+    }
+
+    template<class Priority,class Compare,size_t Arity>
+    void indexed_priority_queue<Priority,Compare,Arity>::sift_down(size_type i){
+        const id_type id = heap_[i];
+        const size_type len = heap_.size();
+        for(;;){
+            const size_type child = i * Arity + 1;
+            if(child >= len) break;
+            const size_type child_end = hxqstl::min(child + Arity,len);
+            size_type best = child;
+            for(size_type c = child + 1;c < child_end;++c){
+                if(higher(heap_[c],heap_[best])) best = c;
+            }
+            if(!higher(heap_[best],id)) break;
+            place(i,heap_[best]);
+            i = best;
+        }
+        place(i,id);
+    }
+
+    // 用最后一个 id 填补 i 处的空位，再按需要上浮或下沉
+    template<class Priority,class Compare,size_t Arity>
+    void indexed_priority_queue<Priority,Compare,Arity>::remove_at(size_type i){
+        const id_type removed = heap_[i];
+        const id_type last = heap_.back();
+        heap_.pop_back();
+        pos_[removed] = npos;
+        if(i == heap_.size()) return;
+        place(i,last);
+        if(i > 0 && higher(last,heap_[(i - 1) / Arity])) sift_up(i);
+        else sift_down(i);
+    }
+}
@@ -0,0 +1,781 @@
+#pragma once
+
+// ranges
+// 惰性的区间视图：transform / filter / take / drop / zip / chunk / enumerate
+// 视图只保存底层区间和参数，解引用迭代器时才计算元素，串起来的多个视图只遍历一次底层数据，
+// 中间不产生临时容器：
+//     auto out = hxqstl::to_vector(data | views::filter(pred) | views::transform(f) | views::take(10));
+// 左值容器按引用保存，右值容器和视图移动进新的视图里；视图本身不要在迭代过程中被移动
+// C++14 的范围 for 要求 begin/end 类型相同，所以所有视图的 end() 都返回同类迭代器
+// to_vector 在区间大小已知时(有 size() 或随机访问迭代器)先一次 reserve 准确的大小
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "iterator.h"
+#include "util.h"
+#include "vector.h"
+#include "exceptdef.h"
+
+namespace hxqstl{
+    namespace ranges{
+        template<class R>
+        using iterator_t = decltype(std::declval<R&>().begin());
+
+        template<class R>
+        using range_reference_t = typename iterator_traits<iterator_t<R>>::reference;
+
+        // 指针的 iterator_traits 对 const T* 给出 const T，这里去掉 cv 限定
+        template<class R>
+        using range_value_t = typename std::remove_cv<
+            typename iterator_traits<iterator_t<R>>::value_type>::type;
+
+        template<class R>
+        using range_category_t = typename iterator_traits<iterator_t<R>>::iterator_category;
+
+        // 所有视图的基类，用来区分视图和容器
+        struct view_base {};
+
+        template<class T>
+        struct is_view : std::is_base_of<view_base,typename std::decay<T>::type> {};
+
+        template<class R,class = void>
+        struct has_size : std::false_type {};
+
+        template<class R>
+        struct has_size<R,decltype((void)std::declval<R&>().size())> : std::true_type {};
+
+        // 不遍历就能知道大小的区间
+        template<class R>
+        struct is_sized : std::integral_constant<bool,has_size<R>::value ||
+                                                 is_random_access_iterator<iterator_t<R>>::value> {};
+
+        // hxqstl 的 m_bool_constant 不是 std::integral_constant，标签分派时转换一下
+        template<class I>
+        using random_access_t = std::integral_constant<bool,is_random_access_iterator<I>::value>;
+
+        template<class R>
+        size_t size_of_dispatch(R& r,std::true_type) {return static_cast<size_t>(r.size());}
+
+        template<class R>
+        size_t size_of_dispatch(R& r,std::false_type) {return static_cast<size_t>(r.end() - r.begin());}
+
+        template<class R>
+        size_t size_of(R& r) {return size_of_dispatch(r,has_size<R>{});}
+
+        // 迭代器类别不超过 Cap
+        template<class Cat,class Cap>
+        using clamp_category_t = typename std::conditional<std::is_convertible<Cat,Cap>::value,Cap,Cat>::type;
+
+        // end() 只在随机访问时能定位到真实位置，其余情况下不能从 end() 往回走，最多是前向迭代器
+        template<class I>
+        using end_category_t = typename std::conditional<is_random_access_iterator<I>::value,
+            typename iterator_traits<I>::iterator_category,
+            clamp_category_t<typename iterator_traits<I>::iterator_category,forward_iterator_tag>>::type;
+
+        // 由 ++、--、+=、== 和两个迭代器相减推出其余运算
+        template<class D,class Diff>
+        struct iterator_facade
+        {
+            D& self() noexcept {return static_cast<D&>(*this);}
+            const D& self() const noexcept {return static_cast<const D&>(*this);}
+
+            D operator++(int) {D tmp = self(); ++self(); return tmp;}
+            D operator--(int) {D tmp = self(); --self(); return tmp;}
+            D& operator-=(Diff n) {return self() += -n;}
+            decltype(auto) operator[](Diff n) const {return *(self() + n);}
+
+            friend D operator+(D it,Diff n) {return it += n;}
+            friend D operator+(Diff n,D it) {return it += n;}
+            friend D operator-(D it,Diff n) {return it -= n;}
+            friend bool operator!=(const D& a,const D& b) {return !(a == b);}
+            friend bool operator<(const D& a,const D& b) {return (a - b) < 0;}
+            friend bool operator>(const D& a,const D& b) {return b < a;}
+            friend bool operator<=(const D& a,const D& b) {return !(b < a);}
+            friend bool operator>=(const D& a,const D& b) {return !(a < b);}
+        };
+
+        template<class... Ts>
+        void swallow(Ts&&...) noexcept {}
+    }
+
+    /*****************************************************************************************/
+    // 视图的存放方式
+
+    // 引用一个左值容器
+    template<class R>
+    class ref_view : public ranges::view_base{
+        private:
+            R* r_;
+        public:
+            explicit ref_view(R& r) noexcept : r_(hxqstl::address_of(r)) {}
+
+            ranges::iterator_t<R> begin() const {return r_->begin();}
+            ranges::iterator_t<R> end() const {return r_->end();}
+
+            template<class B = R,typename std::enable_if<ranges::is_sized<B>::value,int>::type = 0>
+            size_t size() const {return ranges::size_of(*r_);}
+    };
+
+    // 接管一个右值容器
+    template<class R>
+    class owning_view : public ranges::view_base{
+        private:
+            R r_;
+        public:
+            explicit owning_view(R&& r) : r_(hxqstl::move(r)) {}
+
+            ranges::iterator_t<R> begin() {return r_.begin();}
+            ranges::iterator_t<R> end() {return r_.end();}
+
+            template<class B = R,typename std::enable_if<ranges::is_sized<B>::value,int>::type = 0>
+            size_t size() {return ranges::size_of(r_);}
+    };
+
+    // 一对迭代器组成的区间，chunk 的元素类型
+    template<class Iter>
+    class subrange : public ranges::view_base{
+        private:
+            Iter first_;
+            Iter last_;
+        public:
+            subrange(Iter first,Iter last) : first_(first),last_(last) {}
+
+            Iter begin() const {return first_;}
+            Iter end() const {return last_;}
+            bool empty() const {return first_ == last_;}
+
+            template<class I = Iter,typename std::enable_if<
+                is_random_access_iterator<I>::value,int>::type = 0>
+            size_t size() const {return static_cast<size_t>(last_ - first_);}
+    };
+
+    namespace views{
+        template<class R>
+        R all_dispatch(R&& r,std::true_type) {return hxqstl::forward<R>(r);}
+
+        template<class R>
+        ref_view<R> all_dispatch(R& r,std::false_type) {return ref_view<R>(r);}
+
+        template<class R,typename std::enable_if<!std::is_lvalue_reference<R>::value,int>::type = 0>
+        owning_view<R> all_dispatch(R&& r,std::false_type) {return owning_view<R>(hxqstl::move(r));}
+
+        // 视图原样复制或移动，左值容器包装成 ref_view，右值容器包装成 owning_view
+        template<class R>
+        auto all(R&& r)
+        {
+            return all_dispatch(hxqstl::forward<R>(r),ranges::is_view<R>{});
+        }
+    }
+
+    namespace ranges{
+        template<class R>
+        using all_t = typename std::decay<decltype(views::all(std::declval<R>()))>::type;
+    }
+
+    /*****************************************************************************************/
+    // transform_view
+    // 解引用时对底层元素调用 f，迭代器类别与底层相同
+
+    template<class V,class F>
+    class transform_view : public ranges::view_base{
+        private:
+            typedef ranges::iterator_t<V> base_iterator;
+
+            V base_;
+            F fn_;
+
+        public:
+            class iterator
+                : public ranges::iterator_facade<iterator,typename iterator_traits<base_iterator>::difference_type>
+            {
+                private:
+                    base_iterator it_;
+                    F* fn_;
+                public:
+                    typedef typename iterator_traits<base_iterator>::iterator_category iterator_category;
+                    typedef decltype(std::declval<F&>()(*std::declval<base_iterator&>())) reference;
+                    typedef typename std::decay<reference>::type value_type;
+                    typedef void pointer;
+                    typedef typename iterator_traits<base_iterator>::difference_type difference_type;
+
+                    iterator() : it_(),fn_(nullptr) {}
+                    iterator(base_iterator it,F* fn) : it_(it),fn_(fn) {}
+
+                    base_iterator base() const {return it_;}
+
+                    reference operator*() const {return (*fn_)(*it_);}
+                    iterator& operator++() {++it_; return *this;}
+                    iterator& operator--() {--it_; return *this;}
+                    iterator& operator+=(difference_type n) {it_ += n; return *this;}
+                    using ranges::iterator_facade<iterator,difference_type>::operator++;
+                    using ranges::iterator_facade<iterator,difference_type>::operator--;
+
+                    friend bool operator==(const iterator& a,const iterator& b) {return a.it_ == b.it_;}
+                    friend difference_type operator-(const iterator& a,const iterator& b) {return a.it_ - b.it_;}
+            };
+
+            transform_view(V base,F fn) : base_(hxqstl::move(base)),fn_(hxqstl::move(fn)) {}
+
+            iterator begin() {return iterator(base_.begin(),hxqstl::address_of(fn_));}
+            iterator end() {return iterator(base_.end(),hxqstl::address_of(fn_));}
+
+            template<class B = V,typename std::enable_if<ranges::is_sized<B>::value,int>::type = 0>
+            size_t size() {return ranges::size_of(base_);}
+    };
+
+    /*****************************************************************************************/
+    // filter_view
+    // 只保留满足 pred 的元素，最多是前向迭代器；begin() 每次调用都会向前查找第一个元素
+
+    template<class V,class Pred>
+    class filter_view : public ranges::view_base{
+        private:
+            typedef ranges::iterator_t<V> base_iterator;
+
+            V base_;
+            Pred pred_;
+
+        public:
+            class iterator
+                : public ranges::iterator_facade<iterator,typename iterator_traits<base_iterator>::difference_type>
+            {
+                private:
+                    base_iterator it_;
+                    base_iterator last_;
+                    Pred* pred_;
+
+                    void satisfy()
+                    {
+                        while(it_ != last_ && !(*pred_)(*it_)) ++it_;
+                    }
+                public:
+                    typedef ranges::clamp_category_t<
+                        typename iterator_traits<base_iterator>::iterator_category,forward_iterator_tag> iterator_category;
+                    typedef typename iterator_traits<base_iterator>::reference reference;
+                    typedef typename iterator_traits<base_iterator>::value_type value_type;
+                    typedef typename iterator_traits<base_iterator>::pointer pointer;
+                    typedef typename iterator_traits<base_iterator>::difference_type difference_type;
+
+                    iterator() : it_(),last_(),pred_(nullptr) {}
+                    iterator(base_iterator it,base_iterator last,Pred* pred)
+                    : it_(it),last_(last),pred_(pred)
+                    {
+                        satisfy();
+                    }
+
+                    base_iterator base() const {return it_;}
+
+                    reference operator*() const {return *it_;}
+                    iterator& operator++() {++it_; satisfy(); return *this;}
+                    using ranges::iterator_facade<iterator,difference_type>::operator++;
+
+                    friend bool operator==(const iterator& a,const iterator& b) {return a.it_ == b.it_;}
+            };
+
+            filter_view(V base,Pred pred) : base_(hxqstl::move(base)),pred_(hxqstl::move(pred)) {}
+
+            iterator begin() {return iterator(base_.begin(),base_.end(),hxqstl::address_of(pred_));}
+            iterator end() {return iterator(base_.end(),base_.end(),hxqstl::address_of(pred_));}
+    };
+
+    /*****************************************************************************************/
+    // take_view
+    // 最多取前 n 个元素；迭代器记录剩余个数，位置相同或剩余个数相同即相等
+    // 随机访问时 end() 直接定位到 min(n,size) 处，迭代器相减得到准确距离
+    // 其余情况下 end() 只是一个哨兵，迭代器降为前向迭代器
+
+    template<class V>
+    class take_view : public ranges::view_base{
+        private:
+            typedef ranges::iterator_t<V> base_iterator;
+
+            V base_;
+            size_t count_;
+
+        public:
+            class iterator
+                : public ranges::iterator_facade<iterator,typename iterator_traits<base_iterator>::difference_type>
+            {
+                private:
+                    base_iterator it_;
+                    typename iterator_traits<base_iterator>::difference_type left_;
+                public:
+                    typedef ranges::end_category_t<base_iterator> iterator_category;
+                    typedef typename iterator_traits<base_iterator>::reference reference;
+                    typedef typename iterator_traits<base_iterator>::value_type value_type;
+                    typedef typename iterator_traits<base_iterator>::pointer pointer;
+                    typedef typename iterator_traits<base_iterator>::difference_type difference_type;
+
+                    iterator() : it_(),left_(0) {}
+                    iterator(base_iterator it,difference_type left) : it_(it),left_(left) {}
+
+                    base_iterator base() const {return it_;}
+
+                    reference operator*() const {return *it_;}
+                    iterator& operator++() {++it_; --left_; return *this;}
+                    iterator& operator--() {--it_; ++left_; return *this;}
+                    iterator& operator+=(difference_type n) {it_ += n; left_ -= n; return *this;}
+                    using ranges::iterator_facade<iterator,difference_type>::operator++;
+                    using ranges::iterator_facade<iterator,difference_type>::operator--;
+
+                    friend bool operator==(const iterator& a,const iterator& b)
+                    { return a.left_ == b.left_ || a.it_ == b.it_; }
+                    friend difference_type operator-(const iterator& a,const iterator& b)
+                    { return b.left_ - a.left_; }
+            };
+
+            take_view(V base,size_t count) : base_(hxqstl::move(base)),count_(count) {}
+
+            iterator begin() {return iterator(base_.begin(),static_cast<difference_type>(count_));}
+            iterator end() {return end_dispatch(ranges::random_access_t<base_iterator>{});}
+
+            template<class B = V,typename std::enable_if<ranges::is_sized<B>::value,int>::type = 0>
+            size_t size()
+            {
+                const size_t n = ranges::size_of(base_);
+                return n < count_ ? n : count_;
+            }
+
+        private:
+            typedef typename iterator_traits<base_iterator>::difference_type difference_type;
+
+            iterator end_dispatch(std::true_type)
+            {
+                const difference_type n = base_.end() - base_.begin();
+                const difference_type m = n < static_cast<difference_type>(count_) ? n : static_cast<difference_type>(count_);
+                return iterator(base_.begin() + m,static_cast<difference_type>(count_) - m);
+            }
+            iterator end_dispatch(std::false_type)
+            {
+                return iterator(base_.end(),0);
+            }
+    };
+
+    /*****************************************************************************************/
+    // drop_view
+    // 跳过前 n 个元素，迭代器就是底层迭代器
+
+    template<class V>
+    class drop_view : public ranges::view_base{
+        private:
+            typedef ranges::iterator_t<V> base_iterator;
+
+            V base_;
+            size_t count_;
+
+        public:
+            typedef base_iterator iterator;
+
+            drop_view(V base,size_t count) : base_(hxqstl::move(base)),count_(count) {}
+
+            iterator begin() {return begin_dispatch(ranges::random_access_t<base_iterator>{});}
+            iterator end() {return base_.end();}
+
+            template<class B = V,typename std::enable_if<ranges::is_sized<B>::value,int>::type = 0>
+            size_t size()
+            {
+                const size_t n = ranges::size_of(base_);
+                return n > count_ ? n - count_ : 0;
+            }
+
+        private:
+            iterator begin_dispatch(std::true_type)
+            {
+                const auto n = base_.end() - base_.begin();
+                return base_.begin() + (static_cast<size_t>(n) < count_ ? n : static_cast<decltype(n)>(count_));
+            }
+            iterator begin_dispatch(std::false_type)
+            {
+                iterator it = base_.begin();
+                const iterator last = base_.end();
+                for(size_t i = 0;i < count_ && it != last;++i) ++it;
+                return it;
+            }
+    };
+
+    /*****************************************************************************************/
+    // zip_view
+    // 同时遍历多个区间，元素是各区间引用组成的 std::tuple，长度取最短的区间
+    // 全部随机访问时迭代器也是随机访问，否则取各区间中最弱的一个，最多是前向迭代器
+
+    template<class... Vs>
+    class zip_view : public ranges::view_base{
+        static_assert(sizeof...(Vs) > 0,"zip_view needs at least one range");
+        private:
+            typedef std::tuple<ranges::iterator_t<Vs>...> iterators;
+            typedef std::index_sequence_for<Vs...> indices;
+            typedef std::integral_constant<bool,std::is_same<
+                typename std::common_type<ranges::range_category_t<Vs>...>::type,
+                random_access_iterator_tag>::value> all_random_access;
+
+            std::tuple<Vs...> bases_;
+
+        public:
+            class iterator
+                : public ranges::iterator_facade<iterator,ptrdiff_t>
+            {
+                private:
+                    iterators its_;
+
+                    template<size_t... I>
+                    void next(std::index_sequence<I...>) {ranges::swallow(++std::get<I>(its_)...);}
+                    template<size_t... I>
+                    void prev(std::index_sequence<I...>) {ranges::swallow(--std::get<I>(its_)...);}
+                    template<size_t... I>
+                    void advance(ptrdiff_t n,std::index_sequence<I...>) {ranges::swallow(std::get<I>(its_) += n...);}
+                    template<size_t... I>
+                    auto deref(std::index_sequence<I...>) const
+                    { return std::tuple<ranges::range_reference_t<Vs>...>(*std::get<I>(its_)...); }
+                    // 任一分量到达末尾即视为相等，长度取最短的区间
+                    template<size_t... I>
+                    static bool any_equal(const iterators& a,const iterators& b,std::index_sequence<I...>)
+                    {
+                        const bool eq[] = {false,(std::get<I>(a) == std::get<I>(b))...};
+                        for(bool e : eq){
+                            if(e) return true;
+                        }
+                        return false;
+                    }
+                public:
+                    // 不全是随机访问时 end() 只是各区间 end() 的组合，从它往回退不会停在最短长度处，最多是前向迭代器
+                    typedef typename std::conditional<all_random_access::value,random_access_iterator_tag,
+                        ranges::clamp_category_t<typename std::common_type<ranges::range_category_t<Vs>...>::type,
+                                                 forward_iterator_tag>>::type iterator_category;
+                    typedef std::tuple<ranges::range_reference_t<Vs>...> reference;
+                    typedef std::tuple<ranges::range_value_t<Vs>...> value_type;
+                    typedef void pointer;
+                    typedef ptrdiff_t difference_type;
+
+                    iterator() : its_() {}
+                    explicit iterator(iterators its) : its_(hxqstl::move(its)) {}
+
+                    reference operator*() const {return deref(indices{});}
+                    iterator& operator++() {next(indices{}); return *this;}
+                    iterator& operator--() {prev(indices{}); return *this;}
+                    iterator& operator+=(difference_type n) {advance(n,indices{}); return *this;}
+                    using ranges::iterator_facade<iterator,difference_type>::operator++;
+                    using ranges::iterator_facade<iterator,difference_type>::operator--;
+
+                    friend bool operator==(const iterator& a,const iterator& b)
+                    { return any_equal(a.its_,b.its_,indices{}); }
+                    friend difference_type operator-(const iterator& a,const iterator& b)
+                    { return static_cast<difference_type>(std::get<0>(a.its_) - std::get<0>(b.its_)); }
+            };
+
+            explicit zip_view(Vs... bases) : bases_(hxqstl::move(bases)...) {}
+
+            iterator begin() {return iterator(begins(indices{}));}
+            iterator end() {return end_dispatch(all_random_access{});}
+
+            template<class B = all_random_access,typename std::enable_if<B::value,int>::type = 0>
+            size_t size() {return min_size(indices{});}
+
+        private:
+            template<size_t... I>
+            iterators begins(std::index_sequence<I...>) {return iterators(std::get<I>(bases_).begin()...);}
+            template<size_t... I>
+            iterators ends(std::index_sequence<I...>) {return iterators(std::get<I>(bases_).end()...);}
+
+            template<size_t... I>
+            size_t min_size(std::index_sequence<I...>)
+            {
+                const size_t sizes[] = {static_cast<size_t>(std::get<I>(bases_).end() - std::get<I>(bases_).begin())...};
+                size_t n = sizes[0];
+                for(size_t s : sizes) n = s < n ? s : n;
+                return n;
+            }
+
+            // 全部随机访问时各分量都停在最短长度处，迭代器相减得到准确距离
+            iterator end_dispatch(std::true_type)
+            {
+                return begin() + static_cast<ptrdiff_t>(min_size(indices{}));
+            }
+            iterator end_dispatch(std::false_type)
+            {
+                return iterator(ends(indices{}));
+            }
+    };
+
+    /*****************************************************************************************/
+    // chunk_view
+    // 每 n 个相邻元素组成一个 subrange，最后一块可能不足 n 个；最多是前向迭代器
+
+    template<class V>
+    class chunk_view : public ranges::view_base{
+        private:
+            typedef ranges::iterator_t<V> base_iterator;
+
+            V base_;
+            size_t n_;
+
+        public:
+            class iterator
+                : public ranges::iterator_facade<iterator,typename iterator_traits<base_iterator>::difference_type>
+            {
+                private:
+                    base_iterator it_;
+                    base_iterator last_;
+                    size_t n_;
+
+                    base_iterator chunk_end(std::true_type) const
+                    {
+                        const auto rest = last_ - it_;
+                        return static_cast<size_t>(rest) < n_ ? last_ : it_ + static_cast<decltype(rest)>(n_);
+                    }
+                    base_iterator chunk_end(std::false_type) const
+                    {
+                        base_iterator e = it_;
+                        for(size_t i = 0;i < n_ && e != last_;++i) ++e;
+                        return e;
+                    }
+                    base_iterator chunk_end() const
+                    {
+                        return chunk_end(ranges::random_access_t<base_iterator>{});
+                    }
+                public:
+                    typedef forward_iterator_tag iterator_category;
+                    typedef subrange<base_iterator> reference;
+                    typedef subrange<base_iterator> value_type;
+                    typedef void pointer;
+                    typedef typename iterator_traits<base_iterator>::difference_type difference_type;
+
+                    iterator() : it_(),last_(),n_(1) {}
+                    iterator(base_iterator it,base_iterator last,size_t n) : it_(it),last_(last),n_(n) {}
+
+                    reference operator*() const {return reference(it_,chunk_end());}
+                    iterator& operator++() {it_ = chunk_end(); return *this;}
+                    using ranges::iterator_facade<iterator,difference_type>::operator++;
+
+                    friend bool operator==(const iterator& a,const iterator& b) {return a.it_ == b.it_;}
+            };
+
+            chunk_view(V base,size_t n) : base_(hxqstl::move(base)),n_(n)
+            {
+                MYSTL_DEBUG(n > 0);
+            }
+
+            iterator begin() {return iterator(base_.begin(),base_.end(),n_);}
+            iterator end() {return iterator(base_.end(),base_.end(),n_);}
+
+            template<class B = V,typename std::enable_if<ranges::is_sized<B>::value,int>::type = 0>
+            size_t size() {return (ranges::size_of(base_) + n_ - 1) / n_;}
+    };
+
+    /*****************************************************************************************/
+    // enumerate_view
+    // 元素是 hxqstl::pair<size_t,底层引用>，first 为下标
+    // end() 只在随机访问时带有正确的下标，其余情况下迭代器降为前向迭代器
+
+    template<class V>
+    class enumerate_view : public ranges::view_base{
+        private:
+            typedef ranges::iterator_t<V> base_iterator;
+
+            V base_;
+
+        public:
+            class iterator
+                : public ranges::iterator_facade<iterator,typename iterator_traits<base_iterator>::difference_type>
+            {
+                private:
+                    base_iterator it_;
+                    size_t index_;
+                public:
+                    typedef ranges::end_category_t<base_iterator> iterator_category;
+                    typedef hxqstl::pair<size_t,typename iterator_traits<base_iterator>::reference> reference;
+                    typedef hxqstl::pair<size_t,typename iterator_traits<base_iterator>::value_type> value_type;
+                    typedef void pointer;
+                    typedef typename iterator_traits<base_iterator>::difference_type difference_type;
+
+                    iterator() : it_(),index_(0) {}
+                    iterator(base_iterator it,size_t index) : it_(it),index_(index) {}
+
+                    base_iterator base() const {return it_;}
+                    size_t index() const {return index_;}
+
+                    reference operator*() const {return reference(index_,*it_);}
+                    iterator& operator++() {++it_; ++index_; return *this;}
+                    iterator& operator--() {--it_; --index_; return *this;}
+                    iterator& operator+=(difference_type n) {it_ += n; index_ += n; return *this;}
+                    using ranges::iterator_facade<iterator,difference_type>::operator++;
+                    using ranges::iterator_facade<iterator,difference_type>::operator--;
+
+                    friend bool operator==(const iterator& a,const iterator& b) {return a.it_ == b.it_;}
+                    friend difference_type operator-(const iterator& a,const iterator& b) {return a.it_ - b.it_;}
+            };
+
+            explicit enumerate_view(V base) : base_(hxqstl::move(base)) {}
+
+            iterator begin() {return iterator(base_.begin(),0);}
+            iterator end() {return end_dispatch(ranges::random_access_t<base_iterator>{});}
+
+            template<class B = V,typename std::enable_if<ranges::is_sized<B>::value,int>::type = 0>
+            size_t size() {return ranges::size_of(base_);}
+
+        private:
+            // 随机访问时 end 的下标也要正确，迭代器才能做 end - 1 之类的运算
+            iterator end_dispatch(std::true_type)
+            {
+                return iterator(base_.end(),static_cast<size_t>(base_.end() - base_.begin()));
+            }
+            iterator end_dispatch(std::false_type)
+            {
+                return iterator(base_.end(),0);
+            }
+    };
+
+    /*****************************************************************************************/
+    // 适配器：views::transform(r,f) 直接构造视图，views::transform(f) 返回可以用 | 连接的闭包
+
+    namespace views{
+        template<class Fn>
+        struct closure
+        {
+            Fn fn;
+
+            template<class R>
+            auto operator()(R&& r) const {return fn(hxqstl::forward<R>(r));}
+        };
+
+        template<class Fn>
+        closure<Fn> make_closure(Fn fn) {return closure<Fn>{hxqstl::move(fn)};}
+
+        template<class R,class Fn>
+        auto operator|(R&& r,const closure<Fn>& c) {return c(hxqstl::forward<R>(r));}
+
+        template<class R,class F>
+        transform_view<ranges::all_t<R>,F> transform(R&& r,F f)
+        {
+            return transform_view<ranges::all_t<R>,F>(views::all(hxqstl::forward<R>(r)),hxqstl::move(f));
+        }
+
+        template<class R,class Pred>
+        filter_view<ranges::all_t<R>,Pred> filter(R&& r,Pred pred)
+        {
+            return filter_view<ranges::all_t<R>,Pred>(views::all(hxqstl::forward<R>(r)),hxqstl::move(pred));
+        }
+
+        template<class R>
+        take_view<ranges::all_t<R>> take(R&& r,size_t n)
+        {
+            return take_view<ranges::all_t<R>>(views::all(hxqstl::forward<R>(r)),n);
+        }
+
+        template<class R>
+        drop_view<ranges::all_t<R>> drop(R&& r,size_t n)
+        {
+            return drop_view<ranges::all_t<R>>(views::all(hxqstl::forward<R>(r)),n);
+        }
+
+        template<class R>
+        chunk_view<ranges::all_t<R>> chunk(R&& r,size_t n)
+        {
+            return chunk_view<ranges::all_t<R>>(views::all(hxqstl::forward<R>(r)),n);
+        }
+
+        template<class R>
+        enumerate_view<ranges::all_t<R>> enumerate(R&& r)
+        {
+            return enumerate_view<ranges::all_t<R>>(views::all(hxqstl::forward<R>(r)));
+        }
+
+        template<class... Rs>
+        zip_view<ranges::all_t<Rs>...> zip(Rs&&... rs)
+        {
+            return zip_view<ranges::all_t<Rs>...>(views::all(hxqstl::forward<Rs>(rs))...);
+        }
+
+        // 以下为只带参数的版本，返回闭包
+
+        template<class F>
+        struct transform_fn
+        {
+            F f;
+            template<class R>
+            auto operator()(R&& r) const {return views::transform(hxqstl::forward<R>(r),f);}
+        };
+
+        template<class Pred>
+        struct filter_fn
+        {
+            Pred pred;
+            template<class R>
+            auto operator()(R&& r) const {return views::filter(hxqstl::forward<R>(r),pred);}
+        };
+
+        struct take_fn
+        {
+            size_t n;
+            template<class R>
+            auto operator()(R&& r) const {return views::take(hxqstl::forward<R>(r),n);}
+        };
+
+        struct drop_fn
+        {
+            size_t n;
+            template<class R>
+            auto operator()(R&& r) const {return views::drop(hxqstl::forward<R>(r),n);}
+        };
+
+        struct chunk_fn
+        {
+            size_t n;
+            template<class R>
+            auto operator()(R&& r) const {return views::chunk(hxqstl::forward<R>(r),n);}
+        };
+
+        struct enumerate_fn
+        {
+            template<class R>
+            auto operator()(R&& r) const {return views::enumerate(hxqstl::forward<R>(r));}
+        };
+
+        template<class F>
+        closure<transform_fn<F>> transform(F f) {return make_closure(transform_fn<F>{hxqstl::move(f)});}
+
+        template<class Pred>
+        closure<filter_fn<Pred>> filter(Pred pred) {return make_closure(filter_fn<Pred>{hxqstl::move(pred)});}
+
+        inline closure<take_fn> take(size_t n) {return make_closure(take_fn{n});}
+        inline closure<drop_fn> drop(size_t n) {return make_closure(drop_fn{n});}
+        inline closure<chunk_fn> chunk(size_t n) {return make_closure(chunk_fn{n});}
+        inline closure<enumerate_fn> enumerate() {return make_closure(enumerate_fn{});}
+    }
+
+    /*****************************************************************************************/
+    // to_vector
+    // 把区间物化为 hxqstl::vector，元素类型取迭代器的 value_type
+    // 大小已知时先 reserve，整个流水线只遍历一遍、只分配一次
+
+    namespace ranges{
+        template<class R,class Vec>
+        void reserve_for(R& r,Vec& out,std::true_type) {out.reserve(ranges::size_of(r));}
+
+        template<class R,class Vec>
+        void reserve_for(R&,Vec&,std::false_type) {}
+    }
+
+    template<class R>
+    hxqstl::vector<ranges::range_value_t<R>> to_vector(R&& r)
+    {
+        hxqstl::vector<ranges::range_value_t<R>> out;
+        ranges::reserve_for(r,out,ranges::is_sized<typename std::remove_reference<R>::type>{});
+        for(auto it = r.begin(),last = r.end();it != last;++it){
+            out.emplace_back(*it);
+        }
+        return out;
+    }
+
+    namespace views{
+        struct to_vector_fn
+        {
+            template<class R>
+            auto operator()(R&& r) const {return hxqstl::to_vector(hxqstl::forward<R>(r));}
+        };
+    }
+
+    inline views::closure<views::to_vector_fn> to_vector() {return views::make_closure(views::to_vector_fn{});}
+}
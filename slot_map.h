@@ -0,0 +1,242 @@
+#pragma once
+
+// slot_map
+// 用句柄访问元素的容器，插入、删除、查找都是 O(1)
+// 元素紧密地存放在一个 hxqstl::vector 中，遍历是连续内存；删除时用最后一个元素填补空位
+// 句柄由 32 位槽位下标和 32 位代数组成，槽位每被释放一次代数加一，过期的句柄用一次比较即可识别
+// 元素在 vector 中的位置会变化，不要长期保存元素的指针或迭代器，只保存句柄
+
+#include <cstdint>
+
+#include "util.h"
+#include "vector.h"
+#include "exceptdef.h"
+
+namespace hxqstl{
+    struct slot_handle
+    {
+        uint32_t index;
+        uint32_t generation;
+
+        bool operator==(const slot_handle& rhs) const noexcept
+        { return index == rhs.index && generation == rhs.generation; }
+        bool operator!=(const slot_handle& rhs) const noexcept {return !(*this == rhs);}
+
+        // 打包成一个 64 位整数，便于存进其他结构或做哈希
+        uint64_t to_u64() const noexcept {return (uint64_t(generation) << 32) | index;}
+        static slot_handle from_u64(uint64_t v) noexcept
+        { return slot_handle{static_cast<uint32_t>(v),static_cast<uint32_t>(v >> 32)}; }
+    };
+
+    template<class T>
+    class slot_map{
+        public:
+            typedef T value_type;
+            typedef slot_handle key_type;
+            typedef size_t size_type;
+            typedef T& reference;
+            typedef const T& const_reference;
+            typedef T* iterator;
+            typedef const T* const_iterator;
+
+        private:
+            // 槽位：存活时 index 指向 values_ 中的位置，空闲时 index 是下一个空闲槽位
+            struct slot
+            {
+                uint32_t index;
+                uint32_t generation;
+            };
+
+            static constexpr uint32_t npos = static_cast<uint32_t>(-1);
+
+            hxqstl::vector<slot> slots_;
+            hxqstl::vector<T> values_;
+            hxqstl::vector<uint32_t> slot_of_;     // values_[i] 属于哪个槽位
+            uint32_t free_head_;
+
+        public:
+            slot_map() : slots_(),values_(),slot_of_(),free_head_(npos) {}
+
+            slot_map(const slot_map&) = default;
+            slot_map(slot_map&& rhs) noexcept
+            :slots_(hxqstl::move(rhs.slots_)),values_(hxqstl::move(rhs.values_)),
+             slot_of_(hxqstl::move(rhs.slot_of_)),free_head_(rhs.free_head_)
+            {
+                rhs.free_head_ = npos;
+            }
+            slot_map& operator=(const slot_map&) = default;
+            slot_map& operator=(slot_map&& rhs) noexcept
+            {
+                slot_map tmp(hxqstl::move(rhs));
+                swap(tmp);
+                return *this;
+            }
+            ~slot_map() = default;
+
+        public:
+            iterator begin() noexcept {return values_.begin();}
+            const_iterator begin() const noexcept {return values_.begin();}
+            iterator end() noexcept {return values_.end();}
+            const_iterator end() const noexcept {return values_.end();}
+
+            bool empty() const noexcept {return values_.empty();}
+            size_type size() const noexcept {return values_.size();}
+            size_type capacity() const noexcept {return values_.capacity();}
+
+            void reserve(size_type n)
+            {
+                THROW_LENGTH_ERROR_IF(n >= npos,"slot_map<T> too many elements");
+                slots_.reserve(n);
+                values_.reserve(n);
+                slot_of_.reserve(n);
+            }
+
+            // 紧密存放的元素数组，可以直接交给批量处理的代码
+            T* data() noexcept {return values_.data();}
+            const T* data() const noexcept {return values_.data();}
+
+            template<class... Args>
+            key_type emplace(Args&&... args);
+            key_type insert(const T& value) {return emplace(value);}
+            key_type insert(T&& value) {return emplace(hxqstl::move(value));}
+
+            // 句柄过期或无效时返回 false
+            bool erase(key_type key);
+
+            // 句柄有效时返回元素指针，否则返回 nullptr
+            T* find(key_type key) noexcept
+            {
+                const uint32_t i = dense_index(key);
+                return i == npos ? nullptr : values_.data() + i;
+            }
+            const T* find(key_type key) const noexcept
+            {
+                const uint32_t i = dense_index(key);
+                return i == npos ? nullptr : values_.data() + i;
+            }
+            bool contains(key_type key) const noexcept {return dense_index(key) != npos;}
+
+            T& operator[](key_type key)
+            {
+                MYSTL_DEBUG(contains(key));
+                return values_[slots_[key.index].index];
+            }
+            const T& operator[](key_type key) const
+            {
+                MYSTL_DEBUG(contains(key));
+                return values_[slots_[key.index].index];
+            }
+            T& at(key_type key)
+            {
+                T* p = find(key);
+                THROW_OUT_OF_RANGE_IF(p == nullptr,"slot_map<T>::at() stale or invalid handle");
+                return *p;
+            }
+            const T& at(key_type key) const
+            {
+                const T* p = find(key);
+                THROW_OUT_OF_RANGE_IF(p == nullptr,"slot_map<T>::at() stale or invalid handle");
+                return *p;
+            }
+
+            // 遍历时拿到第 i 个元素的句柄
+            key_type key_at(size_type i) const noexcept
+            {
+                MYSTL_DEBUG(i < size());
+                const uint32_t s = slot_of_[i];
+                return key_type{s,slots_[s].generation};
+            }
+
+            // 删除所有元素，已发出的句柄全部失效，槽位留作复用
+            void clear() noexcept;
+
+            void swap(slot_map& rhs) noexcept
+            {
+                slots_.swap(rhs.slots_);
+                values_.swap(rhs.values_);
+                slot_of_.swap(rhs.slot_of_);
+                hxqstl::swap(free_head_,rhs.free_head_);
+            }
+
+        private:
+            uint32_t dense_index(key_type key) const noexcept
+            {
+                if(key.index >= slots_.size()) return npos;
+                const slot& s = slots_[key.index];
+                return s.generation == key.generation ? s.index : npos;
+            }
+    };
+
+    /*****************************************************************************************/
+
+    template<class T>
+    constexpr uint32_t slot_map<T>::npos;
+
+    template<class T>
+    template<class... Args>
+    typename slot_map<T>::key_type slot_map<T>::emplace(Args&&... args){
+        THROW_LENGTH_ERROR_IF(values_.size() >= npos - 1,"slot_map<T> too many elements");
+        const uint32_t pos = static_cast<uint32_t>(values_.size());
+        // 先放入元素，失败时不改动槽位
+        values_.emplace_back(hxqstl::forward<Args>(args)...);
+        uint32_t s;
+        try{
+            if(free_head_ != npos){
+                s = free_head_;
+                slot_of_.push_back(s);
+                free_head_ = slots_[s].index;
+            }
+            else{
+                s = static_cast<uint32_t>(slots_.size());
+                slot_of_.push_back(s);
+                slots_.push_back(slot{0,0});
+            }
+        }
+        catch(...){
+            if(slot_of_.size() > values_.size() - 1) slot_of_.pop_back();
+            values_.pop_back();
+            throw;
+        }
+        slots_[s].index = pos;
+        return key_type{s,slots_[s].generation};
+    }
+
+    template<class T>
+    bool slot_map<T>::erase(key_type key){
+        const uint32_t i = dense_index(key);
+        if(i == npos) return false;
+        const uint32_t last = static_cast<uint32_t>(values_.size() - 1);
+        if(i != last){
+            // 用最后一个元素填补空位，并更新它的槽位
+            values_[i] = hxqstl::move(values_[last]);
+            slot_of_[i] = slot_of_[last];
+            slots_[slot_of_[i]].index = i;
+        }
+        values_.pop_back();
+        slot_of_.pop_back();
+
+        slot& s = slots_[key.index];
+        ++s.generation;
+        s.index = free_head_;
+        free_head_ = key.index;
+        return true;
+    }
+
+    template<class T>
+    void slot_map<T>::clear() noexcept{
+        for(size_type i = 0;i < slot_of_.size();++i){
+            slot& s = slots_[slot_of_[i]];
+            ++s.generation;
+            s.index = free_head_;
+            free_head_ = slot_of_[i];
+        }
+        values_.clear();
+        slot_of_.clear();
+    }
+
+    template<class T>
+    void swap(slot_map<T>& lhs,slot_map<T>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+}
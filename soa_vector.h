@@ -0,0 +1,538 @@
+#pragma once
+
+// soa_vector
+// 结构体数组(SoA)布局的顺序容器：soa_vector<int,float,char> 中每个字段各自连续存放成一列
+// 所有列共用一次分配，每列起始地址按 64 字节对齐，热循环只访问用到的列，不浪费 cache line
+// column<I>() 返回某一列的 soa_span，可以直接交给向量化的计算核
+// 迭代器解引用得到 std::tuple<Ts&...>，copy/fill 等 algobase 算法照常可用
+
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+#include "algobase.h"
+#include "allocator.h"
+#include "construct.h"
+#include "iterator.h"
+#include "uninitialized.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace hxqstl{
+    namespace soa{
+        constexpr size_t column_align = 64;
+
+        inline size_t round_up(size_t n) noexcept{
+            return (n + column_align - 1) & ~(column_align - 1);
+        }
+
+        // 展开参数包时用于依次求值的辅助类型
+        typedef int swallow[];
+    }
+
+    // 一列数据的视图，不拥有内存
+    template<class T>
+    class soa_span{
+        public:
+            typedef T value_type;
+            typedef T* iterator;
+            typedef T& reference;
+            typedef size_t size_type;
+
+        private:
+            T* data_;
+            size_type size_;
+
+        public:
+            soa_span() noexcept : data_(nullptr),size_(0) {}
+            soa_span(T* p,size_type n) noexcept : data_(p),size_(n) {}
+
+            T* data() const noexcept {return data_;}
+            size_type size() const noexcept {return size_;}
+            bool empty() const noexcept {return size_ == 0;}
+            T* begin() const noexcept {return data_;}
+            T* end() const noexcept {return data_ + size_;}
+            T& operator[](size_type i) const
+            {
+                MYSTL_DEBUG(i < size_);
+                return data_[i];
+            }
+    };
+
+    template<class... Ts>
+    class soa_vector;
+
+    // 按下标访问各列的代理迭代器
+    template<bool IsConst,class... Ts>
+    struct soa_iterator : public iterator<random_access_iterator_tag,std::tuple<Ts...>>
+    {
+        typedef typename std::conditional<IsConst,const soa_vector<Ts...>*,soa_vector<Ts...>*>::type container_ptr;
+        typedef typename std::conditional<IsConst,std::tuple<const Ts&...>,std::tuple<Ts&...>>::type reference;
+        typedef void pointer;
+        typedef ptrdiff_t difference_type;
+        typedef soa_iterator self;
+
+        container_ptr sv;
+        size_t index;
+
+        soa_iterator() noexcept : sv(nullptr),index(0) {}
+        soa_iterator(container_ptr p,size_t i) noexcept : sv(p),index(i) {}
+        template<bool C,typename std::enable_if<IsConst && !C,int>::type = 0>
+        soa_iterator(const soa_iterator<C,Ts...>& rhs) noexcept : sv(rhs.sv),index(rhs.index) {}
+
+        reference operator*() const {return (*sv)[index];}
+        reference operator[](difference_type n) const {return (*sv)[index + n];}
+
+        self& operator++() {++index;return *this;}
+        self operator++(int) {self tmp = *this;++index;return tmp;}
+        self& operator--() {--index;return *this;}
+        self operator--(int) {self tmp = *this;--index;return tmp;}
+        self& operator+=(difference_type n) {index += n;return *this;}
+        self& operator-=(difference_type n) {index -= n;return *this;}
+        self operator+(difference_type n) const {return self(sv,index + n);}
+        self operator-(difference_type n) const {return self(sv,index - n);}
+        difference_type operator-(const self& rhs) const
+        { return static_cast<difference_type>(index) - static_cast<difference_type>(rhs.index); }
+
+        bool operator==(const self& rhs) const {return index == rhs.index;}
+        bool operator!=(const self& rhs) const {return index != rhs.index;}
+        bool operator<(const self& rhs) const {return index < rhs.index;}
+        bool operator>(const self& rhs) const {return rhs.index < index;}
+        bool operator<=(const self& rhs) const {return !(rhs.index < index);}
+        bool operator>=(const self& rhs) const {return !(index < rhs.index);}
+    };
+
+    template<class... Ts>
+    class soa_vector{
+        static_assert(sizeof...(Ts) > 0,"soa_vector needs at least one column");
+        public:
+            typedef std::tuple<Ts...> value_type;
+            typedef std::tuple<Ts&...> reference;
+            typedef std::tuple<const Ts&...> const_reference;
+            typedef size_t size_type;
+            typedef ptrdiff_t difference_type;
+            typedef soa_iterator<false,Ts...> iterator;
+            typedef soa_iterator<true,Ts...> const_iterator;
+
+            template<size_t I>
+            using column_type = typename std::tuple_element<I,std::tuple<Ts...>>::type;
+
+            static constexpr size_t column_count = sizeof...(Ts);
+
+        private:
+            typedef std::make_index_sequence<sizeof...(Ts)> indices;
+            typedef hxqstl::allocator<unsigned char> raw_allocator;
+
+            unsigned char* raw_;            // 分配得到的原始内存
+            size_type raw_bytes_;
+            std::tuple<Ts*...> cols_;       // 每列的起始地址
+            size_type size_;
+            size_type cap_;
+
+        public:
+            soa_vector() noexcept : raw_(nullptr),raw_bytes_(0),cols_(),size_(0),cap_(0) {}
+
+            explicit soa_vector(size_type n)
+            :raw_(nullptr),raw_bytes_(0),cols_(),size_(0),cap_(0)
+            {
+                resize(n);
+            }
+
+            soa_vector(const soa_vector& rhs)
+            :raw_(nullptr),raw_bytes_(0),cols_(),size_(0),cap_(0)
+            {
+                reserve(rhs.size_);
+                try{
+                    copy_columns<0>(rhs);
+                }
+                catch(...){
+                    release();
+                    throw;
+                }
+                size_ = rhs.size_;
+            }
+
+            soa_vector(soa_vector&& rhs) noexcept
+            :raw_(rhs.raw_),raw_bytes_(rhs.raw_bytes_),cols_(rhs.cols_),size_(rhs.size_),cap_(rhs.cap_)
+            {
+                rhs.raw_ = nullptr;
+                rhs.raw_bytes_ = 0;
+                rhs.cols_ = std::tuple<Ts*...>();
+                rhs.size_ = 0;
+                rhs.cap_ = 0;
+            }
+
+            soa_vector& operator=(const soa_vector& rhs)
+            {
+                if(this != &rhs){
+                    soa_vector tmp(rhs);
+                    swap(tmp);
+                }
+                return *this;
+            }
+            soa_vector& operator=(soa_vector&& rhs) noexcept
+            {
+                soa_vector tmp(hxqstl::move(rhs));
+                swap(tmp);
+                return *this;
+            }
+
+            ~soa_vector()
+            {
+                clear();
+                release();
+            }
+
+        public:
+            iterator begin() noexcept {return iterator(this,0);}
+            const_iterator begin() const noexcept {return const_iterator(this,0);}
+            iterator end() noexcept {return iterator(this,size_);}
+            const_iterator end() const noexcept {return const_iterator(this,size_);}
+            const_iterator cbegin() const noexcept {return begin();}
+            const_iterator cend() const noexcept {return end();}
+
+            bool empty() const noexcept {return size_ == 0;}
+            size_type size() const noexcept {return size_;}
+            size_type capacity() const noexcept {return cap_;}
+
+            void reserve(size_type n)
+            {
+                if(n > cap_) reallocate(n);
+            }
+            void shrink_to_fit()
+            {
+                if(size_ == 0){
+                    release();
+                }
+                else if(size_ < cap_){
+                    reallocate(size_);
+                }
+            }
+
+            // 第 I 列的视图
+            template<size_t I>
+            soa_span<column_type<I>> column() noexcept
+            { return soa_span<column_type<I>>(std::get<I>(cols_),size_); }
+            template<size_t I>
+            soa_span<const column_type<I>> column() const noexcept
+            { return soa_span<const column_type<I>>(std::get<I>(cols_),size_); }
+
+            // 第 i 行第 I 列的元素
+            template<size_t I>
+            column_type<I>& get(size_type i) noexcept
+            {
+                MYSTL_DEBUG(i < size_);
+                return std::get<I>(cols_)[i];
+            }
+            template<size_t I>
+            const column_type<I>& get(size_type i) const noexcept
+            {
+                MYSTL_DEBUG(i < size_);
+                return std::get<I>(cols_)[i];
+            }
+
+            reference operator[](size_type i) noexcept
+            {
+                MYSTL_DEBUG(i < size_);
+                return row(i,indices());
+            }
+            const_reference operator[](size_type i) const noexcept
+            {
+                MYSTL_DEBUG(i < size_);
+                return row(i,indices());
+            }
+            reference at(size_type i)
+            {
+                THROW_OUT_OF_RANGE_IF(!(i < size_),"soa_vector::at() subscript out of range");
+                return (*this)[i];
+            }
+            const_reference at(size_type i) const
+            {
+                THROW_OUT_OF_RANGE_IF(!(i < size_),"soa_vector::at() subscript out of range");
+                return (*this)[i];
+            }
+            reference front() noexcept {return (*this)[0];}
+            reference back() noexcept {return (*this)[size_ - 1];}
+
+            // 每列一个参数，分别构造新行的各个字段
+            template<class... Args>
+            void emplace_back(Args&&... args)
+            {
+                static_assert(sizeof...(Args) == sizeof...(Ts),"soa_vector::emplace_back needs one argument per column");
+                if(size_ == cap_){
+                    // 参数可能引用本容器中的元素，先在新内存中构造新行，再搬迁旧数据
+                    reallocate_emplace(std::forward_as_tuple(hxqstl::forward<Args>(args)...));
+                }
+                else{
+                    construct_row<0>(cols_,size_,std::forward_as_tuple(hxqstl::forward<Args>(args)...));
+                }
+                ++size_;
+            }
+
+            void push_back(const Ts&... values) {emplace_back(values...);}
+
+            template<class... Us>
+            void push_back(const std::tuple<Us...>& t)
+            { push_tuple(t,indices()); }
+            void push_back(value_type&& t)
+            { push_tuple(hxqstl::move(t),indices()); }
+
+            template<class A,class B>
+            void push_back(const hxqstl::pair<A,B>& p) {emplace_back(p.first,p.second);}
+            template<class A,class B>
+            void push_back(hxqstl::pair<A,B>&& p) {emplace_back(hxqstl::move(p.first),hxqstl::move(p.second));}
+            template<class A,class B>
+            void push_back(const std::pair<A,B>& p) {emplace_back(p.first,p.second);}
+
+            void pop_back() noexcept
+            {
+                MYSTL_DEBUG(size_ > 0);
+                --size_;
+                destroy_rows(size_,size_ + 1,indices());
+            }
+
+            // 删除第 i 行，后面的行依次前移
+            void erase(size_type i);
+            // 用最后一行覆盖第 i 行，O(1)，不保持顺序
+            void swap_remove(size_type i);
+
+            void resize(size_type n);
+
+            void clear() noexcept
+            {
+                destroy_rows(0,size_,indices());
+                size_ = 0;
+            }
+
+            void swap(soa_vector& rhs) noexcept
+            {
+                hxqstl::swap(raw_,rhs.raw_);
+                hxqstl::swap(raw_bytes_,rhs.raw_bytes_);
+                std::swap(cols_,rhs.cols_);
+                hxqstl::swap(size_,rhs.size_);
+                hxqstl::swap(cap_,rhs.cap_);
+            }
+
+        private:
+            size_type next_cap() const noexcept {return cap_ == 0 ? 16 : cap_ * 2;}
+
+            template<size_t... I>
+            reference row(size_type i,std::index_sequence<I...>) noexcept
+            { return reference(std::get<I>(cols_)[i]...); }
+            template<size_t... I>
+            const_reference row(size_type i,std::index_sequence<I...>) const noexcept
+            { return const_reference(std::get<I>(cols_)[i]...); }
+
+            // 在 cols 中依次构造第 I 列及之后的字段，某列抛出异常时析构本行已构造的字段
+            template<size_t I,class Tuple>
+            static typename std::enable_if<(I < sizeof...(Ts))>::type
+            construct_row(const std::tuple<Ts*...>& cols,size_type i,Tuple&& args)
+            {
+                hxqstl::construct(std::get<I>(cols) + i,std::get<I>(hxqstl::forward<Tuple>(args)));
+                try{
+                    construct_row<I + 1>(cols,i,hxqstl::forward<Tuple>(args));
+                }
+                catch(...){
+                    hxqstl::destroy(std::get<I>(cols) + i);
+                    throw;
+                }
+            }
+            template<size_t I,class Tuple>
+            static typename std::enable_if<(I == sizeof...(Ts))>::type
+            construct_row(const std::tuple<Ts*...>&,size_type,Tuple&&) noexcept {}
+
+            template<class Tuple,size_t... I>
+            void push_tuple(Tuple&& t,std::index_sequence<I...>)
+            { emplace_back(std::get<I>(hxqstl::forward<Tuple>(t))...); }
+
+            template<size_t... I>
+            static void destroy_rows(const std::tuple<Ts*...>& cols,size_type first,size_type last,
+                                     std::index_sequence<I...>) noexcept
+            {
+                (void)soa::swallow{0,(hxqstl::destroy(std::get<I>(cols) + first,std::get<I>(cols) + last),0)...};
+            }
+            template<size_t... I>
+            void destroy_rows(size_type first,size_type last,std::index_sequence<I...> seq) noexcept
+            { destroy_rows(cols_,first,last,seq); }
+
+            // 每列把 [first,last) 行移动赋值到从 dst 开始的行
+            template<size_t... I>
+            void move_rows(size_type first,size_type last,size_type dst,std::index_sequence<I...>)
+            {
+                (void)soa::swallow{0,(hxqstl::move(std::get<I>(cols_) + first,std::get<I>(cols_) + last,
+                                                   std::get<I>(cols_) + dst),0)...};
+            }
+
+            template<size_t... I>
+            static std::tuple<Ts*...> make_columns(unsigned char* base,const size_t* offsets,std::index_sequence<I...>) noexcept
+            { return std::tuple<Ts*...>(reinterpret_cast<Ts*>(base + offsets[I])...); }
+
+            // 一次分配出的所有列
+            struct storage
+            {
+                unsigned char* raw;
+                size_type bytes;
+                std::tuple<Ts*...> cols;
+            };
+
+            static storage allocate_storage(size_type cap);
+            void adopt(const storage& st,size_type new_cap) noexcept;
+            void reallocate(size_type new_cap);
+            template<class Tuple>
+            void reallocate_emplace(Tuple&& args);
+
+            // 把已有的行逐列移动到 dst，某列抛出异常时析构 dst 中已经移动过去的列
+            template<size_t I>
+            typename std::enable_if<(I < sizeof...(Ts))>::type move_columns(const std::tuple<Ts*...>& dst)
+            {
+                hxqstl::uninitialized_move(std::get<I>(cols_),std::get<I>(cols_) + size_,std::get<I>(dst));
+                try{
+                    move_columns<I + 1>(dst);
+                }
+                catch(...){
+                    hxqstl::destroy(std::get<I>(dst),std::get<I>(dst) + size_);
+                    throw;
+                }
+            }
+            template<size_t I>
+            typename std::enable_if<(I == sizeof...(Ts))>::type move_columns(const std::tuple<Ts*...>&) noexcept {}
+
+            // 把 rhs 的行逐列复制到本对象的列中，某列抛出异常时析构已经复制好的列
+            template<size_t I>
+            typename std::enable_if<(I < sizeof...(Ts))>::type copy_columns(const soa_vector& rhs)
+            {
+                hxqstl::uninitialized_copy(std::get<I>(rhs.cols_),std::get<I>(rhs.cols_) + rhs.size_,std::get<I>(cols_));
+                try{
+                    copy_columns<I + 1>(rhs);
+                }
+                catch(...){
+                    hxqstl::destroy(std::get<I>(cols_),std::get<I>(cols_) + rhs.size_);
+                    throw;
+                }
+            }
+            template<size_t I>
+            typename std::enable_if<(I == sizeof...(Ts))>::type copy_columns(const soa_vector&) noexcept {}
+
+            void release() noexcept
+            {
+                if(raw_ != nullptr){
+                    raw_allocator::deallocate(raw_,raw_bytes_);
+                }
+                raw_ = nullptr;
+                raw_bytes_ = 0;
+                cols_ = std::tuple<Ts*...>();
+                cap_ = 0;
+            }
+    };
+
+    /*****************************************************************************************/
+
+    template<class... Ts>
+    constexpr size_t soa_vector<Ts...>::column_count;
+
+    // 计算各列的偏移，一次分配出所有列
+    template<class... Ts>
+    typename soa_vector<Ts...>::storage soa_vector<Ts...>::allocate_storage(size_type cap){
+        const size_t sizes[] = {sizeof(Ts)...};
+        size_t offsets[sizeof...(Ts)];
+        size_t total = 0;
+        for(size_t c = 0;c < sizeof...(Ts);++c){
+            offsets[c] = total;
+            total = soa::round_up(total + sizes[c] * cap);
+        }
+        // 多分配 column_align - 1 字节，用来把第一列对齐
+        storage st;
+        st.bytes = total + soa::column_align - 1;
+        st.raw = raw_allocator::allocate(st.bytes);
+        unsigned char* base = reinterpret_cast<unsigned char*>(
+            soa::round_up(reinterpret_cast<uintptr_t>(st.raw)));
+        st.cols = make_columns(base,offsets,indices());
+        return st;
+    }
+
+    // 旧数据已经移动到 st 中，析构旧数据并换上新内存
+    template<class... Ts>
+    void soa_vector<Ts...>::adopt(const storage& st,size_type new_cap) noexcept{
+        destroy_rows(0,size_,indices());
+        if(raw_ != nullptr){
+            raw_allocator::deallocate(raw_,raw_bytes_);
+        }
+        raw_ = st.raw;
+        raw_bytes_ = st.bytes;
+        cols_ = st.cols;
+        cap_ = new_cap;
+    }
+
+    template<class... Ts>
+    void soa_vector<Ts...>::reallocate(size_type new_cap){
+        MYSTL_DEBUG(new_cap >= size_);
+        const storage st = allocate_storage(new_cap);
+        try{
+            move_columns<0>(st.cols);
+        }
+        catch(...){
+            raw_allocator::deallocate(st.raw,st.bytes);
+            throw;
+        }
+        adopt(st,new_cap);
+    }
+
+    // 新行先构造在新内存的 size_ 处，此时旧数据还完好，参数引用旧元素也是安全的
+    template<class... Ts>
+    template<class Tuple>
+    void soa_vector<Ts...>::reallocate_emplace(Tuple&& args){
+        const size_type new_cap = next_cap();
+        const storage st = allocate_storage(new_cap);
+        try{
+            construct_row<0>(st.cols,size_,hxqstl::forward<Tuple>(args));
+        }
+        catch(...){
+            raw_allocator::deallocate(st.raw,st.bytes);
+            throw;
+        }
+        try{
+            move_columns<0>(st.cols);
+        }
+        catch(...){
+            destroy_rows(st.cols,size_,size_ + 1,indices());
+            raw_allocator::deallocate(st.raw,st.bytes);
+            throw;
+        }
+        adopt(st,new_cap);
+    }
+
+    template<class... Ts>
+    void soa_vector<Ts...>::erase(size_type i){
+        MYSTL_DEBUG(i < size_);
+        move_rows(i + 1,size_,i,indices());
+        pop_back();
+    }
+
+    template<class... Ts>
+    void soa_vector<Ts...>::swap_remove(size_type i){
+        MYSTL_DEBUG(i < size_);
+        if(i + 1 != size_){
+            move_rows(size_ - 1,size_,i,indices());
+        }
+        pop_back();
+    }
+
+    template<class... Ts>
+    void soa_vector<Ts...>::resize(size_type n){
+        if(n < size_){
+            destroy_rows(n,size_,indices());
+            size_ = n;
+            return;
+        }
+        reserve(n);
+        while(size_ < n){
+            emplace_back(Ts()...);
+        }
+    }
+
+    template<class... Ts>
+    void swap(soa_vector<Ts...>& lhs,soa_vector<Ts...>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+}
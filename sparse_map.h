@@ -0,0 +1,198 @@
+#pragma once
+
+// sparse_map
+// 以 32 位整数 ID 为键的映射，结构与 sparse_set 相同：分页的稀疏索引加上稠密数组
+// 值紧密地存放在一个 hxqstl::vector 中，与存放 ID 的数组一一对应，遍历值是连续内存
+// 删除时用最后一个元素填补空位，值在数组中的位置会变化，不要长期保存值的指针，只保存 ID
+
+#include <cstdint>
+
+#include "sparse_set.h"
+#include "util.h"
+#include "vector.h"
+#include "exceptdef.h"
+
+namespace hxqstl{
+    template<class T>
+    class sparse_map{
+        public:
+            typedef uint32_t key_type;
+            typedef T mapped_type;
+            typedef T value_type;
+            typedef size_t size_type;
+            typedef T& reference;
+            typedef const T& const_reference;
+            // 迭代器遍历的是值，对应的 ID 用 key_at 或 keys 取得
+            typedef T* iterator;
+            typedef const T* const_iterator;
+
+        private:
+            sparse::page_table sparse_;
+            hxqstl::vector<uint32_t> keys_;     // values_[i] 的 ID
+            hxqstl::vector<T> values_;
+
+        public:
+            sparse_map() : sparse_(),keys_(),values_() {}
+
+            sparse_map(const sparse_map&) = default;
+            sparse_map(sparse_map&& rhs) noexcept
+            :sparse_(hxqstl::move(rhs.sparse_)),keys_(hxqstl::move(rhs.keys_)),
+             values_(hxqstl::move(rhs.values_)) {}
+            sparse_map& operator=(const sparse_map&) = default;
+            sparse_map& operator=(sparse_map&& rhs) noexcept
+            {
+                sparse_map tmp(hxqstl::move(rhs));
+                swap(tmp);
+                return *this;
+            }
+            ~sparse_map() = default;
+
+        public:
+            iterator begin() noexcept {return values_.begin();}
+            const_iterator begin() const noexcept {return values_.begin();}
+            iterator end() noexcept {return values_.end();}
+            const_iterator end() const noexcept {return values_.end();}
+
+            bool empty() const noexcept {return values_.empty();}
+            size_type size() const noexcept {return values_.size();}
+            size_type capacity() const noexcept {return values_.capacity();}
+
+            // 只预留稠密数组，页仍然在用到时才分配
+            void reserve(size_type n)
+            {
+                THROW_LENGTH_ERROR_IF(n >= sparse::npos,"sparse_map<T> too many elements");
+                keys_.reserve(n);
+                values_.reserve(n);
+            }
+
+            // 紧密存放的值和对应的 ID，下标一一对应
+            T* data() noexcept {return values_.data();}
+            const T* data() const noexcept {return values_.data();}
+            const uint32_t* keys() const noexcept {return keys_.data();}
+
+            key_type key_at(size_type i) const noexcept
+            {
+                MYSTL_DEBUG(i < size());
+                return keys_[i];
+            }
+
+            // 返回值的指针和是否插入了新元素，ID 已存在时不做任何修改
+            template<class... Args>
+            hxqstl::pair<T*,bool> try_emplace(uint32_t id,Args&&... args);
+            hxqstl::pair<T*,bool> insert(uint32_t id,const T& value) {return try_emplace(id,value);}
+            hxqstl::pair<T*,bool> insert(uint32_t id,T&& value) {return try_emplace(id,hxqstl::move(value));}
+
+            // ID 已存在时覆盖原值
+            template<class M>
+            hxqstl::pair<T*,bool> insert_or_assign(uint32_t id,M&& obj)
+            {
+                auto res = try_emplace(id,hxqstl::forward<M>(obj));
+                if(!res.second){
+                    *res.first = hxqstl::forward<M>(obj);
+                }
+                return res;
+            }
+
+            // 返回删除的元素个数
+            size_type erase(uint32_t id);
+
+            // ID 存在时返回值的指针，否则返回 nullptr
+            T* find(uint32_t id) noexcept
+            {
+                const uint32_t i = sparse_.get(id);
+                return i == sparse::npos ? nullptr : values_.data() + i;
+            }
+            const T* find(uint32_t id) const noexcept
+            {
+                const uint32_t i = sparse_.get(id);
+                return i == sparse::npos ? nullptr : values_.data() + i;
+            }
+            bool contains(uint32_t id) const noexcept {return sparse_.get(id) != sparse::npos;}
+            size_type count(uint32_t id) const noexcept {return contains(id) ? 1 : 0;}
+
+            T& operator[](uint32_t id) {return *try_emplace(id).first;}
+
+            T& at(uint32_t id)
+            {
+                T* p = find(id);
+                THROW_OUT_OF_RANGE_IF(p == nullptr,"sparse_map<T> no such element exists");
+                return *p;
+            }
+            const T& at(uint32_t id) const
+            {
+                const T* p = find(id);
+                THROW_OUT_OF_RANGE_IF(p == nullptr,"sparse_map<T> no such element exists");
+                return *p;
+            }
+
+            // 删除所有元素，代价与元素个数成正比；已分配的页保留下来留作复用
+            void clear() noexcept
+            {
+                sparse_.reset(keys_.data(),keys_.size());
+                keys_.clear();
+                values_.clear();
+            }
+
+            // 释放没有存活元素的页和稠密数组多余的容量
+            void shrink_to_fit()
+            {
+                sparse_.shrink(keys_.data(),keys_.size());
+                keys_.shrink_to_fit();
+                values_.shrink_to_fit();
+            }
+
+            // 已分配的页数，每页 sparse::kPageSize 项
+            size_type page_count() const noexcept {return sparse_.page_count();}
+
+            void swap(sparse_map& rhs) noexcept
+            {
+                sparse_.swap(rhs.sparse_);
+                keys_.swap(rhs.keys_);
+                values_.swap(rhs.values_);
+            }
+    };
+
+    /*****************************************************************************************/
+
+    template<class T>
+    template<class... Args>
+    hxqstl::pair<T*,bool> sparse_map<T>::try_emplace(uint32_t id,Args&&... args){
+        THROW_LENGTH_ERROR_IF(values_.size() >= sparse::npos - 1,"sparse_map<T> too many elements");
+        uint32_t& s = sparse_.slot(id);
+        if(s != sparse::npos) return hxqstl::pair<T*,bool>(values_.data() + s,false);
+        // 先放入值，失败时不改动索引
+        values_.emplace_back(hxqstl::forward<Args>(args)...);
+        try{
+            keys_.push_back(id);
+        }
+        catch(...){
+            values_.pop_back();
+            throw;
+        }
+        s = static_cast<uint32_t>(values_.size() - 1);
+        return hxqstl::pair<T*,bool>(values_.data() + s,true);
+    }
+
+    template<class T>
+    typename sparse_map<T>::size_type sparse_map<T>::erase(uint32_t id){
+        const uint32_t i = sparse_.get(id);
+        if(i == sparse::npos) return 0;
+        const uint32_t last = static_cast<uint32_t>(values_.size() - 1);
+        if(i != last){
+            // 用最后一个元素填补空位，并更新它的索引
+            values_[i] = hxqstl::move(values_[last]);
+            keys_[i] = keys_[last];
+            sparse_.set(keys_[i],i);
+        }
+        values_.pop_back();
+        keys_.pop_back();
+        sparse_.set(id,sparse::npos);
+        return 1;
+    }
+
+    template<class T>
+    void swap(sparse_map<T>& lhs,sparse_map<T>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+}
@@ -0,0 +1,252 @@
+#pragma once
+
+// sparse_set
+// 以 32 位整数 ID 为元素的集合，插入、删除、查找都是 O(1)
+// 稀疏部分是按页分配的索引数组：ID 的高位选页，低位选页内位置，存放该 ID 在稠密数组中的下标
+// 页只在第一次写入时分配，ID 分布在很大范围内但实际元素不多时不会占用大量内存
+// 稠密部分是一个 hxqstl::vector，存活的 ID 紧密排列，遍历是连续内存；删除时用最后一个元素填补空位
+// clear 只重置存活 ID 对应的索引，代价与元素个数成正比，与 ID 范围和已分配的页数无关
+
+#include <cstdint>
+#include <cstring>
+
+#include "allocator.h"
+#include "util.h"
+#include "vector.h"
+#include "exceptdef.h"
+
+namespace hxqstl{
+    namespace sparse{
+        static constexpr unsigned kPageBits = 12;
+        static constexpr uint32_t kPageSize = static_cast<uint32_t>(1) << kPageBits;   // 每页 4096 项，16KB
+        static constexpr uint32_t kPageMask = kPageSize - 1;
+        static constexpr uint32_t npos = static_cast<uint32_t>(-1);
+
+        // 分页的稀疏索引：id -> 稠密下标，不存在时为 npos
+        // 新分配的页全部填成 npos，因此不需要再回查稠密数组确认
+        class page_table{
+            private:
+                typedef hxqstl::allocator<uint32_t> page_allocator;
+
+                hxqstl::vector<uint32_t*> pages_;   // 未分配的页为 nullptr，长度只到用过的最大页号
+
+            public:
+                page_table() : pages_() {}
+
+                page_table(const page_table& rhs) : pages_(rhs.pages_.size(),nullptr)
+                {
+                    try{
+                        for(size_t i = 0;i < rhs.pages_.size();++i){
+                            if(rhs.pages_[i] == nullptr) continue;
+                            pages_[i] = page_allocator::allocate(kPageSize);
+                            std::memcpy(pages_[i],rhs.pages_[i],kPageSize * sizeof(uint32_t));
+                        }
+                    }
+                    catch(...){
+                        release();
+                        throw;
+                    }
+                }
+                page_table(page_table&& rhs) noexcept : pages_(hxqstl::move(rhs.pages_)) {}
+                page_table& operator=(const page_table& rhs)
+                {
+                    if(this != &rhs){
+                        page_table tmp(rhs);
+                        swap(tmp);
+                    }
+                    return *this;
+                }
+                page_table& operator=(page_table&& rhs) noexcept
+                {
+                    page_table tmp(hxqstl::move(rhs));
+                    swap(tmp);
+                    return *this;
+                }
+                ~page_table() {release();}
+
+            public:
+                uint32_t get(uint32_t id) const noexcept
+                {
+                    const size_t p = id >> kPageBits;
+                    if(p >= pages_.size() || pages_[p] == nullptr) return npos;
+                    return pages_[p][id & kPageMask];
+                }
+
+                // id 必须已经有页(get 返回过非 npos，或者之前调用过 slot)
+                void set(uint32_t id,uint32_t index) noexcept
+                {
+                    MYSTL_DEBUG((id >> kPageBits) < pages_.size() && pages_[id >> kPageBits] != nullptr);
+                    pages_[id >> kPageBits][id & kPageMask] = index;
+                }
+
+                // 返回 id 对应的索引项，页不存在时先分配
+                uint32_t& slot(uint32_t id)
+                {
+                    const size_t p = id >> kPageBits;
+                    if(p >= pages_.size()) pages_.resize(p + 1,nullptr);
+                    if(pages_[p] == nullptr){
+                        uint32_t* page = page_allocator::allocate(kPageSize);
+                        hxqstl::fill_n(page,kPageSize,npos);
+                        pages_[p] = page;
+                    }
+                    return pages_[p][id & kPageMask];
+                }
+
+                // 把 ids 中每个 id 的索引项重置为 npos，页保留下来留作复用
+                void reset(const uint32_t* ids,size_t n) noexcept
+                {
+                    for(size_t i = 0;i < n;++i) set(ids[i],npos);
+                }
+
+                // 释放没有任何存活 id 的页，ids 是全部存活的 id
+                void shrink(const uint32_t* ids,size_t n)
+                {
+                    hxqstl::vector<unsigned char> used(pages_.size(),0);
+                    for(size_t i = 0;i < n;++i) used[ids[i] >> kPageBits] = 1;
+                    for(size_t p = 0;p < pages_.size();++p){
+                        if(!used[p] && pages_[p] != nullptr){
+                            page_allocator::deallocate(pages_[p],kPageSize);
+                            pages_[p] = nullptr;
+                        }
+                    }
+                    while(!pages_.empty() && pages_.back() == nullptr) pages_.pop_back();
+                    pages_.shrink_to_fit();
+                }
+
+                size_t page_count() const noexcept
+                {
+                    size_t n = 0;
+                    for(size_t p = 0;p < pages_.size();++p) n += pages_[p] != nullptr;
+                    return n;
+                }
+
+                void release() noexcept
+                {
+                    for(size_t p = 0;p < pages_.size();++p){
+                        if(pages_[p] != nullptr) page_allocator::deallocate(pages_[p],kPageSize);
+                    }
+                    pages_.clear();
+                }
+
+                void swap(page_table& rhs) noexcept {pages_.swap(rhs.pages_);}
+        };
+    }
+
+    class sparse_set{
+        public:
+            typedef uint32_t value_type;
+            typedef uint32_t key_type;
+            typedef size_t size_type;
+            typedef const uint32_t& reference;
+            typedef const uint32_t& const_reference;
+            // 元素不能原地修改，只提供只读迭代器
+            typedef const uint32_t* iterator;
+            typedef const uint32_t* const_iterator;
+
+        private:
+            sparse::page_table sparse_;
+            hxqstl::vector<uint32_t> dense_;
+
+        public:
+            sparse_set() : sparse_(),dense_() {}
+
+            sparse_set(const sparse_set&) = default;
+            sparse_set(sparse_set&& rhs) noexcept
+            :sparse_(hxqstl::move(rhs.sparse_)),dense_(hxqstl::move(rhs.dense_)) {}
+            sparse_set& operator=(const sparse_set&) = default;
+            sparse_set& operator=(sparse_set&& rhs) noexcept
+            {
+                sparse_set tmp(hxqstl::move(rhs));
+                swap(tmp);
+                return *this;
+            }
+            ~sparse_set() = default;
+
+        public:
+            const_iterator begin() const noexcept {return dense_.begin();}
+            const_iterator end() const noexcept {return dense_.end();}
+
+            bool empty() const noexcept {return dense_.empty();}
+            size_type size() const noexcept {return dense_.size();}
+            size_type capacity() const noexcept {return dense_.capacity();}
+
+            // 只预留稠密数组，页仍然在用到时才分配
+            void reserve(size_type n)
+            {
+                THROW_LENGTH_ERROR_IF(n >= sparse::npos,"sparse_set too many elements");
+                dense_.reserve(n);
+            }
+
+            // 紧密存放的存活 ID，顺序是插入顺序被删除打乱之后的结果
+            const uint32_t* data() const noexcept {return dense_.data();}
+
+            // 返回是否插入了新元素
+            bool insert(uint32_t id);
+            // 返回删除的元素个数
+            size_type erase(uint32_t id);
+
+            bool contains(uint32_t id) const noexcept {return sparse_.get(id) != sparse::npos;}
+            size_type count(uint32_t id) const noexcept {return contains(id) ? 1 : 0;}
+
+            // id 在 data() 中的下标，不存在时返回 end() - begin()
+            size_type index_of(uint32_t id) const noexcept
+            {
+                const uint32_t i = sparse_.get(id);
+                return i == sparse::npos ? size() : i;
+            }
+
+            // 删除所有元素，代价与元素个数成正比；已分配的页保留下来留作复用
+            void clear() noexcept
+            {
+                sparse_.reset(dense_.data(),dense_.size());
+                dense_.clear();
+            }
+
+            // 释放没有存活元素的页和稠密数组多余的容量
+            void shrink_to_fit()
+            {
+                sparse_.shrink(dense_.data(),dense_.size());
+                dense_.shrink_to_fit();
+            }
+
+            // 已分配的页数，每页 sparse::kPageSize 项
+            size_type page_count() const noexcept {return sparse_.page_count();}
+
+            void swap(sparse_set& rhs) noexcept
+            {
+                sparse_.swap(rhs.sparse_);
+                dense_.swap(rhs.dense_);
+            }
+    };
+
+    /*****************************************************************************************/
+
+    inline bool sparse_set::insert(uint32_t id){
+        THROW_LENGTH_ERROR_IF(dense_.size() >= sparse::npos - 1,"sparse_set too many elements");
+        // 先分配页，再放入稠密数组，任何一步失败都不会留下不一致的索引
+        uint32_t& s = sparse_.slot(id);
+        if(s != sparse::npos) return false;
+        dense_.push_back(id);
+        s = static_cast<uint32_t>(dense_.size() - 1);
+        return true;
+    }
+
+    inline sparse_set::size_type sparse_set::erase(uint32_t id){
+        const uint32_t i = sparse_.get(id);
+        if(i == sparse::npos) return 0;
+        const uint32_t last = static_cast<uint32_t>(dense_.size() - 1);
+        if(i != last){
+            // 用最后一个元素填补空位，并更新它的索引
+            dense_[i] = dense_[last];
+            sparse_.set(dense_[i],i);
+        }
+        dense_.pop_back();
+        sparse_.set(id,sparse::npos);
+        return 1;
+    }
+
+    inline void swap(sparse_set& lhs,sparse_set& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+}
@@ -0,0 +1,326 @@
+#pragma once
+
+// static_vector
+// 容量固定为 N 的 vector，元素内联存放在对象内部，不申请堆内存
+// 超出容量时抛出 length_error
+//
+// 平凡类型(trivial)用普通数组 T[N] 存放，所有操作都是 constexpr，可以在编译期构造查找表：
+//     constexpr auto table = make_table();    // 函数内部用 static_vector 逐个 push_back
+// 代价是构造时会把 N 个元素全部值初始化，以及复制时复制整个数组
+// 非平凡类型用未初始化的内存存放，只构造 [0,size) 上的元素
+
+#include <initializer_list>
+
+#include "algobase.h"
+#include "construct.h"
+#include "iterator.h"
+#include "uninitialized.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace hxqstl{
+    namespace svec{
+        template<class T>
+        struct use_array
+            : std::integral_constant<bool,std::is_trivial<T>::value> {};
+
+        template<class T,size_t N,bool Trivial = use_array<T>::value>
+        struct storage;
+
+        // 平凡类型：复制、移动、析构都使用编译器生成的版本，满足字面类型的要求
+        template<class T,size_t N>
+        struct storage<T,N,true>
+        {
+            T data_[N == 0 ? 1 : N];
+            size_t size_;
+
+            constexpr storage() noexcept : data_{},size_(0) {}
+
+            constexpr T* ptr() noexcept {return data_;}
+            constexpr const T* ptr() const noexcept {return data_;}
+        };
+
+        template<class T,size_t N>
+        struct storage<T,N,false>
+        {
+            typename std::aligned_storage<sizeof(T),alignof(T)>::type data_[N == 0 ? 1 : N];
+            size_t size_;
+
+            storage() noexcept : size_(0) {}
+
+            storage(const storage& rhs) : size_(0)
+            {
+                hxqstl::uninitialized_copy(rhs.ptr(),rhs.ptr() + rhs.size_,ptr());
+                size_ = rhs.size_;
+            }
+
+            storage(storage&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value)
+            : size_(0)
+            {
+                hxqstl::uninitialized_move(rhs.ptr(),rhs.ptr() + rhs.size_,ptr());
+                size_ = rhs.size_;
+            }
+
+            storage& operator=(const storage& rhs)
+            {
+                if(this != &rhs) assign_from(rhs.ptr(),rhs.size_);
+                return *this;
+            }
+
+            storage& operator=(storage&& rhs)
+            {
+                if(this != &rhs) assign_from(hxqstl::make_move_iterator(rhs.ptr()),rhs.size_);
+                return *this;
+            }
+
+            ~storage()
+            {
+                hxqstl::destroy(ptr(),ptr() + size_);
+            }
+
+            T* ptr() noexcept {return reinterpret_cast<T*>(data_);}
+            const T* ptr() const noexcept {return reinterpret_cast<const T*>(data_);}
+
+            // 公共部分逐个赋值，多出的部分构造或析构
+            template<class Iter>
+            void assign_from(Iter src,size_t n)
+            {
+                const size_t common = hxqstl::min(n,size_);
+                hxqstl::copy(src,src + common,ptr());
+                if(n > size_){
+                    hxqstl::uninitialized_copy(src + common,src + n,ptr() + size_);
+                }
+                else{
+                    hxqstl::destroy(ptr() + n,ptr() + size_);
+                }
+                size_ = n;
+            }
+        };
+    }
+
+    template<class T,size_t N>
+    class static_vector : private svec::storage<T,N>{
+        private:
+            typedef svec::storage<T,N> base;
+            using base::size_;
+            using base::ptr;
+
+        public:
+            typedef T value_type;
+            typedef T* pointer;
+            typedef const T* const_pointer;
+            typedef T& reference;
+            typedef const T& const_reference;
+            typedef size_t size_type;
+            typedef ptrdiff_t difference_type;
+
+            typedef T* iterator;
+            typedef const T* const_iterator;
+            typedef hxqstl::reverse_iterator<iterator> reverse_iterator;
+            typedef hxqstl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+        public:
+            constexpr static_vector() noexcept : base() {}
+
+            constexpr explicit static_vector(size_type n) : base()
+            { resize(n); }
+
+            constexpr static_vector(size_type n,const value_type& value) : base()
+            { resize(n,value); }
+
+            template<class Iter,typename std::enable_if<
+                hxqstl::is_input_iterator<Iter>::value,int>::type = 0>
+            constexpr static_vector(Iter first,Iter last) : base()
+            {
+                for(;first != last;++first){
+                    emplace_back(*first);
+                }
+            }
+
+            constexpr static_vector(std::initializer_list<value_type> ilist) : base()
+            {
+                THROW_LENGTH_ERROR_IF(ilist.size() > N,"static_vector<T,N> capacity exceeded");
+                for(const value_type* p = ilist.begin();p != ilist.end();++p){
+                    emplace_back(*p);
+                }
+            }
+
+        public:
+            constexpr iterator begin() noexcept {return ptr();}
+            constexpr const_iterator begin() const noexcept {return ptr();}
+            constexpr iterator end() noexcept {return ptr() + size_;}
+            constexpr const_iterator end() const noexcept {return ptr() + size_;}
+
+            reverse_iterator rbegin() noexcept {return reverse_iterator(end());}
+            const_reverse_iterator rbegin() const noexcept {return const_reverse_iterator(end());}
+            reverse_iterator rend() noexcept {return reverse_iterator(begin());}
+            const_reverse_iterator rend() const noexcept {return const_reverse_iterator(begin());}
+
+            constexpr const_iterator cbegin() const noexcept {return begin();}
+            constexpr const_iterator cend() const noexcept {return end();}
+
+            constexpr bool empty() const noexcept {return size_ == 0;}
+            constexpr bool full() const noexcept {return size_ == N;}
+            constexpr size_type size() const noexcept {return size_;}
+            static constexpr size_type capacity() noexcept {return N;}
+            static constexpr size_type max_size() noexcept {return N;}
+
+            constexpr reference operator[](size_type n)
+            {
+                MYSTL_DEBUG(n < size_);
+                return ptr()[n];
+            }
+            constexpr const_reference operator[](size_type n) const
+            {
+                MYSTL_DEBUG(n < size_);
+                return ptr()[n];
+            }
+
+            constexpr reference at(size_type n)
+            {
+                THROW_OUT_OF_RANGE_IF(!(n < size_),"static_vector<T,N>::at() subscript out of range");
+                return ptr()[n];
+            }
+            constexpr const_reference at(size_type n) const
+            {
+                THROW_OUT_OF_RANGE_IF(!(n < size_),"static_vector<T,N>::at() subscript out of range");
+                return ptr()[n];
+            }
+
+            constexpr reference front() {MYSTL_DEBUG(!empty()); return ptr()[0];}
+            constexpr const_reference front() const {MYSTL_DEBUG(!empty()); return ptr()[0];}
+            constexpr reference back() {MYSTL_DEBUG(!empty()); return ptr()[size_ - 1];}
+            constexpr const_reference back() const {MYSTL_DEBUG(!empty()); return ptr()[size_ - 1];}
+
+            constexpr pointer data() noexcept {return ptr();}
+            constexpr const_pointer data() const noexcept {return ptr();}
+
+            template<class... Args>
+            constexpr reference emplace_back(Args&&... args)
+            {
+                THROW_LENGTH_ERROR_IF(size_ == N,"static_vector<T,N> capacity exceeded");
+                hxqstl::construct(ptr() + size_,hxqstl::forward<Args>(args)...);
+                return ptr()[size_++];
+            }
+
+            constexpr void push_back(const value_type& value) {emplace_back(value);}
+            constexpr void push_back(value_type&& value) {emplace_back(hxqstl::move(value));}
+
+            constexpr void pop_back()
+            {
+                MYSTL_DEBUG(!empty());
+                --size_;
+                hxqstl::destroy(ptr() + size_);
+            }
+
+            template<class... Args>
+            constexpr iterator emplace(const_iterator pos,Args&&... args);
+
+            constexpr iterator insert(const_iterator pos,const value_type& value)
+            { return emplace(pos,value); }
+            constexpr iterator insert(const_iterator pos,value_type&& value)
+            { return emplace(pos,hxqstl::move(value)); }
+
+            constexpr iterator erase(const_iterator pos)
+            {
+                MYSTL_DEBUG(pos >= begin() && pos < end());
+                return erase(pos,pos + 1);
+            }
+            constexpr iterator erase(const_iterator first,const_iterator last);
+
+            constexpr void clear() noexcept
+            {
+                hxqstl::destroy(ptr(),ptr() + size_);
+                size_ = 0;
+            }
+
+            constexpr void resize(size_type n) {resize_impl(n);}
+            constexpr void resize(size_type n,const value_type& value) {resize_impl(n,value);}
+
+            constexpr void swap(static_vector& rhs);
+
+        private:
+            template<class... Args>
+            constexpr void resize_impl(size_type n,const Args&... args)
+            {
+                THROW_LENGTH_ERROR_IF(n > N,"static_vector<T,N> capacity exceeded");
+                while(size_ > n) pop_back();
+                while(size_ < n) emplace_back(args...);
+            }
+    };
+
+    /*****************************************************************************************/
+
+    // 新元素先构造在临时对象里，参数引用容器内元素时也安全
+    template<class T,size_t N>
+    template<class... Args>
+    constexpr typename static_vector<T,N>::iterator
+    static_vector<T,N>::emplace(const_iterator pos,Args&&... args){
+        MYSTL_DEBUG(pos >= begin() && pos <= end());
+        THROW_LENGTH_ERROR_IF(size_ == N,"static_vector<T,N> capacity exceeded");
+        iterator xpos = begin() + (pos - begin());
+        if(xpos == end()){
+            emplace_back(hxqstl::forward<Args>(args)...);
+            return xpos;
+        }
+        value_type tmp(hxqstl::forward<Args>(args)...);
+        hxqstl::construct(ptr() + size_,hxqstl::move(ptr()[size_ - 1]));
+        ++size_;
+        hxqstl::move_backward(xpos,end() - 2,end() - 1);
+        *xpos = hxqstl::move(tmp);
+        return xpos;
+    }
+
+    template<class T,size_t N>
+    constexpr typename static_vector<T,N>::iterator
+    static_vector<T,N>::erase(const_iterator first,const_iterator last){
+        MYSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
+        iterator xfirst = begin() + (first - begin());
+        iterator xlast = begin() + (last - begin());
+        if(xfirst == xlast) return xfirst;     // 避免元素自我移动赋值
+        iterator new_end = hxqstl::move(xlast,end(),xfirst);
+        hxqstl::destroy(new_end,end());
+        size_ -= static_cast<size_type>(xlast - xfirst);
+        return xfirst;
+    }
+
+    // 内联存储无法交换指针，只能逐个交换元素
+    template<class T,size_t N>
+    constexpr void static_vector<T,N>::swap(static_vector& rhs){
+        if(this == &rhs) return;
+        static_vector& small = size_ < rhs.size_ ? *this : rhs;
+        static_vector& large = size_ < rhs.size_ ? rhs : *this;
+        const size_type common = small.size_;
+        hxqstl::swap_range(small.ptr(),small.ptr() + common,large.ptr());
+        for(size_type i = common;i < large.size_;++i){
+            hxqstl::construct(small.ptr() + i,hxqstl::move(large.ptr()[i]));
+        }
+        hxqstl::destroy(large.ptr() + common,large.ptr() + large.size_);
+        small.size_ = large.size_;
+        large.size_ = common;
+    }
+
+    template<class T,size_t N>
+    constexpr bool operator==(const static_vector<T,N>& lhs,const static_vector<T,N>& rhs)
+    {
+        return lhs.size() == rhs.size() && hxqstl::equal(lhs.begin(),lhs.end(),rhs.begin());
+    }
+
+    template<class T,size_t N>
+    constexpr bool operator!=(const static_vector<T,N>& lhs,const static_vector<T,N>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template<class T,size_t N>
+    constexpr bool operator<(const static_vector<T,N>& lhs,const static_vector<T,N>& rhs)
+    {
+        return hxqstl::lexicographical_compare(lhs.begin(),lhs.end(),rhs.begin(),rhs.end());
+    }
+
+    template<class T,size_t N>
+    constexpr void swap(static_vector<T,N>& lhs,static_vector<T,N>& rhs)
+    {
+        lhs.swap(rhs);
+    }
+}
@@ -0,0 +1,582 @@
+#pragma once
+
+// basic_string_view
+// 不拥有内存的字符串视图：一个指针加一个长度，复制和取子串都是 O(1)，解析时不必复制子串
+// 视图不管理所引用字符的生命周期，原字符串销毁或重新分配后视图失效
+//
+// char_traits<char> 的查找和比较用 SSE2 一次处理 16 个字节，没有 SSE2 时退回 memchr 和 8 字节一组的比较：
+//   find(ch)          按组比较后取 movemask 的最低位
+//   find(str)         首尾两个字符同时匹配的位置才是候选，再比较中间部分
+//   find_first_of     字符集不超过 16 个字符时按组比较，否则查 256 位的表
+//   compare           按组找到第一个不同的字节
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HXQSTL_STRING_SSE2 1
+#endif
+
+#include "algobase.h"
+#include "bitops.h"
+#include "functional.h"
+#include "iterator.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace hxqstl{
+    namespace strops{
+        constexpr size_t npos = static_cast<size_t>(-1);
+
+        // 让参数不参与模板推导，比较运算符两侧可以一边是视图、一边是能转换成视图的类型
+        template<class T>
+        struct identity {typedef T type;};
+
+#ifdef HXQSTL_STRING_SSE2
+        inline __m128i load16(const char* p) noexcept
+        { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+
+        inline unsigned match16(const char* p,__m128i c) noexcept
+        { return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(load16(p),c))); }
+#endif
+
+        // [s,s+n) 中第一个 c 的位置，找不到时返回 nullptr
+        inline const char* find_char(const char* s,size_t n,char c) noexcept{
+#ifdef HXQSTL_STRING_SSE2
+            const __m128i vc = _mm_set1_epi8(c);
+            size_t i = 0;
+            for(;i + 16 <= n;i += 16){
+                const unsigned m = match16(s + i,vc);
+                if(m != 0) return s + i + bits::countr_zero(m);
+            }
+            for(;i < n;++i){
+                if(s[i] == c) return s + i;
+            }
+            return nullptr;
+#else
+            return n == 0 ? nullptr : static_cast<const char*>(std::memchr(s,c,n));
+#endif
+        }
+
+        // 第一个不同字节的下标，全部相同时返回 n
+        inline size_t mismatch(const char* a,const char* b,size_t n) noexcept{
+            size_t i = 0;
+#ifdef HXQSTL_STRING_SSE2
+            for(;i + 16 <= n;i += 16){
+                const unsigned m = 0xffffu ^ static_cast<unsigned>(
+                    _mm_movemask_epi8(_mm_cmpeq_epi8(load16(a + i),load16(b + i))));
+                if(m != 0) return i + bits::countr_zero(m);
+            }
+#else
+            for(;i + 8 <= n;i += 8){
+                uint64_t x,y;
+                std::memcpy(&x,a + i,8);
+                std::memcpy(&y,b + i,8);
+                if(x != y) break;
+            }
+#endif
+            while(i < n && a[i] == b[i]) ++i;
+            return i;
+        }
+
+        // 按 unsigned char 比较
+        inline int compare(const char* a,const char* b,size_t n) noexcept{
+            const size_t i = mismatch(a,b,n);
+            if(i == n) return 0;
+            return static_cast<unsigned char>(a[i]) < static_cast<unsigned char>(b[i]) ? -1 : 1;
+        }
+
+        // 256 位的字符集合
+        struct char_set
+        {
+            uint64_t w[4];
+
+            char_set(const char* set,size_t m) noexcept : w{0,0,0,0}
+            {
+                for(size_t i = 0;i < m;++i){
+                    const unsigned char c = static_cast<unsigned char>(set[i]);
+                    w[c >> 6] |= uint64_t(1) << (c & 63);
+                }
+            }
+
+            bool test(char ch) const noexcept
+            {
+                const unsigned char c = static_cast<unsigned char>(ch);
+                return ((w[c >> 6] >> (c & 63)) & 1) != 0;
+            }
+        };
+
+        // 从 pos 向后第一个属于(in 为 true)或不属于集合的字符
+        inline size_t find_first_of(const char* s,size_t n,const char* set,size_t m,
+                                    size_t pos,bool in) noexcept{
+            if(pos >= n) return npos;
+            if(in && m == 1){
+                const char* p = find_char(s + pos,n - pos,set[0]);
+                return p == nullptr ? npos : static_cast<size_t>(p - s);
+            }
+#ifdef HXQSTL_STRING_SSE2
+            if(m <= 16){
+                __m128i vs[16];
+                for(size_t j = 0;j < m;++j) vs[j] = _mm_set1_epi8(set[j]);
+                size_t i = pos;
+                for(;i + 16 <= n;i += 16){
+                    const __m128i blk = load16(s + i);
+                    __m128i hit = _mm_setzero_si128();
+                    for(size_t j = 0;j < m;++j){
+                        hit = _mm_or_si128(hit,_mm_cmpeq_epi8(blk,vs[j]));
+                    }
+                    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+                    if(!in) mask ^= 0xffffu;
+                    if(mask != 0) return i + bits::countr_zero(mask);
+                }
+                for(;i < n;++i){
+                    const bool hit = m != 0 && std::memchr(set,s[i],m) != nullptr;
+                    if(hit == in) return i;
+                }
+                return npos;
+            }
+#endif
+            const char_set cs(set,m);
+            for(size_t i = pos;i < n;++i){
+                if(cs.test(s[i]) == in) return i;
+            }
+            return npos;
+        }
+
+        // 从 pos 向前第一个属于或不属于集合的字符
+        inline size_t find_last_of(const char* s,size_t n,const char* set,size_t m,
+                                   size_t pos,bool in) noexcept{
+            if(n == 0) return npos;
+            const char_set cs(set,m);
+            for(size_t i = hxqstl::min(pos,n - 1) + 1;i-- > 0;){
+                if(cs.test(s[i]) == in) return i;
+            }
+            return npos;
+        }
+
+        // 子串查找
+        inline size_t find(const char* h,size_t n,const char* s,size_t m,size_t pos) noexcept{
+            if(m == 0) return pos <= n ? pos : npos;
+            if(m > n || pos > n - m) return npos;
+            if(m == 1){
+                const char* p = find_char(h + pos,n - pos,s[0]);
+                return p == nullptr ? npos : static_cast<size_t>(p - h);
+            }
+            const char first = s[0];
+            const char last = s[m - 1];
+            const size_t limit = n - m;     // 最后一个候选位置
+            size_t i = pos;
+#ifdef HXQSTL_STRING_SSE2
+            // 一次检查 16 个候选位置，两次读取都不会越过 h + n
+            const __m128i vf = _mm_set1_epi8(first);
+            const __m128i vl = _mm_set1_epi8(last);
+            for(;i + 15 <= limit;i += 16){
+                unsigned mask = match16(h + i,vf) & match16(h + i + m - 1,vl);
+                while(mask != 0){
+                    const size_t k = i + bits::countr_zero(mask);
+                    if(std::memcmp(h + k + 1,s + 1,m - 2) == 0) return k;
+                    mask &= mask - 1;
+                }
+            }
+#endif
+            while(i <= limit){
+                const char* p = find_char(h + i,limit - i + 1,first);
+                if(p == nullptr) return npos;
+                i = static_cast<size_t>(p - h);
+                if(h[i + m - 1] == last && std::memcmp(h + i + 1,s + 1,m - 2) == 0) return i;
+                ++i;
+            }
+            return npos;
+        }
+
+        // 通用版本，用于 char 以外的字符类型
+        template<class Traits,class CharT>
+        size_t generic_find(const CharT* h,size_t n,const CharT* s,size_t m,size_t pos) noexcept{
+            if(m == 0) return pos <= n ? pos : npos;
+            if(m > n || pos > n - m) return npos;
+            const size_t limit = n - m;
+            for(size_t i = pos;i <= limit;++i){
+                const CharT* p = Traits::find(h + i,limit - i + 1,s[0]);
+                if(p == nullptr) return npos;
+                i = static_cast<size_t>(p - h);
+                if(Traits::compare(h + i + 1,s + 1,m - 1) == 0) return i;
+            }
+            return npos;
+        }
+
+        template<class Traits,class CharT>
+        size_t generic_find_first_of(const CharT* s,size_t n,const CharT* set,size_t m,
+                                     size_t pos,bool in) noexcept{
+            for(size_t i = pos;i < n;++i){
+                if((Traits::find(set,m,s[i]) != nullptr) == in) return i;
+            }
+            return npos;
+        }
+
+        template<class Traits,class CharT>
+        size_t generic_find_last_of(const CharT* s,size_t n,const CharT* set,size_t m,
+                                    size_t pos,bool in) noexcept{
+            if(n == 0) return npos;
+            for(size_t i = hxqstl::min(pos,n - 1) + 1;i-- > 0;){
+                if((Traits::find(set,m,s[i]) != nullptr) == in) return i;
+            }
+            return npos;
+        }
+
+        // 按 8 字节一组混合，给 hash<string> 使用；容器还会再混合一次
+        inline size_t hash_bytes(const void* p,size_t n) noexcept{
+            const unsigned char* s = static_cast<const unsigned char*>(p);
+            const uint64_t k = 0x9e3779b97f4a7c15ULL;
+            uint64_t h = n * k;
+            for(;n >= 8;s += 8,n -= 8){
+                uint64_t w;
+                std::memcpy(&w,s,8);
+                h = (h ^ (w * k));
+                h = ((h << 31) | (h >> 33)) * k;
+            }
+            if(n != 0){
+                uint64_t w = 0;
+                std::memcpy(&w,s,n);
+                h = (h ^ (w * k));
+                h = ((h << 31) | (h >> 33)) * k;
+            }
+            return static_cast<size_t>(h ^ (h >> 32));
+        }
+    }
+
+    /*****************************************************************************************/
+    // char_traits
+    // 字符的比较、查找和复制，只支持平凡的字符类型
+
+    template<class CharT>
+    struct char_traits
+    {
+        typedef CharT char_type;
+
+        static constexpr bool eq(char_type a,char_type b) noexcept {return a == b;}
+        static constexpr bool lt(char_type a,char_type b) noexcept {return a < b;}
+
+        static size_t length(const char_type* s) noexcept
+        {
+            size_t n = 0;
+            while(!eq(s[n],char_type())) ++n;
+            return n;
+        }
+
+        static int compare(const char_type* a,const char_type* b,size_t n) noexcept
+        {
+            for(size_t i = 0;i < n;++i){
+                if(lt(a[i],b[i])) return -1;
+                if(lt(b[i],a[i])) return 1;
+            }
+            return 0;
+        }
+
+        // 找不到时返回 nullptr
+        static const char_type* find(const char_type* s,size_t n,char_type c) noexcept
+        {
+            for(size_t i = 0;i < n;++i){
+                if(eq(s[i],c)) return s + i;
+            }
+            return nullptr;
+        }
+
+        static char_type* copy(char_type* dst,const char_type* src,size_t n) noexcept
+        {
+            if(n != 0) std::memcpy(dst,src,n * sizeof(char_type));
+            return dst;
+        }
+
+        static char_type* move(char_type* dst,const char_type* src,size_t n) noexcept
+        {
+            if(n != 0) std::memmove(dst,src,n * sizeof(char_type));
+            return dst;
+        }
+
+        static char_type* assign(char_type* dst,size_t n,char_type c) noexcept
+        {
+            for(size_t i = 0;i < n;++i) dst[i] = c;
+            return dst;
+        }
+    };
+
+    template<>
+    struct char_traits<char>
+    {
+        typedef char char_type;
+
+        static constexpr bool eq(char a,char b) noexcept {return a == b;}
+        static constexpr bool lt(char a,char b) noexcept
+        { return static_cast<unsigned char>(a) < static_cast<unsigned char>(b); }
+
+        static size_t length(const char* s) noexcept {return std::strlen(s);}
+
+        static int compare(const char* a,const char* b,size_t n) noexcept
+        { return strops::compare(a,b,n); }
+
+        static const char* find(const char* s,size_t n,char c) noexcept
+        { return strops::find_char(s,n,c); }
+
+        static char* copy(char* dst,const char* src,size_t n) noexcept
+        {
+            if(n != 0) std::memcpy(dst,src,n);
+            return dst;
+        }
+
+        static char* move(char* dst,const char* src,size_t n) noexcept
+        {
+            if(n != 0) std::memmove(dst,src,n);
+            return dst;
+        }
+
+        static char* assign(char* dst,size_t n,char c) noexcept
+        {
+            if(n != 0) std::memset(dst,static_cast<unsigned char>(c),n);
+            return dst;
+        }
+    };
+
+    /*****************************************************************************************/
+
+    template<class CharT,class Traits = char_traits<CharT>>
+    class basic_string_view{
+        public:
+            typedef Traits traits_type;
+            typedef CharT value_type;
+            typedef const CharT* pointer;
+            typedef const CharT* const_pointer;
+            typedef const CharT& reference;
+            typedef const CharT& const_reference;
+            typedef size_t size_type;
+            typedef ptrdiff_t difference_type;
+
+            typedef const CharT* iterator;
+            typedef const CharT* const_iterator;
+            typedef hxqstl::reverse_iterator<const_iterator> reverse_iterator;
+            typedef hxqstl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+            static constexpr size_type npos = static_cast<size_type>(-1);
+
+        private:
+            const CharT* data_;
+            size_type size_;
+
+            // 标准 char_traits<char> 才走 strops 中的加速版本，自定义 traits 按 traits 的语义逐个比较
+            typedef std::integral_constant<bool,
+                std::is_same<Traits,char_traits<char>>::value> fast_search;
+
+        public:
+            constexpr basic_string_view() noexcept : data_(nullptr),size_(0) {}
+            constexpr basic_string_view(const CharT* s,size_type n) noexcept : data_(s),size_(n) {}
+            basic_string_view(const CharT* s) : data_(s),size_(traits_type::length(s)) {}
+
+            basic_string_view(const basic_string_view&) noexcept = default;
+            basic_string_view& operator=(const basic_string_view&) noexcept = default;
+
+        public:
+            constexpr const_iterator begin() const noexcept {return data_;}
+            constexpr const_iterator end() const noexcept {return data_ + size_;}
+            constexpr const_iterator cbegin() const noexcept {return data_;}
+            constexpr const_iterator cend() const noexcept {return data_ + size_;}
+            const_reverse_iterator rbegin() const noexcept {return const_reverse_iterator(end());}
+            const_reverse_iterator rend() const noexcept {return const_reverse_iterator(begin());}
+
+            constexpr size_type size() const noexcept {return size_;}
+            constexpr size_type length() const noexcept {return size_;}
+            constexpr bool empty() const noexcept {return size_ == 0;}
+            constexpr size_type max_size() const noexcept {return static_cast<size_type>(-1) / sizeof(CharT);}
+
+            const_reference operator[](size_type n) const
+            {
+                MYSTL_DEBUG(n < size_);
+                return data_[n];
+            }
+            const_reference at(size_type n) const
+            {
+                THROW_OUT_OF_RANGE_IF(n >= size_,"basic_string_view::at() subscript out of range");
+                return data_[n];
+            }
+            const_reference front() const {MYSTL_DEBUG(!empty()); return data_[0];}
+            const_reference back() const {MYSTL_DEBUG(!empty()); return data_[size_ - 1];}
+            constexpr const_pointer data() const noexcept {return data_;}
+
+            void remove_prefix(size_type n)
+            {
+                MYSTL_DEBUG(n <= size_);
+                data_ += n;
+                size_ -= n;
+            }
+            void remove_suffix(size_type n)
+            {
+                MYSTL_DEBUG(n <= size_);
+                size_ -= n;
+            }
+
+            void swap(basic_string_view& rhs) noexcept
+            {
+                hxqstl::swap(data_,rhs.data_);
+                hxqstl::swap(size_,rhs.size_);
+            }
+
+            size_type copy(CharT* dst,size_type count,size_type pos = 0) const
+            {
+                THROW_OUT_OF_RANGE_IF(pos > size_,"basic_string_view::copy() pos out of range");
+                const size_type n = hxqstl::min(count,size_ - pos);
+                traits_type::copy(dst,data_ + pos,n);
+                return n;
+            }
+
+            basic_string_view substr(size_type pos = 0,size_type count = npos) const
+            {
+                THROW_OUT_OF_RANGE_IF(pos > size_,"basic_string_view::substr() pos out of range");
+                return basic_string_view(data_ + pos,hxqstl::min(count,size_ - pos));
+            }
+
+            int compare(basic_string_view v) const noexcept
+            {
+                const int r = traits_type::compare(data_,v.data_,hxqstl::min(size_,v.size_));
+                if(r != 0) return r;
+                return size_ < v.size_ ? -1 : (size_ > v.size_ ? 1 : 0);
+            }
+            int compare(size_type pos1,size_type n1,basic_string_view v) const
+            { return substr(pos1,n1).compare(v); }
+            int compare(size_type pos1,size_type n1,basic_string_view v,size_type pos2,size_type n2) const
+            { return substr(pos1,n1).compare(v.substr(pos2,n2)); }
+
+            bool starts_with(basic_string_view v) const noexcept
+            { return size_ >= v.size_ && traits_type::compare(data_,v.data_,v.size_) == 0; }
+            bool starts_with(CharT ch) const noexcept
+            { return !empty() && traits_type::eq(data_[0],ch); }
+            bool ends_with(basic_string_view v) const noexcept
+            { return size_ >= v.size_ && traits_type::compare(data_ + size_ - v.size_,v.data_,v.size_) == 0; }
+            bool ends_with(CharT ch) const noexcept
+            { return !empty() && traits_type::eq(data_[size_ - 1],ch); }
+
+            // 查找，找不到时返回 npos
+            size_type find(basic_string_view v,size_type pos = 0) const noexcept
+            { return find(v.data_,pos,v.size_); }
+            size_type find(CharT ch,size_type pos = 0) const noexcept
+            {
+                if(pos >= size_) return npos;
+                const CharT* p = traits_type::find(data_ + pos,size_ - pos,ch);
+                return p == nullptr ? npos : static_cast<size_type>(p - data_);
+            }
+            size_type find(const CharT* s,size_type pos,size_type n) const noexcept
+            { return find_dispatch(s,pos,n,fast_search{}); }
+
+            size_type rfind(basic_string_view v,size_type pos = npos) const noexcept
+            { return rfind(v.data_,pos,v.size_); }
+            size_type rfind(CharT ch,size_type pos = npos) const noexcept
+            {
+                if(size_ == 0) return npos;
+                for(size_type i = hxqstl::min(pos,size_ - 1) + 1;i-- > 0;){
+                    if(traits_type::eq(data_[i],ch)) return i;
+                }
+                return npos;
+            }
+            size_type rfind(const CharT* s,size_type pos,size_type n) const noexcept;
+
+            size_type find_first_of(basic_string_view v,size_type pos = 0) const noexcept
+            { return find_first_of(v.data_,pos,v.size_); }
+            size_type find_first_of(CharT ch,size_type pos = 0) const noexcept
+            { return find(ch,pos); }
+            size_type find_first_of(const CharT* s,size_type pos,size_type n) const noexcept
+            { return first_of_dispatch(s,pos,n,true,fast_search{}); }
+
+            size_type find_first_not_of(basic_string_view v,size_type pos = 0) const noexcept
+            { return find_first_not_of(v.data_,pos,v.size_); }
+            size_type find_first_not_of(CharT ch,size_type pos = 0) const noexcept
+            { return find_first_not_of(&ch,pos,1); }
+            size_type find_first_not_of(const CharT* s,size_type pos,size_type n) const noexcept
+            { return first_of_dispatch(s,pos,n,false,fast_search{}); }
+
+            size_type find_last_of(basic_string_view v,size_type pos = npos) const noexcept
+            { return find_last_of(v.data_,pos,v.size_); }
+            size_type find_last_of(CharT ch,size_type pos = npos) const noexcept
+            { return rfind(ch,pos); }
+            size_type find_last_of(const CharT* s,size_type pos,size_type n) const noexcept
+            { return last_of_dispatch(s,pos,n,true,fast_search{}); }
+
+            size_type find_last_not_of(basic_string_view v,size_type pos = npos) const noexcept
+            { return find_last_not_of(v.data_,pos,v.size_); }
+            size_type find_last_not_of(CharT ch,size_type pos = npos) const noexcept
+            { return find_last_not_of(&ch,pos,1); }
+            size_type find_last_not_of(const CharT* s,size_type pos,size_type n) const noexcept
+            { return last_of_dispatch(s,pos,n,false,fast_search{}); }
+
+        private:
+            size_type find_dispatch(const CharT* s,size_type pos,size_type n,std::true_type) const noexcept
+            { return strops::find(data_,size_,s,n,pos); }
+            size_type find_dispatch(const CharT* s,size_type pos,size_type n,std::false_type) const noexcept
+            { return strops::generic_find<Traits>(data_,size_,s,n,pos); }
+
+            size_type first_of_dispatch(const CharT* s,size_type pos,size_type n,bool in,std::true_type) const noexcept
+            { return strops::find_first_of(data_,size_,s,n,pos,in); }
+            size_type first_of_dispatch(const CharT* s,size_type pos,size_type n,bool in,std::false_type) const noexcept
+            { return strops::generic_find_first_of<Traits>(data_,size_,s,n,pos,in); }
+
+            size_type last_of_dispatch(const CharT* s,size_type pos,size_type n,bool in,std::true_type) const noexcept
+            { return strops::find_last_of(data_,size_,s,n,pos,in); }
+            size_type last_of_dispatch(const CharT* s,size_type pos,size_type n,bool in,std::false_type) const noexcept
+            { return strops::generic_find_last_of<Traits>(data_,size_,s,n,pos,in); }
+    };
+
+    template<class CharT,class Traits>
+    constexpr typename basic_string_view<CharT,Traits>::size_type basic_string_view<CharT,Traits>::npos;
+
+    template<class CharT,class Traits>
+    typename basic_string_view<CharT,Traits>::size_type
+    basic_string_view<CharT,Traits>::rfind(const CharT* s,size_type pos,size_type n) const noexcept{
+        if(n > size_) return npos;
+        for(size_type i = hxqstl::min(pos,size_ - n) + 1;i-- > 0;){
+            if(traits_type::compare(data_ + i,s,n) == 0) return i;
+        }
+        return npos;
+    }
+
+    // 比较运算符：两侧都是视图，或者一侧是能隐式转换成视图的类型(字符串字面量、basic_string)
+    #define HXQSTL_STRING_VIEW_COMPARE(OP,EXPR)                                                     \
+    template<class CharT,class Traits>                                                              \
+    bool operator OP(basic_string_view<CharT,Traits> lhs,basic_string_view<CharT,Traits> rhs) noexcept \
+    { return EXPR; }                                                                                \
+    template<class CharT,class Traits>                                                              \
+    bool operator OP(basic_string_view<CharT,Traits> lhs,                                           \
+        typename strops::identity<basic_string_view<CharT,Traits>>::type rhs) noexcept              \
+    { return EXPR; }                                                                                \
+    template<class CharT,class Traits>                                                              \
+    bool operator OP(typename strops::identity<basic_string_view<CharT,Traits>>::type lhs,          \
+        basic_string_view<CharT,Traits> rhs) noexcept                                               \
+    { return EXPR; }
+
+    HXQSTL_STRING_VIEW_COMPARE(==,lhs.size() == rhs.size() && lhs.compare(rhs) == 0)
+    HXQSTL_STRING_VIEW_COMPARE(!=,!(lhs.size() == rhs.size() && lhs.compare(rhs) == 0))
+    HXQSTL_STRING_VIEW_COMPARE(<,lhs.compare(rhs) < 0)
+    HXQSTL_STRING_VIEW_COMPARE(>,lhs.compare(rhs) > 0)
+    HXQSTL_STRING_VIEW_COMPARE(<=,lhs.compare(rhs) <= 0)
+    HXQSTL_STRING_VIEW_COMPARE(>=,lhs.compare(rhs) >= 0)
+
+    #undef HXQSTL_STRING_VIEW_COMPARE
+
+    template<class CharT,class Traits>
+    void swap(basic_string_view<CharT,Traits>& lhs,basic_string_view<CharT,Traits>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    template<class CharT,class Traits>
+    struct hash<basic_string_view<CharT,Traits>>
+    {
+        size_t operator()(basic_string_view<CharT,Traits> s) const noexcept
+        {
+            return strops::hash_bytes(s.data(),s.size() * sizeof(CharT));
+        }
+    };
+
+    typedef basic_string_view<char> string_view;
+    typedef basic_string_view<wchar_t> wstring_view;
+    typedef basic_string_view<char16_t> u16string_view;
+    typedef basic_string_view<char32_t> u32string_view;
+}
@@ -0,0 +1,113 @@
+// btree_map / btree_set 的独立检查，以 std::map / std::set 为参照
+// g++ -std=c++14 -I.. -fsanitize=address,undefined btree_test.cpp && ./a.out
+
+#include <cassert>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+
+#include "btree_map.h"
+#include "btree_set.h"
+
+namespace{
+    // 与参照容器逐个比较内容和顺序
+    template<class Map,class Ref>
+    void check_same(const Map& m,const Ref& ref){
+        assert(m.size() == ref.size());
+        auto r = ref.begin();
+        for(auto it = m.begin();it != m.end();++it,++r){
+            assert(it.key() == r->first && it.value() == r->second);
+        }
+        assert(r == ref.end());
+    }
+
+    // 随机插入、删除和边界查找；int 键走节点内的线性计数
+    void test_int_keys_against_std_map(){
+        std::mt19937 rng(12345);
+        hxqstl::btree_map<int,int> m;
+        std::map<int,int> ref;
+        for(int step = 0;step < 200000;++step){
+            const int k = static_cast<int>(rng() % 20000);
+            switch(rng() % 4){
+                case 0:
+                case 1:
+                    assert(m.insert(hxqstl::pair<int,int>(k,step)).second ==
+                           ref.insert(std::make_pair(k,step)).second);
+                    break;
+                case 2:
+                    assert(m.erase(k) == ref.erase(k));
+                    break;
+                default:{
+                    auto lb = m.lower_bound(k);
+                    auto rlb = ref.lower_bound(k);
+                    assert((lb == m.end()) == (rlb == ref.end()));
+                    if(rlb != ref.end()) assert(lb.key() == rlb->first && lb.value() == rlb->second);
+                    auto ub = m.upper_bound(k);
+                    auto rub = ref.upper_bound(k);
+                    assert((ub == m.end()) == (rub == ref.end()));
+                    if(rub != ref.end()) assert(ub.key() == rub->first);
+                    break;
+                }
+            }
+        }
+        check_same(m,ref);
+        // 区间删除
+        auto first = m.lower_bound(5000);
+        auto last = m.lower_bound(15000);
+        m.erase(first,last);
+        ref.erase(ref.lower_bound(5000),ref.lower_bound(15000));
+        check_same(m,ref);
+    }
+
+    // 字符串键走 branchless_lower_bound
+    void test_string_keys(){
+        std::mt19937 rng(777);
+        hxqstl::btree_map<std::string,int> m;
+        std::map<std::string,int> ref;
+        for(int step = 0;step < 50000;++step){
+            const std::string k = "key_" + std::to_string(rng() % 8000);
+            if(rng() % 3 != 0){
+                m.insert_or_assign(k,step);
+                ref[k] = step;
+            }
+            else{
+                assert(m.erase(k) == ref.erase(k));
+            }
+        }
+        check_same(m,ref);
+        for(auto& kv : ref) assert(m.at(kv.first) == kv.second);
+    }
+
+    void test_bulk_load_and_set(){
+        hxqstl::vector<hxqstl::pair<int,int>> sorted;
+        for(int i = 0;i < 100000;++i) sorted.emplace_back(i * 3,i);
+        hxqstl::btree_map<int,int> m;
+        m.bulk_load(sorted);
+        assert(m.size() == sorted.size());
+        for(int i = 0;i < 100000;i += 97) assert(m.find(i * 3).value() == i && !m.contains(i * 3 + 1));
+        m.insert(hxqstl::pair<int,int>(1,-1));
+        assert(m.begin().key() == 0 && (++m.begin()).key() == 1);
+
+        std::mt19937 rng(99);
+        hxqstl::btree_set<int> s;
+        std::set<int> rs;
+        for(int i = 0;i < 50000;++i){
+            const int k = static_cast<int>(rng() % 10000);
+            if(rng() % 3 != 0) {s.insert(k);rs.insert(k);}
+            else assert(s.erase(k) == rs.erase(k));
+        }
+        assert(s.size() == rs.size());
+        auto r = rs.begin();
+        for(auto it = s.begin();it != s.end();++it,++r) assert(*it == *r);
+    }
+}
+
+int main(){
+    test_int_keys_against_std_map();
+    test_string_keys();
+    test_bulk_load_and_set();
+    std::puts("btree_test ok");
+    return 0;
+}
@@ -0,0 +1,94 @@
+// concurrent_hash_map 的独立检查
+// g++ -std=c++14 -I.. -pthread -fsanitize=thread concurrent_hash_map_test.cpp && ./a.out
+
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "concurrent_hash_map.h"
+
+namespace{
+    // 多个线程插入互不相交的键，同时有线程读取：插入的元素全部可见，读到的值总是完整的
+    void test_parallel_insert_and_find(){
+        const int writers = 4,per = 20000;
+        hxqstl::concurrent_hash_map<int,std::string> m;
+        std::atomic<bool> done(false);
+        std::vector<std::thread> ts;
+        for(int w = 0;w < writers;++w){
+            ts.emplace_back([&,w]{
+                for(int i = 0;i < per;++i){
+                    const int k = w * per + i;
+                    assert(m.insert(hxqstl::pair<int,std::string>(k,"value_" + std::to_string(k))));
+                }
+            });
+        }
+        std::thread reader([&]{
+            std::string out;
+            while(!done.load()){
+                for(int k = 0;k < writers * per;k += 101){
+                    if(m.find(k,out)) assert(out == "value_" + std::to_string(k));
+                }
+            }
+        });
+        for(auto& t : ts) t.join();
+        done = true;
+        reader.join();
+
+        assert(m.size() == static_cast<size_t>(writers * per));
+        std::string out;
+        for(int k = 0;k < writers * per;++k){
+            assert(m.find(k,out) && out == "value_" + std::to_string(k));
+        }
+    }
+
+    // 写锁下的 visit 互斥：并发自增不丢失
+    void test_exclusive_visit(){
+        const int threads = 8,per = 20000,keys = 16;
+        hxqstl::concurrent_hash_map<int,long> m;
+        for(int k = 0;k < keys;++k) m.try_emplace(k,0L);
+        std::vector<std::thread> ts;
+        for(int t = 0;t < threads;++t){
+            ts.emplace_back([&,t]{
+                for(int i = 0;i < per;++i){
+                    m.visit((t + i) % keys,[](hxqstl::pair<const int,long>& v){++v.second;});
+                }
+            });
+        }
+        for(auto& t : ts) t.join();
+        long total = 0;
+        m.visit_all([&](const hxqstl::pair<const int,long>& v){total += v.second;});
+        assert(total == static_cast<long>(threads) * per);
+    }
+
+    // 并发插入和删除同一批键后，计数与单线程推演一致
+    void test_insert_erase(){
+        const int threads = 4,per = 10000;
+        hxqstl::concurrent_hash_map<int,int> m(16);
+        std::vector<std::thread> ts;
+        for(int t = 0;t < threads;++t){
+            ts.emplace_back([&,t]{
+                for(int i = 0;i < per;++i){
+                    const int k = t * per + i;
+                    m.insert_or_assign(k,k);
+                    if(k % 2 == 0) assert(m.erase(k) == 1);
+                }
+            });
+        }
+        for(auto& t : ts) t.join();
+        assert(m.size() == static_cast<size_t>(threads * per / 2));
+        assert(!m.contains(0) && m.contains(1));
+        m.clear();
+        assert(m.empty());
+    }
+}
+
+int main(){
+    test_parallel_insert_and_find();
+    test_exclusive_visit();
+    test_insert_erase();
+    std::puts("concurrent_hash_map_test ok");
+    return 0;
+}
@@ -0,0 +1,128 @@
+// spsc_queue / mpmc_queue 的独立检查
+// g++ -std=c++14 -I.. -pthread -fsanitize=address,undefined concurrent_queue_test.cpp && ./a.out
+
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "concurrent_queue.h"
+
+namespace{
+    // 第 budget 次赋值时抛出的输出迭代器
+    struct throwing_output
+    {
+        std::vector<std::string>* out;
+        int* budget;
+
+        throwing_output& operator*() {return *this;}
+        throwing_output& operator++() {return *this;}
+        throwing_output& operator=(std::string&& s)
+        {
+            if((*budget)-- == 0) throw 42;
+            out->push_back(hxqstl::move(s));
+            return *this;
+        }
+    };
+
+    std::string item(int i){
+        return "queued_string_long_enough_to_heap_" + std::to_string(i);
+    }
+
+    // 写入 result 中途抛出：已取出的元素出队，失败的元素留在队首，不会被重复析构
+    void test_spsc_pop_n_throws(){
+        hxqstl::spsc_queue<std::string> q(16);
+        for(int i = 0;i < 10;++i) assert(q.try_push(item(i)));
+        std::vector<std::string> out;
+        int budget = 3;
+        try{
+            q.try_pop_n(throwing_output{&out,&budget},10);
+            assert(false);
+        }
+        catch(int){}
+        assert(out.size() == 3 && q.size() == 7);
+        std::string s;
+        assert(q.try_pop(s) && s == item(3));
+        for(int i = 4;i < 10;++i){
+            assert(q.try_pop(s) && s == item(i));
+        }
+        assert(q.empty());
+    }
+
+    void test_mpmc_pop_n_throws(){
+        hxqstl::mpmc_queue<std::string> q(16);
+        for(int i = 0;i < 10;++i) assert(q.try_push(item(i)));
+        std::vector<std::string> out;
+        int budget = 3;
+        try{
+            q.try_pop_n(throwing_output{&out,&budget},10);
+            assert(false);
+        }
+        catch(int){}
+        assert(out.size() == 3);
+    }
+
+    // 单生产者单消费者：元素不丢失、不重复且保持顺序
+    void test_spsc_threads(){
+        const int n = 200000;
+        hxqstl::spsc_queue<int> q(1024);
+        std::thread producer([&]{
+            for(int i = 0;i < n;){
+                if(q.try_push(i)) ++i;
+            }
+        });
+        int expect = 0;
+        while(expect < n){
+            int v;
+            if(q.try_pop(v)){
+                assert(v == expect);
+                ++expect;
+            }
+        }
+        producer.join();
+        assert(q.empty());
+    }
+
+    // 多生产者多消费者：所有元素恰好被取出一次
+    void test_mpmc_threads(){
+        const int producers = 4,consumers = 4,per = 50000;
+        hxqstl::mpmc_queue<int> q(1024);
+        std::atomic<long long> sum(0);
+        std::atomic<int> popped(0);
+        std::vector<std::thread> ts;
+        for(int p = 0;p < producers;++p){
+            ts.emplace_back([&,p]{
+                for(int i = 0;i < per;){
+                    if(q.try_push(p * per + i + 1)) ++i;
+                }
+            });
+        }
+        for(int c = 0;c < consumers;++c){
+            ts.emplace_back([&]{
+                int buf[32];
+                while(popped.load() < producers * per){
+                    const size_t got = q.try_pop_n(buf,32);
+                    for(size_t i = 0;i < got;++i) sum += buf[i];
+                    popped += static_cast<int>(got);
+                }
+            });
+        }
+        for(auto& t : ts) t.join();
+        const long long total = static_cast<long long>(producers) * per;
+        assert(popped.load() == total);
+        assert(sum.load() == total * (total + 1) / 2);
+    }
+}
+
+int main(){
+    // 下标和序号都是 size_t 原子量，必须无锁
+    assert(std::atomic<size_t>().is_lock_free());
+    test_spsc_pop_n_throws();
+    test_mpmc_pop_n_throws();
+    test_spsc_threads();
+    test_mpmc_threads();
+    std::puts("concurrent_queue_test ok");
+    return 0;
+}
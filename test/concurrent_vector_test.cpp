@@ -0,0 +1,86 @@
+// concurrent_vector 的独立检查
+// g++ -std=c++14 -I.. -pthread -fsanitize=address,undefined concurrent_vector_test.cpp && ./a.out
+
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "concurrent_vector.h"
+
+namespace{
+    // 拷贝到第 budget 次时抛出，live 统计存活的对象
+    struct tracked
+    {
+        std::string s;
+        static int budget;
+        static std::atomic<int> live;
+
+        explicit tracked(int i) : s("tracked_value_long_enough_to_heap_" + std::to_string(i)) {++live;}
+        tracked(const tracked& rhs) : s(rhs.s)
+        {
+            if(budget >= 0 && budget-- == 0) throw 42;
+            ++live;
+        }
+        ~tracked() {--live;}
+    };
+    int tracked::budget = -1;
+    std::atomic<int> tracked::live(0);
+
+    // grow_by 和 emplace_back 中途失败：损坏的区间被跳过，其余元素各析构一次
+    void test_broken_ranges(){
+        {
+            hxqstl::concurrent_vector<tracked> v;
+            const tracked proto(0);
+            for(int round = 0;round < 20;++round){
+                v.grow_by(5,proto);
+                tracked::budget = round % 7;
+                try{
+                    v.grow_by(40,proto);
+                }
+                catch(int){}
+                tracked::budget = 0;
+                try{
+                    v.push_back(proto);
+                }
+                catch(int){}
+                tracked::budget = -1;
+            }
+            v.clear();
+            assert(tracked::live == 1);
+            v.grow_by(3,proto);
+            assert(tracked::live == 4);
+        }
+        assert(tracked::live == 0);
+    }
+
+    // 多线程追加：每个元素恰好出现一次，先前取得的引用保持有效
+    void test_parallel_push_back(){
+        const int threads = 4,per = 20000;
+        hxqstl::concurrent_vector<int> v;
+        const int& first = *v.push_back(-1);
+        std::vector<std::thread> ts;
+        for(int t = 0;t < threads;++t){
+            ts.emplace_back([&,t]{
+                for(int i = 0;i < per;++i) v.push_back(t * per + i);
+            });
+        }
+        for(auto& t : ts) t.join();
+        assert(first == -1 && &first == &v[0]);
+        assert(v.size() == static_cast<size_t>(threads * per + 1));
+        std::vector<char> seen(threads * per,0);
+        for(size_t i = 1;i < v.size();++i){
+            assert(!seen[v[i]]);
+            seen[v[i]] = 1;
+        }
+    }
+}
+
+int main(){
+    test_broken_ranges();
+    test_parallel_push_back();
+    std::puts("concurrent_vector_test ok");
+    return 0;
+}
@@ -0,0 +1,132 @@
+// flat_hash_map / flat_hash_set 的独立检查
+// g++ -std=c++14 -I.. -fsanitize=address,undefined flat_hash_map_test.cpp && ./a.out
+
+#include <cassert>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "flat_hash_map.h"
+#include "flat_hash_set.h"
+
+namespace{
+    // 第 budget 次调用时抛出
+    struct throwing_hash
+    {
+        static int budget;
+        size_t operator()(const std::string& s) const
+        {
+            if(budget >= 0 && budget-- == 0) throw 42;
+            return std::hash<std::string>()(s);
+        }
+    };
+    int throwing_hash::budget = -1;
+
+    struct counted_key
+    {
+        int v;
+        static int copies;
+        counted_key(int x) : v(x) {}
+        counted_key(const counted_key& rhs) : v(rhs.v) {++copies;}
+        counted_key(counted_key&& rhs) noexcept : v(rhs.v) {}
+        bool operator==(const counted_key& rhs) const {return v == rhs.v;}
+    };
+    int counted_key::copies = 0;
+
+    struct counted_key_hash
+    {
+        size_t operator()(const counted_key& k) const {return std::hash<int>()(k.v);}
+    };
+
+    // 拷贝和移动都可能抛出，扩容只能拷贝
+    struct throwing_value
+    {
+        int v;
+        static int budget;
+        throwing_value(int x) : v(x) {}
+        throwing_value(const throwing_value& rhs) : v(rhs.v) {tick();}
+        throwing_value(throwing_value&& rhs) : v(rhs.v) {tick();}
+        static void tick() {if(budget >= 0 && budget-- == 0) throw 42;}
+    };
+    int throwing_value::budget = -1;
+
+    // 扩容时哈希抛出，已有元素完好且仍能查到
+    void test_rehash_hash_throws(){
+        for(int k = 0;k < 64;++k){
+            hxqstl::flat_hash_map<std::string,std::string,throwing_hash> m;
+            for(int i = 0;i < 14;++i){
+                m.try_emplace("key_long_enough_to_heap_" + std::to_string(i),
+                              "value_long_enough_to_heap_" + std::to_string(i));
+            }
+            throwing_hash::budget = k;
+            try{
+                for(int i = 14;i < 64;++i) m.try_emplace("key_long_enough_to_heap_" + std::to_string(i),
+                                                         "value_long_enough_to_heap_" + std::to_string(i));
+            }
+            catch(int){}
+            throwing_hash::budget = -1;
+            for(auto it = m.begin();it != m.end();++it){
+                assert(it->second == "value_long_enough_to_heap_" + it->first.substr(24));
+                assert(m.find(it->first) != m.end());
+            }
+        }
+    }
+
+    // 值的拷贝在扩容中途抛出，已有元素完好
+    void test_rehash_copy_throws(){
+        for(int k = 0;k < 64;++k){
+            hxqstl::flat_hash_map<int,throwing_value> m;
+            for(int i = 0;i < 14;++i) m.try_emplace(i,i);
+            throwing_value::budget = k;
+            try{
+                for(int i = 14;i < 64;++i) m.try_emplace(i,i);
+            }
+            catch(int){}
+            throwing_value::budget = -1;
+            for(auto it = m.begin();it != m.end();++it){
+                assert(it->first == it->second.v);
+                assert(m.find(it->first) != m.end());
+            }
+        }
+    }
+
+    // 扩容搬迁移动键，不拷贝
+    void test_growth_moves_keys(){
+        hxqstl::flat_hash_map<counted_key,int,counted_key_hash> m;
+        for(int i = 0;i < 1000;++i) m.try_emplace(counted_key(i),i);
+        counted_key::copies = 0;
+        m.rehash(8000);
+        assert(counted_key::copies == 0);
+        for(int i = 0;i < 1000;++i) assert(m.find(counted_key(i))->second == i);
+    }
+
+    void test_move_only_values(){
+        hxqstl::flat_hash_map<std::string,std::unique_ptr<int>> m;
+        for(int i = 0;i < 200;++i) m.emplace(std::to_string(i),std::unique_ptr<int>(new int(i)));
+        for(int i = 0;i < 200;++i) assert(*m.find(std::to_string(i))->second == i);
+    }
+
+    void test_copy_and_set(){
+        hxqstl::flat_hash_map<std::string,std::string> a;
+        for(int i = 0;i < 100;++i) a[std::to_string(i)] = "x" + std::to_string(i);
+        auto b = a;
+        assert(a == b);
+        a.erase("5");
+        assert(a.size() == 99 && !a.contains("5") && b.contains("5"));
+
+        hxqstl::flat_hash_set<std::string> s;
+        for(int i = 0;i < 100;++i) s.insert(std::to_string(i));
+        auto t = s;
+        assert(t.size() == 100 && t.contains("42"));
+    }
+}
+
+int main(){
+    test_rehash_hash_throws();
+    test_rehash_copy_throws();
+    test_growth_moves_keys();
+    test_move_only_values();
+    test_copy_and_set();
+    std::puts("flat_hash_map_test ok");
+    return 0;
+}
@@ -0,0 +1,147 @@
+// flat_map / flat_set 的独立检查
+// g++ -std=c++14 -I.. -fsanitize=address,undefined flat_map_test.cpp && ./a.out
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+#include "flat_map.h"
+#include "flat_set.h"
+#include "memory.h"
+
+namespace{
+    // 第 budget 次比较时抛出
+    struct throwing_less
+    {
+        static int budget;
+        bool operator()(const std::string& a,const std::string& b) const
+        {
+            if(budget >= 0 && budget-- == 0) throw std::runtime_error("compare");
+            return a < b;
+        }
+    };
+    int throwing_less::budget = -1;
+
+    // 拷贝和移动都可能抛出，归并时原有元素只能拷贝
+    struct throwing_value
+    {
+        int v;
+        static int budget;
+        throwing_value(int x) : v(x) {}
+        throwing_value(const throwing_value& rhs) : v(rhs.v) {tick();}
+        throwing_value(throwing_value&& rhs) : v(rhs.v) {tick();}
+        throwing_value& operator=(const throwing_value& rhs) {v = rhs.v;return *this;}
+        static void tick() {if(budget >= 0 && budget-- == 0) throw 42;}
+    };
+    int throwing_value::budget = -1;
+
+    std::string key(int i){
+        return "flat_key_long_enough_to_heap_" + std::to_string(i);
+    }
+
+    // 比较器在任意一次比较时抛出，map 和 set 都保持原样
+    void test_bulk_insert_compare_throws(){
+        for(int k = 0;k < 200;++k){
+            hxqstl::flat_map<std::string,std::string,throwing_less> m;
+            hxqstl::flat_set<std::string,throwing_less> s;
+            for(int i = 0;i < 10;++i){
+                m.try_emplace(key(i * 2),std::string(40,static_cast<char>('a' + i)));
+                s.insert(key(i * 2));
+            }
+            hxqstl::vector<hxqstl::pair<std::string,std::string>> in;
+            hxqstl::vector<std::string> sin;
+            for(int i = 0;i < 10;++i){
+                in.emplace_back(key(i * 2 + 1),std::string(40,'z'));
+                sin.emplace_back(key(i * 2 + 1));
+            }
+            const auto m0 = m;
+            const auto s0 = s;
+
+            throwing_less::budget = k;
+            bool threw = false;
+            try{
+                m.insert(in.begin(),in.end());
+            }
+            catch(std::runtime_error&){
+                threw = true;
+            }
+            throwing_less::budget = -1;
+            if(threw){
+                assert(m.size() == m0.size());
+                auto b = m0.begin();
+                for(auto a = m.begin();a != m.end();++a,++b){
+                    assert(a->first == b->first && a->second == b->second);
+                }
+            }
+            else{
+                assert(m.size() == 20);
+            }
+
+            throwing_less::budget = k;
+            threw = false;
+            try{
+                s.insert(sin.begin(),sin.end());
+            }
+            catch(std::runtime_error&){
+                threw = true;
+            }
+            throwing_less::budget = -1;
+            assert(threw ? s == s0 : s.size() == 20);
+        }
+    }
+
+    // 元素搬运在任意位置抛出，map 保持原样
+    void test_bulk_insert_copy_throws(){
+        for(int k = 0;k < 80;++k){
+            hxqstl::flat_map<int,throwing_value> m;
+            for(int i = 0;i < 10;++i) m.try_emplace(i * 2,i * 2);
+            hxqstl::vector<hxqstl::pair<int,throwing_value>> in;
+            for(int i = 0;i < 10;++i) in.emplace_back(i * 2 + 1,throwing_value(i * 2 + 1));
+
+            throwing_value::budget = k;
+            bool threw = false;
+            try{
+                m.insert(in.begin(),in.end());
+            }
+            catch(int){
+                threw = true;
+            }
+            throwing_value::budget = -1;
+            assert(m.size() == (threw ? 10u : 20u));
+            int expect = 0;
+            for(auto it = m.begin();it != m.end();++it,expect += threw ? 2 : 1){
+                assert(it->first == expect && it->second.v == expect);
+            }
+        }
+    }
+
+    // 无分支二分与 std::lower_bound 结果一致
+    void test_branchless_lower_bound(){
+        int a[64];
+        for(int i = 0;i < 64;++i) a[i] = i * 2;
+        for(size_t n = 0;n <= 64;++n){
+            for(int x = -1;x <= 130;++x){
+                const int* p = hxqstl::branchless_lower_bound(a,n,x,hxqstl::less<int>());
+                assert(p == std::lower_bound(a,a + n,x));
+            }
+        }
+    }
+
+    void test_move_only_values(){
+        hxqstl::flat_map<int,hxqstl::unique_ptr<int>> m;
+        for(int i = 10;i > 0;--i) m.try_emplace(i,hxqstl::make_unique<int>(i));
+        m.erase(5);
+        assert(m.size() == 9 && *m.at(7) == 7 && !m.contains(5));
+    }
+}
+
+int main(){
+    test_bulk_insert_compare_throws();
+    test_bulk_insert_copy_throws();
+    test_branchless_lower_bound();
+    test_move_only_values();
+    std::puts("flat_map_test ok");
+    return 0;
+}
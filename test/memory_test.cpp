@@ -0,0 +1,47 @@
+// unique_ptr / shared_ptr 的独立检查
+// g++ -std=c++14 -I.. -fsanitize=address,undefined memory_test.cpp && ./a.out
+
+#include <cassert>
+#include <cstdio>
+
+#include "memory.h"
+#include "vector.h"
+
+namespace{
+    // unique_ptr 可以放进 vector，中间插入、删除以及扩容都只移动
+    void test_unique_ptr_in_vector(){
+        hxqstl::vector<hxqstl::unique_ptr<int>> v;
+        for(int i = 0;i < 5;++i) v.push_back(hxqstl::make_unique<int>(i));
+        v.reserve(v.size() + 4);
+        v.emplace(v.begin() + 2,hxqstl::make_unique<int>(100));
+        v.insert(v.begin() + 1,hxqstl::make_unique<int>(200));
+        v.erase(v.begin() + 4);
+        v.erase(v.begin(),v.begin() + 1);
+        // 容量用尽后的中间插入走重新分配的路径
+        while(v.size() != v.capacity()) v.emplace_back(hxqstl::make_unique<int>(7));
+        v.emplace(v.begin() + 1,hxqstl::make_unique<int>(300));
+
+        const int expect[] = {200,300,1,100,3,4};
+        for(int i = 0;i < 6;++i) assert(*v[i] == expect[i]);
+        for(size_t i = 6;i < v.size();++i) assert(*v[i] == 7);
+    }
+
+    void test_shared_ptr_counts(){
+        hxqstl::shared_ptr<int> p = hxqstl::make_shared<int>(5);
+        hxqstl::weak_ptr<int> w = p;
+        {
+            hxqstl::vector<hxqstl::shared_ptr<int>> v(3,p);
+            assert(p.use_count() == 4);
+        }
+        assert(p.use_count() == 1);
+        p.reset();
+        assert(w.expired());
+    }
+}
+
+int main(){
+    test_unique_ptr_in_vector();
+    test_shared_ptr_counts();
+    std::puts("memory_test ok");
+    return 0;
+}
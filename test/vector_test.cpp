@@ -0,0 +1,105 @@
+// vector 的独立检查
+// g++ -std=c++14 -I.. -fsanitize=address,undefined vector_test.cpp && ./a.out
+
+#include <cassert>
+#include <cstdio>
+#include <string>
+
+#include "vector.h"
+
+namespace{
+    struct move_only
+    {
+        int v;
+        explicit move_only(int x) : v(x) {}
+        move_only(move_only&& rhs) noexcept : v(rhs.v) {rhs.v = -1;}
+        move_only& operator=(move_only&& rhs) noexcept {v = rhs.v;rhs.v = -1;return *this;}
+        move_only(const move_only&) = delete;
+        move_only& operator=(const move_only&) = delete;
+    };
+
+    // 移动可能抛出的类型，重新分配时只能拷贝
+    struct throwing_move
+    {
+        std::string s;
+        static int budget;
+        explicit throwing_move(int i) : s("element_long_enough_to_heap_" + std::to_string(i)) {}
+        throwing_move(const throwing_move& rhs) : s(rhs.s) {tick();}
+        throwing_move(throwing_move&& rhs) : s(hxqstl::move(rhs.s)) {tick();}
+        throwing_move& operator=(const throwing_move& rhs) {s = rhs.s;return *this;}
+        static void tick() {if(budget >= 0 && budget-- == 0) throw 42;}
+    };
+    int throwing_move::budget = -1;
+
+    // 容量足够时在中间插入只移动元素，不要求可拷贝
+    void test_middle_insert_move_only(){
+        hxqstl::vector<move_only> v;
+        v.reserve(16);
+        for(int i = 0;i < 5;++i) v.emplace_back(i);
+        v.emplace(v.begin() + 2,100);
+        v.insert(v.begin(),move_only(200));
+        v.erase(v.begin() + 3);
+        const int expect[] = {200,0,1,2,3,4};
+        assert(v.size() == 6);
+        for(int i = 0;i < 6;++i) assert(v[i].v == expect[i]);
+    }
+
+    // 参数引用容器自身的元素
+    void test_insert_self_reference(){
+        hxqstl::vector<std::string> v = {"a","b","c"};
+        v.reserve(10);
+        v.emplace(v.begin(),v[2]);
+        v.insert(v.begin() + 1,v[0]);
+        const char* expect[] = {"c","c","a","b","c"};
+        assert(v.size() == 5);
+        for(int i = 0;i < 5;++i) assert(v[i] == expect[i]);
+    }
+
+    // 重新分配的中间插入失败时原有元素保持不变
+    void test_reallocate_insert_strong(){
+        for(int k = 0;k < 12;++k){
+            hxqstl::vector<throwing_move> v;
+            for(int i = 0;i < 8;++i) v.emplace_back(i);
+            v.shrink_to_fit();
+            const size_t cap = v.capacity();
+            throwing_move::budget = k;
+            try{
+                v.emplace(v.begin() + 3,100);
+            }
+            catch(int){}
+            throwing_move::budget = -1;
+            if(v.size() == 8){
+                assert(v.capacity() == cap);
+                for(int i = 0;i < 8;++i) assert(v[i].s == throwing_move(i).s);
+            }
+            else{
+                assert(v.size() == 9 && v[3].s == throwing_move(100).s);
+            }
+        }
+    }
+
+    // 逐个 resize(size() + 1) 按几何级数扩容
+    void test_resize_growth(){
+        hxqstl::vector<int> v;
+        int reallocs = 0;
+        const int* p = v.data();
+        for(int i = 0;i < 20000;++i){
+            v.resize(v.size() + 1,i);
+            if(v.data() != p){
+                ++reallocs;
+                p = v.data();
+            }
+        }
+        assert(reallocs < 40);
+        for(int i = 0;i < 20000;++i) assert(v[i] == i);
+    }
+}
+
+int main(){
+    test_middle_insert_move_only();
+    test_insert_self_reference();
+    test_reallocate_insert_strong();
+    test_resize_growth();
+    std::puts("vector_test ok");
+    return 0;
+}
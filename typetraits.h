@@ -1,7 +1,27 @@
 #pragma once
 
 #include <type_traits>
+// 编译器提供 __builtin_is_constant_evaluated 时，constexpr 函数可以在常量求值时绕开 memmove/memset
+#if defined(__has_builtin)
+#  if __has_builtin(__builtin_is_constant_evaluated)
+#    define MYSTL_HAS_CONSTANT_EVALUATED 1
+#  endif
+#endif
+#if !defined(MYSTL_HAS_CONSTANT_EVALUATED) && defined(_MSC_VER) && _MSC_VER >= 1925
+#  define MYSTL_HAS_CONSTANT_EVALUATED 1
+#endif
+
 namespace hxqstl{
+    // 常量求值时返回 true；编译器不支持时总是返回 false，此时带 memmove 的快速路径不能在编译期使用
+    constexpr bool is_constant_evaluated() noexcept
+    {
+#ifdef MYSTL_HAS_CONSTANT_EVALUATED
+        return __builtin_is_constant_evaluated();
+#else
+        return false;
+#endif
+    }
+
     template<class T,T v>
     struct m_integral_const{
         static constexpr T value = v;
@@ -19,8 +39,8 @@ namespace hxqstl{
 
     // 这里的冒号代表继承
     template<class T>
-    struct is_pair:hxqstL::m_false_type{};
+    struct is_pair:hxqstl::m_false_type{};
 
     template<class T1,class T2>
-    struct is_pair<hxqstl::pair<T1, T2>> : mystl::m_true_type {};
+    struct is_pair<hxqstl::pair<T1, T2>> : hxqstl::m_true_type {};
 }
\ No newline at end of file
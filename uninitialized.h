@@ -1,5 +1,9 @@
 #pragma once
 
+#include <cstdint>
+#include <exception>
+#include <thread>
+
 #include "algobase.h"
 #include "construct.h"
 #include "iterator.h"
@@ -10,7 +14,7 @@ namespace hxqstl{
     // uninitialized_copy
     // 把[first,last)上的内容复制到以result起始的位置，返回复制结束的位置
     template<class InputIter,class ForwardIter>
-    ForwardIter unchecked_uninit_copy(InputIter first,InputIter last,ForwardIter,std::true_type){
+    ForwardIter unchecked_uninit_copy(InputIter first,InputIter last,ForwardIter result,std::true_type){
         return hxqstl::copy(first,last,result);
     }
 
@@ -23,15 +27,20 @@ namespace hxqstl{
             }
          }
          catch(...){
-            for(;result != cur;--cur){
-                for(;result != cur;--cur){
-                    hxqstl::destroy(&*cur);
-                }
-            }
+            hxqstl::destroy(result,cur);
+            throw;
          }
          return cur;
     }
 
+    template<class InputIter,class ForwardIter>
+    ForwardIter uninitialized_copy(InputIter first,InputIter last,ForwardIter result){
+        return hxqstl::unchecked_uninit_copy(first,last,result,
+                                              std::is_trivially_copy_assignable<
+                                              typename iterator_traits<ForwardIter>::
+                                              value_type>{});
+    }
+
     // uninitialized_copy_n
     // 把[first,first + n)上的内容复制到以result为起始处的空间，返回复制结束的位置
     template<class InputIter,class Size,class ForwardIter>
@@ -51,9 +60,8 @@ namespace hxqstl{
         }
         catch(...)
         {
-            for(;result != cur;--cur){
-                hxqstl::destroy(&*cur);
-            }
+            hxqstl::destroy(result,cur);
+            throw;
         }
         return cur;
     }
@@ -85,9 +93,8 @@ namespace hxqstl{
         }
         catch(...)
         {
-            for(;first != cur;++first){
-                hxqstl::destroy(&*first);
-            }
+            hxqstl::destroy(first,cur);
+            throw;
         }
     }
 
@@ -120,8 +127,8 @@ namespace hxqstl{
         }
         catch (...)
         {
-            for (; first != cur; ++first)
-                hxqstl::destroy(&*first);
+            hxqstl::destroy(first, cur);
+            throw;
         }
         return cur;
     }
@@ -138,4 +145,201 @@ namespace hxqstl{
     ForwardIter unchecked_uninit_move(InputIter first,InputIter last,ForwardIter result,std::true_type){
         return hxqstl::move(first,last,result);
     }
-}
\ No newline at end of file
+
+    template<class InputIter,class ForwardIter>
+    ForwardIter unchecked_uninit_move(InputIter first,InputIter last,ForwardIter result,std::false_type){
+        ForwardIter cur = result;
+        try
+        {
+            for(;first != last;++first,++cur){
+                hxqstl::construct(&*cur,hxqstl::move(*first));
+            }
+        }
+        catch(...)
+        {
+            hxqstl::destroy(result,cur);
+            throw;
+        }
+        return cur;
+    }
+
+    template<class InputIter,class ForwardIter>
+    ForwardIter uninitialized_move(InputIter first,InputIter last,ForwardIter result){
+        return hxqstl::unchecked_uninit_move(first,last,result,
+                                              std::is_trivially_move_assignable<
+                                              typename iterator_traits<InputIter>::
+                                              value_type>{});
+    }
+
+    // uninitialized_move_if_noexcept
+    // 移动构造可能抛出而又可以拷贝时改为拷贝，失败时源区间保持不变，供需要强异常保证的搬迁使用
+    template<class InputIter,class ForwardIter>
+    ForwardIter uninit_move_if_noexcept_dispatch(InputIter first,InputIter last,ForwardIter result,std::true_type){
+        return hxqstl::uninitialized_move(first,last,result);
+    }
+
+    template<class InputIter,class ForwardIter>
+    ForwardIter uninit_move_if_noexcept_dispatch(InputIter first,InputIter last,ForwardIter result,std::false_type){
+        return hxqstl::uninitialized_copy(first,last,result);
+    }
+
+    template<class InputIter,class ForwardIter>
+    ForwardIter uninitialized_move_if_noexcept(InputIter first,InputIter last,ForwardIter result){
+        typedef typename iterator_traits<InputIter>::value_type value_type;
+        return hxqstl::uninit_move_if_noexcept_dispatch(first,last,result,
+            std::integral_constant<bool,std::is_nothrow_move_constructible<value_type>::value ||
+                                        !std::is_copy_constructible<value_type>::value>{});
+    }
+
+    /*****************************************************************************************/
+    // 并行构造
+    // 把连续的目标区间按线程切块，每个线程在自己的块上调用上面的串行版本
+    // 块的边界取在页面边界上(从目标区间所在的第一页起按字节计算)，操作系统按首次写入的线程把页面放到它所在的 NUMA 节点
+    // sizeof(T) 整除页大小时每个页面只被一个线程首次写入；否则只有跨越块边界的那个元素所在的页面可能被相邻的两个线程写到
+    // 回滚语义与串行版本一致：任何一块失败时，析构所有已构造的元素，再把第一个异常重新抛出
+
+    // 并行构造的选项，threads 为 0 时使用硬件线程数
+    struct parallel_t
+    {
+        unsigned threads;
+        constexpr explicit parallel_t(unsigned n = 0) noexcept : threads(n) {}
+    };
+    constexpr parallel_t parallel_construct{};
+
+    namespace par{
+        enum{EMaxWorkers = 256};
+        enum{EMinChunkBytes = 1 << 20};     // 每个线程至少处理 1MB，否则开线程得不偿失
+        enum{EPageBytes = 4096};
+
+        inline unsigned worker_count(unsigned requested,size_t bytes) noexcept{
+            unsigned w = requested != 0 ? requested : std::thread::hardware_concurrency();
+            const size_t by_size = bytes / EMinChunkBytes;
+            if(w > by_size) w = static_cast<unsigned>(by_size);
+            if(w > EMaxWorkers) w = EMaxWorkers;
+            return w == 0 ? 1 : w;
+        }
+
+        // 切块方案：从 p 所在的页起，每块是整数个页面，块内的元素是起始地址落在这些页面上的元素
+        class chunk_plan{
+            private:
+                uintptr_t base_;        // 第一个元素的地址
+                uintptr_t origin_;      // base_ 向下取整到页
+                size_t n_;
+                size_t elem_bytes_;
+                size_t chunk_bytes_;
+                size_t count_;
+
+            public:
+                chunk_plan(const void* p,size_t n,size_t elem_bytes,unsigned workers) noexcept
+                :base_(reinterpret_cast<uintptr_t>(p)),
+                 origin_(base_ & ~static_cast<uintptr_t>(EPageBytes - 1)),
+                 n_(n),elem_bytes_(elem_bytes)
+                {
+                    const size_t span = static_cast<size_t>(base_ - origin_) + n * elem_bytes;
+                    const size_t c = (span + workers - 1) / workers;
+                    chunk_bytes_ = c == 0 ? static_cast<size_t>(EPageBytes) : (c + EPageBytes - 1) / EPageBytes * EPageBytes;
+                    count_ = (span + chunk_bytes_ - 1) / chunk_bytes_;
+                }
+
+                size_t count() const noexcept {return count_;}
+
+                // 第 i 块的第一个元素；元素很大时相邻的边界可能相同，对应的块为空
+                size_t first(size_t i) const noexcept
+                {
+                    if(i == 0) return 0;
+                    if(i >= count_) return n_;
+                    const uintptr_t edge = origin_ + i * chunk_bytes_;
+                    const size_t idx = static_cast<size_t>(edge - base_ + elem_bytes_ - 1) / elem_bytes_;
+                    return idx < n_ ? idx : n_;
+                }
+        };
+
+        // 按 plan 切块并行执行 body(b,e)，第 0 块由调用线程执行，开不出线程的块也就地执行
+        // body 失败时自己回滚本块；有块失败时对成功的块调用 undo(b,e)，再抛出第一个异常
+        template<class Body,class Undo>
+        void run_chunks(const chunk_plan& plan,Body body,Undo undo){
+            const size_t count = plan.count();
+            std::thread workers[EMaxWorkers];
+            std::exception_ptr errors[EMaxWorkers];
+            auto run = [&](size_t i){
+                try{
+                    body(plan.first(i),plan.first(i + 1));
+                }
+                catch(...){
+                    errors[i] = std::current_exception();
+                }
+            };
+            for(size_t i = 1;i < count;++i){
+                try{
+                    workers[i] = std::thread(run,i);
+                }
+                catch(...){
+                    run(i);
+                }
+            }
+            run(0);
+            for(size_t i = 1;i < count;++i){
+                if(workers[i].joinable()) workers[i].join();
+            }
+
+            size_t failed = count;
+            for(size_t i = 0;i < count;++i){
+                if(errors[i]){
+                    failed = i;
+                    break;
+                }
+            }
+            if(failed == count) return;
+            for(size_t i = 0;i < count;++i){
+                if(!errors[i]) undo(plan.first(i),plan.first(i + 1));
+            }
+            std::rethrow_exception(errors[failed]);
+        }
+    }
+
+    template<class T,class Size>
+    T* parallel_uninitialized_fill_n(T* first,Size n,const T& value,unsigned threads = 0){
+        const size_t count = static_cast<size_t>(n);
+        const unsigned w = par::worker_count(threads,count * sizeof(T));
+        if(w <= 1) return hxqstl::uninitialized_fill_n(first,count,value);
+        par::run_chunks(par::chunk_plan(first,count,sizeof(T),w),
+                        [first,&value](size_t b,size_t e){ hxqstl::uninitialized_fill_n(first + b,e - b,value); },
+                        [first](size_t b,size_t e){ hxqstl::destroy(first + b,first + e); });
+        return first + count;
+    }
+
+    template<class RandomIter,class T>
+    T* parallel_uninitialized_copy(RandomIter first,RandomIter last,T* result,unsigned threads = 0){
+        const size_t count = static_cast<size_t>(last - first);
+        const unsigned w = par::worker_count(threads,count * sizeof(T));
+        if(w <= 1) return hxqstl::uninitialized_copy(first,last,result);
+        par::run_chunks(par::chunk_plan(result,count,sizeof(T),w),
+                        [first,result](size_t b,size_t e){ hxqstl::uninitialized_copy(first + b,first + e,result + b); },
+                        [result](size_t b,size_t e){ hxqstl::destroy(result + b,result + e); });
+        return result + count;
+    }
+
+    template<class T>
+    T* parallel_uninitialized_move(T* first,T* last,T* result,unsigned threads = 0){
+        const size_t count = static_cast<size_t>(last - first);
+        const unsigned w = par::worker_count(threads,count * sizeof(T));
+        if(w <= 1) return hxqstl::uninitialized_move(first,last,result);
+        par::run_chunks(par::chunk_plan(result,count,sizeof(T),w),
+                        [first,result](size_t b,size_t e){ hxqstl::uninitialized_move(first + b,first + e,result + b); },
+                        [result](size_t b,size_t e){ hxqstl::destroy(result + b,result + e); });
+        return result + count;
+    }
+
+    // 只为尚未构造的内存分配物理页：各线程向自己那一段的每一页写一个字节
+    // 数据量不足以并行时什么也不做，页面留给之后真正构造元素的线程
+    inline void parallel_first_touch(void* p,size_t bytes,unsigned threads = 0){
+        const unsigned w = par::worker_count(threads,bytes);
+        if(w <= 1) return;
+        char* base = static_cast<char*>(p);
+        par::run_chunks(par::chunk_plan(p,bytes,1,w),
+                        [base](size_t b,size_t e){
+                            for(size_t i = b;i < e;i += par::EPageBytes) base[i] = 0;
+                        },
+                        [](size_t,size_t){});
+    }
+}
@@ -2,34 +2,44 @@
 
 #include "typetraits.h"
 #include <cstddef>
+#include <tuple>
+#include <utility>
 
 namespace hxqstl{
     template<class T>
-    typename std::remove_reference<T>::type&& move(T&& arg) noexcept{
+    constexpr typename std::remove_reference<T>::type&& move(T&& arg) noexcept{
         return static_cast<typename std::remove_reference<T>::type&&>(arg);
     }
 
     template<class T>
-    T&& forward(typename std::remove_reference<T>::type& arg) noexcept{
+    constexpr T&& forward(typename std::remove_reference<T>::type& arg) noexcept{
         return static_cast<T&&>(arg);
     }
 
     template<class T>
-    T&& forward(typename std::remove_reference<T>::type&& arg) noexcept{
+    constexpr T&& forward(typename std::remove_reference<T>::type&& arg) noexcept{
         static_assert(!std::is_lvalue_reference<T>::value,"bad forward");
         return static_cast<T&&>(arg);
     }
 
+    // 移动构造不会抛出（或者无法拷贝）时移动，否则拷贝，供需要强异常保证的搬运使用
+    template<class T>
+    constexpr typename std::conditional<!std::is_nothrow_move_constructible<T>::value &&
+                                        std::is_copy_constructible<T>::value,const T&,T&&>::type
+    move_if_noexcept(T& arg) noexcept{
+        return hxqstl::move(arg);
+    }
+
     //swap
     template<class Tp>
-    void swap(Tp& lhs,Tp& rhs){
+    constexpr void swap(Tp& lhs,Tp& rhs){
         auto tmp(hxqstl::move(lhs));
         lhs = hxqstl::move(rhs);
         rhs = hxqstl::move(tmp);
     }
 
     template<class ForwardIter1,class ForwardIter2>
-    ForwardIter2 swap_range(ForwardIter1 first1,ForwardIter1 last1,ForwardIter2 first2){
+    constexpr ForwardIter2 swap_range(ForwardIter1 first1,ForwardIter1 last1,ForwardIter2 first2){
         for(;first1 != last1;++first1,(void)++first2){
             hxqstl::swap(*first1,*first2);
         }
@@ -38,10 +48,17 @@ namespace hxqstl{
 
     // a是一个数组引用
     template<class Tp,size_t N>
-    void swap(Tp(&a)[N],Tp(&b)[N]){
+    constexpr void swap(Tp(&a)[N],Tp(&b)[N]){
         hxqstl::swap_range(a,a+N,b);
     }
 
+    // 分段构造 pair 的标记：两个成员分别用一个 tuple 中的参数就地构造
+    struct piecewise_construct_t
+    {
+        explicit piecewise_construct_t() = default;
+    };
+    constexpr piecewise_construct_t piecewise_construct{};
+
     template<class Ty1,class Ty2>
     struct pair
     {
@@ -82,7 +99,7 @@ namespace hxqstl{
         pair(const pair& rhs) = default;
         pair(pair&& rhs) = default;
         
-        template<class Other1,class Other2,typename std::enabla_if<std::is_constructible<Ty1,Other1>::value &&
+        template<class Other1,class Other2,typename std::enable_if<std::is_constructible<Ty1,Other1>::value &&
                                                                     std::is_constructible<Ty2,Other2>::value &&
                                                                     std::is_convertible<Other1&&,Ty1>::value &&
                                                                     std::is_convertible<Other2&&,Ty2>::value,int>::type = 0>
@@ -121,26 +138,33 @@ namespace hxqstl{
         }
 
         template<class Other1,class Other2,typename std::enable_if<
-                                            std::is_constructible<Ty1,const Other1&>::value &&
-                                            std::is_constructible<Ty2,const Other2&>::value &&
-                                            std::is_convertible<const Other1&,Ty1>::value &&
-                                            std::is_convertible<const Other2&,Ty2>::value,int>::type = 0>
-        constexpr pair(const pair<Other1,Other2>&& other) : first(hxqstl::forward<Other1>(other.first)),second(hxqstl::forward<Other2>(other.second)){
+                                            std::is_constructible<Ty1,Other1>::value &&
+                                            std::is_constructible<Ty2,Other2>::value &&
+                                            std::is_convertible<Other1,Ty1>::value &&
+                                            std::is_convertible<Other2,Ty2>::value,int>::type = 0>
+        constexpr pair(pair<Other1,Other2>&& other) : first(hxqstl::forward<Other1>(other.first)),second(hxqstl::forward<Other2>(other.second)){
 
         }
 
         // explicit constructiable for other pair
         template <class Other1, class Other2,typename std::enable_if<
-                                            std::is_constructible<Ty1, const Other1&>::value &&
-                                            std::is_constructible<Ty2, const Other2&>::value &&
-                                            (!std::is_convertible<const Other1&, Ty1>::value ||
-                                             !std::is_convertible<const Other2&, Ty2>::value), int>::type = 0>
-        explicit constexpr pair(const pair<Other1, Other2>&& other) : first(hxqstl::forward<Other1>(other.first)),second(hxqstl::forward<Other2>(other.second))
+                                            std::is_constructible<Ty1, Other1>::value &&
+                                            std::is_constructible<Ty2, Other2>::value &&
+                                            (!std::is_convertible<Other1, Ty1>::value ||
+                                             !std::is_convertible<Other2, Ty2>::value), int>::type = 0>
+        explicit constexpr pair(pair<Other1, Other2>&& other) : first(hxqstl::forward<Other1>(other.first)),second(hxqstl::forward<Other2>(other.second))
         {
             
         }
 
-        pair& operator=(const pair& rhs){
+        template<class... Args1,class... Args2>
+        pair(piecewise_construct_t,std::tuple<Args1...> a,std::tuple<Args2...> b)
+        :pair(a,b,std::index_sequence_for<Args1...>{},std::index_sequence_for<Args2...>{})
+        {
+
+        }
+
+        constexpr pair& operator=(const pair& rhs){
             if(this != &rhs){
                 first = rhs.first;
                 second = rhs.second;
@@ -148,7 +172,7 @@ namespace hxqstl{
             return *this;
         }
 
-        pair& operator=(pair&& rhs){
+        constexpr pair& operator=(pair&& rhs){
             if(this != &rhs){
                 first = hxqstl::move(rhs.first);
                 second = hxqstl::move(rhs.second);
@@ -157,14 +181,14 @@ namespace hxqstl{
         }
 
         template<class Other1,class Other2>
-        pair& operator=(const pair<Other1,Other2>& other){
+        constexpr pair& operator=(const pair<Other1,Other2>& other){
             first = other.first;
             second = other.second;
             return *this;
         }
 
         template<class Other1,class Other2>
-        pair& operator=(pair<Other1,Other2>&& other){
+        constexpr pair& operator=(pair<Other1,Other2>&& other){
             first = hxqstl::forward<Other1>(other.first);
             second = hxqstl::forward<Other2>(other.second);
             return *this;
@@ -172,51 +196,59 @@ namespace hxqstl{
 
         ~pair() = default;
 
-        void swap(pair& other){
+        constexpr void swap(pair& other){
             if(this != &other){
                 hxqstl::swap(first,other.first);
                 hxqstl::swap(second,other.second);
             }
         }
+
+    private:
+        template<class Tuple1,class Tuple2,size_t... I1,size_t... I2>
+        pair(Tuple1& a,Tuple2& b,std::index_sequence<I1...>,std::index_sequence<I2...>)
+        :first(std::get<I1>(hxqstl::move(a))...),second(std::get<I2>(hxqstl::move(b))...)
+        {
+
+        }
     };
 
     template<class Ty1,class Ty2>
-    void swap(pair<Ty1,Ty2>& lhs,pair<Ty1,Ty2>& rhs){
+    constexpr void swap(pair<Ty1,Ty2>& lhs,pair<Ty1,Ty2>& rhs){
         lhs.swap(rhs);
     }
 
     template<class Ty1,class Ty2>
-    bool operator<(const pair<Ty1,Ty2>& lhs,const pair<Ty1,Ty2>& rhs){
+    constexpr bool operator<(const pair<Ty1,Ty2>& lhs,const pair<Ty1,Ty2>& rhs){
         return lhs.first < rhs.first || (lhs.first == rhs.first && lhs.second < rhs.second);
     }
 
     template<class Ty1,class Ty2>
-    bool operator==(const pair<Ty1,Ty2>& lhs,const pair<Ty1,Ty2>& rhs){
+    constexpr bool operator==(const pair<Ty1,Ty2>& lhs,const pair<Ty1,Ty2>& rhs){
         return lhs.first==rhs.first && lhs.second == rhs.second;
     }
 
     template<class Ty1,class Ty2>
-    bool operator!=(const pair<Ty1,Ty2>& lhs,const pair<Ty1,Ty2>& rhs){
+    constexpr bool operator!=(const pair<Ty1,Ty2>& lhs,const pair<Ty1,Ty2>& rhs){
         return !(lhs == rhs);
     }
 
     template<class Ty1,class Ty2>
-    bool operator>(const pair<Ty1,Ty2>& lhs,const pair<Ty1,Ty2>& rhs){
+    constexpr bool operator>(const pair<Ty1,Ty2>& lhs,const pair<Ty1,Ty2>& rhs){
         return rhs < lhs;
     }
 
     template<class Ty1,class Ty2>
-    bool operator>=(const pair<Ty1,Ty2>& lhs,const pair<Ty1,Ty2>& rhs){
+    constexpr bool operator>=(const pair<Ty1,Ty2>& lhs,const pair<Ty1,Ty2>& rhs){
         return !(rhs < lhs);
     }
 
     template<class Ty1,class Ty2>
-    bool operator<=(const pair<Ty1,Ty2>& lhs,const pair<Ty1,Ty2>& rhs){
+    constexpr bool operator<=(const pair<Ty1,Ty2>& lhs,const pair<Ty1,Ty2>& rhs){
         return !(rhs > lhs);
     }  
 
     template<class Ty1,class Ty2>
-    pair<Ty1,Ty2> make_pair(Ty1&& first,Ty2&& second){
+    constexpr pair<Ty1,Ty2> make_pair(Ty1&& first,Ty2&& second){
         return pair<Ty1,Ty2>(hxqstl::forward<Ty1>(first),hxqstl::forward<Ty2>(second));
     }
 }
\ No newline at end of file
@@ -7,6 +7,18 @@
 #include "exceptdef.h"
 #include "algo.h"
 
+#ifdef MYSTL_VECTOR_TELEMETRY
+#include "vector_telemetry.h"
+#define MYSTL_VECTOR_REALLOC(T,kind,new_cap,moved,new_size) \
+    hxqstl::vector_telemetry::on_reallocate<T>(hxqstl::vector_growth_kind::kind,MYSTL_CALL_SITE(),(new_cap),(moved),(new_size))
+// 调用 MYSTL_VECTOR_REALLOC 的函数标 MYSTL_VECTOR_SLOW，只转发到它们的公开接口标 MYSTL_VECTOR_ENTRY
+#define MYSTL_VECTOR_SLOW MYSTL_NOINLINE
+#define MYSTL_VECTOR_ENTRY MYSTL_ALWAYS_INLINE
+#else
+#define MYSTL_VECTOR_REALLOC(T,kind,new_cap,moved,new_size) ((void)(new_cap),(void)(moved),(void)(new_size))
+#define MYSTL_VECTOR_SLOW
+#define MYSTL_VECTOR_ENTRY
+#endif
 
 namespace hxqstl{
     #ifdef max
@@ -19,12 +31,24 @@ namespace hxqstl{
     #undef min
     #endif
 
-    template<class T>
+    // 扩容策略，vector 和 basic_string 共用
+    // 每次扩容至少增长一半，或者16个元素；调用方保证 old_cap + add_size 不超过 max_size
+    inline size_t grow_capacity(size_t old_cap,size_t add_size,size_t max_size) noexcept{
+        if(old_cap > max_size - old_cap / 2){
+            return old_cap + add_size > max_size - 16
+                ? old_cap + add_size : old_cap + add_size + 16;
+        }
+        return old_cap == 0
+            ? hxqstl::max(add_size,static_cast<size_t>(16))
+            : hxqstl::max(old_cap + old_cap / 2,old_cap + add_size);
+    }
+
+    template<class T,class Alloc = hxqstl::allocator<T>>
     class vector{
         static_assert(!std::is_same<bool,T>::value,"vector<bool> is abandoned in hxqstl");
         public:
-            typedef hxqstl::allocator<T> allocator_type;
-            typedef hxqstl::allocator<T> data_allocator;
+            typedef Alloc allocator_type;
+            typedef Alloc data_allocator;
 
             typedef typename allocator_type::value_type value_type;
             typedef typename allocator_type::pointer pointer;
@@ -39,7 +63,7 @@ namespace hxqstl{
             typedef hxqstl::reverse_iterator<iterator> reverse_iterator;
             typedef hxqstl::reverse_iterator<const_iterator> const_reverse_iterator;
 
-            allocate_type get_allocator() {return data_allocator();}
+            allocator_type get_allocator() {return data_allocator();}
 
         private:
             iterator begin_;
@@ -71,7 +95,7 @@ namespace hxqstl{
             }
 
             vector(vector&& rhs) noexcept
-            :begin_(rhs.begin_),end_(rhs.end_),cap(rhs.cp_){
+            :begin_(rhs.begin_),end_(rhs.end_),cap_(rhs.cap_){
                 rhs.begin_ = nullptr;
                 rhs.end_ = nullptr;
                 rhs.cap_ = nullptr;
@@ -81,13 +105,30 @@ namespace hxqstl{
                 range_init(ilist.begin(),ilist.end());
             }
 
+            // 并行构造：按线程切块构造，每个线程首次写入自己那一段的页面，数据量小时退化为串行
+            vector(parallel_t par,size_type n){
+                parallel_fill_init(par,n,value_type());
+            }
+
+            vector(parallel_t par,size_type n,const value_type& value){
+                parallel_fill_init(par,n,value);
+            }
+
+            template<class Iter,typename std::enable_if<
+                hxqstl::is_random_access_iterator<Iter>::value,int>::type = 0>
+            vector(parallel_t par,Iter first,Iter last)
+            {
+                MYSTL_DEBUG(!(last<first));
+                parallel_range_init(par,first,last);
+            }
+
             vector& operator=(const vector& rhs);
             vector& operator=(vector&& rhs) noexcept;
 
             vector& operator=(std::initializer_list<value_type> ilist){
                 vector tmp(ilist.begin(),ilist.end());
                 swap(tmp);
-                return &this;
+                return *this;
             }
 
             ~vector(){
@@ -145,22 +186,29 @@ namespace hxqstl{
             size_type capacity() const noexcept{
                 return static_cast<size_type>(cap_ - begin_);
             }
-            void reserve(size_type n);
-            void shrink_to_fit();
+            MYSTL_VECTOR_SLOW void reserve(size_type n);
+            // 并行搬移已有元素，并由各线程预先写入新增容量的页面
+            MYSTL_VECTOR_SLOW void reserve(parallel_t par,size_type n);
+            MYSTL_VECTOR_SLOW void shrink_to_fit();
 
             reference operator[](size_type n){
                 MYSTL_DEBUG(n < size());
                 return *(begin_ + n);
             }
 
+            const_reference operator[](size_type n) const{
+                MYSTL_DEBUG(n < size());
+                return *(begin_ + n);
+            }
+
             reference at(size_type n){
                 THROW_OUT_OF_RANGE_IF(!(n < size()),"vector<T>::at() subscript out of range");
-                return *this[n];
+                return (*this)[n];
             }
 
             const_reference at(size_type n) const{
                 THROW_OUT_OF_RANGE_IF(!(n < size()),"vector<T>::at() subscript out of range");
-                return *this[n];
+                return (*this)[n];
             }
 
             reference front()
@@ -192,72 +240,768 @@ namespace hxqstl{
                 return begin_;
             }
 
-            void assign(size_type n,const value_type& value){
+            MYSTL_VECTOR_ENTRY void assign(size_type n,const value_type& value){
                 fill_assign(n,value);
             }
 
             template<class Iter,typename std::enable_if<hxqstl::is_input_iterator<Iter>::value,int>::type = 0>
-            void assign(Iter first,Iter last){
+            MYSTL_VECTOR_ENTRY void assign(Iter first,Iter last){
                 MYSTL_DEBUG(!(last < first));
                 copy_assign(first,last,iterator_category(first));
             }
 
-            void assign(std::initializer_list<value_type> il){
+            MYSTL_VECTOR_ENTRY void assign(std::initializer_list<value_type> il){
                 copy_assign(il.begin(),il.end(),hxqstl::forward_iterator_tag{});
             }
 
             template<class... Args>
-            iterator emplace(const_iterator pos,Args&& ...args);
+            MYSTL_VECTOR_ENTRY iterator emplace(const_iterator pos,Args&& ...args);
 
             template<class... Args>
-            void emplace_back(Args&&... args);
+            MYSTL_VECTOR_ENTRY void emplace_back(Args&&... args);
+
+            MYSTL_VECTOR_ENTRY void push_back(const value_type& value);
+            MYSTL_VECTOR_ENTRY void push_back(value_type&& value)
+            { emplace_back(hxqstl::move(value)); }
+
+            void pop_back();
+
+            MYSTL_VECTOR_ENTRY iterator insert(const_iterator pos,const value_type& value);
+            MYSTL_VECTOR_ENTRY iterator insert(const_iterator pos,value_type&& value)
+            { return emplace(pos,hxqstl::move(value)); }
+            MYSTL_VECTOR_ENTRY iterator insert(const_iterator pos,size_type n,const value_type& value);
+
+            // 前向迭代器只计算一次长度，最多重新分配一次；输入迭代器先缓存再插入
+            template<class Iter,typename std::enable_if<
+                hxqstl::is_input_iterator<Iter>::value,int>::type = 0>
+            MYSTL_VECTOR_ENTRY iterator insert(const_iterator pos,Iter first,Iter last)
+            {
+                MYSTL_DEBUG(pos >= begin() && pos <= end());
+                const size_type off = pos - begin_;
+                range_insert(begin_ + off,first,last,iterator_category(first));
+                return begin_ + off;
+            }
+
+            MYSTL_VECTOR_ENTRY iterator insert(const_iterator pos,std::initializer_list<value_type> ilist)
+            { return insert(pos,ilist.begin(),ilist.end()); }
+
+            // 在尾部追加一个区间，Range 只需要提供 begin()/end()
+            template<class Range>
+            MYSTL_VECTOR_ENTRY void append_range(const Range& r)
+            { insert(end(),r.begin(),r.end()); }
+
+            // 在尾部用相同的参数构造 n 个元素，最多重新分配一次
+            template<class... Args>
+            MYSTL_VECTOR_SLOW void emplace_back_n(size_type n,const Args&... args);
+
+            iterator erase(const_iterator pos);
+            iterator erase(const_iterator first,const_iterator last);
+            void clear() { erase(begin(),end()); }
+
+            MYSTL_VECTOR_ENTRY void resize(size_type new_size) { return resize(new_size,value_type()); }
+            MYSTL_VECTOR_SLOW void resize(size_type new_size,const value_type& value);
+            MYSTL_VECTOR_ENTRY void resize(parallel_t par,size_type new_size) { return resize(par,new_size,value_type()); }
+            MYSTL_VECTOR_SLOW void resize(parallel_t par,size_type new_size,const value_type& value);
+
+            void swap(vector& rhs) noexcept;
+
+        private:
+            void try_init() noexcept;
+
+            void init_space(size_type size,size_type cap);
+
+            void fill_init(size_type n,const value_type& value);
+            template<class Iter>
+            void range_init(Iter first,Iter last);
+
+            void parallel_fill_init(parallel_t par,size_type n,const value_type& value);
+            template<class Iter>
+            void parallel_range_init(parallel_t par,Iter first,Iter last);
+            void reallocate(size_type n);
+            void parallel_reallocate(parallel_t par,size_type n,bool touch_tail);
+
+            void destroy_and_recover(iterator first,iterator last,size_type n);
+
+            size_type get_new_cap(size_type add_size);
+            size_type get_resize_cap(size_type new_size) const noexcept;
+
+            MYSTL_VECTOR_SLOW void fill_assign(size_type n,const value_type& value);
+
+            template<class IIter>
+            MYSTL_VECTOR_ENTRY void copy_assign(IIter first,IIter last,input_iterator_tag);
+
+            template<class FIter>
+            MYSTL_VECTOR_SLOW void copy_assign(FIter first,FIter last,forward_iterator_tag);
+
+            MYSTL_VECTOR_SLOW void fill_insert(iterator pos,size_type n,const value_type& value);
+
+            template<class IIter>
+            MYSTL_VECTOR_ENTRY void range_insert(iterator pos,IIter first,IIter last,input_iterator_tag);
+
+            template<class FIter>
+            MYSTL_VECTOR_SLOW void range_insert(iterator pos,FIter first,FIter last,forward_iterator_tag);
+
+            iterator relocate_around(iterator pos,iterator new_begin,iterator new_pos,size_type n,size_type new_cap);
 
             template<class... Args>
-            void reallocate_emplace(iterator pos,Args&&... args);
+            MYSTL_VECTOR_SLOW void reallocate_emplace(iterator pos,Args&&... args);
+            MYSTL_VECTOR_SLOW void reallocate_insert(iterator pos,const value_type& value);
     };
 
-    template<class T>
+    /*****************************************************************************************/
+
+    // 复制赋值操作符
+    template<class T,class Alloc>
+    vector<T,Alloc>& vector<T,Alloc>::operator=(const vector& rhs){
+        if(this != &rhs){
+            const auto len = rhs.size();
+            if(len > capacity()){
+                vector tmp(rhs.begin(),rhs.end());
+                swap(tmp);
+            }
+            else if(size() >= len){
+                auto i = hxqstl::copy(rhs.begin(),rhs.end(),begin());
+                data_allocator::destroy(i,end_);
+                end_ = begin_ + len;
+            }
+            else{
+                hxqstl::copy(rhs.begin(),rhs.begin() + size(),begin_);
+                hxqstl::uninitialized_copy(rhs.begin() + size(),rhs.end(),end_);
+                end_ = begin_ + len;
+            }
+        }
+        return *this;
+    }
+
+    // 移动赋值操作符
+    template<class T,class Alloc>
+    vector<T,Alloc>& vector<T,Alloc>::operator=(vector&& rhs) noexcept{
+        if(this != &rhs){
+            destroy_and_recover(begin_,end_,cap_ - begin_);
+            begin_ = rhs.begin_;
+            end_ = rhs.end_;
+            cap_ = rhs.cap_;
+            rhs.begin_ = nullptr;
+            rhs.end_ = nullptr;
+            rhs.cap_ = nullptr;
+        }
+        return *this;
+    }
+
+    // 预留空间大小，当原容量小于要求大小时，才会重新分配
+    template<class T,class Alloc>
+    void vector<T,Alloc>::reserve(size_type n){
+        if(capacity() < n){
+            THROW_LENGTH_ERROR_IF(n > max_size(),"n can not larger than max_size() in vector<T>::reserve(n)");
+            const auto old_size = size();
+            reallocate(n);
+            MYSTL_VECTOR_REALLOC(T,reserve,n,old_size,old_size);
+        }
+    }
+
+    template<class T,class Alloc>
+    void vector<T,Alloc>::reserve(parallel_t par,size_type n){
+        if(capacity() < n){
+            THROW_LENGTH_ERROR_IF(n > max_size(),"n can not larger than max_size() in vector<T>::reserve(n)");
+            const auto old_size = size();
+            parallel_reallocate(par,n,true);
+            MYSTL_VECTOR_REALLOC(T,reserve,n,old_size,old_size);
+        }
+    }
+
+    // 放弃多余的容量
+    template<class T,class Alloc>
+    void vector<T,Alloc>::shrink_to_fit(){
+        if(end_ < cap_){
+            const auto old_size = size();
+            auto new_begin = data_allocator::allocate(old_size);
+            try{
+                hxqstl::uninitialized_move(begin_,end_,new_begin);
+            }
+            catch(...){
+                data_allocator::deallocate(new_begin,old_size);
+                throw;
+            }
+            destroy_and_recover(begin_,end_,cap_ - begin_);
+            begin_ = new_begin;
+            end_ = begin_ + old_size;
+            cap_ = begin_ + old_size;
+            MYSTL_VECTOR_REALLOC(T,shrink,old_size,old_size,old_size);
+        }
+    }
+
+    // 在尾部就地构造元素，避免额外的复制或移动开销
+    template<class T,class Alloc>
     template<class ...Args>
-    void vector<T>::reallocate_emplace(iterator pos,Args&& ...args){
+    void vector<T,Alloc>::emplace_back(Args&& ...args){
+        if(end_ < cap_){
+            data_allocator::construct(hxqstl::address_of(*end_),hxqstl::forward<Args>(args)...);
+            ++end_;
+        }
+        else{
+            reallocate_emplace(end_,hxqstl::forward<Args>(args)...);
+        }
+    }
+
+    template<class T,class Alloc>
+    void vector<T,Alloc>::push_back(const value_type& value){
+        if(end_ != cap_){
+            data_allocator::construct(hxqstl::address_of(*end_),value);
+            ++end_;
+        }
+        else{
+            reallocate_insert(end_,value);
+        }
+    }
+
+    template<class T,class Alloc>
+    void vector<T,Alloc>::pop_back(){
+        MYSTL_DEBUG(!empty());
+        data_allocator::destroy(end_ - 1);
+        --end_;
+    }
+
+    template<class T,class Alloc>
+    typename vector<T,Alloc>::iterator vector<T,Alloc>::insert(const_iterator pos,const value_type& value){
+        MYSTL_DEBUG(pos >= begin() && pos <= end());
+        iterator xpos = const_cast<iterator>(pos);
+        const size_type n = pos - begin_;
+        if(end_ != cap_ && xpos == end_){
+            data_allocator::construct(hxqstl::address_of(*end_),value);
+            ++end_;
+        }
+        else if(end_ != cap_){
+            auto value_copy = value;    // 避免元素因以下搬移操作而被改变
+            data_allocator::construct(hxqstl::address_of(*end_),hxqstl::move(*(end_ - 1)));
+            ++end_;
+            hxqstl::move_backward(xpos,end_ - 2,end_ - 1);
+            *xpos = hxqstl::move(value_copy);
+        }
+        else{
+            reallocate_insert(xpos,value);
+        }
+        return begin_ + n;
+    }
+
+    template<class T,class Alloc>
+    typename vector<T,Alloc>::iterator vector<T,Alloc>::insert(const_iterator pos,size_type n,const value_type& value){
+        MYSTL_DEBUG(pos >= begin() && pos <= end());
+        const size_type off = pos - begin_;
+        fill_insert(begin_ + off,n,value);
+        return begin_ + off;
+    }
+
+    template<class T,class Alloc>
+    template<class... Args>
+    void vector<T,Alloc>::emplace_back_n(size_type n,const Args&... args){
+        if(static_cast<size_type>(cap_ - end_) >= n){
+            auto cur = end_;
+            try{
+                for(;n > 0;--n,++cur){
+                    data_allocator::construct(hxqstl::address_of(*cur),args...);
+                }
+            }
+            catch(...){
+                data_allocator::destroy(end_,cur);
+                throw;
+            }
+            end_ = cur;
+            return;
+        }
+        // 参数可能引用容器内的元素，先在新空间构造新元素，再搬迁旧元素
+        const size_type old_size = size();
+        const size_type new_cap = get_new_cap(n);
+        auto new_begin = data_allocator::allocate(new_cap);
+        auto new_pos = new_begin + old_size;
+        auto cur = new_pos;
+        try{
+            for(;n > 0;--n,++cur){
+                data_allocator::construct(hxqstl::address_of(*cur),args...);
+            }
+        }
+        catch(...){
+            data_allocator::destroy(new_pos,cur);
+            data_allocator::deallocate(new_begin,new_cap);
+            throw;
+        }
+        relocate_around(end_,new_begin,new_pos,static_cast<size_type>(cur - new_pos),new_cap);
+        destroy_and_recover(begin_,end_,cap_ - begin_);
+        begin_ = new_begin;
+        end_ = cur;
+        cap_ = new_begin + new_cap;
+        MYSTL_VECTOR_REALLOC(T,grow,new_cap,old_size,size());
+    }
+
+    // 删除pos位置上的元素
+    template<class T,class Alloc>
+    typename vector<T,Alloc>::iterator vector<T,Alloc>::erase(const_iterator pos){
+        MYSTL_DEBUG(pos >= begin() && pos < end());
+        iterator xpos = begin_ + (pos - begin());
+        hxqstl::move(xpos + 1,end_,xpos);
+        data_allocator::destroy(end_ - 1);
+        --end_;
+        return xpos;
+    }
+
+    // 删除[first,last)上的元素
+    template<class T,class Alloc>
+    typename vector<T,Alloc>::iterator vector<T,Alloc>::erase(const_iterator first,const_iterator last){
+        MYSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
+        const auto n = first - begin();
+        iterator r = begin_ + (first - begin());
+        data_allocator::destroy(hxqstl::move(r + (last - first),end_,r),end_);
+        end_ = end_ - (last - first);
+        return begin_ + n;
+    }
+
+    // 重置容器大小，需要扩容时先复制 value，它可能引用将被搬走的元素
+    // 扩容在新元素填好之后才记录统计，闲置容量按最终大小计算
+    template<class T,class Alloc>
+    void vector<T,Alloc>::resize(size_type new_size,const value_type& value){
+        if(new_size < size()){
+            erase(begin() + new_size,end());
+        }
+        else if(new_size > capacity()){
+            THROW_LENGTH_ERROR_IF(new_size > max_size(),"vector<T>'s size too big");
+            const auto old_size = size();
+            const auto new_cap = get_resize_cap(new_size);
+            const value_type value_copy(value);
+            reallocate(new_cap);
+            end_ = hxqstl::uninitialized_fill_n(end_,new_size - old_size,value_copy);
+            MYSTL_VECTOR_REALLOC(T,reserve,new_cap,old_size,new_size);
+        }
+        else{
+            end_ = hxqstl::uninitialized_fill_n(end_,new_size - size(),value);
+        }
+    }
+
+    // 需要扩容时先复制 value，它可能引用将被搬走的元素
+    template<class T,class Alloc>
+    void vector<T,Alloc>::resize(parallel_t par,size_type new_size,const value_type& value){
+        if(new_size < size()){
+            erase(begin() + new_size,end());
+        }
+        else if(new_size > capacity()){
+            THROW_LENGTH_ERROR_IF(new_size > max_size(),"vector<T>'s size too big");
+            const auto old_size = size();
+            const auto new_cap = get_resize_cap(new_size);
+            const value_type value_copy(value);
+            parallel_reallocate(par,new_cap,false);
+            end_ = hxqstl::parallel_uninitialized_fill_n(end_,new_size - old_size,value_copy,par.threads);
+            MYSTL_VECTOR_REALLOC(T,reserve,new_cap,old_size,new_size);
+        }
+        else{
+            end_ = hxqstl::parallel_uninitialized_fill_n(end_,new_size - size(),value,par.threads);
+        }
+    }
+
+    // 与另一个vector交换
+    template<class T,class Alloc>
+    void vector<T,Alloc>::swap(vector<T,Alloc>& rhs) noexcept{
+        if(this != &rhs){
+            hxqstl::swap(begin_,rhs.begin_);
+            hxqstl::swap(end_,rhs.end_);
+            hxqstl::swap(cap_,rhs.cap_);
+        }
+    }
+
+    /*****************************************************************************************/
+    // helper function
+
+    // try_init 函数，若分配失败则忽略，不抛出异常
+    template<class T,class Alloc>
+    void vector<T,Alloc>::try_init() noexcept{
+        try{
+            begin_ = data_allocator::allocate(16);
+            end_ = begin_;
+            cap_ = begin_ + 16;
+        }
+        catch(...){
+            begin_ = nullptr;
+            end_ = nullptr;
+            cap_ = nullptr;
+        }
+    }
+
+    template<class T,class Alloc>
+    void vector<T,Alloc>::init_space(size_type size,size_type cap){
+        try{
+            begin_ = data_allocator::allocate(cap);
+            end_ = begin_ + size;
+            cap_ = begin_ + cap;
+        }
+        catch(...){
+            begin_ = nullptr;
+            end_ = nullptr;
+            cap_ = nullptr;
+            throw;
+        }
+    }
+
+    template<class T,class Alloc>
+    void vector<T,Alloc>::fill_init(size_type n,const value_type& value){
+        const size_type init_size = hxqstl::max(static_cast<size_type>(16),n);
+        init_space(n,init_size);
+        try{
+            hxqstl::uninitialized_fill_n(begin_,n,value);
+        }
+        catch(...){
+            data_allocator::deallocate(begin_,init_size);
+            throw;
+        }
+    }
+
+    template<class T,class Alloc>
+    template<class Iter>
+    void vector<T,Alloc>::range_init(Iter first,Iter last){
+        const size_type len = hxqstl::distance(first,last);
+        const size_type init_size = hxqstl::max(len,static_cast<size_type>(16));
+        init_space(len,init_size);
+        try{
+            hxqstl::uninitialized_copy(first,last,begin_);
+        }
+        catch(...){
+            data_allocator::deallocate(begin_,init_size);
+            throw;
+        }
+    }
+
+    template<class T,class Alloc>
+    void vector<T,Alloc>::parallel_fill_init(parallel_t par,size_type n,const value_type& value){
+        const size_type init_size = hxqstl::max(static_cast<size_type>(16),n);
+        init_space(n,init_size);
+        try{
+            hxqstl::parallel_uninitialized_fill_n(begin_,n,value,par.threads);
+        }
+        catch(...){
+            data_allocator::deallocate(begin_,init_size);
+            throw;
+        }
+    }
+
+    template<class T,class Alloc>
+    template<class Iter>
+    void vector<T,Alloc>::parallel_range_init(parallel_t par,Iter first,Iter last){
+        const size_type len = static_cast<size_type>(last - first);
+        const size_type init_size = hxqstl::max(len,static_cast<size_type>(16));
+        init_space(len,init_size);
+        try{
+            hxqstl::parallel_uninitialized_copy(first,last,begin_,par.threads);
+        }
+        catch(...){
+            data_allocator::deallocate(begin_,init_size);
+            throw;
+        }
+    }
+
+    // 换到容量为 n 的新空间，统计由调用者在元素就位后记录
+    template<class T,class Alloc>
+    void vector<T,Alloc>::reallocate(size_type n){
+        const auto old_size = size();
+        auto tmp = data_allocator::allocate(n);
+        try{
+            hxqstl::uninitialized_move(begin_,end_,tmp);
+        }
+        catch(...){
+            data_allocator::deallocate(tmp,n);
+            throw;
+        }
+        destroy_and_recover(begin_,end_,cap_ - begin_);
+        begin_ = tmp;
+        end_ = tmp + old_size;
+        cap_ = begin_ + n;
+    }
+
+    // 并行版本，touch_tail 为 true 时由各线程预先写入新增容量的页面
+    template<class T,class Alloc>
+    void vector<T,Alloc>::parallel_reallocate(parallel_t par,size_type n,bool touch_tail){
+        const auto old_size = size();
+        auto tmp = data_allocator::allocate(n);
+        // 先写新增容量的页面再搬迁元素，任何一步失败时旧数据都还完好
+        try{
+            if(touch_tail){
+                hxqstl::parallel_first_touch(tmp + old_size,(n - old_size) * sizeof(T),par.threads);
+            }
+            hxqstl::parallel_uninitialized_move(begin_,end_,tmp,par.threads);
+        }
+        catch(...){
+            data_allocator::deallocate(tmp,n);
+            throw;
+        }
+        destroy_and_recover(begin_,end_,cap_ - begin_);
+        begin_ = tmp;
+        end_ = tmp + old_size;
+        cap_ = tmp + n;
+    }
+
+    template<class T,class Alloc>
+    void vector<T,Alloc>::destroy_and_recover(iterator first,iterator last,size_type n){
+        data_allocator::destroy(first,last);
+        data_allocator::deallocate(first,n);
+    }
+
+    template<class T,class Alloc>
+    typename vector<T,Alloc>::size_type vector<T,Alloc>::get_new_cap(size_type add_size){
+        THROW_LENGTH_ERROR_IF(capacity() > max_size() - add_size,"vector<T>'s size too big");
+        return hxqstl::grow_capacity(capacity(),add_size,max_size());
+    }
+
+    // resize 扩容时沿用 grow_capacity 的增长策略，逐个 resize(size() + 1) 也是均摊 O(1)
+    // 调用方保证 capacity() < new_size <= max_size()
+    template<class T,class Alloc>
+    typename vector<T,Alloc>::size_type vector<T,Alloc>::get_resize_cap(size_type new_size) const noexcept{
+        const size_type add_size = new_size - size();
+        if(capacity() > max_size() - add_size) return new_size;
+        return hxqstl::max(new_size,hxqstl::grow_capacity(capacity(),add_size,max_size()));
+    }
+
+    template<class T,class Alloc>
+    void vector<T,Alloc>::fill_assign(size_type n,const value_type& value){
+        if(n > capacity()){
+            vector tmp(n,value);
+            swap(tmp);
+            MYSTL_VECTOR_REALLOC(T,reserve,capacity(),0,n);
+        }
+        else if(n > size()){
+            hxqstl::fill(begin(),end(),value);
+            end_ = hxqstl::uninitialized_fill_n(end_,n - size(),value);
+        }
+        else{
+            erase(hxqstl::fill_n(begin_,n,value),end_);
+        }
+    }
+
+    template<class T,class Alloc>
+    template<class IIter>
+    void vector<T,Alloc>::copy_assign(IIter first,IIter last,input_iterator_tag){
+        auto cur = begin_;
+        for(;first != last && cur != end_;++first,++cur){
+            *cur = *first;
+        }
+        if(first == last){
+            erase(cur,end_);
+        }
+        else{
+            for(;first != last;++first){
+                emplace_back(*first);
+            }
+        }
+    }
+
+    template<class T,class Alloc>
+    template<class FIter>
+    void vector<T,Alloc>::copy_assign(FIter first,FIter last,forward_iterator_tag){
+        const size_type len = hxqstl::distance(first,last);
+        if(len > capacity()){
+            vector tmp(first,last);
+            swap(tmp);
+            MYSTL_VECTOR_REALLOC(T,reserve,capacity(),0,len);
+        }
+        else if(size() >= len){
+            auto new_end = hxqstl::copy(first,last,begin_);
+            data_allocator::destroy(new_end,end_);
+            end_ = new_end;
+        }
+        else{
+            auto mid = first;
+            hxqstl::advance(mid,size());
+            hxqstl::copy(first,mid,begin_);
+            auto new_end = hxqstl::uninitialized_copy(mid,last,end_);
+            end_ = new_end;
+        }
+    }
+
+    // 在 pos 处插入 n 个 value
+    template<class T,class Alloc>
+    void vector<T,Alloc>::fill_insert(iterator pos,size_type n,const value_type& value){
+        if(n == 0) return;
+        if(static_cast<size_type>(cap_ - end_) >= n){
+            const value_type value_copy = value;    // value 可能是容器内的元素
+            const size_type after = static_cast<size_type>(end_ - pos);
+            auto old_end = end_;
+            if(after > n){
+                end_ = hxqstl::uninitialized_move(old_end - n,old_end,old_end);
+                hxqstl::move_backward(pos,old_end - n,old_end);
+                hxqstl::fill_n(pos,n,value_copy);
+            }
+            else{
+                end_ = hxqstl::uninitialized_fill_n(old_end,n - after,value_copy);
+                end_ = hxqstl::uninitialized_move(pos,old_end,end_);
+                hxqstl::fill_n(pos,after,value_copy);
+            }
+            return;
+        }
+        // 旧空间在搬迁前仍然有效，先构造新元素，value 引用容器内元素也没有问题
+        const size_type new_cap = get_new_cap(n);
+        const size_type off = static_cast<size_type>(pos - begin_);
+        auto new_begin = data_allocator::allocate(new_cap);
+        try{
+            hxqstl::uninitialized_fill_n(new_begin + off,n,value);
+        }
+        catch(...){
+            data_allocator::deallocate(new_begin,new_cap);
+            throw;
+        }
+        auto new_end = relocate_around(pos,new_begin,new_begin + off,n,new_cap);
+        const size_type moved = size();
+        destroy_and_recover(begin_,end_,cap_ - begin_);
+        begin_ = new_begin;
+        end_ = new_end;
+        cap_ = new_begin + new_cap;
+        MYSTL_VECTOR_REALLOC(T,grow,new_cap,moved,size());
+    }
+
+    // 输入迭代器只能遍历一次，无法预先知道长度
+    // 插入到尾部时逐个追加；否则先缓存到临时 vector，再按前向迭代器的方式移动进来
+    template<class T,class Alloc>
+    template<class IIter>
+    void vector<T,Alloc>::range_insert(iterator pos,IIter first,IIter last,input_iterator_tag){
+        if(pos == end_){
+            for(;first != last;++first){
+                emplace_back(*first);
+            }
+            return;
+        }
+        vector buf;
+        for(;first != last;++first){
+            buf.emplace_back(*first);
+        }
+        range_insert(pos,hxqstl::make_move_iterator(buf.begin()),
+                     hxqstl::make_move_iterator(buf.end()),forward_iterator_tag());
+    }
+
+    // 容量足够时只把 pos 之后的元素整体后移一次；否则按最终大小分配一次新空间，
+    // 先复制新区间，再把前段和后段搬到它的两侧，平凡类型的复制走 memmove
+    template<class T,class Alloc>
+    template<class FIter>
+    void vector<T,Alloc>::range_insert(iterator pos,FIter first,FIter last,forward_iterator_tag){
+        if(first == last) return;
+        const size_type n = static_cast<size_type>(hxqstl::distance(first,last));
+        if(static_cast<size_type>(cap_ - end_) >= n){
+            const size_type after = static_cast<size_type>(end_ - pos);
+            auto old_end = end_;
+            if(after > n){
+                end_ = hxqstl::uninitialized_move(old_end - n,old_end,old_end);
+                hxqstl::move_backward(pos,old_end - n,old_end);
+                hxqstl::copy(first,last,pos);
+            }
+            else{
+                auto mid = first;
+                hxqstl::advance(mid,after);
+                end_ = hxqstl::uninitialized_copy(mid,last,old_end);
+                end_ = hxqstl::uninitialized_move(pos,old_end,end_);
+                hxqstl::copy(first,mid,pos);
+            }
+            return;
+        }
+        const size_type new_cap = get_new_cap(n);
+        const size_type off = static_cast<size_type>(pos - begin_);
+        auto new_begin = data_allocator::allocate(new_cap);
+        try{
+            hxqstl::uninitialized_copy(first,last,new_begin + off);
+        }
+        catch(...){
+            data_allocator::deallocate(new_begin,new_cap);
+            throw;
+        }
+        auto new_end = relocate_around(pos,new_begin,new_begin + off,n,new_cap);
+        const size_type moved = size();
+        destroy_and_recover(begin_,end_,cap_ - begin_);
+        begin_ = new_begin;
+        end_ = new_end;
+        cap_ = new_begin + new_cap;
+        MYSTL_VECTOR_REALLOC(T,grow,new_cap,moved,size());
+    }
+
+    // 新元素已经构造在 [new_pos,new_pos + n)，把 [begin_,pos) 和 [pos,end_) 搬到它的两侧，返回新的尾部
+    // 移动可能抛出的元素改为拷贝，任何一步失败时析构新空间中已构造的全部元素并释放新空间，旧空间保持不变
+    template<class T,class Alloc>
+    typename vector<T,Alloc>::iterator
+    vector<T,Alloc>::relocate_around(iterator pos,iterator new_begin,iterator new_pos,size_type n,size_type new_cap){
+        auto new_end = new_begin;
+        try{
+            new_end = hxqstl::uninitialized_move_if_noexcept(begin_,pos,new_begin);
+            new_end = hxqstl::uninitialized_move_if_noexcept(pos,end_,new_pos + n);
+        }
+        catch(...){
+            data_allocator::destroy(new_begin,new_end);
+            data_allocator::destroy(new_pos,new_pos + n);
+            data_allocator::deallocate(new_begin,new_cap);
+            throw;
+        }
+        return new_end;
+    }
+
+    template<class T,class Alloc>
+    template<class ...Args>
+    void vector<T,Alloc>::reallocate_emplace(iterator pos,Args&& ...args){
+        // 参数可能引用容器内的元素，先在新空间构造新元素，再搬迁旧元素
         const auto new_size = get_new_cap(1);
         auto new_begin = data_allocator::allocate(new_size);
-        auto new_end = new_begin;
+        auto new_pos = new_begin + (pos - begin_);
+        try{
+            data_allocator::construct(hxqstl::address_of(*new_pos),hxqstl::forward<Args>(args)...);
+        }
+        catch(...){
+            data_allocator::deallocate(new_begin,new_size);
+            throw;
+        }
+        auto new_end = relocate_around(pos,new_begin,new_pos,1,new_size);
+        const size_type moved = size();
+        destroy_and_recover(begin_,end_,cap_ - begin_);
+        begin_ = new_begin;
+        end_ = new_end;
+        cap_ = new_begin + new_size;
+        MYSTL_VECTOR_REALLOC(T,grow,new_size,moved,moved + 1);
+    }
+
+    template<class T,class Alloc>
+    void vector<T,Alloc>::reallocate_insert(iterator pos,const value_type& value){
+        // value 可能引用容器内的元素，先在新空间复制出新元素，再搬迁旧元素
+        const auto new_size = get_new_cap(1);
+        auto new_begin = data_allocator::allocate(new_size);
+        auto new_pos = new_begin + (pos - begin_);
         try{
-            new_end = hxqstl::uninitialized_move(begin_,pos,new_begin);
-            data_allocator::construct(hxqstl::address_of(*new_end),hxqstl::forward<Args>(args)...);
-            ++new_end;
-            new_end = hxqstl::unintialized_move(pos,end_,new_end);
+            data_allocator::construct(hxqstl::address_of(*new_pos),value);
         }
         catch(...){
             data_allocator::deallocate(new_begin,new_size);
             throw;
         }
+        auto new_end = relocate_around(pos,new_begin,new_pos,1,new_size);
+        const size_type moved = size();
         destroy_and_recover(begin_,end_,cap_ - begin_);
         begin_ = new_begin;
         end_ = new_end;
         cap_ = new_begin + new_size;
+        MYSTL_VECTOR_REALLOC(T,grow,new_size,moved,moved + 1);
     }
 
-    template<class T>
+    template<class T,class Alloc>
     template<class ...Args>
-    typename vector<T>::iterator vector<T>::emplace(const_iterator pos,Args&& ...args){
+    typename vector<T,Alloc>::iterator vector<T,Alloc>::emplace(const_iterator pos,Args&& ...args){
         MYSTL_DEBUG(pos >= begin() && pos <= end());
-        iterator xpos = const_cast<iterator> pos;
+        iterator xpos = const_cast<iterator>(pos);
         const size_type n = xpos - begin_;
         if(end_ != cap_ && xpos == end_){
-            data_allocator::construct(hxqstl::address_of(*end),hxqstl::forward<Args>(args)...);
+            data_allocator::construct(hxqstl::address_of(*end_),hxqstl::forward<Args>(args)...);
             ++end_;
         }
         else if(end_ != cap_){
-            auto new_end = end_;
-            data_allocator::construct(hxqstl::address_of(*end),*(end_ - 1));
-            ++new_end;
-            hxqstl::copy_backward(xpos,end_ - 1,end_);
-            *xpos = value_type(hxqstl::forward<Args>(args)...);
-            end_ = new_end;
+            // 先构造新元素，参数可能引用即将被搬移的元素
+            value_type tmp(hxqstl::forward<Args>(args)...);
+            data_allocator::construct(hxqstl::address_of(*end_),hxqstl::move(*(end_ - 1)));
+            ++end_;
+            hxqstl::move_backward(xpos,end_ - 2,end_ - 1);
+            *xpos = hxqstl::move(tmp);
         } else {
             reallocate_emplace(xpos,hxqstl::forward<Args>(args)...);
         }
         return begin() + n;
     }
-}
\ No newline at end of file
+
+    // 数据按 Align 对齐、容量按 Align 取整的 vector
+    // 默认对齐到缓存行，SIMD 内核可以直接使用对齐加载，相邻的数组也不会共享缓存行
+    template<class T,size_t Align = 64>
+    using aligned_vector = vector<T,hxqstl::aligned_allocator<T,Align>>;
+}
@@ -0,0 +1,245 @@
+#pragma once
+
+// vector 扩容统计
+// 定义 MYSTL_VECTOR_TELEMETRY 后 vector 每次重新分配(自动扩容、reserve、resize、assign、shrink_to_fit)都会调用这里的钩子，
+// 未定义时钩子不会被编译进去，没有任何开销
+// 按 (元素类型, 标签, 调用点) 分组统计：重新分配次数、搬迁的元素个数和字节数、峰值容量、
+// 重新分配后闲置的容量(cap_ - end_)，用来决定在哪里加 reserve、预留多少
+// 标签用 vector_telemetry::scope 在当前线程内设置；有标签时同一标签下的调用点合并成一条
+// 调用点是用户代码里调用 vector 的位置，与优化级别无关：记录统计的慢路径(reallocate_insert、reserve 等)不内联，
+// 取它的返回地址；转发到慢路径的公开接口(push_back、insert、assign 等)强制内联，返回地址因此落在调用者的代码里
+
+#include <mutex>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <typeinfo>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+#if defined(__GLIBC__) || defined(__APPLE__)
+#include <execinfo.h>
+#include <cstdlib>
+#define MYSTL_HAS_BACKTRACE 1
+#endif
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+#if defined(__GNUC__)
+#define MYSTL_CALL_SITE() __builtin_return_address(0)
+#define MYSTL_NOINLINE __attribute__((noinline))
+#define MYSTL_ALWAYS_INLINE __attribute__((always_inline)) inline
+#else
+#define MYSTL_CALL_SITE() static_cast<void*>(nullptr)
+#define MYSTL_NOINLINE
+#define MYSTL_ALWAYS_INLINE inline
+#endif
+
+namespace hxqstl{
+    enum class vector_growth_kind
+    {
+        grow,       // 插入时容量不足自动扩容
+        reserve,    // reserve、resize 或 assign 一次性扩容
+        shrink      // shrink_to_fit
+    };
+
+    // 一组统计结果，容量和闲置量以元素个数计
+    struct vector_growth_stats
+    {
+        const char* type;
+        const char* tag;
+        void* site;
+        size_t elem_size;
+        size_t grows;
+        size_t reserves;
+        size_t shrinks;
+        size_t moved_elements;
+        size_t moved_bytes;
+        size_t peak_capacity;
+        size_t peak_waste;          // 单次重新分配后 cap_ - end_ 的最大值
+        size_t total_waste;         // 每次重新分配后 cap_ - end_ 之和
+    };
+
+    class vector_telemetry{
+    public:
+        // 在当前线程内给之后的重新分配打标签，tag 必须在统计导出之前一直有效(一般用字符串字面量)
+        class scope{
+        public:
+            explicit scope(const char* tag) : prev_(M_tag()) {M_tag() = tag;}
+            ~scope() {M_tag() = prev_;}
+            scope(const scope&) = delete;
+            scope& operator=(const scope&) = delete;
+        private:
+            const char* prev_;
+        };
+
+        template<class T>
+        static void on_reallocate(vector_growth_kind kind,void* site,size_t new_cap,size_t moved,size_t new_size);
+
+        static const char* current_tag() {return M_tag();}
+
+        // 按搬迁字节数从大到小排列
+        static std::vector<vector_growth_stats> snapshot();
+        static void reset();
+
+        static void report(FILE* out);
+        static bool write_report(const char* path);
+
+    private:
+        struct key
+        {
+            const char* type;
+            const char* tag;
+            void* site;
+
+            bool operator==(const key& rhs) const
+            { return type == rhs.type && tag == rhs.tag && site == rhs.site; }
+        };
+        struct key_hash
+        {
+            size_t operator()(const key& k) const noexcept
+            {
+                size_t h = reinterpret_cast<size_t>(k.type);
+                h = h * 31 + reinterpret_cast<size_t>(k.tag);
+                h = h * 31 + reinterpret_cast<size_t>(k.site);
+                return h ^ (h >> 17);
+            }
+        };
+
+        static const char*& M_tag();
+        static std::mutex& M_lock();
+        static std::unordered_map<key,vector_growth_stats,key_hash>& M_table();
+
+        template<class T>
+        static const char* M_type_name();
+        static const char* M_demangle(const char* name);
+    };
+
+    inline const char*& vector_telemetry::M_tag(){
+        static thread_local const char* tag = nullptr;
+        return tag;
+    }
+
+    inline std::mutex& vector_telemetry::M_lock(){
+        static std::mutex lock;
+        return lock;
+    }
+
+    inline std::unordered_map<vector_telemetry::key,vector_growth_stats,vector_telemetry::key_hash>&
+    vector_telemetry::M_table(){
+        static std::unordered_map<key,vector_growth_stats,key_hash> table;
+        return table;
+    }
+
+    // 每个类型只解析一次，同一类型的名字指针相同，可以直接作为键
+    template<class T>
+    const char* vector_telemetry::M_type_name(){
+        static const char* name = M_demangle(typeid(T).name());
+        return name;
+    }
+
+    inline const char* vector_telemetry::M_demangle(const char* name){
+#if defined(__GNUG__)
+        int status = 0;
+        // 结果只在首次使用时申请一次，生命周期与程序相同
+        char* res = abi::__cxa_demangle(name,nullptr,nullptr,&status);
+        if(status == 0 && res != nullptr) return res;
+#endif
+        return name;
+    }
+
+    // 重新分配不在热路径的每次迭代上(容量按 1.5 倍增长)，这里直接加锁
+    template<class T>
+    void vector_telemetry::on_reallocate(vector_growth_kind kind,void* site,size_t new_cap,size_t moved,size_t new_size){
+        const char* tag = M_tag();
+        const key k = {M_type_name<T>(),tag,tag != nullptr ? nullptr : site};
+        const size_t waste = new_cap - new_size;
+        std::lock_guard<std::mutex> guard(M_lock());
+        auto it = M_table().find(k);
+        if(it == M_table().end()){
+            vector_growth_stats s;
+            std::memset(&s,0,sizeof(s));
+            s.type = k.type;
+            s.tag = k.tag;
+            s.site = k.site;
+            s.elem_size = sizeof(T);
+            it = M_table().emplace(k,s).first;
+        }
+        vector_growth_stats& s = it->second;
+        switch(kind){
+            case vector_growth_kind::grow: ++s.grows; break;
+            case vector_growth_kind::reserve: ++s.reserves; break;
+            case vector_growth_kind::shrink: ++s.shrinks; break;
+        }
+        s.moved_elements += moved;
+        s.moved_bytes += moved * sizeof(T);
+        s.peak_capacity = std::max(s.peak_capacity,new_cap);
+        s.peak_waste = std::max(s.peak_waste,waste);
+        s.total_waste += waste;
+    }
+
+    inline std::vector<vector_growth_stats> vector_telemetry::snapshot(){
+        std::vector<vector_growth_stats> res;
+        {
+            std::lock_guard<std::mutex> guard(M_lock());
+            res.reserve(M_table().size());
+            for(const auto& kv : M_table()){
+                res.push_back(kv.second);
+            }
+        }
+        // 排序下标而不是元素，避免 std::sort 内部的 swap 与 hxqstl::swap 产生 ADL 歧义
+        std::vector<size_t> order(res.size());
+        for(size_t i = 0;i < res.size();++i) order[i] = i;
+        std::sort(order.begin(),order.end(),[&res](size_t x,size_t y){
+            return res[x].moved_bytes > res[y].moved_bytes;
+        });
+        std::vector<vector_growth_stats> sorted;
+        sorted.reserve(res.size());
+        for(size_t i : order) sorted.push_back(res[i]);
+        return sorted;
+    }
+
+    inline void vector_telemetry::reset(){
+        std::lock_guard<std::mutex> guard(M_lock());
+        M_table().clear();
+    }
+
+    // 每行一个分组；没有标签时输出调用点地址，glibc 下附带符号名(需要 -rdynamic)，也可以用 addr2line 解析
+    inline void vector_telemetry::report(FILE* out){
+        const std::vector<vector_growth_stats> rows = snapshot();
+        std::fprintf(out,"%-32s %-40s %8s %8s %8s %14s %16s %12s %12s %14s\n",
+                     "type","tag/site","grows","reserves","shrinks","moved_elems","moved_bytes",
+                     "peak_cap","peak_waste","total_waste");
+        for(const auto& r : rows){
+            char where[64];
+            if(r.tag != nullptr){
+                std::snprintf(where,sizeof(where),"%s",r.tag);
+            }
+            else{
+                std::snprintf(where,sizeof(where),"%p",r.site);
+            }
+            std::fprintf(out,"%-32s %-40s %8zu %8zu %8zu %14zu %16zu %12zu %12zu %14zu\n",
+                         r.type,where,r.grows,r.reserves,r.shrinks,r.moved_elements,r.moved_bytes,
+                         r.peak_capacity,r.peak_waste,r.total_waste);
+#ifdef MYSTL_HAS_BACKTRACE
+            if(r.tag == nullptr && r.site != nullptr){
+                void* frame = r.site;
+                if(char** sym = ::backtrace_symbols(&frame,1)){
+                    std::fprintf(out,"    at %s\n",sym[0]);
+                    std::free(sym);
+                }
+            }
+#endif
+        }
+    }
+
+    inline bool vector_telemetry::write_report(const char* path){
+        FILE* out = std::fopen(path,"w");
+        if(out == nullptr) return false;
+        report(out);
+        return std::fclose(out) == 0;
+    }
+}